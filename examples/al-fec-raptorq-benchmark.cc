@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+/*
+ * Encode and decode the same object with the Reed-Solomon codec, the Cauchy
+ * Reed-Solomon codec, the FFT Reed-Solomon codec and the RaptorQ codec, and
+ * print the throughput and the reception overhead of each. The two GF(2^8)
+ * RS codecs compare the multiplication kernels with the XOR-only bit matrix
+ * schedule. They hold at most 256 symbols per block, so the object is split
+ * into many blocks for them, while the FFT RS codec over GF(2^16) handles up
+ * to 32768 symbols per block at rate 1/2 and RaptorQ up to 56403.
+ *
+ * ./ns3 run "al-fec-raptorq-benchmark --payloadSize=16000000 --lossRate=0.05"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/al-fec-codec.h"
+#include "ns3/al-fec-codec-native-rs.h"
+#include "ns3/al-fec-codec-cauchy-rs.h"
+#include "ns3/al-fec-codec-fft-rs.h"
+#include "ns3/al-fec-codec-raptorq.h"
+#include "ns3/al-fec-block-partition.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+namespace {
+
+struct BenchmarkResult
+{
+  size_t nbBlocks = 0;
+  size_t nbFailures = 0; // Blocks not decoded with all the received symbols
+  size_t nbReceived = 0; // Symbols given to the decoder until each block is decoded
+  double encodeSeconds = 0;
+  double decodeSeconds = 0;
+};
+
+BenchmarkResult
+RunBenchmark (std::string typeId, const std::vector<uint8_t> &object, uint32_t symbolSize,
+              double codeRate, double lossRate, uint32_t seed)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (typeId);
+  factory.Set ("symbolSize", UintegerValue (symbolSize));
+  factory.Set ("codeRate", DoubleValue (codeRate));
+  Ptr<Object> encoderObj = factory.Create ();
+  Ptr<Object> decoderObj = factory.Create ();
+  AlFecCodec *encoder = dynamic_cast<AlFecCodec *> (PeekPointer (encoderObj));
+  AlFecCodec *decoder = dynamic_cast<AlFecCodec *> (PeekPointer (decoderObj));
+
+  BenchmarkResult result;
+  AlFecBlockPartition partition;
+  partition.Compute ((object.size () + symbolSize - 1) / symbolSize,
+                     encoder->GetMaxSourceBlockLength ());
+  result.nbBlocks = partition.GetNbBlocks ();
+
+  // Every codec gets the same erasures from the same seed
+  std::mt19937 gen (seed);
+  std::bernoulli_distribution loss (lossRate);
+  std::vector<uint8_t> symbols;
+  std::vector<unsigned int> esis;
+
+  for (size_t sbn = 0; sbn < partition.GetNbBlocks (); sbn++)
+    {
+      size_t offset = partition.GetBlockOffset (sbn) * symbolSize;
+      size_t size = std::min (partition.GetBlockLength (sbn) * symbolSize, object.size () - offset);
+      Buffer block;
+      block.AddAtStart (size);
+      block.Begin ().Write (&object[offset], size);
+
+      // Encode, keeping the symbols that survive the channel
+      symbols.clear ();
+      esis.clear ();
+      auto start = std::chrono::steady_clock::now ();
+      encoder->SetSourceBlock (block);
+      std::optional<std::pair<unsigned int, const uint8_t *>> encodedSymbol;
+      while ((encodedSymbol = encoder->NextEncodedSymbol ()))
+        {
+          if (!loss (gen))
+            {
+              symbols.insert (symbols.end (), encodedSymbol->second,
+                              encodedSymbol->second + symbolSize);
+              esis.push_back (encodedSymbol->first);
+            }
+        }
+      auto encoded = std::chrono::steady_clock::now ();
+
+      // Decode
+      decoder->NextBlock ();
+      decoder->SetK (encoder->GetK ());
+      std::optional<Buffer> decoded;
+      size_t i = 0;
+      for (; i < esis.size () && !decoded; i++)
+        {
+          decoded = decoder->Decode (&symbols[i * symbolSize], symbolSize, esis[i]);
+        }
+      auto end = std::chrono::steady_clock::now ();
+
+      result.encodeSeconds += std::chrono::duration<double> (encoded - start).count ();
+      result.decodeSeconds += std::chrono::duration<double> (end - encoded).count ();
+      result.nbReceived += i;
+      if (!decoded)
+        {
+          result.nbFailures++;
+        }
+    }
+
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+  return result;
+}
+
+} // namespace
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t payloadSize = 4000000;
+  uint32_t symbolSize = 1024;
+  double codeRate = 0.8;
+  double lossRate = 0.1;
+  uint32_t seed = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("payloadSize", "Size of the object in bytes", payloadSize);
+  cmd.AddValue ("symbolSize", "Symbol size in bytes, a multiple of 64", symbolSize);
+  cmd.AddValue ("codeRate", "k/n of all the codecs", codeRate);
+  cmd.AddValue ("lossRate", "Probability to lose each symbol", lossRate);
+  cmd.AddValue ("seed", "Seed of the payload and of the erasures", seed);
+  cmd.Parse (argc, argv);
+
+  std::vector<uint8_t> object (payloadSize);
+  std::mt19937 gen (seed);
+  for (uint8_t &byte : object)
+    {
+      byte = gen ();
+    }
+
+  std::cout << "payload=" << payloadSize << " B, symbol=" << symbolSize
+            << " B, code rate=" << codeRate << ", loss rate=" << lossRate << std::endl;
+  for (std::string typeId : {"ns3::AlFecCodecNativeRs", "ns3::AlFecCodecCauchyRs",
+                             "ns3::AlFecCodecFftRs", "ns3::AlFecCodecRaptorq"})
+    {
+      BenchmarkResult result =
+          RunBenchmark (typeId, object, symbolSize, codeRate, lossRate, seed);
+      size_t nbSymbols = (payloadSize + symbolSize - 1) / symbolSize;
+      std::cout << typeId << ": " << result.nbBlocks << " blocks, encode "
+                << payloadSize / result.encodeSeconds / 1e6 << " MB/s, decode "
+                << payloadSize / result.decodeSeconds / 1e6 << " MB/s, received "
+                << static_cast<double> (result.nbReceived) / nbSymbols
+                << " symbols per source symbol, " << result.nbFailures << " blocks lost"
+                << std::endl;
+    }
+
+  return 0;
+}
@@ -0,0 +1,68 @@
+#include "ns3/al-fec-block-partition.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecBlockPartition");
+
+AlFecBlockPartition::AlFecBlockPartition ()
+    : m_nbSymbols (0), m_nbBlocks (0), m_nbLargeBlocks (0), m_largeBlockLength (0),
+      m_smallBlockLength (0)
+{
+}
+
+void
+AlFecBlockPartition::Compute (size_t nbSymbols, size_t maxBlockLength)
+{
+  NS_LOG_FUNCTION (this << nbSymbols << maxBlockLength);
+  NS_ASSERT_MSG (maxBlockLength > 0, "The maximum block length must greater than 0");
+
+  m_nbSymbols = nbSymbols;
+  if (nbSymbols == 0)
+    {
+      m_nbBlocks = 0;
+      m_nbLargeBlocks = 0;
+      m_largeBlockLength = 0;
+      m_smallBlockLength = 0;
+      return;
+    }
+  m_nbBlocks = (nbSymbols + maxBlockLength - 1) / maxBlockLength;
+  m_largeBlockLength = (nbSymbols + m_nbBlocks - 1) / m_nbBlocks;
+  m_smallBlockLength = nbSymbols / m_nbBlocks;
+  m_nbLargeBlocks = nbSymbols - m_smallBlockLength * m_nbBlocks;
+
+  NS_LOG_INFO ("Partition " << nbSymbols << " symbols into " << m_nbLargeBlocks << " blocks of "
+                            << m_largeBlockLength << " and " << m_nbBlocks - m_nbLargeBlocks
+                            << " blocks of " << m_smallBlockLength);
+}
+
+size_t
+AlFecBlockPartition::GetNbBlocks () const
+{
+  return m_nbBlocks;
+}
+
+size_t
+AlFecBlockPartition::GetBlockLength (size_t sbn) const
+{
+  NS_ASSERT_MSG (sbn < m_nbBlocks, "SBN out of range");
+  return sbn < m_nbLargeBlocks ? m_largeBlockLength : m_smallBlockLength;
+}
+
+size_t
+AlFecBlockPartition::GetBlockOffset (size_t sbn) const
+{
+  NS_ASSERT_MSG (sbn < m_nbBlocks, "SBN out of range");
+  if (sbn < m_nbLargeBlocks)
+    {
+      return sbn * m_largeBlockLength;
+    }
+  return m_nbLargeBlocks * m_largeBlockLength + (sbn - m_nbLargeBlocks) * m_smallBlockLength;
+}
+
+size_t
+AlFecBlockPartition::GetNbSymbols () const
+{
+  return m_nbSymbols;
+}
+
+} // namespace ns3
@@ -0,0 +1,60 @@
+#ifndef AL_FEC_BLOCK_PARTITION_H
+#define AL_FEC_BLOCK_PARTITION_H
+
+#include <stddef.h>
+
+namespace ns3 {
+
+/**
+ * \brief Split an object of T source symbols into source blocks of at most
+ * B source symbols, following the block partitioning algorithm of RFC 5052
+ * (section 9.1).
+ *
+ * The object gets N = ceil(T/B) blocks. The first T - floor(T/N)*N blocks
+ * hold ceil(T/N) symbols and the others floor(T/N), so the block lengths
+ * differ by at most one symbol.
+ */
+class AlFecBlockPartition
+{
+public:
+  AlFecBlockPartition ();
+
+  /**
+   * \brief Partition an object
+   *
+   * \param nbSymbols The number of source symbols of the object (T)
+   * \param maxBlockLength The maximum number of source symbols per block (B)
+   */
+  void Compute (size_t nbSymbols, size_t maxBlockLength);
+
+  /**
+   * \brief Get the number of source blocks (N)
+   */
+  size_t GetNbBlocks () const;
+
+  /**
+   * \brief Get the number of source symbols of the given block
+   */
+  size_t GetBlockLength (size_t sbn) const;
+
+  /**
+   * \brief Get the index in the object of the first source symbol of the given block
+   */
+  size_t GetBlockOffset (size_t sbn) const;
+
+  /**
+   * \brief Get the number of source symbols of the object (T)
+   */
+  size_t GetNbSymbols () const;
+
+private:
+  size_t m_nbSymbols; // T
+  size_t m_nbBlocks; // N
+  size_t m_nbLargeBlocks; // Number of blocks of m_largeBlockLength symbols
+  size_t m_largeBlockLength; // ceil(T/N)
+  size_t m_smallBlockLength; // floor(T/N)
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_BLOCK_PARTITION_H
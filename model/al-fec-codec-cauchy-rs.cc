@@ -0,0 +1,673 @@
+#include "ns3/al-fec-codec-cauchy-rs.h"
+#include "ns3/al-fec-gf256.h"
+#include "ns3/al-fec-matrix-cache.h"
+#include "ns3/core-module.h"
+#include "ns3/type-id.h"
+
+#include <optional>
+#include <cmath>
+#include <algorithm>
+#include <string.h>
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecCauchyRs");
+NS_OBJECT_ENSURE_REGISTERED (AlFecCodecCauchyRs);
+
+namespace {
+
+// Irreducible polynomials of GF(2^w), indexed by w
+const uint16_t POLYNOMIALS[] = {0, 0, 0x7, 0xb, 0x13, 0x25, 0x43, 0x89, 0x11d};
+
+uint8_t
+GfMul (uint8_t a, uint8_t b, uint32_t w)
+{
+  uint16_t product = 0;
+  uint16_t x = a;
+  for (; b; b >>= 1)
+    {
+      if (b & 1)
+        {
+          product ^= x;
+        }
+      x <<= 1;
+      if (x >> w)
+        {
+          x ^= POLYNOMIALS[w];
+        }
+    }
+  return product;
+}
+
+uint8_t
+GfInv (uint8_t a, uint32_t w)
+{
+  NS_ASSERT (a != 0);
+  for (uint32_t x = 1; x < (1u << w); x++)
+    {
+      if (GfMul (a, x, w) == 1)
+        {
+          return x;
+        }
+    }
+  NS_ASSERT_MSG (false, "No inverse");
+  return 0;
+}
+
+// Number of ones in the w*w bit matrix of a multiplication by e
+size_t
+CountOnes (uint8_t e, uint32_t w)
+{
+  size_t ones = 0;
+  for (uint32_t c = 0; c < w; c++)
+    {
+      ones += __builtin_popcount (GfMul (e, 1 << c, w));
+    }
+  return ones;
+}
+
+// A row of bits packed in 64-bit words
+typedef std::vector<uint64_t> BitRow;
+
+bool
+GetBit (const BitRow &row, size_t i)
+{
+  return (row[i / 64] >> (i % 64)) & 1;
+}
+
+void
+SetBit (BitRow &row, size_t i)
+{
+  row[i / 64] |= uint64_t (1) << (i % 64);
+}
+
+} // namespace
+
+AlFecCodecCauchyRs::AlFecCodecCauchyRs ()
+    : m_sourceBlock (std::nullopt), m_esi (0), m_nbReceived (0), m_nbSourceReceived (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AlFecCodecCauchyRs::~AlFecCodecCauchyRs ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+AlFecCodecCauchyRs::GetTypeId (void)
+{
+  static TypeId tid =
+      TypeId ("ns3::AlFecCodecCauchyRs")
+          .SetParent<Object> ()
+          .AddConstructor<AlFecCodecCauchyRs> ()
+          .AddAttribute ("w", "Cauchy RS over GF(2^w). N must not exceed 2^w", UintegerValue (8),
+                         MakeUintegerAccessor (&AlFecCodecCauchyRs::m_w),
+                         MakeUintegerChecker<uint32_t> (2, 8))
+          .AddAttribute ("symbolSize", "The symbol size in bytes, a multiple of w",
+                         UintegerValue (16),
+                         MakeUintegerAccessor (&AlFecCodecCauchyRs::m_symbolSize),
+                         MakeUintegerChecker<uint32_t> ())
+          .AddAttribute ("codeRate", "k/n", DoubleValue (0.5),
+                         MakeDoubleAccessor (&AlFecCodecCauchyRs::m_codeRate),
+                         MakeDoubleChecker<double> (0.1, 1.0));
+  return tid;
+}
+
+void
+AlFecCodecCauchyRs::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  NextBlock ();
+  m_slab.Release ();
+}
+
+void
+AlFecCodecCauchyRs::NextBlock ()
+{
+  NS_LOG_FUNCTION (this);
+  // The slab and the schedule are kept for the next block
+  m_sourceBlock = std::nullopt;
+  m_decoded = false;
+  m_esi = 0;
+  m_received.clear ();
+  m_nbReceived = 0;
+  m_nbSourceReceived = 0;
+}
+
+std::vector<uint8_t>
+AlFecCodecCauchyRs::ComputeBitmatrix (size_t k, size_t n, uint32_t w)
+{
+  // Cauchy matrix 1 / (x_i + y_j) with x_i = i and y_j = m + j
+  size_t m = n - k;
+  if (m == 0)
+    {
+      return {};
+    }
+  std::vector<uint8_t> matrix (m * k);
+  for (size_t i = 0; i < m; i++)
+    {
+      for (size_t j = 0; j < k; j++)
+        {
+          matrix[i * k + j] = GfInv (i ^ (m + j), w);
+        }
+    }
+
+  // Scaling a row or a column keeps every square submatrix invertible. The
+  // columns are scaled to make the first row all ones, then each other row by
+  // the inverse of the element that leaves the fewest ones, as Jerasure does.
+  for (size_t j = 0; j < k; j++)
+    {
+      uint8_t inv = GfInv (matrix[j], w);
+      for (size_t i = 0; i < m; i++)
+        {
+          matrix[i * k + j] = GfMul (matrix[i * k + j], inv, w);
+        }
+    }
+  for (size_t i = 1; i < m; i++)
+    {
+      uint8_t *row = &matrix[i * k];
+      size_t bestOnes = 0;
+      for (size_t j = 0; j < k; j++)
+        {
+          bestOnes += CountOnes (row[j], w);
+        }
+      uint8_t bestInv = 1;
+      for (size_t candidate = 0; candidate < k; candidate++)
+        {
+          if (row[candidate] == 1)
+            {
+              continue;
+            }
+          uint8_t inv = GfInv (row[candidate], w);
+          size_t ones = 0;
+          for (size_t j = 0; j < k; j++)
+            {
+              ones += CountOnes (GfMul (row[j], inv, w), w);
+            }
+          if (ones < bestOnes)
+            {
+              bestOnes = ones;
+              bestInv = inv;
+            }
+        }
+      for (size_t j = 0; j < k; j++)
+        {
+          row[j] = GfMul (row[j], bestInv, w);
+        }
+    }
+
+  // Column c of the bit matrix of e holds the bits of e * 2^c
+  size_t stride = (k * w + 7) / 8;
+  std::vector<uint8_t> bitmatrix (m * w * stride, 0);
+  for (size_t i = 0; i < m; i++)
+    {
+      for (size_t j = 0; j < k; j++)
+        {
+          for (uint32_t c = 0; c < w; c++)
+            {
+              uint8_t v = GfMul (matrix[i * k + j], 1 << c, w);
+              size_t col = j * w + c;
+              for (uint32_t b = 0; b < w; b++)
+                {
+                  if ((v >> b) & 1)
+                    {
+                      bitmatrix[(i * w + b) * stride + col / 8] |= 1 << (col % 8);
+                    }
+                }
+            }
+        }
+    }
+  return bitmatrix;
+}
+
+std::vector<uint8_t>
+AlFecCodecCauchyRs::ComputeSchedule (const std::vector<uint8_t> &bitmatrix, size_t k, size_t n,
+                                     uint32_t w)
+{
+  size_t cols = k * w;
+  size_t rows = (n - k) * w;
+  size_t stride = (cols + 7) / 8;
+  size_t words = (cols + 63) / 64;
+  std::vector<BitRow> bits (rows, BitRow (words, 0));
+  for (size_t r = 0; r < rows; r++)
+    {
+      for (size_t c = 0; c < cols; c++)
+        {
+          if ((bitmatrix[r * stride + c / 8] >> (c % 8)) & 1)
+            {
+              SetBit (bits[r], c);
+            }
+        }
+    }
+
+  std::vector<uint8_t> schedule;
+  auto addOperation = [&schedule] (uint16_t dst, uint16_t src) {
+    uint16_t op[2] = {dst, src};
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *> (op);
+    schedule.insert (schedule.end (), bytes, bytes + sizeof (op));
+  };
+
+  // Each repair packet starts from the source packets it is made of, or from
+  // an earlier repair packet if they differ in fewer source packets
+  for (size_t r = 0; r < rows; r++)
+    {
+      size_t bestCost = 0;
+      for (uint64_t word : bits[r])
+        {
+          bestCost += __builtin_popcountll (word);
+        }
+      size_t base = rows;
+      for (size_t p = 0; p < r; p++)
+        {
+          size_t cost = 1;
+          for (size_t i = 0; i < words && cost < bestCost; i++)
+            {
+              cost += __builtin_popcountll (bits[r][i] ^ bits[p][i]);
+            }
+          if (cost < bestCost)
+            {
+              bestCost = cost;
+              base = p;
+            }
+        }
+
+      uint16_t dst = cols + r;
+      BitRow diff = bits[r];
+      bool copied = false;
+      if (base < rows)
+        {
+          addOperation (dst | COPY, cols + base);
+          for (size_t i = 0; i < words; i++)
+            {
+              diff[i] ^= bits[base][i];
+            }
+          copied = true;
+        }
+      for (size_t c = 0; c < cols; c++)
+        {
+          if (GetBit (diff, c))
+            {
+              addOperation (copied ? dst : dst | COPY, c);
+              copied = true;
+            }
+        }
+      NS_ASSERT_MSG (copied, "Empty row in the bit matrix");
+    }
+  return schedule;
+}
+
+void
+AlFecCodecCauchyRs::BuildSchedule ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_n <= (1u << m_w), "N must not exceed 2^w");
+  NS_ASSERT_MSG (m_symbolSize % m_w == 0, "The symbol size must be a multiple of w");
+
+  // Consecutive blocks usually share the same parameters
+  if (m_schedule && m_matrixK == m_k && m_matrixN == m_n)
+    {
+      return;
+    }
+
+  size_t k = m_k;
+  size_t n = m_n;
+  uint32_t w = m_w;
+  std::string family = GetTypeId ().GetName ();
+  m_bitmatrix = AlFecMatrixCache::Get ().GetGenerator (
+      family, w, k, n, [k, n, w] () { return ComputeBitmatrix (k, n, w); });
+  AlFecMatrixCache::Matrix bitmatrix = m_bitmatrix;
+  m_schedule = AlFecMatrixCache::Get ().GetGenerator (
+      family + "/schedule", w, k, n,
+      [&bitmatrix, k, n, w] () { return ComputeSchedule (*bitmatrix, k, n, w); });
+  m_matrixK = m_k;
+  m_matrixN = m_n;
+  NS_LOG_INFO ("Schedule of " << GetScheduleLength () << " operations for k=" << k << " n=" << n
+                              << " w=" << w);
+}
+
+size_t
+AlFecCodecCauchyRs::GetScheduleLength () const
+{
+  return m_schedule ? m_schedule->size () / (2 * sizeof (uint16_t)) : 0;
+}
+
+uint8_t *
+AlFecCodecCauchyRs::GetPacket (size_t index) const
+{
+  // The packets of the symbols are contiguous in the slab
+  return m_slab.GetData () + index * (m_symbolSize / m_w);
+}
+
+size_t
+AlFecCodecCauchyRs::GetMaxSourceBlockLength ()
+{
+  size_t maxN = 1u << m_w;
+  return GetMaxSourceBlockLengthForN (maxN, m_codeRate);
+}
+
+std::pair<size_t, size_t>
+AlFecCodecCauchyRs::SetSourceBlock (Buffer p)
+{
+  return SetSourceBlock (p.PeekData (), p.GetSize ());
+}
+
+std::pair<size_t, size_t>
+AlFecCodecCauchyRs::SetSourceBlock (const uint8_t *block, size_t sourceBlockSize)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_LOG_INFO ("Got new source block with size=" << sourceBlockSize);
+  NextBlock ();
+
+  // Calculate the encoding parameter
+  SetK (static_cast<size_t> (ceil (static_cast<double> (sourceBlockSize) / m_symbolSize)));
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  BuildSchedule ();
+
+  // The source block is copied at once and only the padding of the last symbol is cleared
+  size_t sourceSymbolsSize = m_k * m_symbolSize;
+  m_slab.Reset (m_n, m_symbolSize);
+  memcpy (m_slab.GetData (), block, sourceBlockSize);
+  memset (m_slab.GetData () + sourceBlockSize, 0, sourceSymbolsSize - sourceBlockSize);
+
+  // Run the schedule. Every repair packet starts with a copy, so the repair
+  // symbols need no clearing.
+  size_t packetSize = m_symbolSize / m_w;
+  const uint8_t *schedule = m_schedule->data ();
+  for (size_t i = 0; i < GetScheduleLength (); i++)
+    {
+      uint16_t op[2];
+      memcpy (op, schedule + i * sizeof (op), sizeof (op));
+      uint8_t *dst = GetPacket (op[0] & ~COPY);
+      if (op[0] & COPY)
+        {
+          memcpy (dst, GetPacket (op[1]), packetSize);
+        }
+      else
+        {
+          AlFecGf256::XorRegion (dst, GetPacket (op[1]), packetSize);
+        }
+    }
+
+  // Reset the internal state
+  m_esi = 0;
+
+  return std::make_pair (m_n, m_k);
+}
+
+std::optional<std::pair<unsigned int, const uint8_t *>>
+AlFecCodecCauchyRs::NextEncodedSymbol ()
+{
+  NS_LOG_FUNCTION (this << " " << m_esi);
+
+  if (m_esi >= m_n)
+    {
+      return std::nullopt;
+    }
+  const uint8_t *payload = m_slab.GetSymbol (m_esi);
+  return std::make_pair (m_esi++, payload);
+}
+
+std::optional<std::pair<unsigned int, Buffer>>
+AlFecCodecCauchyRs::NextEncodedBlock ()
+{
+  std::optional<std::pair<unsigned int, const uint8_t *>> symbol = NextEncodedSymbol ();
+  if (!symbol)
+    {
+      return std::nullopt;
+    }
+  Buffer newBlock;
+  newBlock.AddAtStart (m_symbolSize);
+  newBlock.Begin ().Write (symbol->second, m_symbolSize);
+
+  return std::make_pair (symbol->first, newBlock);
+}
+
+void
+AlFecCodecCauchyRs::RecoverSourceSymbols ()
+{
+  NS_LOG_FUNCTION (this);
+  BuildSchedule ();
+
+  // Pick the first k received symbols
+  std::vector<unsigned int> used;
+  used.reserve (m_k);
+  for (unsigned int esi = 0; esi < m_n && used.size () < m_k; esi++)
+    {
+      if (m_received[esi])
+        {
+          used.push_back (esi);
+        }
+    }
+  NS_ASSERT (used.size () == m_k);
+
+  // Invert the bit matrix rows of the used symbols over GF(2). The result
+  // only depends on which symbols are used.
+  size_t k = m_k;
+  uint32_t w = m_w;
+  AlFecMatrixCache::Matrix bitmatrix = m_bitmatrix;
+  AlFecMatrixCache::Matrix inverse = AlFecMatrixCache::Get ().GetInverse (
+      GetTypeId ().GetName (), m_w, m_k, m_n, used, [k, w, &used, &bitmatrix] () {
+        size_t dim = k * w;
+        size_t stride = (dim + 7) / 8;
+        size_t words = (dim + 63) / 64;
+        std::vector<BitRow> matrix (dim, BitRow (words, 0));
+        std::vector<BitRow> inverse (dim, BitRow (words, 0));
+        for (size_t row = 0; row < dim; row++)
+          {
+            unsigned int esi = used[row / w];
+            if (esi < k)
+              {
+                SetBit (matrix[row], esi * w + row % w);
+              }
+            else
+              {
+                const uint8_t *bits = &(*bitmatrix)[((esi - k) * w + row % w) * stride];
+                for (size_t col = 0; col < dim; col++)
+                  {
+                    if ((bits[col / 8] >> (col % 8)) & 1)
+                      {
+                        SetBit (matrix[row], col);
+                      }
+                  }
+              }
+            SetBit (inverse[row], row);
+          }
+
+        // Gauss-Jordan elimination
+        for (size_t col = 0; col < dim; col++)
+          {
+            size_t pivot = col;
+            while (pivot < dim && !GetBit (matrix[pivot], col))
+              {
+                pivot++;
+              }
+            NS_ASSERT_MSG (pivot < dim, "Decoding bit matrix is singular");
+            std::swap (matrix[col], matrix[pivot]);
+            std::swap (inverse[col], inverse[pivot]);
+            for (size_t row = 0; row < dim; row++)
+              {
+                if (row != col && GetBit (matrix[row], col))
+                  {
+                    for (size_t i = 0; i < words; i++)
+                      {
+                        matrix[row][i] ^= matrix[col][i];
+                        inverse[row][i] ^= inverse[col][i];
+                      }
+                  }
+              }
+          }
+
+        std::vector<uint8_t> packed (dim * stride, 0);
+        for (size_t row = 0; row < dim; row++)
+          {
+            for (size_t col = 0; col < dim; col++)
+              {
+                if (GetBit (inverse[row], col))
+                  {
+                    packed[row * stride + col / 8] |= 1 << (col % 8);
+                  }
+              }
+          }
+        return packed;
+      });
+
+  // Only the missing source packets have to be computed. Their slots are free
+  // and none of the used symbols lives there, so they are written in place.
+  size_t dim = m_k * m_w;
+  size_t stride = (dim + 7) / 8;
+  size_t packetSize = m_symbolSize / m_w;
+  for (unsigned int esi = 0; esi < m_k; esi++)
+    {
+      if (m_received[esi])
+        {
+          continue;
+        }
+      for (size_t row = esi * m_w; row < (esi + 1) * m_w; row++)
+        {
+          const uint8_t *bits = &(*inverse)[row * stride];
+          uint8_t *dst = GetPacket (row);
+          bool copied = false;
+          for (size_t col = 0; col < dim; col++)
+            {
+              if (!((bits[col / 8] >> (col % 8)) & 1))
+                {
+                  continue;
+                }
+              const uint8_t *src = GetPacket (used[col / m_w] * m_w + col % m_w);
+              if (copied)
+                {
+                  AlFecGf256::XorRegion (dst, src, packetSize);
+                }
+              else
+                {
+                  memcpy (dst, src, packetSize);
+                  copied = true;
+                }
+            }
+          NS_ASSERT_MSG (copied, "Empty row in the decoding bit matrix");
+        }
+      m_received[esi] = true;
+    }
+}
+
+void
+AlFecCodecCauchyRs::InitDecoder ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_k > 0, "K is not initialize");
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  m_slab.Reset (m_n, m_symbolSize);
+  m_received.assign (m_n, false);
+  m_nbReceived = 0;
+  m_nbSourceReceived = 0;
+}
+
+uint8_t *
+AlFecCodecCauchyRs::GetSymbolBuffer (unsigned int esi)
+{
+  if (m_decoded)
+    {
+      return nullptr;
+    }
+  if (m_received.empty ())
+    {
+      InitDecoder ();
+    }
+  if (esi >= m_n || m_received[esi])
+    {
+      return nullptr;
+    }
+  return m_slab.GetSymbol (esi);
+}
+
+const uint8_t *
+AlFecCodecCauchyRs::GetSourceSymbol (unsigned int esi)
+{
+  if (m_decoded && esi < m_k)
+    {
+      return m_slab.GetSymbol (esi);
+    }
+  if (esi >= m_k || esi >= m_received.size () || !m_received[esi])
+    {
+      return nullptr;
+    }
+  return m_slab.GetSymbol (esi);
+}
+
+std::optional<Buffer>
+AlFecCodecCauchyRs::Decode (Buffer p, unsigned int esi)
+{
+  return Decode (p.PeekData (), p.GetSize (), esi);
+}
+
+std::optional<Buffer>
+AlFecCodecCauchyRs::Decode (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  if (!m_sourceBlock && DecodeSymbol (symbol, size, esi))
+    {
+      // Construct original packet
+      size_t decodedContentLength = m_k * m_symbolSize;
+      Buffer sourceBlock;
+      sourceBlock.AddAtStart (decodedContentLength);
+      sourceBlock.Begin ().Write (m_slab.GetData (), decodedContentLength);
+      m_sourceBlock = sourceBlock;
+
+      NS_LOG_INFO ("Successfully decode source block. size=" << sourceBlock.GetSize ()
+                                                             << " (may contain padding)");
+    }
+  return m_sourceBlock;
+}
+
+bool
+AlFecCodecCauchyRs::DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC ("Decode with block esi=" << esi);
+
+  // The source packet has already decoded, there's no need to decode again.
+  if (m_decoded)
+    {
+      return true;
+    }
+
+  // Instance the decoder
+  if (m_received.empty ())
+    {
+      InitDecoder ();
+    }
+
+  NS_ASSERT_MSG (esi < m_n, "ESI out of range");
+  NS_ASSERT_MSG (size == m_symbolSize, "Symbol size mismatch");
+  if (m_received[esi])
+    {
+      return false;
+    }
+  uint8_t *slot = m_slab.GetSymbol (esi);
+  if (symbol != slot)
+    {
+      memcpy (slot, symbol, m_symbolSize);
+    }
+  m_received[esi] = true;
+  m_nbReceived++;
+  if (esi < m_k)
+    {
+      m_nbSourceReceived++;
+    }
+
+  if (m_nbReceived < m_k)
+    {
+      return false;
+    }
+
+  // Systematic fast path: all the source symbols are already in place
+  if (m_nbSourceReceived < m_k)
+    {
+      RecoverSourceSymbols ();
+    }
+
+  m_decoded = true;
+  return true;
+}
+
+} // namespace ns3
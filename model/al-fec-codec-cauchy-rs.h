@@ -0,0 +1,178 @@
+#ifndef AL_FEC_CODEC_CAUCHY_RS_H
+#define AL_FEC_CODEC_CAUCHY_RS_H
+
+#include "ns3/al-fec-codec.h"
+#include "ns3/al-fec-matrix-cache.h"
+#include "ns3/al-fec-symbol-slab.h"
+#include "ns3/object.h"
+
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Cauchy Reed-Solomon codec over GF(2^w) that encodes and decodes with XORs only.
+ *
+ * Each symbol is split into w packets of symbolSize / w bytes. Multiplying
+ * by a field element is then a w*w bit matrix applied to the packets, as in
+ * Jerasure: output packet b is the XOR of the input packets c whose bit
+ * (b, c) is set. The Cauchy matrix is normalized so that its bit matrix has
+ * as few ones as possible, which is the number of XORs per packet.
+ *
+ * The repair packets are built by a schedule of copy and XOR operations
+ * that computes a repair packet from an earlier one when they differ in
+ * fewer source packets than it has. The bit matrix and the schedule are
+ * kept in AlFecMatrixCache per (k, n, w). Decoding inverts the bit matrix
+ * rows of the received symbols over GF(2), which the cache keeps per
+ * erasure pattern. The code is MDS: any K symbols decode the block.
+ */
+class AlFecCodecCauchyRs : public Object, public AlFecCodec
+{
+public:
+  AlFecCodecCauchyRs ();
+  ~AlFecCodecCauchyRs ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual void DoDispose ();
+
+  /**
+   * \brief Specify the source block
+   *
+   * \return {The number of encoded block (n), the number of source block (k)}
+  */
+  std::pair<size_t, size_t> SetSourceBlock (Buffer p);
+
+  /**
+   * \brief Specify the source block from memory, which is copied into the slab
+  */
+  std::pair<size_t, size_t> SetSourceBlock (const uint8_t *block, size_t size);
+
+  /**
+   * \brief Get the next encoded symbol
+   *
+   * \return Return the next unsent encoded block.
+   * If there's no unsent encoded block, return std::nullopt
+  */
+  std::optional<std::pair<unsigned int, Buffer>> NextEncodedBlock ();
+
+  /**
+   * \brief Decode source block with received block
+   *
+   * \param p The content of received block
+   * \param esi The received Encoded Symbol ID
+   *
+   * \return If the source block successfully decoded, return the decoded block.
+   * Other, return std::nullopt
+  */
+  std::optional<Buffer> Decode (Buffer p, unsigned int esi);
+
+  /**
+   * \brief Get the next encoded symbol, pointing into the symbol slab
+  */
+  std::optional<std::pair<unsigned int, const uint8_t *>> NextEncodedSymbol ();
+  using AlFecCodec::NextEncodedSymbol;
+
+  /**
+   * \brief Get the slab slot of the symbol with the given ESI
+  */
+  uint8_t *GetSymbolBuffer (unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The symbol is copied
+   * into the slab unless it is already in its slot.
+  */
+  std::optional<Buffer> Decode (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The decoded source
+   * symbols are left in the slab for GetSourceSymbol.
+  */
+  bool DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Get the slab slot of a received or recovered source symbol
+  */
+  const uint8_t *GetSourceSymbol (unsigned int esi);
+
+  /**
+   * \brief Get the largest K for which N = ceil(K / codeRate) fits in 2^w
+  */
+  size_t GetMaxSourceBlockLength ();
+
+  /**
+   * \brief Finish the current block. The symbol memory and the schedule are
+   * kept for the next block.
+  */
+  void NextBlock ();
+
+  /**
+   * \brief Get the number of XORs and copies of packets per encoded block
+  */
+  size_t GetScheduleLength () const;
+
+private:
+  /**
+   * \brief Compute the (n-k)w*kw bit matrix of the repair symbols, one bit per
+   * packet, rows packed 8 bits per byte with the lowest column in the lowest bit
+   */
+  static std::vector<uint8_t> ComputeBitmatrix (size_t k, size_t n, uint32_t w);
+
+  /**
+   * \brief Compute the operations building the repair packets from the bit
+   * matrix. Each operation is a pair of uint16_t {destination, source}
+   * packet index, with COPY set in the destination when it is a copy.
+   */
+  static std::vector<uint8_t> ComputeSchedule (const std::vector<uint8_t> &bitmatrix, size_t k,
+                                               size_t n, uint32_t w);
+
+  /**
+   * \brief Get the bit matrix and the schedule of the current parameters
+   * from the matrix cache
+   */
+  void BuildSchedule ();
+
+  /**
+   * \brief Recover the missing source symbols once k symbols are received
+   */
+  void RecoverSourceSymbols ();
+
+  /**
+   * \brief Set up the decoder state of a new block
+   */
+  void InitDecoder ();
+
+  /**
+   * \brief Get the packet with the given index, i.e. packet index % w of
+   * the symbol index / w
+   */
+  uint8_t *GetPacket (size_t index) const;
+
+  static const uint16_t COPY = 0x8000; // Flag of the copy operations
+
+  // Common
+  uint32_t m_w = 8; // Cauchy RS over GF(2^w). For configuration.
+  double m_codeRate = 0.5; // Code rate. For configuration.
+  AlFecMatrixCache::Matrix m_bitmatrix; // Bit matrix of the repair symbols
+  AlFecMatrixCache::Matrix m_schedule; // Operations building the repair packets
+  size_t m_matrixK = 0; // K of m_bitmatrix
+  size_t m_matrixN = 0; // N of m_bitmatrix
+  std::optional<Buffer> m_sourceBlock;
+  bool m_decoded = false; // The current block is decoded
+  AlFecSymbolSlab m_slab; // Encoded symbols when encoding, received symbols when decoding
+
+  // Encode
+  unsigned int m_esi; // Current ESI
+
+  // Decode
+  std::vector<bool> m_received; // Whether the slot of each ESI holds a symbol
+  size_t m_nbReceived; // Number of distinct received symbol
+  size_t m_nbSourceReceived; // Number of distinct received source symbol
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_CODEC_CAUCHY_RS_H
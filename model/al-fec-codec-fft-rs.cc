@@ -0,0 +1,574 @@
+#include "ns3/al-fec-codec-fft-rs.h"
+#include "ns3/al-fec-gf256.h"
+#include "ns3/al-fec-gf65536.h"
+#include "ns3/core-module.h"
+#include "ns3/type-id.h"
+
+#include <optional>
+#include <cmath>
+#include <algorithm>
+#include <mutex>
+#include <string.h>
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecFftRs");
+NS_OBJECT_ENSURE_REGISTERED (AlFecCodecFftRs);
+
+namespace {
+
+const uint32_t kModulus = 65535; // Logarithms are taken modulo the order of the group
+
+struct FftTables
+{
+  uint16_t skew[16][16]; // Normalized subspace polynomial l at basis element t
+  uint16_t derivative[16]; // Derivative of the normalized subspace polynomial l, a constant
+  std::vector<uint16_t> logPoint; // Logarithm of each point, 0 for the point 0
+  std::vector<uint32_t> logWalsh[17]; // Walsh-Hadamard transform of the first 2^r logPoint
+  std::once_flag logWalshOnce[17]; // Computes each logWalsh once, whatever the thread
+
+  FftTables () : logPoint (AlFecCodecFftRs::MAX_N, 0)
+  {
+    // Cantor basis: v_0 = 1 and v_l^2 + v_l = v_(l-1)
+    uint16_t basis[16];
+    basis[0] = 1;
+    for (int l = 1; l < 16; l++)
+      {
+        uint32_t x = 2;
+        while (x < AlFecCodecFftRs::MAX_N && (AlFecGf65536::Mul (x, x) ^ x) != basis[l - 1])
+          {
+            x++;
+          }
+        NS_ASSERT_MSG (x < AlFecCodecFftRs::MAX_N, "No Cantor basis");
+        basis[l] = x;
+      }
+
+    // Subspace polynomials of the basis, from s_0(x) = x and
+    // s_(l+1)(x) = s_l(x) (s_l(x) + s_l(v_l)). They are linearized, and the
+    // derivative of s_(l+1) is s_l(v_l) times the one of s_l.
+    uint16_t s[16];
+    std::copy (basis, basis + 16, s);
+    uint16_t sDerivative = 1;
+    for (int l = 0; l < 16; l++)
+      {
+        uint16_t norm = s[l];
+        for (int t = 0; t < 16; t++)
+          {
+            skew[l][t] = AlFecGf65536::Div (s[t], norm);
+          }
+        derivative[l] = AlFecGf65536::Div (sDerivative, norm);
+        sDerivative = AlFecGf65536::Mul (sDerivative, norm);
+        for (int t = 0; t < 16; t++)
+          {
+            s[t] = AlFecGf65536::Mul (s[t], s[t]) ^ AlFecGf65536::Mul (norm, s[t]);
+          }
+      }
+
+    // Point i is the sum of the basis elements of the bits of i
+    std::vector<uint16_t> point (AlFecCodecFftRs::MAX_N, 0);
+    for (size_t i = 1; i < AlFecCodecFftRs::MAX_N; i++)
+      {
+        point[i] = point[i & (i - 1)] ^ basis[__builtin_ctz (i)];
+        logPoint[i] = AlFecGf65536::Log (point[i]);
+      }
+  }
+};
+
+FftTables &
+GetFftTables ()
+{
+  static FftTables tables;
+  return tables;
+}
+
+/**
+ * Value of the normalized subspace polynomial l at a point, which is the
+ * sum of its values at the basis elements of the point
+ */
+uint16_t
+GetSkew (const FftTables &t, size_t l, size_t point)
+{
+  uint16_t skew = 0;
+  for (; point; point &= point - 1)
+    {
+      skew ^= t.skew[l][__builtin_ctzl (point)];
+    }
+  return skew;
+}
+
+/**
+ * Walsh-Hadamard transform modulo 65535, without normalization
+ */
+void
+Fwht (std::vector<uint32_t> &data)
+{
+  for (size_t half = 1; half < data.size (); half <<= 1)
+    {
+      for (size_t r = 0; r < data.size (); r += 2 * half)
+        {
+          for (size_t i = r; i < r + half; i++)
+            {
+              uint32_t x = data[i];
+              uint32_t y = data[i + half];
+              data[i] = (x + y) % kModulus;
+              data[i + half] = (x + kModulus - y) % kModulus;
+            }
+        }
+    }
+}
+
+const std::vector<uint32_t> &
+GetLogWalsh (size_t log2Size)
+{
+  FftTables &t = GetFftTables ();
+  std::vector<uint32_t> &logWalsh = t.logWalsh[log2Size];
+  std::call_once (t.logWalshOnce[log2Size], [&t, &logWalsh, log2Size] () {
+    logWalsh.assign (t.logPoint.begin (), t.logPoint.begin () + (size_t (1) << log2Size));
+    Fwht (logWalsh);
+  });
+  return logWalsh;
+}
+
+size_t
+NextPowerOfTwo (size_t x)
+{
+  size_t p = 1;
+  while (p < x)
+    {
+      p <<= 1;
+    }
+  return p;
+}
+
+} // namespace
+
+AlFecCodecFftRs::AlFecCodecFftRs ()
+    : m_sourceBlock (std::nullopt), m_esi (0), m_nbReceived (0), m_nbSourceReceived (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AlFecCodecFftRs::~AlFecCodecFftRs ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+AlFecCodecFftRs::GetTypeId (void)
+{
+  static TypeId tid =
+      TypeId ("ns3::AlFecCodecFftRs")
+          .SetParent<Object> ()
+          .AddConstructor<AlFecCodecFftRs> ()
+          .AddAttribute ("symbolSize", "The symbol size in bytes, a multiple of 64",
+                         UintegerValue (64),
+                         MakeUintegerAccessor (&AlFecCodecFftRs::m_symbolSize),
+                         MakeUintegerChecker<uint32_t> (64))
+          .AddAttribute ("codeRate", "k/n", DoubleValue (0.5),
+                         MakeDoubleAccessor (&AlFecCodecFftRs::m_codeRate),
+                         MakeDoubleChecker<double> (0.1, 1.0));
+  return tid;
+}
+
+void
+AlFecCodecFftRs::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  NextBlock ();
+  m_slab.Release ();
+  m_work.Release ();
+}
+
+void
+AlFecCodecFftRs::NextBlock ()
+{
+  NS_LOG_FUNCTION (this);
+  // The slabs are kept for the next block
+  m_sourceBlock = std::nullopt;
+  m_decoded = false;
+  m_esi = 0;
+  m_received.clear ();
+  m_nbReceived = 0;
+  m_nbSourceReceived = 0;
+}
+
+size_t
+AlFecCodecFftRs::GetRepairPoints () const
+{
+  return m_n > m_k ? NextPowerOfTwo (m_n - m_k) : 0;
+}
+
+size_t
+AlFecCodecFftRs::GetMaxSourceBlockLength ()
+{
+  size_t k = MAX_N * m_codeRate;
+  while (k > 1)
+    {
+      size_t n = ceil (static_cast<double> (k) / m_codeRate);
+      size_t m = n > k ? NextPowerOfTwo (n - k) : 0;
+      if (m + k <= MAX_N)
+        {
+          break;
+        }
+      k--;
+    }
+  return k;
+}
+
+void
+AlFecCodecFftRs::Fft (uint8_t *data, size_t size, size_t offset) const
+{
+  const FftTables &t = GetFftTables ();
+  for (size_t half = size / 2; half > 0; half >>= 1)
+    {
+      size_t l = __builtin_ctzl (half);
+      for (size_t r = 0; r < size; r += 2 * half)
+        {
+          // The polynomial is a0 + s_l * a1, with s_l = skew on the first
+          // half of the points and skew + 1 on the second half
+          uint16_t skew = GetSkew (t, l, offset + r);
+          for (size_t i = r; i < r + half; i++)
+            {
+              uint8_t *x = data + i * m_symbolSize;
+              uint8_t *y = data + (i + half) * m_symbolSize;
+              AlFecGf65536::MulAddRegion (x, y, skew, m_symbolSize);
+              AlFecGf256::XorRegion (y, x, m_symbolSize);
+            }
+        }
+    }
+}
+
+void
+AlFecCodecFftRs::Ifft (uint8_t *data, size_t size, size_t offset) const
+{
+  const FftTables &t = GetFftTables ();
+  for (size_t half = 1; half < size; half <<= 1)
+    {
+      size_t l = __builtin_ctzl (half);
+      for (size_t r = 0; r < size; r += 2 * half)
+        {
+          uint16_t skew = GetSkew (t, l, offset + r);
+          for (size_t i = r; i < r + half; i++)
+            {
+              uint8_t *x = data + i * m_symbolSize;
+              uint8_t *y = data + (i + half) * m_symbolSize;
+              AlFecGf256::XorRegion (y, x, m_symbolSize);
+              AlFecGf65536::MulAddRegion (x, y, skew, m_symbolSize);
+            }
+        }
+    }
+}
+
+void
+AlFecCodecFftRs::FormalDerivative (uint8_t *data, size_t size) const
+{
+  // The derivative of basis polynomial i is the sum over the bits j of i of
+  // s_j' times basis polynomial i - 2^j. Coefficient i only takes from higher
+  // coefficients, so they are replaced in increasing order.
+  const FftTables &t = GetFftTables ();
+  for (size_t i = 0; i < size; i++)
+    {
+      uint8_t *coef = data + i * m_symbolSize;
+      memset (coef, 0, m_symbolSize);
+      for (size_t j = 0; (size_t (1) << j) < size; j++)
+        {
+          if (!((i >> j) & 1))
+            {
+              AlFecGf65536::MulAddRegion (coef, data + (i + (size_t (1) << j)) * m_symbolSize,
+                                          t.derivative[j], m_symbolSize);
+            }
+        }
+    }
+}
+
+void
+AlFecCodecFftRs::Encode ()
+{
+  NS_LOG_FUNCTION (this);
+  size_t m = GetRepairPoints ();
+  if (m == 0)
+    {
+      return;
+    }
+
+  // Interpolate each chunk of m source symbols on its m points, and sum
+  m_work.Reset (2 * m, m_symbolSize);
+  uint8_t *sum = m_work.GetSymbol (0);
+  uint8_t *chunk = m_work.GetSymbol (m);
+  for (size_t first = 0; first < m_k; first += m)
+    {
+      size_t count = std::min (m, m_k - first);
+      uint8_t *dst = first == 0 ? sum : chunk;
+      memcpy (dst, m_slab.GetSymbol (first), count * m_symbolSize);
+      memset (dst + count * m_symbolSize, 0, (m - count) * m_symbolSize);
+      Ifft (dst, m, m + first);
+      if (first > 0)
+        {
+          AlFecGf256::XorRegion (sum, chunk, m * m_symbolSize);
+        }
+    }
+
+  // Evaluate the sum on the repair points
+  Fft (sum, m, 0);
+  memcpy (m_slab.GetSymbol (m_k), sum, (m_n - m_k) * m_symbolSize);
+}
+
+std::pair<size_t, size_t>
+AlFecCodecFftRs::SetSourceBlock (Buffer p)
+{
+  return SetSourceBlock (p.PeekData (), p.GetSize ());
+}
+
+std::pair<size_t, size_t>
+AlFecCodecFftRs::SetSourceBlock (const uint8_t *block, size_t sourceBlockSize)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_symbolSize % AlFecGf65536::REGION_ALIGNMENT == 0,
+                 "The symbol size must be a multiple of 64");
+
+  NS_LOG_INFO ("Got new source block with size=" << sourceBlockSize);
+  NextBlock ();
+
+  // Calculate the encoding parameter
+  SetK (static_cast<size_t> (ceil (static_cast<double> (sourceBlockSize) / m_symbolSize)));
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  NS_ASSERT_MSG (GetRepairPoints () + m_k <= MAX_N, "Source block too large");
+
+  // The source block is copied at once and only the padding of the last symbol is cleared
+  size_t sourceSymbolsSize = m_k * m_symbolSize;
+  m_slab.Reset (m_n, m_symbolSize);
+  memcpy (m_slab.GetData (), block, sourceBlockSize);
+  memset (m_slab.GetData () + sourceBlockSize, 0, sourceSymbolsSize - sourceBlockSize);
+  Encode ();
+
+  // Reset the internal state
+  m_esi = 0;
+
+  return std::make_pair (m_n, m_k);
+}
+
+std::optional<std::pair<unsigned int, const uint8_t *>>
+AlFecCodecFftRs::NextEncodedSymbol ()
+{
+  NS_LOG_FUNCTION (this << " " << m_esi);
+
+  if (m_esi >= m_n)
+    {
+      return std::nullopt;
+    }
+  const uint8_t *payload = m_slab.GetSymbol (m_esi);
+  return std::make_pair (m_esi++, payload);
+}
+
+std::optional<std::pair<unsigned int, Buffer>>
+AlFecCodecFftRs::NextEncodedBlock ()
+{
+  std::optional<std::pair<unsigned int, const uint8_t *>> symbol = NextEncodedSymbol ();
+  if (!symbol)
+    {
+      return std::nullopt;
+    }
+  Buffer newBlock;
+  newBlock.AddAtStart (m_symbolSize);
+  newBlock.Begin ().Write (symbol->second, m_symbolSize);
+
+  return std::make_pair (symbol->first, newBlock);
+}
+
+void
+AlFecCodecFftRs::RecoverSourceSymbols ()
+{
+  NS_LOG_FUNCTION (this);
+  size_t m = GetRepairPoints ();
+  size_t size = NextPowerOfTwo (m + m_k);
+  size_t log2Size = __builtin_ctzl (size);
+
+  // Point p holds repair symbol k + p below m, and source symbol p - m above
+  auto getEsi = [this, m] (size_t p) -> std::optional<unsigned int> {
+    if (p < m)
+      {
+        return p < m_n - m_k ? std::make_optional<unsigned int> (m_k + p) : std::nullopt;
+      }
+    return p < m + m_k ? std::make_optional<unsigned int> (p - m) : std::nullopt;
+  };
+
+  // Logarithm of the erasure locator at every point p, i.e. of the product of
+  // (point p + point e) over the erased points e other than p. This is the
+  // convolution of the erasures with logPoint over the XOR of the indexes.
+  std::vector<uint32_t> locator (size, 0);
+  for (size_t p = 0; p < m + m_k; p++)
+    {
+      std::optional<unsigned int> esi = getEsi (p);
+      locator[p] = !esi || !m_received[*esi];
+    }
+  Fwht (locator);
+  const std::vector<uint32_t> &logWalsh = GetLogWalsh (log2Size);
+  for (size_t i = 0; i < size; i++)
+    {
+      locator[i] = static_cast<uint64_t> (locator[i]) * logWalsh[i] % kModulus;
+    }
+  Fwht (locator);
+  // The transform applied twice multiplies by size, and 2^16 is 1 modulo 65535
+  for (size_t i = 0; i < size; i++)
+    {
+      locator[i] = (static_cast<uint64_t> (locator[i]) << (16 - log2Size)) % kModulus;
+    }
+
+  // The received symbols times the locator are the values of a polynomial of
+  // degree below size, which vanishes on the erased points
+  m_work.Reset (size, m_symbolSize);
+  for (size_t p = 0; p < size; p++)
+    {
+      std::optional<unsigned int> esi = getEsi (p);
+      uint8_t *dst = m_work.GetSymbol (p);
+      if (esi && m_received[*esi])
+        {
+          AlFecGf65536::MulRegion (dst, m_slab.GetSymbol (*esi), AlFecGf65536::Exp (locator[p]),
+                                   m_symbolSize);
+        }
+      else
+        {
+          memset (dst, 0, m_symbolSize);
+        }
+    }
+
+  // On an erased point, the derivative of the product is the symbol times
+  // the derivative of the locator, which the convolution gave
+  Ifft (m_work.GetData (), size, 0);
+  FormalDerivative (m_work.GetData (), size);
+  Fft (m_work.GetData (), size, 0);
+  for (unsigned int esi = 0; esi < m_k; esi++)
+    {
+      if (m_received[esi])
+        {
+          continue;
+        }
+      size_t p = m + esi;
+      AlFecGf65536::MulRegion (m_slab.GetSymbol (esi), m_work.GetSymbol (p),
+                               AlFecGf65536::Exp (kModulus - locator[p]), m_symbolSize);
+      m_received[esi] = true;
+    }
+}
+
+void
+AlFecCodecFftRs::InitDecoder ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_k > 0, "K is not initialize");
+  NS_ASSERT_MSG (m_symbolSize % AlFecGf65536::REGION_ALIGNMENT == 0,
+                 "The symbol size must be a multiple of 64");
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  NS_ASSERT_MSG (GetRepairPoints () + m_k <= MAX_N, "Source block too large");
+  m_slab.Reset (m_n, m_symbolSize);
+  m_received.assign (m_n, false);
+  m_nbReceived = 0;
+  m_nbSourceReceived = 0;
+}
+
+uint8_t *
+AlFecCodecFftRs::GetSymbolBuffer (unsigned int esi)
+{
+  if (m_decoded)
+    {
+      return nullptr;
+    }
+  if (m_received.empty ())
+    {
+      InitDecoder ();
+    }
+  if (esi >= m_n || m_received[esi])
+    {
+      return nullptr;
+    }
+  return m_slab.GetSymbol (esi);
+}
+
+const uint8_t *
+AlFecCodecFftRs::GetSourceSymbol (unsigned int esi)
+{
+  if (m_decoded && esi < m_k)
+    {
+      return m_slab.GetSymbol (esi);
+    }
+  if (esi >= m_k || esi >= m_received.size () || !m_received[esi])
+    {
+      return nullptr;
+    }
+  return m_slab.GetSymbol (esi);
+}
+
+std::optional<Buffer>
+AlFecCodecFftRs::Decode (Buffer p, unsigned int esi)
+{
+  return Decode (p.PeekData (), p.GetSize (), esi);
+}
+
+std::optional<Buffer>
+AlFecCodecFftRs::Decode (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  if (!m_sourceBlock && DecodeSymbol (symbol, size, esi))
+    {
+      // Construct original packet
+      size_t decodedContentLength = m_k * m_symbolSize;
+      Buffer sourceBlock;
+      sourceBlock.AddAtStart (decodedContentLength);
+      sourceBlock.Begin ().Write (m_slab.GetData (), decodedContentLength);
+      m_sourceBlock = sourceBlock;
+
+      NS_LOG_INFO ("Successfully decode source block. size=" << sourceBlock.GetSize ()
+                                                             << " (may contain padding)");
+    }
+  return m_sourceBlock;
+}
+
+bool
+AlFecCodecFftRs::DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC ("Decode with block esi=" << esi);
+
+  // The source packet has already decoded, there's no need to decode again.
+  if (m_decoded)
+    {
+      return true;
+    }
+
+  // Instance the decoder
+  if (m_received.empty ())
+    {
+      InitDecoder ();
+    }
+
+  NS_ASSERT_MSG (esi < m_n, "ESI out of range");
+  NS_ASSERT_MSG (size == m_symbolSize, "Symbol size mismatch");
+  if (m_received[esi])
+    {
+      return false;
+    }
+  uint8_t *slot = m_slab.GetSymbol (esi);
+  if (symbol != slot)
+    {
+      memcpy (slot, symbol, m_symbolSize);
+    }
+  m_received[esi] = true;
+  m_nbReceived++;
+  if (esi < m_k)
+    {
+      m_nbSourceReceived++;
+    }
+
+  if (m_nbReceived < m_k)
+    {
+      return false;
+    }
+
+  // Systematic fast path: all the source symbols are already in place
+  if (m_nbSourceReceived < m_k)
+    {
+      RecoverSourceSymbols ();
+    }
+
+  m_decoded = true;
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,174 @@
+#ifndef AL_FEC_CODEC_FFT_RS_H
+#define AL_FEC_CODEC_FFT_RS_H
+
+#include "ns3/al-fec-codec.h"
+#include "ns3/al-fec-symbol-slab.h"
+#include "ns3/object.h"
+
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Reed-Solomon codec over GF(2^16) with additive FFTs, after Leopard-RS.
+ *
+ * The codeword is the evaluation of a polynomial on the points of a subspace
+ * of GF(2^16) spanned by a Cantor basis, in the polynomial basis of Lin,
+ * Chung and Han, where evaluating and interpolating are FFTs of O(N log N)
+ * multiply-adds. The repair symbols sit on the first m points, m being N-K
+ * rounded up to a power of 2, and the source symbols on the next K points.
+ *
+ * Encoding interpolates each chunk of m source symbols with an inverse FFT,
+ * sums the chunks and evaluates the sum on the repair points. Decoding
+ * multiplies the received symbols by the erasure locator polynomial, whose
+ * logarithms come from a Walsh-Hadamard transform, then recovers the
+ * erased symbols from the formal derivative of the product. Both cost
+ * O(N log N) whatever the erasures, for blocks of up to 65536 symbols
+ * including the rounding of m, and the code is MDS: any K symbols decode
+ * the block.
+ *
+ * The symbol size must be a multiple of 64 bytes, the layout of the
+ * regions of AlFecGf65536. The output only depends on the source block,
+ * not on the kernel or the run.
+ */
+class AlFecCodecFftRs : public Object, public AlFecCodec
+{
+public:
+  static const size_t MAX_N = 65536; // Number of points of GF(2^16)
+
+  AlFecCodecFftRs ();
+  ~AlFecCodecFftRs ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual void DoDispose ();
+
+  /**
+   * \brief Specify the source block
+   *
+   * \return {The number of encoded block (n), the number of source block (k)}
+  */
+  std::pair<size_t, size_t> SetSourceBlock (Buffer p);
+
+  /**
+   * \brief Specify the source block from memory, which is copied into the slab
+  */
+  std::pair<size_t, size_t> SetSourceBlock (const uint8_t *block, size_t size);
+
+  /**
+   * \brief Get the next encoded symbol
+   *
+   * \return Return the next unsent encoded block.
+   * If there's no unsent encoded block, return std::nullopt
+  */
+  std::optional<std::pair<unsigned int, Buffer>> NextEncodedBlock ();
+
+  /**
+   * \brief Decode source block with received block
+   *
+   * \param p The content of received block
+   * \param esi The received Encoded Symbol ID
+   *
+   * \return If the source block successfully decoded, return the decoded block.
+   * Other, return std::nullopt
+  */
+  std::optional<Buffer> Decode (Buffer p, unsigned int esi);
+
+  /**
+   * \brief Get the next encoded symbol, pointing into the symbol slab
+  */
+  std::optional<std::pair<unsigned int, const uint8_t *>> NextEncodedSymbol ();
+  using AlFecCodec::NextEncodedSymbol;
+
+  /**
+   * \brief Get the slab slot of the symbol with the given ESI
+  */
+  uint8_t *GetSymbolBuffer (unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The symbol is copied
+   * into the slab unless it is already in its slot.
+  */
+  std::optional<Buffer> Decode (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The decoded source
+   * symbols are left in the slab for GetSourceSymbol.
+  */
+  bool DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Get the slab slot of a received or recovered source symbol
+  */
+  const uint8_t *GetSourceSymbol (unsigned int esi);
+
+  /**
+   * \brief Get the largest K for which K plus the repair points fit in GF(2^16)
+  */
+  size_t GetMaxSourceBlockLength ();
+
+  /**
+   * \brief Finish the current block. The symbol memory is kept for the next block.
+  */
+  void NextBlock ();
+
+private:
+  /**
+   * \brief Get the number of repair points m of the current K and N
+   */
+  size_t GetRepairPoints () const;
+
+  /**
+   * \brief Evaluate, in place, the polynomial of the given coefficients on
+   * the points [offset, offset + size). size is a power of 2 and offset a
+   * multiple of it.
+   */
+  void Fft (uint8_t *data, size_t size, size_t offset) const;
+
+  /**
+   * \brief Interpolate, in place, the values on the points [offset, offset + size)
+   */
+  void Ifft (uint8_t *data, size_t size, size_t offset) const;
+
+  /**
+   * \brief Replace the coefficients by the ones of the formal derivative
+   */
+  void FormalDerivative (uint8_t *data, size_t size) const;
+
+  /**
+   * \brief Build the repair symbols of the source block in the slab
+   */
+  void Encode ();
+
+  /**
+   * \brief Recover the missing source symbols once k symbols are received
+   */
+  void RecoverSourceSymbols ();
+
+  /**
+   * \brief Set up the decoder state of a new block
+   */
+  void InitDecoder ();
+
+  // Common
+  double m_codeRate = 0.5; // Code rate. For configuration.
+  std::optional<Buffer> m_sourceBlock;
+  bool m_decoded = false; // The current block is decoded
+  AlFecSymbolSlab m_slab; // Encoded symbols when encoding, received symbols when decoding
+  AlFecSymbolSlab m_work; // Transformed symbols
+
+  // Encode
+  unsigned int m_esi; // Current ESI
+
+  // Decode
+  std::vector<bool> m_received; // Whether the slot of each ESI holds a symbol
+  size_t m_nbReceived; // Number of distinct received symbol
+  size_t m_nbSourceReceived; // Number of distinct received source symbol
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_CODEC_FFT_RS_H
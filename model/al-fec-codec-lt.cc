@@ -0,0 +1,467 @@
+#include "ns3/al-fec-codec-lt.h"
+#include "ns3/al-fec-gf256.h"
+#include "ns3/core-module.h"
+#include "ns3/type-id.h"
+
+#include <optional>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string.h>
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecLt");
+NS_OBJECT_ENSURE_REGISTERED (AlFecCodecLt);
+
+namespace {
+
+/**
+ * \brief splitmix64, so that the neighbors only depend on the seed and the ESI
+ */
+uint64_t
+NextRandom (uint64_t &state)
+{
+  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+} // namespace
+
+AlFecCodecLt::AlFecCodecLt ()
+    : m_sourceBlock (std::nullopt),
+      m_esi (0),
+      m_nbKnown (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AlFecCodecLt::~AlFecCodecLt ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+AlFecCodecLt::GetTypeId (void)
+{
+  static TypeId tid =
+      TypeId ("ns3::AlFecCodecLt")
+          .SetParent<Object> ()
+          .AddConstructor<AlFecCodecLt> ()
+          .AddAttribute ("symbolSize", "The symbol size in bytes", UintegerValue (16),
+                         MakeUintegerAccessor (&AlFecCodecLt::m_symbolSize),
+                         MakeUintegerChecker<uint32_t> ())
+          .AddAttribute ("codeRate", "k/n, where n only bounds NextEncodedBlock",
+                         DoubleValue (0.5), MakeDoubleAccessor (&AlFecCodecLt::m_codeRate),
+                         MakeDoubleChecker<double> (0.01, 1.0))
+          .AddAttribute ("c", "Robust soliton parameter c, which scales the low degrees",
+                         DoubleValue (0.05), MakeDoubleAccessor (&AlFecCodecLt::m_c),
+                         MakeDoubleChecker<double> (0.001, 1.0))
+          .AddAttribute ("delta", "Robust soliton parameter delta, the targeted failure rate",
+                         DoubleValue (0.5), MakeDoubleAccessor (&AlFecCodecLt::m_delta),
+                         MakeDoubleChecker<double> (0.001, 1.0))
+          .AddAttribute ("seed", "Seed of the neighbors of the encoded symbols",
+                         UintegerValue (0), MakeUintegerAccessor (&AlFecCodecLt::m_seed),
+                         MakeUintegerChecker<uint32_t> ())
+          .AddAttribute ("systematic",
+                         "Send the source symbols as the first K encoded symbols. The LT "
+                         "symbols then mostly cover received source symbols, which raises "
+                         "the overhead under losses",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&AlFecCodecLt::m_systematic),
+                         MakeBooleanChecker ());
+  return tid;
+}
+
+void
+AlFecCodecLt::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  NextBlock ();
+  m_slab.Release ();
+}
+
+size_t
+AlFecCodecLt::GetMaxSourceBlockLength ()
+{
+  // Encoded symbols are endless, but AlFec only sends the ESIs up to N in 16 bits
+  return GetMaxSourceBlockLengthForN (std::numeric_limits<uint16_t>::max () + 1, m_codeRate);
+}
+
+void
+AlFecCodecLt::NextBlock ()
+{
+  NS_LOG_FUNCTION (this);
+  // The slab and the edge lists are kept for the next block
+  m_sourceBlock = std::nullopt;
+  m_decoded = false;
+  m_esi = 0;
+  m_known.clear ();
+  m_nbKnown = 0;
+  m_repairData.clear ();
+  m_repairReceived.clear ();
+  m_degree.clear ();
+  m_neighborXor.clear ();
+  m_ready.clear ();
+}
+
+void
+AlFecCodecLt::ComputeDegreeDistribution ()
+{
+  if (m_degreeCdf.size () == m_k + 1)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_k);
+
+  // Ideal soliton rho, plus the spike tau at k / R
+  double k = m_k;
+  double r = m_c * log (k / m_delta) * sqrt (k);
+  size_t spike = r > 0 ? std::clamp<size_t> (floor (k / r), 1, m_k) : m_k;
+  std::vector<double> mu (m_k + 1, 0);
+  mu[1] = 1 / k;
+  for (size_t d = 2; d <= m_k; d++)
+    {
+      mu[d] = 1 / (static_cast<double> (d) * (d - 1));
+    }
+  for (size_t d = 1; d < spike; d++)
+    {
+      mu[d] += r / (d * k);
+    }
+  if (r > m_delta)
+    {
+      mu[spike] += r * log (r / m_delta) / k;
+    }
+
+  double sum = 0;
+  m_degreeCdf.assign (m_k + 1, 0);
+  for (size_t d = 1; d <= m_k; d++)
+    {
+      sum += mu[d];
+      m_degreeCdf[d] = sum;
+    }
+  for (double &p : m_degreeCdf)
+    {
+      p /= sum;
+    }
+  m_degreeCdf[m_k] = 1;
+}
+
+void
+AlFecCodecLt::GetNeighbors (unsigned int esi, std::vector<uint32_t> &neighbors)
+{
+  neighbors.clear ();
+  if (m_systematic && esi < m_k)
+    {
+      neighbors.push_back (esi);
+      return;
+    }
+  ComputeDegreeDistribution ();
+
+  uint64_t state = (static_cast<uint64_t> (m_seed) << 32) | esi;
+  double u = (NextRandom (state) >> 11) * 0x1.0p-53;
+  uint32_t degree = std::upper_bound (m_degreeCdf.begin () + 1, m_degreeCdf.end (), u) -
+                    m_degreeCdf.begin ();
+  degree = std::min<uint32_t> (degree, m_k);
+
+  // Floyd's sampling of distinct neighbors
+  m_isNeighbor.resize (m_k, false);
+  for (uint32_t j = m_k - degree; j < m_k; j++)
+    {
+      uint32_t t = NextRandom (state) % (j + 1);
+      if (m_isNeighbor[t])
+        {
+          t = j;
+        }
+      m_isNeighbor[t] = true;
+      neighbors.push_back (t);
+    }
+  for (uint32_t i : neighbors)
+    {
+      m_isNeighbor[i] = false;
+    }
+}
+
+std::pair<size_t, size_t>
+AlFecCodecLt::SetSourceBlock (Buffer p)
+{
+  return SetSourceBlock (p.PeekData (), p.GetSize ());
+}
+
+std::pair<size_t, size_t>
+AlFecCodecLt::SetSourceBlock (const uint8_t *block, size_t sourceBlockSize)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_LOG_INFO ("Got new source block with size=" << sourceBlockSize);
+  NextBlock ();
+
+  // Calculate the encoding parameter
+  SetK (static_cast<size_t> (ceil (static_cast<double> (sourceBlockSize) / m_symbolSize)));
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  ComputeDegreeDistribution ();
+
+  // The padding of the last symbol is cleared
+  m_slab.Reset (m_k, m_symbolSize);
+  memcpy (m_slab.GetData (), block, sourceBlockSize);
+  memset (m_slab.GetData () + sourceBlockSize, 0, m_k * m_symbolSize - sourceBlockSize);
+
+  m_repairSymbol.resize (m_symbolSize);
+  m_esi = 0;
+
+  return std::make_pair (m_n, m_k);
+}
+
+void
+AlFecCodecLt::GetEncodedSymbol (unsigned int esi, uint8_t *symbol)
+{
+  NS_LOG_FUNCTION (this << esi);
+  GetNeighbors (esi, m_neighbors);
+  memcpy (symbol, m_slab.GetSymbol (m_neighbors[0]), m_symbolSize);
+  for (size_t i = 1; i < m_neighbors.size (); i++)
+    {
+      AlFecGf256::XorRegion (symbol, m_slab.GetSymbol (m_neighbors[i]), m_symbolSize);
+    }
+}
+
+std::optional<std::pair<unsigned int, const uint8_t *>>
+AlFecCodecLt::NextEncodedSymbol ()
+{
+  NS_LOG_FUNCTION (this << " " << m_esi);
+
+  if (m_esi >= m_n)
+    {
+      return std::nullopt;
+    }
+  if (m_systematic && m_esi < m_k)
+    {
+      const uint8_t *payload = m_slab.GetSymbol (m_esi);
+      return std::make_pair (m_esi++, payload);
+    }
+  GetEncodedSymbol (m_esi, m_repairSymbol.data ());
+  return std::make_pair (m_esi++, static_cast<const uint8_t *> (m_repairSymbol.data ()));
+}
+
+std::optional<std::pair<unsigned int, Buffer>>
+AlFecCodecLt::NextEncodedBlock ()
+{
+  std::optional<std::pair<unsigned int, const uint8_t *>> symbol = NextEncodedSymbol ();
+  if (!symbol)
+    {
+      return std::nullopt;
+    }
+  Buffer newBlock;
+  newBlock.AddAtStart (m_symbolSize);
+  newBlock.Begin ().Write (symbol->second, m_symbolSize);
+
+  return std::make_pair (symbol->first, newBlock);
+}
+
+void
+AlFecCodecLt::InitDecoder ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_k > 0, "K is not initialize");
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  ComputeDegreeDistribution ();
+  m_slab.Reset (m_k, m_symbolSize);
+  m_known.assign (m_k, false);
+  m_nbKnown = 0;
+  m_repairData.clear ();
+  m_repairReceived.clear ();
+  m_degree.clear ();
+  m_neighborXor.clear ();
+  m_ready.clear ();
+  // The inner vectors keep their capacity from block to block
+  m_edges.resize (m_k);
+  for (std::vector<uint32_t> &edges : m_edges)
+    {
+      edges.clear ();
+    }
+}
+
+void
+AlFecCodecLt::AddEncodedSymbol (size_t index, unsigned int esi)
+{
+  uint8_t *data = &m_repairData[index * m_symbolSize];
+  uint32_t degree = 0;
+  uint32_t neighborXor = 0;
+  GetNeighbors (esi, m_neighbors);
+  for (uint32_t i : m_neighbors)
+    {
+      if (m_known[i])
+        {
+          AlFecGf256::XorRegion (data, m_slab.GetSymbol (i), m_symbolSize);
+        }
+      else
+        {
+          degree++;
+          neighborXor ^= i;
+          m_edges[i].push_back (index);
+        }
+    }
+  m_degree.push_back (degree);
+  m_neighborXor.push_back (neighborXor);
+  if (degree == 1)
+    {
+      m_ready.push_back (index);
+    }
+}
+
+void
+AlFecCodecLt::ResolveSourceSymbol (uint32_t i)
+{
+  m_known[i] = true;
+  m_nbKnown++;
+  const uint8_t *symbol = m_slab.GetSymbol (i);
+  for (uint32_t index : m_edges[i])
+    {
+      if (m_degree[index] == 0)
+        {
+          continue;
+        }
+      AlFecGf256::XorRegion (&m_repairData[index * m_symbolSize], symbol, m_symbolSize);
+      m_neighborXor[index] ^= i;
+      if (--m_degree[index] == 1)
+        {
+          m_ready.push_back (index);
+        }
+    }
+  m_edges[i].clear ();
+}
+
+void
+AlFecCodecLt::Peel ()
+{
+  while (!m_ready.empty () && m_nbKnown < m_k)
+    {
+      uint32_t index = m_ready.back ();
+      m_ready.pop_back ();
+      if (m_degree[index] != 1)
+        {
+          continue;
+        }
+      // The XOR of a single neighbor is the neighbor itself
+      uint32_t i = m_neighborXor[index];
+      m_degree[index] = 0;
+      memcpy (m_slab.GetSymbol (i), &m_repairData[index * m_symbolSize], m_symbolSize);
+      ResolveSourceSymbol (i);
+    }
+}
+
+uint8_t *
+AlFecCodecLt::GetSymbolBuffer (unsigned int esi)
+{
+  if (m_decoded)
+    {
+      return nullptr;
+    }
+  if (m_known.empty ())
+    {
+      InitDecoder ();
+    }
+  if (m_systematic && esi < m_k)
+    {
+      return m_known[esi] ? nullptr : m_slab.GetSymbol (esi);
+    }
+  if (m_repairReceived.count (esi))
+    {
+      return nullptr;
+    }
+  // The next LT symbol goes right after the received ones
+  size_t offset = m_degree.size () * m_symbolSize;
+  if (m_repairData.size () < offset + m_symbolSize)
+    {
+      m_repairData.resize (offset + m_symbolSize);
+    }
+  return &m_repairData[offset];
+}
+
+const uint8_t *
+AlFecCodecLt::GetSourceSymbol (unsigned int esi)
+{
+  if (m_decoded && esi < m_k)
+    {
+      return m_slab.GetSymbol (esi);
+    }
+  if (esi >= m_k || esi >= m_known.size () || !m_known[esi])
+    {
+      return nullptr;
+    }
+  return m_slab.GetSymbol (esi);
+}
+
+std::optional<Buffer>
+AlFecCodecLt::Decode (Buffer p, unsigned int esi)
+{
+  return Decode (p.PeekData (), p.GetSize (), esi);
+}
+
+std::optional<Buffer>
+AlFecCodecLt::Decode (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  if (!m_sourceBlock && DecodeSymbol (symbol, size, esi))
+    {
+      // Construct original packet
+      size_t decodedContentLength = m_k * m_symbolSize;
+      Buffer sourceBlock;
+      sourceBlock.AddAtStart (decodedContentLength);
+      sourceBlock.Begin ().Write (m_slab.GetData (), decodedContentLength);
+      m_sourceBlock = sourceBlock;
+
+      NS_LOG_INFO ("Successfully decode source block. size=" << sourceBlock.GetSize ()
+                                                             << " (may contain padding)");
+    }
+  return m_sourceBlock;
+}
+
+bool
+AlFecCodecLt::DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC ("Decode with block esi=" << esi);
+
+  // The source packet has already decoded, there's no need to decode again.
+  if (m_decoded)
+    {
+      return true;
+    }
+
+  // Instance the decoder
+  if (m_known.empty ())
+    {
+      InitDecoder ();
+    }
+
+  NS_ASSERT_MSG (size == m_symbolSize, "Symbol size mismatch");
+  uint8_t *slot = GetSymbolBuffer (esi);
+  if (!slot)
+    {
+      return false;
+    }
+  if (symbol != slot)
+    {
+      memcpy (slot, symbol, m_symbolSize);
+    }
+  if (m_systematic && esi < m_k)
+    {
+      ResolveSourceSymbol (esi);
+    }
+  else
+    {
+      m_repairReceived.insert (esi);
+      AddEncodedSymbol (m_degree.size (), esi);
+    }
+  Peel ();
+
+  if (m_nbKnown < m_k)
+    {
+      return false;
+    }
+
+  m_decoded = true;
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,192 @@
+#ifndef AL_FEC_CODEC_LT_H
+#define AL_FEC_CODEC_LT_H
+
+#include "ns3/al-fec-codec.h"
+#include "ns3/al-fec-symbol-slab.h"
+#include "ns3/object.h"
+
+#include <unordered_set>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief LT fountain codec with a peeling decoder.
+ *
+ * Each encoded symbol is the XOR of d source symbols, where d follows the
+ * robust soliton distribution of parameters c and delta. The degree and the
+ * neighbors of a symbol are drawn from a generator seeded with the seed
+ * attribute and the ESI only, so the decoder needs nothing else than the ESI.
+ *
+ * The decoder peels: every encoded symbol with a single unknown neighbor
+ * gives that source symbol, which is then XORed out of the other encoded
+ * symbols. Decoding therefore costs one XOR per edge, without any Gaussian
+ * elimination, at the price of an overhead of some percent over K, which
+ * shrinks as K grows.
+ *
+ * With systematic, the ESIs below K are the source symbols themselves and
+ * the LT symbols follow. This is off by default, since the LT symbols then
+ * mostly cover source symbols that are already received. Like RaptorQ, N
+ * only bounds NextEncodedBlock, and GetEncodedSymbol builds the symbol of any ESI.
+ */
+class AlFecCodecLt : public Object, public AlFecCodec
+{
+public:
+  AlFecCodecLt ();
+  ~AlFecCodecLt ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual void DoDispose ();
+
+  /**
+   * \brief Specify the source block
+   *
+   * \return {The number of encoded block (n), the number of source block (k)}
+  */
+  std::pair<size_t, size_t> SetSourceBlock (Buffer p);
+
+  /**
+   * \brief Specify the source block from memory, which is copied into the slab
+  */
+  std::pair<size_t, size_t> SetSourceBlock (const uint8_t *block, size_t size);
+
+  /**
+   * \brief Get the next encoded symbol
+   *
+   * \return Return the next unsent encoded block.
+   * If there's no unsent encoded block, return std::nullopt
+  */
+  std::optional<std::pair<unsigned int, Buffer>> NextEncodedBlock ();
+
+  /**
+   * \brief Decode source block with received block
+   *
+   * \param p The content of received block
+   * \param esi The received Encoded Symbol ID
+   *
+   * \return If the source block successfully decoded, return the decoded block.
+   * Other, return std::nullopt
+  */
+  std::optional<Buffer> Decode (Buffer p, unsigned int esi);
+
+  /**
+   * \brief Get the next encoded symbol. Source symbols point into the symbol
+   * slab, LT symbols into a buffer reused by the next call.
+  */
+  std::optional<std::pair<unsigned int, const uint8_t *>> NextEncodedSymbol ();
+  using AlFecCodec::NextEncodedSymbol;
+
+  /**
+   * \brief Build the encoded symbol of any ESI of the current source block
+   *
+   * \param esi The ESI, which may exceed N
+   * \param symbol The destination, GetSymbolSize bytes
+  */
+  void GetEncodedSymbol (unsigned int esi, uint8_t *symbol);
+
+  /**
+   * \brief Get the slot of the symbol with the given ESI. Source symbols have
+   * their slot in the slab, LT symbols are appended to the received ones.
+  */
+  uint8_t *GetSymbolBuffer (unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The symbol is copied
+   * unless it is already in its slot.
+  */
+  std::optional<Buffer> Decode (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The decoded source
+   * symbols are left in the slab for GetSourceSymbol.
+  */
+  bool DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Get the slab slot of a received or recovered source symbol
+  */
+  const uint8_t *GetSourceSymbol (unsigned int esi);
+
+  /**
+   * \brief Get the largest K whose N = ceil (K / codeRate) ESIs fit in the
+   * AlFec header
+  */
+  size_t GetMaxSourceBlockLength ();
+
+  /**
+   * \brief Finish the current block. The symbol memory is kept for the next block.
+  */
+  void NextBlock ();
+
+  /**
+   * \brief Get the source symbols an encoded symbol of the current K is made of
+   *
+   * \param esi The ESI
+   * \param neighbors Filled with the indexes of the source symbols, without duplicates
+  */
+  void GetNeighbors (unsigned int esi, std::vector<uint32_t> &neighbors);
+
+private:
+  /**
+   * \brief Build the cumulative robust soliton distribution of the current K
+   */
+  void ComputeDegreeDistribution ();
+
+  /**
+   * \brief Set up the decoder state of a new block
+   */
+  void InitDecoder ();
+
+  /**
+   * \brief Store a received LT symbol, XOR the known source symbols out of it,
+   * and queue it if a single unknown neighbor is left
+   */
+  void AddEncodedSymbol (size_t index, unsigned int esi);
+
+  /**
+   * \brief Mark a source symbol as known, and XOR it out of the encoded
+   * symbols it is part of
+   */
+  void ResolveSourceSymbol (uint32_t i);
+
+  /**
+   * \brief Recover source symbols from the queued encoded symbols until the
+   * queue is empty
+   */
+  void Peel ();
+
+  // Common
+  double m_codeRate = 0.5; // Code rate. For configuration.
+  double m_c = 0.05; // Robust soliton parameter c. For configuration.
+  double m_delta = 0.5; // Robust soliton parameter delta. For configuration.
+  uint32_t m_seed = 0; // Seed of the neighbors. For configuration.
+  bool m_systematic = false; // Whether source symbols are sent first. For configuration.
+  std::vector<double> m_degreeCdf; // P(degree <= d), for the K it was computed for
+  std::vector<bool> m_isNeighbor; // Scratch of GetNeighbors
+  std::optional<Buffer> m_sourceBlock;
+  bool m_decoded = false; // The current block is decoded
+  AlFecSymbolSlab m_slab; // Source symbols
+
+  // Encode
+  unsigned int m_esi; // Current ESI
+  std::vector<uint32_t> m_neighbors; // Scratch of GetEncodedSymbol
+  std::vector<uint8_t> m_repairSymbol; // LT symbol returned by NextEncodedSymbol
+
+  // Decode
+  std::vector<bool> m_known; // Whether each source symbol is received or recovered
+  size_t m_nbKnown; // Number of known source symbols
+  std::vector<uint8_t> m_repairData; // Received LT symbols, one after another
+  std::unordered_set<unsigned int> m_repairReceived; // ESI of the received LT symbols
+  std::vector<uint32_t> m_degree; // Number of unknown neighbors of each received LT symbol
+  std::vector<uint32_t> m_neighborXor; // XOR of the unknown neighbors of each LT symbol
+  std::vector<std::vector<uint32_t>> m_edges; // LT symbols of each unknown source symbol
+  std::vector<uint32_t> m_ready; // LT symbols with a single unknown neighbor
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_CODEC_LT_H
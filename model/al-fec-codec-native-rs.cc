@@ -0,0 +1,621 @@
+#include "ns3/al-fec-codec-native-rs.h"
+#include "ns3/al-fec-gf256.h"
+#include "ns3/al-fec-matrix-cache.h"
+#include "ns3/al-fec-worker-pool.h"
+#include "ns3/core-module.h"
+#include "ns3/type-id.h"
+
+#include <optional>
+#include <cmath>
+#include <algorithm>
+#include <string.h>
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecNativeRs");
+NS_OBJECT_ENSURE_REGISTERED (AlFecCodecNativeRs);
+
+const unsigned int AlFecCodecNativeRs::NO_PIVOT;
+
+AlFecCodecNativeRs::AlFecCodecNativeRs ()
+    : m_sourceBlock (std::nullopt),
+      m_esi (0),
+      m_nbSourceAdded (0),
+      m_nbReceived (0),
+      m_nbSourceReceived (0),
+      m_rank (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AlFecCodecNativeRs::~AlFecCodecNativeRs ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+AlFecCodecNativeRs::GetTypeId (void)
+{
+  static TypeId tid =
+      TypeId ("ns3::AlFecCodecNativeRs")
+          .SetParent<Object> ()
+          .AddConstructor<AlFecCodecNativeRs> ()
+          .AddAttribute ("m", "Reed-Solomon over GF(2^m). Only m=8 is supported", UintegerValue (8),
+                         MakeUintegerAccessor (&AlFecCodecNativeRs::m_rsM),
+                         MakeUintegerChecker<uint16_t> (8, 8))
+          .AddAttribute ("symbolSize", "The symbol size in bytes", UintegerValue (16),
+                         MakeUintegerAccessor (&AlFecCodecNativeRs::m_symbolSize),
+                         MakeUintegerChecker<uint32_t> ())
+          .AddAttribute ("codeRate", "k/n", DoubleValue (0.5),
+                         MakeDoubleAccessor (&AlFecCodecNativeRs::m_codeRate),
+                         MakeDoubleChecker<double> (0.1, 1.0))
+          .AddAttribute ("lazyRepair",
+                         "Build each repair symbol only when NextEncodedBlock reaches its ESI",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&AlFecCodecNativeRs::m_lazyRepair),
+                         MakeBooleanChecker ())
+          .AddAttribute ("nbWorkerThreads",
+                         "Number of pool threads that build the repair symbols of a block "
+                         "with the calling thread. 0 builds them on the calling thread only",
+                         UintegerValue (0),
+                         MakeUintegerAccessor (&AlFecCodecNativeRs::m_nbWorkerThreads),
+                         MakeUintegerChecker<uint32_t> (0, 64))
+          .AddAttribute ("incrementalDecoding",
+                         "Eliminate each received symbol on arrival, so that the last one "
+                         "only needs a back-substitution",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&AlFecCodecNativeRs::m_incrementalDecoding),
+                         MakeBooleanChecker ());
+  return tid;
+}
+
+void
+AlFecCodecNativeRs::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  NextBlock ();
+  m_slab.Release ();
+}
+
+void
+AlFecCodecNativeRs::NextBlock ()
+{
+  NS_LOG_FUNCTION (this);
+  // The slab and the encoding matrix are kept for the next block
+  m_sourceBlock = std::nullopt;
+  m_decoded = false;
+  m_esi = 0;
+  m_nbSourceAdded = 0;
+  m_received.clear ();
+  m_nbReceived = 0;
+  m_nbSourceReceived = 0;
+  m_rank = 0;
+}
+
+std::vector<uint8_t>
+AlFecCodecNativeRs::ComputeEncodingMatrix (size_t k, size_t n)
+{
+  // Same construction as OpenFEC: a Vandermonde matrix evaluated at
+  // {0, alpha^0, alpha^1, ...}, made systematic by multiplying it with the
+  // inverse of its top k*k part.
+  std::vector<uint8_t> vandermonde (n * k, 0);
+  vandermonde[0] = 1;
+  for (size_t row = 1; row < n; row++)
+    {
+      for (size_t col = 0; col < k; col++)
+        {
+          vandermonde[row * k + col] = AlFecGf256::Exp ((row - 1) * col);
+        }
+    }
+
+  std::vector<uint8_t> topInverse (vandermonde.begin (), vandermonde.begin () + k * k);
+  bool ret = AlFecGf256::InvertMatrix (topInverse.data (), k);
+  NS_ASSERT_MSG (ret, "Vandermonde matrix is singular");
+
+  std::vector<uint8_t> encodingMatrix ((n - k) * k, 0);
+  for (size_t row = k; row < n; row++)
+    {
+      uint8_t *out = &encodingMatrix[(row - k) * k];
+      for (size_t i = 0; i < k; i++)
+        {
+          AlFecGf256::MulAddRegion (out, &topInverse[i * k], vandermonde[row * k + i], k);
+        }
+    }
+  return encodingMatrix;
+}
+
+void
+AlFecCodecNativeRs::BuildEncodingMatrix ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_rsM == 8, "Only RS over GF(2^8) is supported");
+  NS_ASSERT_MSG (m_n <= 255, "N must not exceed 2^m - 1");
+
+  // Consecutive blocks usually share the same parameters
+  if (m_encodingMatrix && m_matrixK == m_k && m_matrixN == m_n)
+    {
+      return;
+    }
+
+  size_t k = m_k;
+  size_t n = m_n;
+  m_encodingMatrix = AlFecMatrixCache::Get ().GetGenerator (
+      GetTypeId ().GetName (), m_rsM, k, n, [k, n] () { return ComputeEncodingMatrix (k, n); });
+  m_matrixK = m_k;
+  m_matrixN = m_n;
+}
+
+size_t
+AlFecCodecNativeRs::GetMaxSourceBlockLength ()
+{
+  size_t maxN = (1u << m_rsM) - 1;
+  return GetMaxSourceBlockLengthForN (maxN, m_codeRate);
+}
+
+std::pair<size_t, size_t>
+AlFecCodecNativeRs::SetSourceBlock (Buffer p)
+{
+  return SetSourceBlock (p.PeekData (), p.GetSize ());
+}
+
+std::pair<size_t, size_t>
+AlFecCodecNativeRs::SetSourceBlock (const uint8_t *block, size_t sourceBlockSize)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_LOG_INFO ("Got new source block with size=" << sourceBlockSize);
+  NextBlock ();
+
+  // Calculate the encoding parameter
+  SetK (static_cast<size_t> (ceil (static_cast<double> (sourceBlockSize) / m_symbolSize)));
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  BuildEncodingMatrix ();
+
+  // Fill the source symbol. They are contiguous in the slab, so the source
+  // block is copied at once and only the padding of the last symbol is cleared.
+  size_t sourceSymbolsSize = m_k * m_symbolSize;
+  m_slab.Reset (m_n, m_symbolSize);
+  memcpy (m_slab.GetData (), block, sourceBlockSize);
+  memset (m_slab.GetData () + sourceBlockSize, 0, sourceSymbolsSize - sourceBlockSize);
+  m_nbSourceAdded = m_k;
+
+  // Generate the repair symbol. In lazy mode, they are built by NextEncodedBlock instead.
+  if (!m_lazyRepair)
+    {
+      BuildRepairSymbols ();
+    }
+
+  // Reset the internal state
+  m_esi = 0;
+
+  return std::make_pair (m_n, m_k);
+}
+
+void
+AlFecCodecNativeRs::StartSourceBlock (size_t k)
+{
+  NS_LOG_FUNCTION (this << k);
+  NextBlock ();
+
+  SetK (k);
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  BuildEncodingMatrix ();
+  m_slab.Reset (m_n, m_symbolSize);
+}
+
+bool
+AlFecCodecNativeRs::AddSourceSymbol (const uint8_t *symbol, size_t size)
+{
+  NS_LOG_FUNCTION (this << m_nbSourceAdded);
+  NS_ASSERT_MSG (m_nbSourceAdded < m_k, "Every source symbol was already added");
+  NS_ASSERT_MSG (size <= m_symbolSize, "Symbol is larger than the symbol size");
+
+  unsigned int i = m_nbSourceAdded++;
+  uint8_t *source = m_slab.GetSymbol (i);
+  memcpy (source, symbol, size);
+  memset (source + size, 0, m_symbolSize - size);
+
+  // Column i of the encoding matrix. The first source symbol initializes the
+  // repair symbols, so that the slab does not have to be cleared.
+  if (!m_lazyRepair)
+    {
+      for (unsigned int esi = m_k; esi < m_n; esi++)
+        {
+          uint8_t coef = (*m_encodingMatrix)[(esi - m_k) * m_k + i];
+          if (i == 0)
+            {
+              AlFecGf256::MulRegion (m_slab.GetSymbol (esi), source, coef, m_symbolSize);
+            }
+          else
+            {
+              AlFecGf256::MulAddRegion (m_slab.GetSymbol (esi), source, coef, m_symbolSize);
+            }
+        }
+    }
+  return m_nbSourceAdded == m_k;
+}
+
+void
+AlFecCodecNativeRs::BuildRepairSymbol (unsigned int esi)
+{
+  NS_LOG_FUNCTION (this << esi);
+  NS_ASSERT (esi >= m_k && esi < m_n);
+
+  const uint8_t *coef = &(*m_encodingMatrix)[(esi - m_k) * m_k];
+  // The source symbols are the first k entries of the symbol table
+  AlFecGf256::DotProductRegion (m_slab.GetSymbol (esi), m_slab.GetTable (), coef, m_k,
+                                m_symbolSize);
+  NS_LOG_LOGIC ("Built repair symbol esi=" << esi << " with " << AlFecGf256::GetKernelName ()
+                                           << " kernel");
+}
+
+void
+AlFecCodecNativeRs::BuildRepairSymbols ()
+{
+  NS_LOG_FUNCTION (this << m_nbWorkerThreads);
+
+  // Each repair symbol only reads the source symbols and its row of the
+  // encoding matrix, so the ESIs are split between the threads
+  const uint8_t *matrix = m_encodingMatrix->data ();
+  uint8_t *const *table = m_slab.GetTable ();
+  size_t k = m_k;
+  size_t symbolSize = m_symbolSize;
+  AlFecWorkerPool::Get ().ParallelFor (
+      m_k, m_n, m_nbWorkerThreads + 1,
+      [matrix, table, k, symbolSize] (size_t begin, size_t end) {
+        for (size_t esi = begin; esi < end; esi++)
+          {
+            AlFecGf256::DotProductRegion (table[esi], table, &matrix[(esi - k) * k], k,
+                                          symbolSize);
+          }
+      });
+}
+
+std::optional<std::pair<unsigned int, const uint8_t *>>
+AlFecCodecNativeRs::NextEncodedSymbol ()
+{
+  NS_LOG_FUNCTION (this << " " << m_esi);
+
+  NS_ASSERT_MSG (m_nbSourceAdded == m_k, "The source block is not complete");
+  if (m_esi >= m_n)
+    {
+      return std::nullopt;
+    }
+  // ESIs are emitted in order, so each lazy repair symbol is built exactly once
+  if (m_lazyRepair && m_esi >= m_k)
+    {
+      BuildRepairSymbol (m_esi);
+    }
+  const uint8_t *payload = m_slab.GetSymbol (m_esi);
+  return std::make_pair (m_esi++, payload);
+}
+
+std::optional<std::pair<unsigned int, Buffer>>
+AlFecCodecNativeRs::NextEncodedBlock ()
+{
+  std::optional<std::pair<unsigned int, const uint8_t *>> symbol = NextEncodedSymbol ();
+  if (!symbol)
+    {
+      return std::nullopt;
+    }
+  Buffer newBlock;
+  newBlock.AddAtStart (m_symbolSize);
+  newBlock.Begin ().Write (symbol->second, m_symbolSize);
+
+  return std::make_pair (symbol->first, newBlock);
+}
+
+void
+AlFecCodecNativeRs::RecoverSourceSymbols ()
+{
+  NS_LOG_FUNCTION (this);
+  BuildEncodingMatrix ();
+
+  // Pick the first k received symbols and build their rows of the generator matrix
+  std::vector<unsigned int> used;
+  used.reserve (m_k);
+  for (unsigned int esi = 0; esi < m_n && used.size () < m_k; esi++)
+    {
+      if (m_received[esi])
+        {
+          used.push_back (esi);
+        }
+    }
+  NS_ASSERT (used.size () == m_k);
+
+  // The decoding matrix only depends on which symbols are used
+  size_t k = m_k;
+  AlFecMatrixCache::Matrix generator = m_encodingMatrix;
+  AlFecMatrixCache::Matrix inverse = AlFecMatrixCache::Get ().GetInverse (
+      GetTypeId ().GetName (), m_rsM, m_k, m_n, used, [k, &used, &generator] () {
+        std::vector<uint8_t> matrix (k * k, 0);
+        for (size_t row = 0; row < k; row++)
+          {
+            unsigned int esi = used[row];
+            if (esi < k)
+              {
+                matrix[row * k + esi] = 1;
+              }
+            else
+              {
+                std::copy_n (&(*generator)[(esi - k) * k], k, &matrix[row * k]);
+              }
+          }
+        bool ret = AlFecGf256::InvertMatrix (matrix.data (), k);
+        NS_ASSERT_MSG (ret, "Decoding matrix is singular");
+        return matrix;
+      });
+  const std::vector<uint8_t> &matrix = *inverse;
+
+  // Only the missing source symbols have to be computed. Their slots are free
+  // and none of the used symbols lives there, so they are written in place.
+  std::vector<const uint8_t *> sources (m_k);
+  for (size_t i = 0; i < m_k; i++)
+    {
+      sources[i] = m_slab.GetSymbol (used[i]);
+    }
+  for (unsigned int esi = 0; esi < m_k; esi++)
+    {
+      if (m_received[esi])
+        {
+          continue;
+        }
+      AlFecGf256::DotProductRegion (m_slab.GetSymbol (esi), sources.data (), &matrix[esi * m_k],
+                                    m_k, m_symbolSize);
+      m_received[esi] = true;
+    }
+}
+
+void
+AlFecCodecNativeRs::EliminateSymbol (unsigned int esi)
+{
+  NS_LOG_FUNCTION (this << esi);
+  if (esi >= m_k)
+    {
+      std::vector<uint8_t> row (&(*m_encodingMatrix)[(esi - m_k) * m_k],
+                                &(*m_encodingMatrix)[(esi - m_k + 1) * m_k]);
+      InsertRow (row, esi);
+      return;
+    }
+
+  // A source symbol is the unit row of its column, the cheapest pivot there
+  // is. A repair symbol holding the column moves on to another one.
+  unsigned int previous = m_pivotSlots[esi];
+  uint8_t *pivotRow = &m_pivotRows[esi * m_k];
+  std::vector<uint8_t> row (pivotRow, pivotRow + m_k);
+  std::fill_n (pivotRow, m_k, 0);
+  pivotRow[esi] = 1;
+  m_pivotSlots[esi] = esi;
+  if (previous == NO_PIVOT)
+    {
+      m_rank++;
+    }
+  else
+    {
+      // The source symbol replaces the repair symbol, which then counts again if independent
+      InsertRow (row, previous);
+    }
+}
+
+void
+AlFecCodecNativeRs::InsertRow (std::vector<uint8_t> &row, unsigned int slot)
+{
+  // The pivot row of column c is 1 at c and 0 before, so the row is reduced
+  // in increasing column order
+  uint8_t *symbol = m_slab.GetSymbol (slot);
+  for (size_t c = 0; c < m_k; c++)
+    {
+      uint8_t coef = row[c];
+      if (coef == 0)
+        {
+          continue;
+        }
+      unsigned int pivotSlot = m_pivotSlots[c];
+      if (pivotSlot == NO_PIVOT)
+        {
+          uint8_t inv = AlFecGf256::Inv (coef);
+          AlFecGf256::MulRegion (&row[c], &row[c], inv, m_k - c);
+          AlFecGf256::MulRegion (symbol, symbol, inv, m_symbolSize);
+          std::copy (row.begin (), row.end (), m_pivotRows.begin () + c * m_k);
+          m_pivotSlots[c] = slot;
+          m_rank++;
+          return;
+        }
+      if (pivotSlot < m_k)
+        {
+          row[c] = 0;
+        }
+      else
+        {
+          AlFecGf256::MulAddRegion (&row[c], &m_pivotRows[c * m_k + c], coef, m_k - c);
+        }
+      AlFecGf256::MulAddRegion (symbol, m_slab.GetSymbol (pivotSlot), coef, m_symbolSize);
+    }
+  NS_LOG_LOGIC ("Symbol in slot " << slot << " is redundant");
+}
+
+void
+AlFecCodecNativeRs::BackSubstitute ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_rank == m_k);
+
+  // The pivots after c are already reduced to their own column
+  for (size_t c = m_k; c-- > 0;)
+    {
+      unsigned int slot = m_pivotSlots[c];
+      if (slot < m_k)
+        {
+          continue;
+        }
+      uint8_t *symbol = m_slab.GetSymbol (slot);
+      const uint8_t *row = &m_pivotRows[c * m_k];
+      for (size_t j = c + 1; j < m_k; j++)
+        {
+          if (row[j] != 0)
+            {
+              AlFecGf256::MulAddRegion (symbol, m_slab.GetSymbol (m_pivotSlots[j]), row[j],
+                                        m_symbolSize);
+            }
+        }
+    }
+
+  // The slot of a source symbol is free when a repair symbol is its pivot
+  for (unsigned int esi = 0; esi < m_k; esi++)
+    {
+      if (m_pivotSlots[esi] != esi)
+        {
+          memcpy (m_slab.GetSymbol (esi), m_slab.GetSymbol (m_pivotSlots[esi]), m_symbolSize);
+          m_received[esi] = true;
+        }
+    }
+}
+
+std::optional<size_t>
+AlFecCodecNativeRs::GetRank ()
+{
+  if (m_decoded)
+    {
+      return m_k;
+    }
+  return m_incrementalDecoding ? m_rank : std::min (m_nbReceived, m_k);
+}
+
+void
+AlFecCodecNativeRs::InitDecoder ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_k > 0, "K is not initialize");
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  m_slab.Reset (m_n, m_symbolSize);
+  m_received.assign (m_n, false);
+  m_nbReceived = 0;
+  m_nbSourceReceived = 0;
+  m_rank = 0;
+  if (m_incrementalDecoding)
+    {
+      BuildEncodingMatrix ();
+      m_pivotRows.assign (m_k * m_k, 0);
+      m_pivotSlots.assign (m_k, NO_PIVOT);
+    }
+}
+
+uint8_t *
+AlFecCodecNativeRs::GetSymbolBuffer (unsigned int esi)
+{
+  if (m_decoded)
+    {
+      return nullptr;
+    }
+  if (m_received.empty ())
+    {
+      InitDecoder ();
+    }
+  if (esi >= m_n || m_received[esi])
+    {
+      return nullptr;
+    }
+  return m_slab.GetSymbol (esi);
+}
+
+const uint8_t *
+AlFecCodecNativeRs::GetSourceSymbol (unsigned int esi)
+{
+  if (m_decoded && esi < m_k)
+    {
+      return m_slab.GetSymbol (esi);
+    }
+  if (esi >= m_k || esi >= m_received.size () || !m_received[esi])
+    {
+      return nullptr;
+    }
+  return m_slab.GetSymbol (esi);
+}
+
+std::optional<Buffer>
+AlFecCodecNativeRs::Decode (Buffer p, unsigned int esi)
+{
+  return Decode (p.PeekData (), p.GetSize (), esi);
+}
+
+std::optional<Buffer>
+AlFecCodecNativeRs::Decode (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  if (!m_sourceBlock && DecodeSymbol (symbol, size, esi))
+    {
+      // Construct original packet
+      size_t decodedContentLength = m_k * m_symbolSize;
+      Buffer sourceBlock;
+      sourceBlock.AddAtStart (decodedContentLength);
+      sourceBlock.Begin ().Write (m_slab.GetData (), decodedContentLength);
+      m_sourceBlock = sourceBlock;
+
+      NS_LOG_INFO ("Successfully decode source block. size=" << sourceBlock.GetSize ()
+                                                             << " (may contain padding)");
+    }
+  return m_sourceBlock;
+}
+
+bool
+AlFecCodecNativeRs::DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC ("Decode with block esi=" << esi);
+
+  // The source packet has already decoded, there's no need to decode again.
+  if (m_decoded)
+    {
+      return true;
+    }
+
+  // Instance the decoder
+  if (m_received.empty ())
+    {
+      InitDecoder ();
+    }
+
+  NS_ASSERT_MSG (esi < m_n, "ESI out of range");
+  NS_ASSERT_MSG (size == m_symbolSize, "Symbol size mismatch");
+  if (m_received[esi])
+    {
+      return false;
+    }
+  uint8_t *slot = m_slab.GetSymbol (esi);
+  if (symbol != slot)
+    {
+      memcpy (slot, symbol, m_symbolSize);
+    }
+  m_received[esi] = true;
+  m_nbReceived++;
+  if (esi < m_k)
+    {
+      m_nbSourceReceived++;
+    }
+
+  if (m_incrementalDecoding)
+    {
+      EliminateSymbol (esi);
+      if (m_rank < m_k)
+        {
+          return false;
+        }
+      BackSubstitute ();
+    }
+  else
+    {
+      if (m_nbReceived < m_k)
+        {
+          return false;
+        }
+
+      // Systematic fast path: all the source symbols are already in place
+      if (m_nbSourceReceived < m_k)
+        {
+          RecoverSourceSymbols ();
+        }
+    }
+
+  m_decoded = true;
+  return true;
+}
+
+} // namespace ns3
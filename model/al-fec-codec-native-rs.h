@@ -0,0 +1,208 @@
+#ifndef AL_FEC_CODEC_NATIVE_RS_H
+#define AL_FEC_CODEC_NATIVE_RS_H
+
+#include "ns3/al-fec-codec.h"
+#include "ns3/al-fec-matrix-cache.h"
+#include "ns3/al-fec-symbol-slab.h"
+#include "ns3/object.h"
+
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Reed-Solomon codec over GF(2^8) implemented with the SIMD kernels of AlFecGf256.
+ *
+ * The generator matrix is built exactly like the one of OpenFEC
+ * (OF_CODEC_REED_SOLOMON_GF_2_M_STABLE with m=8), so the encoded symbols are
+ * bit-identical to AlFecCodecOpenfecRs and the two codecs can be mixed freely
+ * between the sender and the receiver.
+ *
+ * By default the decoder inverts the matrix of the first K received symbols
+ * when the last one arrives. With incrementalDecoding, each symbol is
+ * instead eliminated on arrival against the pivot rows of the previous ones
+ * (on-the-fly Gaussian elimination), and the last one only triggers a
+ * back-substitution.
+ */
+class AlFecCodecNativeRs : public Object, public AlFecCodec
+{
+public:
+  AlFecCodecNativeRs ();
+  ~AlFecCodecNativeRs ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual void DoDispose ();
+
+  /**
+   * \brief Specify the source block
+   *
+   * \return {The number of encoded block (n), the number of source block (k)}
+  */
+  std::pair<size_t, size_t> SetSourceBlock (Buffer p);
+
+  /**
+   * \brief Specify the source block from memory, which is copied into the slab
+  */
+  std::pair<size_t, size_t> SetSourceBlock (const uint8_t *block, size_t size);
+
+  /**
+   * \brief Start a source block of k symbols given one by one to AddSourceSymbol.
+   * N and the encoding matrix are set up right away.
+  */
+  void StartSourceBlock (size_t k);
+
+  /**
+   * \brief Add the next source symbol and, unless lazyRepair is set, fold it
+   * into every repair symbol, which are then complete with the last one
+  */
+  bool AddSourceSymbol (const uint8_t *symbol, size_t size);
+
+  /**
+   * \brief Get the next encoded symbol
+   *
+   * \return Return the next unsent encoded block.
+   * If there's no unsent encoded block, return std::nullopt
+  */
+  std::optional<std::pair<unsigned int, Buffer>> NextEncodedBlock ();
+
+  /**
+   * \brief Decode source block with received block
+   *
+   * \param p The content of received block
+   * \param esi The received Encoded Symbol ID
+   *
+   * \return If the source block successfully decoded, return the decoded block.
+   * Other, return std::nullopt
+  */
+  std::optional<Buffer> Decode (Buffer p, unsigned int esi);
+
+  /**
+   * \brief Get the next encoded symbol, pointing into the symbol slab
+  */
+  std::optional<std::pair<unsigned int, const uint8_t *>> NextEncodedSymbol ();
+  using AlFecCodec::NextEncodedSymbol;
+
+  /**
+   * \brief Get the slab slot of the symbol with the given ESI
+  */
+  uint8_t *GetSymbolBuffer (unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The symbol is copied
+   * into the slab unless it is already in its slot.
+  */
+  std::optional<Buffer> Decode (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The decoded source
+   * symbols are left in the slab for GetSourceSymbol.
+  */
+  bool DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Get the slab slot of a received or recovered source symbol
+  */
+  const uint8_t *GetSourceSymbol (unsigned int esi);
+
+  /**
+   * \brief Get the largest K for which N = ceil(K / codeRate) fits in GF(2^m)
+  */
+  size_t GetMaxSourceBlockLength ();
+
+  /**
+   * \brief Get the rank of the received symbols, which is the number of
+   * distinct received symbols up to K as the code is MDS
+  */
+  std::optional<size_t> GetRank ();
+
+  /**
+   * \brief Finish the current block. The symbol memory and the encoding
+   * matrix are kept for the next block.
+  */
+  void NextBlock ();
+
+private:
+  /**
+   * \brief Set up the decoder state of a new block
+   */
+  void InitDecoder ();
+
+  /**
+   * \brief Compute the (n-k)*k repair part of the systematic generator matrix
+   */
+  static std::vector<uint8_t> ComputeEncodingMatrix (size_t k, size_t n);
+
+  /**
+   * \brief Get the encoding matrix of the current parameters from the matrix cache
+   */
+  void BuildEncodingMatrix ();
+
+  /**
+   * \brief Build the repair symbol with the given ESI into the encoded symbol table
+   */
+  void BuildRepairSymbol (unsigned int esi);
+
+  /**
+   * \brief Build every repair symbol, split between nbWorkerThreads pool
+   * threads and the calling thread. The symbols are the same whatever the split.
+   */
+  void BuildRepairSymbols ();
+
+  /**
+   * \brief Recover the missing source symbols once k symbols are received
+   */
+  void RecoverSourceSymbols ();
+
+  /**
+   * \brief Forward elimination of the newly received symbol with the given
+   * ESI against the pivot rows, in incremental decoding
+   */
+  void EliminateSymbol (unsigned int esi);
+
+  /**
+   * \brief Reduce the coefficient row of the symbol in the given slot with
+   * the pivot rows, and make it the pivot of its first remaining column
+   */
+  void InsertRow (std::vector<uint8_t> &row, unsigned int slot);
+
+  /**
+   * \brief Back-substitute the pivot rows once the rank reaches k, and move
+   * the recovered source symbols to their slots
+   */
+  void BackSubstitute ();
+
+  static const unsigned int NO_PIVOT = 0xffffffff; // Column without pivot row
+
+  // Common
+  uint16_t m_rsM = 8; // RS over GF(2^m). Only m=8 is supported.
+  double m_codeRate = 0.5; // Code rate. For configuration.
+  bool m_lazyRepair = false; // Build repair symbols on demand. For configuration.
+  uint32_t m_nbWorkerThreads = 0; // Pool threads building the repair symbols. For configuration.
+  bool m_incrementalDecoding = false; // Eliminate each symbol on arrival. For configuration.
+  AlFecMatrixCache::Matrix m_encodingMatrix; // Row esi-k holds the coefficients of repair symbol esi
+  size_t m_matrixK = 0; // K of m_encodingMatrix
+  size_t m_matrixN = 0; // N of m_encodingMatrix
+  std::optional<Buffer> m_sourceBlock;
+  bool m_decoded = false; // The current block is decoded
+  AlFecSymbolSlab m_slab; // Encoded symbols when encoding, received symbols when decoding
+
+  // Encode
+  unsigned int m_esi; // Current ESI
+  size_t m_nbSourceAdded; // Number of source symbols in the slab
+
+  // Decode
+  std::vector<bool> m_received; // Whether the slot of each ESI holds a symbol
+  size_t m_nbReceived; // Number of distinct received symbol
+  size_t m_nbSourceReceived; // Number of distinct received source symbol
+  std::vector<uint8_t> m_pivotRows; // Row c holds the coefficients of the pivot of column c
+  std::vector<unsigned int> m_pivotSlots; // Slot of the symbol of the pivot of each column
+  size_t m_rank; // Number of pivots
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_CODEC_NATIVE_RS_H
@@ -0,0 +1,478 @@
+#include "ns3/al-fec-codec-openfec-ldpc.h"
+#include "ns3/core-module.h"
+#include "ns3/type-id.h"
+
+#include <optional>
+#include <cmath>
+#include <algorithm>
+#include <string.h>
+
+extern "C" {
+#include "openfec/lib_common/of_openfec_api.h"
+}
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecOpenfecLdpc");
+NS_OBJECT_ENSURE_REGISTERED (AlFecCodecOpenfecLdpc);
+
+const uint32_t AlFecCodecOpenfecLdpc::MAX_N;
+
+AlFecCodecOpenfecLdpc::AlFecCodecOpenfecLdpc ()
+    : m_session (nullptr),
+      m_codecType (OF_ENCODER),
+      m_param ({0, 0, 0, 0, 0}),
+      m_sourceBlock (std::nullopt),
+      m_esi (0),
+      m_nbReceived (0),
+      m_nbSourceReceived (0),
+      m_nbMlAttempts (0),
+      m_nextMlAttempt (0),
+      m_nbDecoderSessions (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AlFecCodecOpenfecLdpc::~AlFecCodecOpenfecLdpc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+AlFecCodecOpenfecLdpc::GetTypeId (void)
+{
+  static TypeId tid =
+      TypeId ("ns3::AlFecCodecOpenfecLdpc")
+          .SetParent<Object> ()
+          .AddConstructor<AlFecCodecOpenfecLdpc> ()
+          .AddAttribute ("symbolSize", "The symbol size in bytes", UintegerValue (16),
+                         MakeUintegerAccessor (&AlFecCodecOpenfecLdpc::m_symbolSize),
+                         MakeUintegerChecker<uint32_t> ())
+          .AddAttribute ("codeRate", "k/n", DoubleValue (0.5),
+                         MakeDoubleAccessor (&AlFecCodecOpenfecLdpc::m_codeRate),
+                         MakeDoubleChecker<double> (0.1, 1.0))
+          .AddAttribute ("n1",
+                         "Number of ones per source symbol column of the parity check matrix",
+                         UintegerValue (7), MakeUintegerAccessor (&AlFecCodecOpenfecLdpc::m_n1),
+                         MakeUintegerChecker<uint8_t> (3))
+          .AddAttribute ("seed", "Seed of the parity check matrix", IntegerValue (1),
+                         MakeIntegerAccessor (&AlFecCodecOpenfecLdpc::m_seed),
+                         MakeIntegerChecker<int32_t> ())
+          .AddAttribute ("mlDecoding",
+                         "Finish with maximum likelihood decoding when the iterative "
+                         "decoding is stuck",
+                         BooleanValue (true),
+                         MakeBooleanAccessor (&AlFecCodecOpenfecLdpc::m_mlDecoding),
+                         MakeBooleanChecker ())
+          .AddAttribute ("lazyRepair",
+                         "Build each repair symbol only when NextEncodedBlock reaches its ESI",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&AlFecCodecOpenfecLdpc::m_lazyRepair),
+                         MakeBooleanChecker ());
+  return tid;
+}
+
+void
+AlFecCodecOpenfecLdpc::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  NextBlock ();
+  m_slab.Release ();
+}
+
+void
+AlFecCodecOpenfecLdpc::NextBlock ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_session)
+    {
+      // Only encoder sessions can serve another block
+      if (m_codecType == OF_ENCODER)
+        {
+          AlFecOpenfecSessionPool::Get ().Release (GetSessionKey (), m_session);
+        }
+      else
+        {
+          of_release_codec_instance (m_session);
+        }
+      m_session = nullptr;
+    }
+  m_sourceBlock = std::nullopt;
+  m_decoded = false;
+  m_esi = 0;
+  m_received.clear ();
+  m_nbReceived = 0;
+  m_nbSourceReceived = 0;
+  m_nbMlAttempts = 0;
+  m_nbDecoderSessions = 0;
+}
+
+AlFecOpenfecSessionPool::Key
+AlFecCodecOpenfecLdpc::GetSessionKey () const
+{
+  return {m_codecId,
+          m_param.nb_source_symbols,
+          m_param.nb_source_symbols + m_param.nb_repair_symbols,
+          m_param.encoding_symbol_length,
+          m_param.N1,
+          static_cast<uint32_t> (m_param.prng_seed)};
+}
+
+void
+AlFecCodecOpenfecLdpc::SetFecParameters ()
+{
+  m_param.nb_source_symbols = m_k;
+  m_param.nb_repair_symbols = m_n - m_k;
+  m_param.encoding_symbol_length = m_symbolSize;
+  m_param.prng_seed = m_seed;
+  // A source symbol cannot be in more equations than there are repair symbols
+  m_param.N1 = std::min<size_t> (m_n1, m_n - m_k);
+  NS_ASSERT_MSG (m_n > m_k, "LDPC-Staircase needs repair symbols");
+  NS_ASSERT_MSG (m_n <= MAX_N, "N must not exceed " << MAX_N);
+}
+
+void *
+AlFecCodecOpenfecLdpc::DecodedSymbolCallback (void *context, UINT32 size, UINT32 esi)
+{
+  AlFecCodecOpenfecLdpc *codec = static_cast<AlFecCodecOpenfecLdpc *> (context);
+  NS_ASSERT (size == codec->m_symbolSize && esi < codec->m_slab.GetN ());
+  return codec->m_slab.GetSymbol (esi);
+}
+
+size_t
+AlFecCodecOpenfecLdpc::GetNbMlAttempts () const
+{
+  return m_nbMlAttempts;
+}
+
+size_t
+AlFecCodecOpenfecLdpc::GetNbDecoderSessions () const
+{
+  return m_nbDecoderSessions;
+}
+
+size_t
+AlFecCodecOpenfecLdpc::GetMaxSourceBlockLength ()
+{
+  return GetMaxSourceBlockLengthForN (MAX_N, m_codeRate);
+}
+
+std::pair<size_t, size_t>
+AlFecCodecOpenfecLdpc::SetSourceBlock (Buffer p)
+{
+  return SetSourceBlock (p.PeekData (), p.GetSize ());
+}
+
+std::pair<size_t, size_t>
+AlFecCodecOpenfecLdpc::SetSourceBlock (const uint8_t *block, size_t sourceBlockSize)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_LOG_INFO ("Got new source block with size=" << sourceBlockSize);
+  NextBlock ();
+
+  // Calculate the encoding parameter
+  SetK (static_cast<size_t> (ceil (static_cast<double> (sourceBlockSize) / m_symbolSize)));
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  SetFecParameters ();
+
+  // Instance the encoder, or reuse an idle one with the same parameters
+  m_codecType = OF_ENCODER;
+  m_session = AlFecOpenfecSessionPool::Get ().Acquire (GetSessionKey ());
+  if (!m_session)
+    {
+      m_session = AlFecOpenfecSessionPool::CreateSession (
+          m_codecId, OF_ENCODER, reinterpret_cast<of_parameters_t *> (&m_param));
+    }
+
+  // Fill the source symbol. They are contiguous in the slab, so the source
+  // block is copied at once and only the padding of the last symbol is cleared.
+  size_t sourceSymbolsSize = m_k * m_symbolSize;
+  m_slab.Reset (m_n, m_symbolSize);
+  memcpy (m_slab.GetData (), block, sourceBlockSize);
+  memset (m_slab.GetData () + sourceBlockSize, 0, sourceSymbolsSize - sourceBlockSize);
+
+  // Generate the repair symbol. In lazy mode, they are built by NextEncodedBlock instead.
+  if (!m_lazyRepair)
+    {
+      for (unsigned int esi = m_param.nb_source_symbols; esi < m_n; esi++)
+        {
+          BuildRepairSymbol (esi);
+        }
+    }
+
+  // Reset the internal state
+  m_esi = 0;
+
+  return std::make_pair (m_n, m_k);
+}
+
+void
+AlFecCodecOpenfecLdpc::BuildRepairSymbol (unsigned int esi)
+{
+  NS_LOG_FUNCTION (this << esi);
+  NS_ASSERT (esi >= m_param.nb_source_symbols);
+
+  int ret;
+  ret = of_build_repair_symbol (m_session, reinterpret_cast<void **> (m_slab.GetTable ()), esi);
+  NS_ASSERT_MSG (ret == OF_STATUS_OK, "Build repair symbol failed");
+}
+
+std::optional<std::pair<unsigned int, const uint8_t *>>
+AlFecCodecOpenfecLdpc::NextEncodedSymbol ()
+{
+  NS_LOG_FUNCTION (this << " " << m_esi);
+
+  if (m_esi >= m_param.nb_repair_symbols + m_param.nb_source_symbols)
+    {
+      return std::nullopt;
+    }
+  // ESIs are emitted in order, which is also the order the staircase needs
+  if (m_lazyRepair && m_esi >= m_param.nb_source_symbols)
+    {
+      BuildRepairSymbol (m_esi);
+    }
+  const uint8_t *payload = m_slab.GetSymbol (m_esi);
+  return std::make_pair (m_esi++, payload);
+}
+
+std::optional<std::pair<unsigned int, Buffer>>
+AlFecCodecOpenfecLdpc::NextEncodedBlock ()
+{
+  std::optional<std::pair<unsigned int, const uint8_t *>> symbol = NextEncodedSymbol ();
+  if (!symbol)
+    {
+      return std::nullopt;
+    }
+  Buffer newBlock;
+  newBlock.AddAtStart (m_symbolSize);
+  newBlock.Begin ().Write (symbol->second, m_symbolSize);
+
+  return std::make_pair (symbol->first, newBlock);
+}
+
+void
+AlFecCodecOpenfecLdpc::CreateDecoder ()
+{
+  NS_LOG_FUNCTION (this);
+
+  int ret;
+  m_codecType = OF_DECODER;
+  SetFecParameters ();
+  m_session = AlFecOpenfecSessionPool::CreateSession (
+      m_codecId, OF_DECODER, reinterpret_cast<of_parameters_t *> (&m_param));
+  m_nbDecoderSessions++;
+
+  // Let OpenFEC write the decoded source symbols into the slab. The decoded
+  // repair symbols are only needed by OpenFEC, which allocates them itself.
+  ret = of_set_callback_functions (m_session, &AlFecCodecOpenfecLdpc::DecodedSymbolCallback,
+                                   nullptr, this);
+  NS_ASSERT_MSG (ret == OF_STATUS_OK, "Set callback functions failed");
+
+  for (unsigned int i = 0; i < m_n && !of_is_decoding_complete (m_session); i++)
+    {
+      if (m_received[i])
+        {
+          ret = of_decode_with_new_symbol (m_session, m_slab.GetSymbol (i), i);
+          NS_ASSERT_MSG (ret == OF_STATUS_OK, "Decode failed");
+        }
+    }
+}
+
+bool
+AlFecCodecOpenfecLdpc::FinishDecoding ()
+{
+  NS_LOG_FUNCTION (this);
+  m_nbMlAttempts++;
+  int ret = of_finish_decoding (m_session);
+  if (ret == OF_STATUS_OK && of_is_decoding_complete (m_session))
+    {
+      NS_LOG_LOGIC ("ML decoding succeeded with " << m_nbReceived << " symbols");
+      return true;
+    }
+
+  // Each attempt costs a Gaussian elimination, so the number of symbols
+  // beyond k doubles before the next one: k, k + 1, k + 2, k + 4...
+  m_nextMlAttempt = m_nbReceived + std::max<size_t> (1, m_nbReceived - m_k);
+  NS_LOG_LOGIC ("ML decoding failed with " << m_nbReceived << " symbols, attempt "
+                                           << m_nbMlAttempts << ", next with "
+                                           << m_nextMlAttempt);
+
+  // The session is not meant to go on after a failed ML decoding. The
+  // iterative decoding goes on in a fresh one fed with the received symbols.
+  of_release_codec_instance (m_session);
+  m_session = nullptr;
+  CreateDecoder ();
+  return of_is_decoding_complete (m_session);
+}
+
+Buffer
+AlFecCodecOpenfecLdpc::AssembleSourceBlock ()
+{
+  size_t decodedContentLength = m_k * m_symbolSize;
+  Buffer sourceBlock;
+  sourceBlock.AddAtStart (decodedContentLength);
+  sourceBlock.Begin ().Write (m_slab.GetData (), decodedContentLength);
+  m_sourceBlock = std::make_optional<Buffer> (sourceBlock);
+
+  NS_LOG_INFO ("Successfully decode source block. size=" << sourceBlock.GetSize ()
+                                                         << " (may contain padding)");
+  return sourceBlock;
+}
+
+void
+AlFecCodecOpenfecLdpc::InitDecoder ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_k > 0, "K is not initialize");
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  m_slab.Reset (m_n, m_symbolSize);
+  m_received.assign (m_n, false);
+  m_nbReceived = 0;
+  m_nbSourceReceived = 0;
+  m_nbMlAttempts = 0;
+  m_nextMlAttempt = m_k;
+  m_nbDecoderSessions = 0;
+}
+
+uint8_t *
+AlFecCodecOpenfecLdpc::GetSymbolBuffer (unsigned int esi)
+{
+  if (m_decoded)
+    {
+      return nullptr;
+    }
+  if (m_received.empty ())
+    {
+      InitDecoder ();
+    }
+  if (esi >= m_n || m_received[esi])
+    {
+      return nullptr;
+    }
+  return m_slab.GetSymbol (esi);
+}
+
+const uint8_t *
+AlFecCodecOpenfecLdpc::GetSourceSymbol (unsigned int esi)
+{
+  if (m_decoded && esi < m_k)
+    {
+      return m_slab.GetSymbol (esi);
+    }
+  if (esi >= m_k || esi >= m_received.size () || !m_received[esi])
+    {
+      return nullptr;
+    }
+  return m_slab.GetSymbol (esi);
+}
+
+std::optional<Buffer>
+AlFecCodecOpenfecLdpc::Decode (Buffer p, unsigned int esi)
+{
+  return Decode (p.PeekData (), p.GetSize (), esi);
+}
+
+std::optional<Buffer>
+AlFecCodecOpenfecLdpc::Decode (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  if (!m_sourceBlock && DecodeSymbol (symbol, size, esi))
+    {
+      AssembleSourceBlock ();
+    }
+  return m_sourceBlock;
+}
+
+bool
+AlFecCodecOpenfecLdpc::DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  NS_LOG_FUNCTION (this);
+
+  int ret;
+  uint8_t *buf;
+
+  NS_LOG_LOGIC ("Decode with block esi=" << esi);
+
+  // The source packet has already decoded, there's no need to decode again.
+  if (m_decoded)
+    {
+      return true;
+    }
+
+  // Initialize the decoder state
+  if (m_received.empty ())
+    {
+      InitDecoder ();
+    }
+
+  // Store the new symbol in its slot
+  NS_ASSERT_MSG (esi < m_n, "ESI out of range");
+  NS_ASSERT_MSG (size == m_symbolSize, "Symbol size mismatch");
+  if (m_received[esi])
+    {
+      return false;
+    }
+  buf = m_slab.GetSymbol (esi);
+  if (symbol != buf)
+    {
+      memcpy (buf, symbol, m_symbolSize);
+    }
+  m_received[esi] = true;
+  m_nbReceived++;
+  if (esi < m_k)
+    {
+      m_nbSourceReceived++;
+    }
+
+  // Systematic fast path: all the source symbols are already in place
+  if (m_nbSourceReceived == m_k)
+    {
+      NS_LOG_LOGIC ("All source symbols received, skip the decoder");
+      m_decoded = true;
+      return true;
+    }
+
+  // No code can decode with less than k symbols. The decoder is then created
+  // and fed with every symbol stored so far.
+  if (!m_session)
+    {
+      if (m_nbReceived < m_k)
+        {
+          return false;
+        }
+      CreateDecoder ();
+    }
+  else
+    {
+      ret = of_decode_with_new_symbol (m_session, buf, esi);
+      NS_ASSERT_MSG (ret == OF_STATUS_OK, "Decode failed");
+    }
+
+  // The ML decoding only runs once enough symbols came since the last attempt
+  bool isComplete = of_is_decoding_complete (m_session);
+  if (!isComplete && m_mlDecoding && m_nbReceived >= m_nextMlAttempt)
+    {
+      isComplete = FinishDecoding ();
+    }
+  if (!isComplete)
+    {
+      return false;
+    }
+
+  // Retrieve source block. The decoded symbols are already in place; only
+  // copy the ones OpenFEC may have put elsewhere.
+  m_sourceSymbol.assign (m_param.nb_source_symbols, nullptr);
+  ret = of_get_source_symbols_tab (m_session, m_sourceSymbol.data ());
+  NS_ASSERT_MSG (ret == OF_STATUS_OK, "Get source symbol failed");
+  for (unsigned int i = 0; i < m_param.nb_source_symbols; i++)
+    {
+      if (m_sourceSymbol[i] != m_slab.GetSymbol (i))
+        {
+          memcpy (m_slab.GetSymbol (i), m_sourceSymbol[i], m_symbolSize);
+        }
+    }
+
+  m_decoded = true;
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,208 @@
+#ifndef AL_FEC_CODEC_OPENFEC_LDPC_H
+#define AL_FEC_CODEC_OPENFEC_LDPC_H
+
+#include "ns3/al-fec-codec.h"
+#include "ns3/al-fec-openfec-session-pool.h"
+#include "ns3/al-fec-symbol-slab.h"
+#include "ns3/object.h"
+
+#include <vector>
+
+extern "C" {
+#include "openfec/lib_common/of_openfec_api.h"
+}
+
+namespace ns3 {
+
+/**
+ * \brief LDPC-Staircase codec of OpenFEC (OF_CODEC_LDPC_STAIRCASE_STABLE, RFC 5170).
+ *
+ * Encoding and iterative decoding take linear time, and blocks may hold up to
+ * 50000 encoded symbols, so this codec suits much larger blocks than RS. The
+ * price is a decoding overhead: the iterative decoder usually needs a few
+ * percent more than k symbols. With mlDecoding, a block that the iterative
+ * decoder cannot finish is solved by Gaussian elimination (maximum
+ * likelihood decoding), which gets close to k symbols at a higher CPU cost.
+ *
+ * The encoder and the decoder must agree on the code, i.e. on N1 and the seed.
+ */
+class AlFecCodecOpenfecLdpc : public Object, public AlFecCodec
+{
+public:
+  static const uint32_t MAX_N = 50000; // Largest block of OpenFEC LDPC-Staircase
+
+  AlFecCodecOpenfecLdpc ();
+  ~AlFecCodecOpenfecLdpc ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual void DoDispose ();
+
+  /**
+   * \brief Specify the source block
+   * 
+   * \return {The number of encoded block (n), the number of source block (k)}
+  */
+  std::pair<size_t, size_t> SetSourceBlock (Buffer p);
+
+  /**
+   * \brief Specify the source block from memory, which is copied into the slab
+  */
+  std::pair<size_t, size_t> SetSourceBlock (const uint8_t *block, size_t size);
+
+
+  /**
+   * \brief Get the next encoded symbol
+   * 
+   * \return Return the next unsent encoded block.
+   * If there's no unsent encoded block, return std::nullopt
+  */
+  std::optional<std::pair<unsigned int, Buffer>> NextEncodedBlock ();
+
+  /**
+   * \brief Decode source block with received block
+   * 
+   * \param p The content of received block
+   * \param esi The received Encoded Symbol ID
+   * 
+   * \return If the source block successfully decoded, return the decoded block.
+   * Other, return std::nullopt
+  */
+  std::optional<Buffer> Decode (Buffer p, unsigned int esi);
+
+  /**
+   * \brief Get the next encoded symbol, pointing into the symbol slab
+  */
+  std::optional<std::pair<unsigned int, const uint8_t *>> NextEncodedSymbol ();
+  using AlFecCodec::NextEncodedSymbol;
+
+  /**
+   * \brief Get the slab slot of the symbol with the given ESI
+  */
+  uint8_t *GetSymbolBuffer (unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The symbol is copied
+   * into the slab unless it is already in its slot.
+  */
+  std::optional<Buffer> Decode (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The decoded source
+   * symbols are left in the slab for GetSourceSymbol.
+  */
+  bool DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Get the slab slot of a received or recovered source symbol
+  */
+  const uint8_t *GetSourceSymbol (unsigned int esi);
+
+  /**
+   * \brief Get the largest K for which N = ceil(K / codeRate) does not exceed
+   * the 50000 encoding symbols of OpenFEC LDPC-Staircase
+  */
+  size_t GetMaxSourceBlockLength ();
+
+  /**
+   * \brief Get the number of ML decoding attempts of the current block
+  */
+  size_t GetNbMlAttempts () const;
+
+  /**
+   * \brief Get the number of decoder sessions created for the current block.
+   * A session is created once k symbols arrived and after each failed ML
+   * decoding attempt.
+  */
+  size_t GetNbDecoderSessions () const;
+
+  /**
+   * \brief Finish the current block. The encoder session goes back to the
+   * session pool, the decoder session is released.
+  */
+  void NextBlock ();
+
+private:
+  /**
+   * \brief Set up the decoder state of a new block
+   */
+  void InitDecoder ();
+
+  /**
+   * \brief Get the pool key of the current parameters
+   */
+  AlFecOpenfecSessionPool::Key GetSessionKey () const;
+
+  /**
+   * \brief Fill the LDPC parameters from N, K and the configuration
+   */
+  void SetFecParameters ();
+
+  /**
+   * \brief Build the repair symbol with the given ESI into the encoded symbol table.
+   * The staircase makes each repair symbol depend on the previous one, so
+   * they must be built in order.
+   */
+  void BuildRepairSymbol (unsigned int esi);
+
+  /**
+   * \brief Instance the OpenFEC decoder session and feed it with the symbols
+   * received so far
+   */
+  void CreateDecoder ();
+
+  /**
+   * \brief Run the maximum likelihood decoding once the iterative decoding is
+   * stuck. After a failure, the decoder goes on with a fresh session and the
+   * next attempt waits for twice as many symbols beyond k.
+   *
+   * \return Whether the block is decoded
+   */
+  bool FinishDecoding ();
+
+  /**
+   * \brief Build the decoded source block from the source symbols in the slab
+   */
+  Buffer AssembleSourceBlock ();
+
+  /**
+   * \brief Tell OpenFEC where to store a decoded symbol
+   *
+   * \return The slot of the symbol in the slab
+   */
+  static void *DecodedSymbolCallback (void *context, UINT32 size, UINT32 esi);
+
+  // Common
+  of_session_t *m_session;
+  of_codec_type_t m_codecType; // Whether m_session is an encoder or a decoder
+  of_ldpc_parameters_t m_param;
+  uint8_t m_n1 = 7; // Number of ones per source column of the parity check matrix. For configuration.
+  int32_t m_seed = 1; // Seed of the parity check matrix. For configuration.
+  double m_codeRate = 0.5; // Code rate. For configuration.
+  bool m_lazyRepair = false; // Build repair symbols on demand. For configuration.
+  bool m_mlDecoding = true; // Fall back to ML decoding. For configuration.
+  const of_codec_id_t m_codecId = OF_CODEC_LDPC_STAIRCASE_STABLE;
+  std::optional<Buffer> m_sourceBlock;
+  bool m_decoded = false; // The current block is decoded
+
+  AlFecSymbolSlab m_slab; // Encoded symbols when encoding, received symbols when decoding
+
+  // Encode
+  unsigned int m_esi; // Current ESI
+
+  // Decode
+  std::vector<void *> m_sourceSymbol; // Table of decoded source symbol
+  std::vector<bool> m_received; // Whether the slot of each ESI holds a symbol
+  size_t m_nbReceived; // Number of distinct received symbol
+  size_t m_nbSourceReceived; // Number of distinct received source symbol
+  size_t m_nbMlAttempts; // Number of ML decoding attempts of the current block
+  size_t m_nextMlAttempt; // Number of received symbols of the next ML decoding attempt
+  size_t m_nbDecoderSessions; // Number of decoder sessions created for the current block
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_CODEC_OPENFEC_LDPC_H
@@ -1,28 +1,29 @@
 #include "ns3/al-fec-codec-openfec-rs.h"
+#include "ns3/al-fec-worker-pool.h"
 #include "ns3/core-module.h"
 #include "ns3/type-id.h"
 
 #include <optional>
 #include <cmath>
 #include <algorithm>
+#include <string.h>
 
 extern "C" {
 #include "openfec/lib_common/of_openfec_api.h"
 }
 
-#define VERBOSITY 2
-
 namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("AlFecCodecOpenfecRs");
 NS_OBJECT_ENSURE_REGISTERED (AlFecCodecOpenfecRs);
 
 AlFecCodecOpenfecRs::AlFecCodecOpenfecRs ()
     : m_session (nullptr),
+      m_codecType (OF_ENCODER),
       m_param ({0, 0}),
       m_sourceBlock (std::nullopt),
       m_esi (0),
-      m_encodedSymbol (nullptr),
-      m_sourceSymbol (nullptr)
+      m_nbReceived (0),
+      m_nbSourceReceived (0)
 {
   NS_LOG_FUNCTION (this);
   m_param.encoding_symbol_length = m_symbolSize;
@@ -49,48 +50,90 @@ AlFecCodecOpenfecRs::GetTypeId (void)
                          MakeUintegerChecker<uint32_t> ())
           .AddAttribute ("codeRate", "k/n", DoubleValue (0.5),
                          MakeDoubleAccessor (&AlFecCodecOpenfecRs::m_codeRate),
-                         MakeDoubleChecker<double> (0.1, 1.0));
+                         MakeDoubleChecker<double> (0.1, 1.0))
+          .AddAttribute ("lazyRepair",
+                         "Build each repair symbol only when NextEncodedBlock reaches its ESI",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&AlFecCodecOpenfecRs::m_lazyRepair),
+                         MakeBooleanChecker ())
+          .AddAttribute ("nbWorkerThreads",
+                         "Number of pool threads that build the repair symbols of a block "
+                         "with the calling thread. 0 builds them on the calling thread only",
+                         UintegerValue (0),
+                         MakeUintegerAccessor (&AlFecCodecOpenfecRs::m_nbWorkerThreads),
+                         MakeUintegerChecker<uint32_t> (0, 64));
   return tid;
 }
 
 void
 AlFecCodecOpenfecRs::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  NextBlock ();
+  m_slab.Release ();
+}
+
+void
+AlFecCodecOpenfecRs::NextBlock ()
 {
   NS_LOG_FUNCTION (this);
   if (m_session)
     {
-      of_release_codec_instance (m_session);
-    }
-  if (m_encodedSymbol)
-    {
-
-      unsigned int n = m_param.nb_repair_symbols + m_param.nb_source_symbols;
-      NS_ASSERT (n > 0);
-      for (unsigned int i = 0; i < n; i++)
+      // Only encoder sessions can serve another block
+      if (m_codecType == OF_ENCODER)
         {
-          free (m_encodedSymbol[i]);
+          AlFecOpenfecSessionPool::Get ().Release (GetSessionKey (), m_session);
         }
-      free (m_encodedSymbol);
-    }
-  if (m_sourceSymbol)
-    {
-      NS_ASSERT (m_param.nb_source_symbols > 0);
-      for (unsigned int i = 0; i < m_param.nb_source_symbols; i++)
+      else
         {
-          free (m_sourceSymbol[i]);
+          of_release_codec_instance (m_session);
         }
-      free (m_sourceSymbol);
+      m_session = nullptr;
     }
+  m_sourceBlock = std::nullopt;
+  m_decoded = false;
+  m_esi = 0;
+  m_received.clear ();
+  m_nbReceived = 0;
+  m_nbSourceReceived = 0;
+}
+
+AlFecOpenfecSessionPool::Key
+AlFecCodecOpenfecRs::GetSessionKey () const
+{
+  return {m_codecId, m_param.nb_source_symbols,
+          m_param.nb_source_symbols + m_param.nb_repair_symbols, m_param.encoding_symbol_length,
+          m_param.m, 0};
+}
+
+void *
+AlFecCodecOpenfecRs::DecodedSymbolCallback (void *context, UINT32 size, UINT32 esi)
+{
+  AlFecCodecOpenfecRs *codec = static_cast<AlFecCodecOpenfecRs *> (context);
+  NS_ASSERT (size == codec->m_symbolSize && esi < codec->m_slab.GetN ());
+  return codec->m_slab.GetSymbol (esi);
+}
+
+size_t
+AlFecCodecOpenfecRs::GetMaxSourceBlockLength ()
+{
+  size_t maxN = (1u << m_rsM) - 1;
+  return GetMaxSourceBlockLengthForN (maxN, m_codeRate);
 }
 
 std::pair<size_t, size_t>
 AlFecCodecOpenfecRs::SetSourceBlock (Buffer p)
+{
+  return SetSourceBlock (p.PeekData (), p.GetSize ());
+}
+
+std::pair<size_t, size_t>
+AlFecCodecOpenfecRs::SetSourceBlock (const uint8_t *block, size_t sourceBlockSize)
 {
   NS_LOG_FUNCTION (this);
 
-  size_t sourceBlockSize = p.GetSize ();
   NS_LOG_INFO ("Got new source block with size=" << sourceBlockSize);
-  NS_ASSERT_MSG (!m_session, "The codec has been initialized");
+  NextBlock ();
 
   // Calculate the encoding parameter
   SetK (static_cast<size_t> (ceil (static_cast<double> (sourceBlockSize) / m_symbolSize)));
@@ -100,30 +143,26 @@ AlFecCodecOpenfecRs::SetSourceBlock (Buffer p)
   m_param.encoding_symbol_length = m_symbolSize;
   m_param.m = m_rsM;
 
-  // Instance the encoder
-  int ret;
-  ret = of_create_codec_instance (&m_session, m_codecId, OF_ENCODER, VERBOSITY);
-  NS_ASSERT_MSG (ret == OF_STATUS_OK, "Create encoder instance failed");
-  ret = of_set_fec_parameters (m_session, reinterpret_cast<of_parameters_t *> (&m_param));
-  NS_ASSERT_MSG (ret == OF_STATUS_OK, "Set FEC parameter failed");
-
-  // Fill the source symbol
-  m_encodedSymbol = reinterpret_cast<uint8_t **> (calloc (m_n, sizeof (uint8_t *)));
-  for (unsigned int esi = 0; esi < m_param.nb_source_symbols; esi++)
+  // Instance the encoder, or reuse an idle one with the same parameters
+  m_codecType = OF_ENCODER;
+  m_session = AlFecOpenfecSessionPool::Get ().Acquire (GetSessionKey ());
+  if (!m_session)
     {
-      unsigned int copyLen =
-          std::min ((size_t) (esi + 1) * m_symbolSize, sourceBlockSize) - esi * m_symbolSize;
-      Buffer fragment = p.CreateFragment (esi * m_symbolSize, copyLen);
-      m_encodedSymbol[esi] = reinterpret_cast<uint8_t *> (calloc (m_symbolSize, sizeof (uint8_t)));
-      fragment.CopyData (m_encodedSymbol[esi], copyLen);
+      m_session = AlFecOpenfecSessionPool::CreateSession (
+          m_codecId, OF_ENCODER, reinterpret_cast<of_parameters_t *> (&m_param));
     }
 
-  // Generate the repair symbol
-  for (unsigned int esi = m_param.nb_source_symbols; esi < m_n; esi++)
+  // Fill the source symbol. They are contiguous in the slab, so the source
+  // block is copied at once and only the padding of the last symbol is cleared.
+  size_t sourceSymbolsSize = m_k * m_symbolSize;
+  m_slab.Reset (m_n, m_symbolSize);
+  memcpy (m_slab.GetData (), block, sourceBlockSize);
+  memset (m_slab.GetData () + sourceBlockSize, 0, sourceSymbolsSize - sourceBlockSize);
+
+  // Generate the repair symbol. In lazy mode, they are built by NextEncodedBlock instead.
+  if (!m_lazyRepair)
     {
-      m_encodedSymbol[esi] = reinterpret_cast<uint8_t *> (calloc (m_symbolSize, sizeof (uint8_t)));
-      ret = of_build_repair_symbol (m_session, reinterpret_cast<void **> (m_encodedSymbol), esi);
-      NS_ASSERT_MSG (ret == OF_STATUS_OK, "Build repair symbol failed");
+      BuildRepairSymbols ();
     }
 
   // Reset the internal state
@@ -132,8 +171,45 @@ AlFecCodecOpenfecRs::SetSourceBlock (Buffer p)
   return std::make_pair (m_n, m_k);
 }
 
-std::optional<std::pair<unsigned int, Buffer>>
-AlFecCodecOpenfecRs::NextEncodedBlock ()
+void
+AlFecCodecOpenfecRs::BuildRepairSymbol (unsigned int esi)
+{
+  NS_LOG_FUNCTION (this << esi);
+  NS_ASSERT (esi >= m_param.nb_source_symbols);
+
+  int ret;
+  ret = of_build_repair_symbol (m_session, reinterpret_cast<void **> (m_slab.GetTable ()), esi);
+  NS_ASSERT_MSG (ret == OF_STATUS_OK, "Build repair symbol failed");
+}
+
+void
+AlFecCodecOpenfecRs::BuildRepairSymbols ()
+{
+  NS_LOG_FUNCTION (this << m_nbWorkerThreads);
+  unsigned int k = m_param.nb_source_symbols;
+  if (k >= m_n)
+    {
+      return;
+    }
+
+  // The first repair symbol makes OpenFEC build the encoding matrix of the
+  // session. The other ones only read it and write their own symbol, so they
+  // are independent and split between the threads.
+  BuildRepairSymbol (k);
+  of_session_t *session = m_session;
+  void **table = reinterpret_cast<void **> (m_slab.GetTable ());
+  AlFecWorkerPool::Get ().ParallelFor (
+      k + 1, m_n, m_nbWorkerThreads + 1, [session, table] (size_t begin, size_t end) {
+        for (size_t esi = begin; esi < end; esi++)
+          {
+            int ret = of_build_repair_symbol (session, table, esi);
+            NS_ASSERT_MSG (ret == OF_STATUS_OK, "Build repair symbol failed");
+          }
+      });
+}
+
+std::optional<std::pair<unsigned int, const uint8_t *>>
+AlFecCodecOpenfecRs::NextEncodedSymbol ()
 {
   NS_LOG_FUNCTION (this << " " << m_esi);
 
@@ -141,16 +217,126 @@ AlFecCodecOpenfecRs::NextEncodedBlock ()
     {
       return std::nullopt;
     }
-  uint8_t *payload = m_encodedSymbol[m_esi];
+  // ESIs are emitted in order, so each lazy repair symbol is built exactly once
+  if (m_lazyRepair && m_esi >= m_param.nb_source_symbols)
+    {
+      BuildRepairSymbol (m_esi);
+    }
+  const uint8_t *payload = m_slab.GetSymbol (m_esi);
+  return std::make_pair (m_esi++, payload);
+}
+
+std::optional<std::pair<unsigned int, Buffer>>
+AlFecCodecOpenfecRs::NextEncodedBlock ()
+{
+  std::optional<std::pair<unsigned int, const uint8_t *>> symbol = NextEncodedSymbol ();
+  if (!symbol)
+    {
+      return std::nullopt;
+    }
   Buffer newBlock;
   newBlock.AddAtStart (m_symbolSize);
-  newBlock.Begin ().Write (payload, m_symbolSize);
+  newBlock.Begin ().Write (symbol->second, m_symbolSize);
 
-  return std::make_pair (m_esi++, newBlock);
+  return std::make_pair (symbol->first, newBlock);
+}
+
+void
+AlFecCodecOpenfecRs::CreateDecoder ()
+{
+  NS_LOG_FUNCTION (this);
+
+  int ret;
+  m_codecType = OF_DECODER;
+  m_param.nb_source_symbols = m_k;
+  m_param.nb_repair_symbols = m_n - m_k;
+  m_param.encoding_symbol_length = m_symbolSize;
+  m_param.m = m_rsM;
+  m_session = AlFecOpenfecSessionPool::CreateSession (
+      m_codecId, OF_DECODER, reinterpret_cast<of_parameters_t *> (&m_param));
+
+  // Let OpenFEC write the decoded source symbols into the slab
+  ret = of_set_callback_functions (m_session, &AlFecCodecOpenfecRs::DecodedSymbolCallback, nullptr,
+                                   this);
+  NS_ASSERT_MSG (ret == OF_STATUS_OK, "Set callback functions failed");
+}
+
+Buffer
+AlFecCodecOpenfecRs::AssembleSourceBlock ()
+{
+  size_t decodedContentLength = m_k * m_symbolSize;
+  Buffer sourceBlock;
+  sourceBlock.AddAtStart (decodedContentLength);
+  sourceBlock.Begin ().Write (m_slab.GetData (), decodedContentLength);
+  m_sourceBlock = std::make_optional<Buffer> (sourceBlock);
+
+  NS_LOG_INFO ("Successfully decode source block. size=" << sourceBlock.GetSize ()
+                                                         << " (may contain padding)");
+  return sourceBlock;
+}
+
+void
+AlFecCodecOpenfecRs::InitDecoder ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_k > 0, "K is not initialize");
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  m_slab.Reset (m_n, m_symbolSize);
+  m_received.assign (m_n, false);
+  m_nbReceived = 0;
+  m_nbSourceReceived = 0;
+}
+
+uint8_t *
+AlFecCodecOpenfecRs::GetSymbolBuffer (unsigned int esi)
+{
+  if (m_decoded)
+    {
+      return nullptr;
+    }
+  if (m_received.empty ())
+    {
+      InitDecoder ();
+    }
+  if (esi >= m_n || m_received[esi])
+    {
+      return nullptr;
+    }
+  return m_slab.GetSymbol (esi);
+}
+
+const uint8_t *
+AlFecCodecOpenfecRs::GetSourceSymbol (unsigned int esi)
+{
+  if (m_decoded && esi < m_k)
+    {
+      return m_slab.GetSymbol (esi);
+    }
+  if (esi >= m_k || esi >= m_received.size () || !m_received[esi])
+    {
+      return nullptr;
+    }
+  return m_slab.GetSymbol (esi);
 }
 
 std::optional<Buffer>
 AlFecCodecOpenfecRs::Decode (Buffer p, unsigned int esi)
+{
+  return Decode (p.PeekData (), p.GetSize (), esi);
+}
+
+std::optional<Buffer>
+AlFecCodecOpenfecRs::Decode (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  if (!m_sourceBlock && DecodeSymbol (symbol, size, esi))
+    {
+      AssembleSourceBlock ();
+    }
+  return m_sourceBlock;
+}
+
+bool
+AlFecCodecOpenfecRs::DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi)
 {
   NS_LOG_FUNCTION (this);
 
@@ -160,61 +346,88 @@ AlFecCodecOpenfecRs::Decode (Buffer p, unsigned int esi)
   NS_LOG_LOGIC ("Decode with block esi=" << esi);
 
   // The source packet has already decoded, there's no need to decode again.
-  if (m_sourceBlock)
+  if (m_decoded)
     {
-      return *m_sourceBlock;
+      return true;
     }
 
-  // Instance the decoder session
-  if (!m_session)
+  // Initialize the decoder state
+  if (m_received.empty ())
     {
-      NS_ASSERT_MSG (m_k > 0, "K is not initialize");
-      SetN (m_k / m_codeRate);
-      ret = of_create_codec_instance (&m_session, m_codecId, OF_DECODER, VERBOSITY);
-      NS_ASSERT_MSG (ret == OF_STATUS_OK, "Create decoder instance failed");
+      InitDecoder ();
+    }
 
-      m_param.nb_source_symbols = m_k;
-      m_param.nb_repair_symbols = m_n - m_k;
-      m_param.encoding_symbol_length = m_symbolSize;
-      m_param.m = m_rsM;
-      ret = of_set_fec_parameters (m_session, reinterpret_cast<of_parameters_t *> (&m_param));
-      NS_ASSERT_MSG (ret == OF_STATUS_OK, "Set FEC parameter failed");
+  // Store the new symbol in its slot
+  NS_ASSERT_MSG (esi < m_n, "ESI out of range");
+  NS_ASSERT_MSG (size == m_symbolSize, "Symbol size mismatch");
+  if (m_received[esi])
+    {
+      return false;
+    }
+  buf = m_slab.GetSymbol (esi);
+  if (symbol != buf)
+    {
+      memcpy (buf, symbol, m_symbolSize);
+    }
+  m_received[esi] = true;
+  m_nbReceived++;
+  if (esi < m_k)
+    {
+      m_nbSourceReceived++;
+    }
+
+  // Systematic fast path: all the source symbols are already in place
+  if (m_nbSourceReceived == m_k)
+    {
+      NS_LOG_LOGIC ("All source symbols received, skip the decoder");
+      m_decoded = true;
+      return true;
     }
 
-  // Decode with new symbol
-  buf = reinterpret_cast<uint8_t *> (calloc (p.GetSize (), sizeof (uint8_t)));
-  p.CopyData (buf, p.GetSize ());
-  ret = of_decode_with_new_symbol (m_session, buf, esi);
-  NS_ASSERT_MSG (ret == OF_STATUS_OK, "Decode failed");
+  // The decoder is only worth instancing once it can complete. It is then
+  // fed with every symbol stored so far.
+  if (!m_session)
+    {
+      if (m_nbReceived < m_k)
+        {
+          return false;
+        }
+      CreateDecoder ();
+      for (unsigned int i = 0; i < m_n && !of_is_decoding_complete (m_session); i++)
+        {
+          if (m_received[i])
+            {
+              ret = of_decode_with_new_symbol (m_session, m_slab.GetSymbol (i), i);
+              NS_ASSERT_MSG (ret == OF_STATUS_OK, "Decode failed");
+            }
+        }
+    }
+  else
+    {
+      ret = of_decode_with_new_symbol (m_session, buf, esi);
+      NS_ASSERT_MSG (ret == OF_STATUS_OK, "Decode failed");
+    }
 
   if (!of_is_decoding_complete (m_session))
     {
-      return std::nullopt;
+      return false;
     }
 
-  // Retrieve source block
-  m_sourceSymbol =
-      reinterpret_cast<uint8_t **> (calloc (m_param.nb_source_symbols, sizeof (uint8_t *)));
-  ret = of_get_source_symbols_tab (m_session, reinterpret_cast<void **> (m_sourceSymbol));
+  // Retrieve source block. The decoded symbols are already in place; only
+  // copy the ones OpenFEC may have put elsewhere.
+  m_sourceSymbol.assign (m_param.nb_source_symbols, nullptr);
+  ret = of_get_source_symbols_tab (m_session, m_sourceSymbol.data ());
   NS_ASSERT_MSG (ret == OF_STATUS_OK, "Get source symbol failed");
-
-  // Construct original packet
-  size_t decodedContentLength = m_param.nb_source_symbols * m_symbolSize;
-  uint8_t *decodedContent = reinterpret_cast<uint8_t *> (malloc (decodedContentLength));
   for (unsigned int i = 0; i < m_param.nb_source_symbols; i++)
     {
-      memcpy (decodedContent + (i * m_symbolSize), m_sourceSymbol[i], m_symbolSize);
+      if (m_sourceSymbol[i] != m_slab.GetSymbol (i))
+        {
+          memcpy (m_slab.GetSymbol (i), m_sourceSymbol[i], m_symbolSize);
+        }
     }
 
-  Buffer sourceBlock;
-  sourceBlock.AddAtStart (decodedContentLength);
-  sourceBlock.Begin ().Write (decodedContent, decodedContentLength);
-  m_sourceBlock = std::make_optional<Buffer> (sourceBlock);
-
-  NS_LOG_INFO ("Successfully decode source block. size=" << sourceBlock.GetSize ()
-                                                         << " (may contain padding)");
-  free (decodedContent);
-  return sourceBlock;
+  m_decoded = true;
+  return true;
 }
 
 } // namespace ns3
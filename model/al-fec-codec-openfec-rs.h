@@ -2,8 +2,12 @@
 #define AL_FEC_CODEC_OPENFEC_H
 
 #include "ns3/al-fec-codec.h"
+#include "ns3/al-fec-openfec-session-pool.h"
+#include "ns3/al-fec-symbol-slab.h"
 #include "ns3/object.h"
 
+#include <vector>
+
 extern "C" {
 #include "openfec/lib_common/of_openfec_api.h"
 }
@@ -30,6 +34,11 @@ public:
   */
   std::pair<size_t, size_t> SetSourceBlock (Buffer p);
 
+  /**
+   * \brief Specify the source block from memory, which is copied into the slab
+  */
+  std::pair<size_t, size_t> SetSourceBlock (const uint8_t *block, size_t size);
+
 
   /**
    * \brief Get the next encoded symbol
@@ -50,22 +59,107 @@ public:
   */
   std::optional<Buffer> Decode (Buffer p, unsigned int esi);
 
+  /**
+   * \brief Get the next encoded symbol, pointing into the symbol slab
+  */
+  std::optional<std::pair<unsigned int, const uint8_t *>> NextEncodedSymbol ();
+  using AlFecCodec::NextEncodedSymbol;
+
+  /**
+   * \brief Get the slab slot of the symbol with the given ESI
+  */
+  uint8_t *GetSymbolBuffer (unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The symbol is copied
+   * into the slab unless it is already in its slot.
+  */
+  std::optional<Buffer> Decode (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The decoded source
+   * symbols are left in the slab for GetSourceSymbol.
+  */
+  bool DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Get the slab slot of a received or recovered source symbol
+  */
+  const uint8_t *GetSourceSymbol (unsigned int esi);
+
+  /**
+   * \brief Get the largest K for which N = ceil(K / codeRate) fits in GF(2^m)
+  */
+  size_t GetMaxSourceBlockLength ();
+
+  /**
+   * \brief Finish the current block. The encoder session goes back to the
+   * session pool, the decoder session is released.
+  */
+  void NextBlock ();
+
 private:
+  /**
+   * \brief Set up the decoder state of a new block
+   */
+  void InitDecoder ();
+
+  /**
+   * \brief Get the pool key of the current parameters
+   */
+  AlFecOpenfecSessionPool::Key GetSessionKey () const;
+
+  /**
+   * \brief Build the repair symbol with the given ESI into the encoded symbol table
+   */
+  void BuildRepairSymbol (unsigned int esi);
+
+  /**
+   * \brief Build every repair symbol, split between nbWorkerThreads pool
+   * threads and the calling thread. The symbols are the same whatever the split.
+   */
+  void BuildRepairSymbols ();
+
+  /**
+   * \brief Instance the OpenFEC decoder session
+   */
+  void CreateDecoder ();
+
+  /**
+   * \brief Build the decoded source block from the source symbols in the slab
+   */
+  Buffer AssembleSourceBlock ();
+
+  /**
+   * \brief Tell OpenFEC where to store a decoded symbol
+   *
+   * \return The slot of the symbol in the slab
+   */
+  static void *DecodedSymbolCallback (void *context, UINT32 size, UINT32 esi);
+
   // Common
   of_session_t *m_session;
+  of_codec_type_t m_codecType; // Whether m_session is an encoder or a decoder
   of_rs_2_m_parameters_t m_param;
   uint16_t m_rsM = 8; // RS over GF(2^m). For configuration.
   double m_codeRate = 0.5; // Code rate. For configuration.
+  bool m_lazyRepair = false; // Build repair symbols on demand. For configuration.
+  uint32_t m_nbWorkerThreads = 0; // Pool threads building the repair symbols. For configuration.
   const of_codec_id_t m_codecId = OF_CODEC_REED_SOLOMON_GF_2_M_STABLE;
   std::optional<Buffer> m_sourceBlock;
+  bool m_decoded = false; // The current block is decoded
   const int m_sizeOfLenField = sizeof (unsigned int);
 
+  AlFecSymbolSlab m_slab; // Encoded symbols when encoding, received symbols when decoding
+
   // Encode
   unsigned int m_esi; // Current ESI
-  uint8_t **m_encodedSymbol; // Table of encoded symbol
 
   // Decode
-  uint8_t **m_sourceSymbol; // Table of decoded source symbol
+  std::vector<void *> m_sourceSymbol; // Table of decoded source symbol
+  std::vector<bool> m_received; // Whether the slot of each ESI holds a symbol
+  size_t m_nbReceived; // Number of distinct received symbol
+  size_t m_nbSourceReceived; // Number of distinct received source symbol
 };
 
 } // namespace ns3
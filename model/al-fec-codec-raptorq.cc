@@ -0,0 +1,358 @@
+#include "ns3/al-fec-codec-raptorq.h"
+#include "ns3/core-module.h"
+#include "ns3/type-id.h"
+
+#include <optional>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <string.h>
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecRaptorq");
+NS_OBJECT_ENSURE_REGISTERED (AlFecCodecRaptorq);
+
+AlFecCodecRaptorq::AlFecCodecRaptorq ()
+    : m_sourceBlock (std::nullopt),
+      m_esi (0),
+      m_nbSourceReceived (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AlFecCodecRaptorq::~AlFecCodecRaptorq ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+AlFecCodecRaptorq::GetTypeId (void)
+{
+  static TypeId tid =
+      TypeId ("ns3::AlFecCodecRaptorq")
+          .SetParent<Object> ()
+          .AddConstructor<AlFecCodecRaptorq> ()
+          .AddAttribute ("symbolSize", "The symbol size in bytes", UintegerValue (16),
+                         MakeUintegerAccessor (&AlFecCodecRaptorq::m_symbolSize),
+                         MakeUintegerChecker<uint32_t> ())
+          .AddAttribute ("codeRate", "k/n, where n only bounds NextEncodedBlock",
+                         DoubleValue (0.5),
+                         MakeDoubleAccessor (&AlFecCodecRaptorq::m_codeRate),
+                         MakeDoubleChecker<double> (0.01, 1.0));
+  return tid;
+}
+
+void
+AlFecCodecRaptorq::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  NextBlock ();
+  m_slab.Release ();
+  m_intermediate.Release ();
+}
+
+void
+AlFecCodecRaptorq::NextBlock ()
+{
+  NS_LOG_FUNCTION (this);
+  // The slabs are kept for the next block
+  m_sourceBlock = std::nullopt;
+  m_decoded = false;
+  m_esi = 0;
+  m_received.clear ();
+  m_nbSourceReceived = 0;
+  m_repairData.clear ();
+  m_repairEsis.clear ();
+  m_repairReceived.clear ();
+}
+
+size_t
+AlFecCodecRaptorq::GetMaxSourceBlockLength ()
+{
+  // The ESIs up to N must also fit in the 16 bits of the AlFec header
+  size_t maxN = std::numeric_limits<uint16_t>::max () + 1;
+  return std::min<size_t> (AlFecRaptorq::MAX_K, GetMaxSourceBlockLengthForN (maxN, m_codeRate));
+}
+
+std::pair<size_t, size_t>
+AlFecCodecRaptorq::SetSourceBlock (Buffer p)
+{
+  return SetSourceBlock (p.PeekData (), p.GetSize ());
+}
+
+std::pair<size_t, size_t>
+AlFecCodecRaptorq::SetSourceBlock (const uint8_t *block, size_t sourceBlockSize)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_LOG_INFO ("Got new source block with size=" << sourceBlockSize);
+  NextBlock ();
+
+  // Calculate the encoding parameter
+  SetK (static_cast<size_t> (ceil (static_cast<double> (sourceBlockSize) / m_symbolSize)));
+  NS_ASSERT_MSG (m_k <= AlFecRaptorq::MAX_K, "Source block too large for RaptorQ");
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  m_code.SetParameters (AlFecRaptorq::GetParameters (m_k));
+  const AlFecRaptorq::Parameters &params = m_code.GetCurrentParameters ();
+
+  // The source symbols are extended to K' with zeroed padding symbols
+  m_slab.Reset (params.kPrime, m_symbolSize);
+  memcpy (m_slab.GetData (), block, sourceBlockSize);
+  memset (m_slab.GetData () + sourceBlockSize, 0,
+          params.kPrime * m_symbolSize - sourceBlockSize);
+
+  // The systematic index guarantees that the source symbols determine the
+  // intermediate symbols
+  std::vector<uint32_t> isis (params.kPrime);
+  std::vector<const uint8_t *> symbols (params.kPrime);
+  for (uint32_t isi = 0; isi < params.kPrime; isi++)
+    {
+      isis[isi] = isi;
+      symbols[isi] = m_slab.GetSymbol (isi);
+    }
+  m_intermediate.Reset (params.l, m_symbolSize);
+  bool ret = m_code.Solve (isis, symbols, m_symbolSize, m_intermediate.GetData ());
+  NS_ASSERT_MSG (ret, "The systematic index of K'=" << params.kPrime << " is wrong");
+
+  m_repairSymbol.resize (m_symbolSize);
+  m_esi = 0;
+
+  return std::make_pair (m_n, m_k);
+}
+
+void
+AlFecCodecRaptorq::GetEncodedSymbol (unsigned int esi, uint8_t *symbol)
+{
+  NS_LOG_FUNCTION (this << esi);
+  if (esi < m_k)
+    {
+      memcpy (symbol, m_slab.GetSymbol (esi), m_symbolSize);
+      return;
+    }
+  // The padding symbols take the ISIs right after the source symbols
+  const AlFecRaptorq::Parameters &params = m_code.GetCurrentParameters ();
+  m_code.EncodeSymbol (m_intermediate.GetData (), m_symbolSize, esi + params.kPrime - m_k,
+                       symbol);
+}
+
+std::optional<std::pair<unsigned int, const uint8_t *>>
+AlFecCodecRaptorq::NextEncodedSymbol ()
+{
+  NS_LOG_FUNCTION (this << " " << m_esi);
+
+  if (m_esi >= m_n)
+    {
+      return std::nullopt;
+    }
+  if (m_esi < m_k)
+    {
+      const uint8_t *payload = m_slab.GetSymbol (m_esi);
+      return std::make_pair (m_esi++, payload);
+    }
+  GetEncodedSymbol (m_esi, m_repairSymbol.data ());
+  return std::make_pair (m_esi++, static_cast<const uint8_t *> (m_repairSymbol.data ()));
+}
+
+std::optional<std::pair<unsigned int, Buffer>>
+AlFecCodecRaptorq::NextEncodedBlock ()
+{
+  std::optional<std::pair<unsigned int, const uint8_t *>> symbol = NextEncodedSymbol ();
+  if (!symbol)
+    {
+      return std::nullopt;
+    }
+  Buffer newBlock;
+  newBlock.AddAtStart (m_symbolSize);
+  newBlock.Begin ().Write (symbol->second, m_symbolSize);
+
+  return std::make_pair (symbol->first, newBlock);
+}
+
+void
+AlFecCodecRaptorq::InitDecoder ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_k > 0, "K is not initialize");
+  NS_ASSERT_MSG (m_k <= AlFecRaptorq::MAX_K, "Source block too large for RaptorQ");
+  SetN (ceil (static_cast<double> (m_k) / m_codeRate));
+  m_code.SetParameters (AlFecRaptorq::GetParameters (m_k));
+  m_slab.Reset (m_k, m_symbolSize);
+  m_received.assign (m_k, false);
+  m_nbSourceReceived = 0;
+  m_repairData.clear ();
+  m_repairEsis.clear ();
+  m_repairReceived.clear ();
+}
+
+bool
+AlFecCodecRaptorq::RecoverSourceSymbols ()
+{
+  NS_LOG_FUNCTION (this);
+  const AlFecRaptorq::Parameters &params = m_code.GetCurrentParameters ();
+
+  // Received source symbols, padding symbols, then repair symbols
+  std::vector<uint32_t> isis;
+  std::vector<const uint8_t *> symbols;
+  isis.reserve (params.kPrime + m_repairEsis.size ());
+  symbols.reserve (params.kPrime + m_repairEsis.size ());
+  for (uint32_t esi = 0; esi < m_k; esi++)
+    {
+      if (m_received[esi])
+        {
+          isis.push_back (esi);
+          symbols.push_back (m_slab.GetSymbol (esi));
+        }
+    }
+  for (uint32_t isi = m_k; isi < params.kPrime; isi++)
+    {
+      isis.push_back (isi);
+      symbols.push_back (nullptr);
+    }
+  for (size_t i = 0; i < m_repairEsis.size (); i++)
+    {
+      isis.push_back (m_repairEsis[i] + params.kPrime - m_k);
+      symbols.push_back (&m_repairData[i * m_symbolSize]);
+    }
+
+  m_intermediate.Reset (params.l, m_symbolSize);
+  if (!m_code.Solve (isis, symbols, m_symbolSize, m_intermediate.GetData ()))
+    {
+      NS_LOG_LOGIC ("Not enough independent symbols among " << isis.size () - params.kPrime + m_k);
+      return false;
+    }
+
+  // The missing source symbols are LT symbols of the intermediate ones
+  for (uint32_t esi = 0; esi < m_k; esi++)
+    {
+      if (!m_received[esi])
+        {
+          m_code.EncodeSymbol (m_intermediate.GetData (), m_symbolSize, esi,
+                               m_slab.GetSymbol (esi));
+          m_received[esi] = true;
+        }
+    }
+  return true;
+}
+
+uint8_t *
+AlFecCodecRaptorq::GetSymbolBuffer (unsigned int esi)
+{
+  if (m_decoded)
+    {
+      return nullptr;
+    }
+  if (m_received.empty ())
+    {
+      InitDecoder ();
+    }
+  if (esi < m_k)
+    {
+      return m_received[esi] ? nullptr : m_slab.GetSymbol (esi);
+    }
+  if (m_repairReceived.count (esi))
+    {
+      return nullptr;
+    }
+  // The next repair symbol goes right after the received ones
+  size_t offset = m_repairEsis.size () * m_symbolSize;
+  if (m_repairData.size () < offset + m_symbolSize)
+    {
+      m_repairData.resize (offset + m_symbolSize);
+    }
+  return &m_repairData[offset];
+}
+
+const uint8_t *
+AlFecCodecRaptorq::GetSourceSymbol (unsigned int esi)
+{
+  if (m_decoded && esi < m_k)
+    {
+      return m_slab.GetSymbol (esi);
+    }
+  if (esi >= m_k || esi >= m_received.size () || !m_received[esi])
+    {
+      return nullptr;
+    }
+  return m_slab.GetSymbol (esi);
+}
+
+std::optional<Buffer>
+AlFecCodecRaptorq::Decode (Buffer p, unsigned int esi)
+{
+  return Decode (p.PeekData (), p.GetSize (), esi);
+}
+
+std::optional<Buffer>
+AlFecCodecRaptorq::Decode (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  if (!m_sourceBlock && DecodeSymbol (symbol, size, esi))
+    {
+      // Construct original packet
+      size_t decodedContentLength = m_k * m_symbolSize;
+      Buffer sourceBlock;
+      sourceBlock.AddAtStart (decodedContentLength);
+      sourceBlock.Begin ().Write (m_slab.GetData (), decodedContentLength);
+      m_sourceBlock = sourceBlock;
+
+      NS_LOG_INFO ("Successfully decode source block. size=" << sourceBlock.GetSize ()
+                                                             << " (may contain padding)");
+    }
+  return m_sourceBlock;
+}
+
+bool
+AlFecCodecRaptorq::DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC ("Decode with block esi=" << esi);
+
+  // The source packet has already decoded, there's no need to decode again.
+  if (m_decoded)
+    {
+      return true;
+    }
+
+  // Instance the decoder
+  if (m_received.empty ())
+    {
+      InitDecoder ();
+    }
+
+  NS_ASSERT_MSG (size == m_symbolSize, "Symbol size mismatch");
+  uint8_t *slot = GetSymbolBuffer (esi);
+  if (!slot)
+    {
+      return false;
+    }
+  if (symbol != slot)
+    {
+      memcpy (slot, symbol, m_symbolSize);
+    }
+  if (esi < m_k)
+    {
+      m_received[esi] = true;
+      m_nbSourceReceived++;
+    }
+  else
+    {
+      m_repairEsis.push_back (esi);
+      m_repairReceived.insert (esi);
+    }
+
+  if (m_nbSourceReceived + m_repairEsis.size () < m_k)
+    {
+      return false;
+    }
+
+  // Systematic fast path: all the source symbols are already in place.
+  // Otherwise, the decoding is tried again with each new symbol until it succeeds.
+  if (m_nbSourceReceived < m_k && !RecoverSourceSymbols ())
+    {
+      return false;
+    }
+
+  m_decoded = true;
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,154 @@
+#ifndef AL_FEC_CODEC_RAPTORQ_H
+#define AL_FEC_CODEC_RAPTORQ_H
+
+#include "ns3/al-fec-codec.h"
+#include "ns3/al-fec-raptorq.h"
+#include "ns3/al-fec-symbol-slab.h"
+#include "ns3/object.h"
+
+#include <unordered_set>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief RaptorQ-like fountain codec, see AlFecRaptorq. Its symbols do not
+ * interoperate with RFC 6330.
+ *
+ * Blocks of up to 56403 source symbols are supported. Encoding and decoding
+ * take roughly linear time in K, and the decoder almost always succeeds with
+ * K + 2 symbols. The source symbols are sent first, then repair symbols.
+ * NextEncodedBlock stops at N = ceil(K / codeRate), but N may be raised with
+ * SetN at any time, and GetEncodedSymbol builds the symbol of any ESI, since
+ * a fountain code has no limit on the number of repair symbols.
+ */
+class AlFecCodecRaptorq : public Object, public AlFecCodec
+{
+public:
+  AlFecCodecRaptorq ();
+  ~AlFecCodecRaptorq ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual void DoDispose ();
+
+  /**
+   * \brief Specify the source block, and solve its intermediate symbols
+   *
+   * \return {The number of encoded block (n), the number of source block (k)}
+  */
+  std::pair<size_t, size_t> SetSourceBlock (Buffer p);
+
+  /**
+   * \brief Specify the source block from memory, which is copied into the slab
+  */
+  std::pair<size_t, size_t> SetSourceBlock (const uint8_t *block, size_t size);
+
+  /**
+   * \brief Get the next encoded symbol
+   *
+   * \return Return the next unsent encoded block.
+   * If there's no unsent encoded block, return std::nullopt
+  */
+  std::optional<std::pair<unsigned int, Buffer>> NextEncodedBlock ();
+
+  /**
+   * \brief Decode source block with received block
+   *
+   * \param p The content of received block
+   * \param esi The received Encoded Symbol ID
+   *
+   * \return If the source block successfully decoded, return the decoded block.
+   * Other, return std::nullopt
+  */
+  std::optional<Buffer> Decode (Buffer p, unsigned int esi);
+
+  /**
+   * \brief Get the next encoded symbol. Source symbols point into the symbol
+   * slab, repair symbols into a buffer reused by the next call.
+  */
+  std::optional<std::pair<unsigned int, const uint8_t *>> NextEncodedSymbol ();
+  using AlFecCodec::NextEncodedSymbol;
+
+  /**
+   * \brief Build the encoded symbol of any ESI of the current source block
+   *
+   * \param esi The ESI, which may exceed N
+   * \param symbol The destination, GetSymbolSize bytes
+  */
+  void GetEncodedSymbol (unsigned int esi, uint8_t *symbol);
+
+  /**
+   * \brief Get the slot of the symbol with the given ESI. Source symbols have
+   * their slot in the slab, repair symbols are appended to the received ones.
+  */
+  uint8_t *GetSymbolBuffer (unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The symbol is copied
+   * unless it is already in its slot.
+  */
+  std::optional<Buffer> Decode (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol. The decoded source
+   * symbols are left in the slab for GetSourceSymbol.
+  */
+  bool DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Get the slab slot of a received or recovered source symbol
+  */
+  const uint8_t *GetSourceSymbol (unsigned int esi);
+
+  /**
+   * \brief Get the largest K of RaptorQ whose N = ceil (K / codeRate) ESIs
+   * fit in the AlFec header
+  */
+  size_t GetMaxSourceBlockLength ();
+
+  /**
+   * \brief Finish the current block. The symbol memory is kept for the next block.
+  */
+  void NextBlock ();
+
+private:
+  /**
+   * \brief Set up the decoder state of a new block
+   */
+  void InitDecoder ();
+
+  /**
+   * \brief Solve the intermediate symbols from the received symbols and
+   * rebuild the missing source symbols
+   *
+   * \return Whether the received symbols were enough
+   */
+  bool RecoverSourceSymbols ();
+
+  // Common
+  double m_codeRate = 0.5; // Code rate. For configuration.
+  AlFecRaptorq m_code; // Parameters and solver of the current K
+  std::optional<Buffer> m_sourceBlock;
+  bool m_decoded = false; // The current block is decoded
+  AlFecSymbolSlab m_slab; // Source symbols, followed by the padding ones when encoding
+  AlFecSymbolSlab m_intermediate; // The L intermediate symbols
+
+  // Encode
+  unsigned int m_esi; // Current ESI
+  std::vector<uint8_t> m_repairSymbol; // Repair symbol returned by NextEncodedSymbol
+
+  // Decode
+  std::vector<bool> m_received; // Whether the slot of each source symbol holds a symbol
+  size_t m_nbSourceReceived; // Number of distinct received source symbol
+  std::vector<uint8_t> m_repairData; // Received repair symbols, one after another
+  std::vector<unsigned int> m_repairEsis; // ESI of each received repair symbol
+  std::unordered_set<unsigned int> m_repairReceived; // Same as m_repairEsis
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_CODEC_RAPTORQ_H
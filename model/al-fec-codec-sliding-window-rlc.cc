@@ -0,0 +1,489 @@
+#include "ns3/al-fec-codec-sliding-window-rlc.h"
+#include "ns3/al-fec-gf256.h"
+#include "ns3/core-module.h"
+#include "ns3/simulator.h"
+#include "ns3/type-id.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecSlidingWindowRlc");
+NS_OBJECT_ENSURE_REGISTERED (AlFecCodecSlidingWindowRlc);
+
+AlFecCodecSlidingWindowRlc::AlFecCodecSlidingWindowRlc ()
+    : m_symbolSize (1402),
+      m_windowSize (32),
+      m_density (1.0),
+      m_codeRate (0.8),
+      m_nextEsi (0),
+      m_nextRepairKey (0),
+      m_repairCredit (0),
+      m_started (false),
+      m_sentEnd (0),
+      m_historyStart (0),
+      m_nbRecovered (0),
+      m_nbLost (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AlFecCodecSlidingWindowRlc::~AlFecCodecSlidingWindowRlc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+AlFecCodecSlidingWindowRlc::GetTypeId (void)
+{
+  static TypeId tid =
+      TypeId ("ns3::AlFecCodecSlidingWindowRlc")
+          .SetParent<Object> ()
+          .AddConstructor<AlFecCodecSlidingWindowRlc> ()
+          .AddAttribute ("symbolSize",
+                         "The symbol size in bytes, including the 2 byte length of the ADU",
+                         UintegerValue (1402),
+                         MakeUintegerAccessor (&AlFecCodecSlidingWindowRlc::m_symbolSize),
+                         MakeUintegerChecker<uint32_t> (3, 65537))
+          .AddAttribute ("windowSize",
+                         "The maximum number of source symbols a repair symbol covers",
+                         UintegerValue (32),
+                         MakeUintegerAccessor (&AlFecCodecSlidingWindowRlc::m_windowSize),
+                         MakeUintegerChecker<uint32_t> (1, 65535))
+          .AddAttribute ("density",
+                         "The probability that a source symbol of the window is part of a "
+                         "repair symbol",
+                         DoubleValue (1.0),
+                         MakeDoubleAccessor (&AlFecCodecSlidingWindowRlc::m_density),
+                         MakeDoubleChecker<double> (0.01, 1.0))
+          .AddAttribute ("codeRate", "Source symbols / (source symbols + repair symbols)",
+                         DoubleValue (0.8),
+                         MakeDoubleAccessor (&AlFecCodecSlidingWindowRlc::m_codeRate),
+                         MakeDoubleChecker<double> (0.1, 1.0));
+  return tid;
+}
+
+void
+AlFecCodecSlidingWindowRlc::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  Reset ();
+}
+
+void
+AlFecCodecSlidingWindowRlc::Reset ()
+{
+  NS_LOG_FUNCTION (this);
+  m_window.clear ();
+  m_nextEsi = 0;
+  m_nextRepairKey = 0;
+  m_repairCredit = 0;
+
+  m_started = false;
+  m_sentEnd = 0;
+  m_historyStart = 0;
+  m_known.clear ();
+  m_missingSince.clear ();
+  m_equations.clear ();
+
+  m_nbRecovered = 0;
+  m_nbLost = 0;
+  m_totalRecoveryDelay = Time ();
+  m_maxRecoveryDelay = Time ();
+}
+
+uint8_t
+AlFecCodecSlidingWindowRlc::GetCoefficient (uint16_t repairKey, uint16_t i,
+                                            uint16_t nbSourceSymbols) const
+{
+  uint64_t z = ((static_cast<uint64_t> (repairKey) << 16) | i) + 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z ^= z >> 31;
+
+  // The last source symbol is always part of the repair symbol, so that a
+  // repair symbol never is useless
+  bool isLast = i + 1 == nbSourceSymbols;
+  if (!isLast && (z & 0xffff) >= m_density * 0x10000)
+    {
+      return 0;
+    }
+  return 1 + (z >> 32) % 255;
+}
+
+std::vector<uint8_t>
+AlFecCodecSlidingWindowRlc::MakeSymbol (const Buffer &p) const
+{
+  size_t size = p.GetSize ();
+  NS_ASSERT_MSG (size + 2 <= m_symbolSize, "ADU larger than symbolSize - 2");
+  std::vector<uint8_t> symbol (m_symbolSize, 0);
+  symbol[0] = size >> 8;
+  symbol[1] = size & 0xff;
+  p.CopyData (&symbol[2], size);
+  return symbol;
+}
+
+Buffer
+AlFecCodecSlidingWindowRlc::GetAdu (const std::vector<uint8_t> &symbol) const
+{
+  size_t size = (symbol[0] << 8) | symbol[1];
+  NS_ASSERT_MSG (size + 2 <= m_symbolSize, "Corrupted source symbol");
+  Buffer p;
+  p.AddAtStart (size);
+  p.Begin ().Write (&symbol[2], size);
+  return p;
+}
+
+uint32_t
+AlFecCodecSlidingWindowRlc::AddSourceSymbol (Buffer p)
+{
+  NS_LOG_FUNCTION (this << m_nextEsi);
+
+  m_window.push_back (MakeSymbol (p));
+  if (m_window.size () > m_windowSize)
+    {
+      m_window.pop_front ();
+    }
+  m_repairCredit += 1 / m_codeRate - 1;
+  return m_nextEsi++;
+}
+
+std::optional<AlFecCodecSlidingWindowRlc::RepairSymbol>
+AlFecCodecSlidingWindowRlc::NextRepairSymbol ()
+{
+  // The credit is compared with some slack, since 1 / codeRate - 1 is rarely exact
+  if (m_window.empty () || m_repairCredit < 1 - 1e-9)
+    {
+      return std::nullopt;
+    }
+  m_repairCredit -= 1;
+  return BuildRepairSymbol ();
+}
+
+AlFecCodecSlidingWindowRlc::RepairSymbol
+AlFecCodecSlidingWindowRlc::BuildRepairSymbol ()
+{
+  NS_LOG_FUNCTION (this << m_nextRepairKey);
+  NS_ASSERT_MSG (!m_window.empty (), "No source symbol to protect");
+
+  RepairSymbol repair;
+  repair.repairKey = m_nextRepairKey++;
+  repair.firstEsi = m_nextEsi - m_window.size ();
+  repair.nbSourceSymbols = m_window.size ();
+
+  std::vector<uint8_t> data (m_symbolSize, 0);
+  for (uint16_t i = 0; i < repair.nbSourceSymbols; i++)
+    {
+      uint8_t c = GetCoefficient (repair.repairKey, i, repair.nbSourceSymbols);
+      if (c)
+        {
+          AlFecGf256::MulAddRegion (data.data (), m_window[i].data (), c, m_symbolSize);
+        }
+    }
+  repair.data.AddAtStart (m_symbolSize);
+  repair.data.Begin ().Write (data.data (), m_symbolSize);
+  return repair;
+}
+
+void
+AlFecCodecSlidingWindowRlc::MarkSent (uint32_t end)
+{
+  if (end <= m_sentEnd)
+    {
+      return;
+    }
+
+  // Only the ESIs that stay in the history are worth tracking
+  uint32_t history = 2 * m_windowSize;
+  uint32_t start = std::max (m_sentEnd, end > history ? end - history : 0);
+  m_nbLost += start - m_sentEnd;
+  Time now = Simulator::Now ();
+  for (uint32_t esi = start; esi < end; esi++)
+    {
+      m_missingSince.emplace (esi, now);
+    }
+  m_sentEnd = end;
+  m_historyStart = std::max (m_historyStart, end > history ? end - history : 0);
+  Evict ();
+}
+
+void
+AlFecCodecSlidingWindowRlc::Evict ()
+{
+  m_known.erase (m_known.begin (), m_known.lower_bound (m_historyStart));
+
+  auto lost = m_missingSince.lower_bound (m_historyStart);
+  for (auto it = m_missingSince.begin (); it != lost; it++)
+    {
+      NS_LOG_LOGIC ("Source symbol " << it->first << " lost");
+      m_nbLost++;
+    }
+  m_missingSince.erase (m_missingSince.begin (), lost);
+
+  // An equation with an unknown out of the history cannot solve it anymore
+  for (auto it = m_equations.begin (); it != m_equations.end ();)
+    {
+      if (it->second.coefs.begin ()->first < m_historyStart)
+        {
+          it = m_equations.erase (it);
+        }
+      else
+        {
+          it++;
+        }
+    }
+}
+
+void
+AlFecCodecSlidingWindowRlc::SubtractEquation (Equation &eq, const Equation &row, uint8_t c) const
+{
+  for (const std::pair<const uint32_t, uint8_t> &coef : row.coefs)
+    {
+      uint8_t x = eq.coefs[coef.first] ^ AlFecGf256::Mul (c, coef.second);
+      if (x)
+        {
+          eq.coefs[coef.first] = x;
+        }
+      else
+        {
+          eq.coefs.erase (coef.first);
+        }
+    }
+  AlFecGf256::MulAddRegion (eq.data.data (), row.data.data (), c, m_symbolSize);
+}
+
+void
+AlFecCodecSlidingWindowRlc::InsertEquation (Equation eq)
+{
+  // Eliminate the pivots of the stored equations. They only hold their pivot
+  // and unknowns without an equation, so the other coefficients of the
+  // pivots in eq do not change.
+  std::vector<std::pair<uint32_t, uint8_t>> pivots;
+  for (const std::pair<const uint32_t, uint8_t> &coef : eq.coefs)
+    {
+      if (m_equations.count (coef.first))
+        {
+          pivots.push_back (coef);
+        }
+    }
+  for (const std::pair<uint32_t, uint8_t> &pivot : pivots)
+    {
+      SubtractEquation (eq, m_equations[pivot.first], pivot.second);
+    }
+  if (eq.coefs.empty ())
+    {
+      NS_LOG_LOGIC ("Redundant equation");
+      return;
+    }
+
+  // Normalize on the lowest unknown, then remove it from the other equations
+  uint32_t pivot = eq.coefs.begin ()->first;
+  uint8_t inv = AlFecGf256::Inv (eq.coefs.begin ()->second);
+  for (std::pair<const uint32_t, uint8_t> &coef : eq.coefs)
+    {
+      coef.second = AlFecGf256::Mul (coef.second, inv);
+    }
+  AlFecGf256::MulRegion (eq.data.data (), eq.data.data (), inv, m_symbolSize);
+  for (std::pair<const uint32_t, Equation> &row : m_equations)
+    {
+      auto coef = row.second.coefs.find (pivot);
+      if (coef != row.second.coefs.end ())
+        {
+          SubtractEquation (row.second, eq, coef->second);
+        }
+    }
+  NS_LOG_LOGIC ("New equation with pivot " << pivot << " and " << eq.coefs.size ()
+                                           << " unknowns");
+  m_equations.emplace (pivot, std::move (eq));
+}
+
+void
+AlFecCodecSlidingWindowRlc::AddKnownSymbol (uint32_t esi, std::vector<uint8_t> symbol)
+{
+  // The equation whose pivot is now known has to find another pivot
+  std::vector<Equation> orphans;
+  for (auto it = m_equations.begin (); it != m_equations.end ();)
+    {
+      auto coef = it->second.coefs.find (esi);
+      if (coef == it->second.coefs.end ())
+        {
+          it++;
+          continue;
+        }
+      AlFecGf256::MulAddRegion (it->second.data.data (), symbol.data (), coef->second,
+                                m_symbolSize);
+      it->second.coefs.erase (coef);
+      if (it->first == esi)
+        {
+          orphans.push_back (std::move (it->second));
+          it = m_equations.erase (it);
+        }
+      else
+        {
+          it++;
+        }
+    }
+  m_known[esi] = std::move (symbol);
+  for (Equation &eq : orphans)
+    {
+      InsertEquation (std::move (eq));
+    }
+}
+
+void
+AlFecCodecSlidingWindowRlc::SolveEquations (std::vector<std::pair<uint32_t, Buffer>> &recovered)
+{
+  // In reduced row echelon form, an equation with its pivot only solves it,
+  // and the pivot appears in no other equation
+  for (auto it = m_equations.begin (); it != m_equations.end ();)
+    {
+      if (it->second.coefs.size () > 1)
+        {
+          it++;
+          continue;
+        }
+      uint32_t esi = it->first;
+      std::vector<uint8_t> symbol = std::move (it->second.data);
+      it = m_equations.erase (it);
+
+      auto missing = m_missingSince.find (esi);
+      if (missing != m_missingSince.end ())
+        {
+          Time delay = Simulator::Now () - missing->second;
+          m_totalRecoveryDelay += delay;
+          m_maxRecoveryDelay = std::max (m_maxRecoveryDelay, delay);
+          m_missingSince.erase (missing);
+        }
+      m_nbRecovered++;
+      NS_LOG_LOGIC ("Recovered source symbol " << esi);
+      recovered.emplace_back (esi, GetAdu (symbol));
+      m_known[esi] = std::move (symbol);
+    }
+}
+
+std::vector<std::pair<uint32_t, Buffer>>
+AlFecCodecSlidingWindowRlc::DecodeSourceSymbol (uint32_t esi, Buffer p)
+{
+  NS_LOG_FUNCTION (this << esi);
+  std::vector<std::pair<uint32_t, Buffer>> recovered;
+
+  // The stream starts with the first received symbol
+  if (!m_started)
+    {
+      m_started = true;
+      m_sentEnd = m_historyStart = esi;
+    }
+  if (esi < m_historyStart || m_known.count (esi))
+    {
+      return recovered;
+    }
+
+  MarkSent (esi + 1);
+  m_missingSince.erase (esi);
+  AddKnownSymbol (esi, MakeSymbol (p));
+  SolveEquations (recovered);
+  return recovered;
+}
+
+std::vector<std::pair<uint32_t, Buffer>>
+AlFecCodecSlidingWindowRlc::DecodeRepairSymbol (const RepairSymbol &repair)
+{
+  NS_LOG_FUNCTION (this << repair.repairKey << repair.firstEsi << repair.nbSourceSymbols);
+  NS_ASSERT_MSG (repair.data.GetSize () == m_symbolSize, "Symbol size mismatch");
+  NS_ASSERT_MSG (repair.nbSourceSymbols > 0 && repair.nbSourceSymbols <= m_windowSize,
+                 "The repair window does not match windowSize");
+  std::vector<std::pair<uint32_t, Buffer>> recovered;
+
+  if (!m_started)
+    {
+      m_started = true;
+      m_sentEnd = m_historyStart = repair.firstEsi;
+    }
+
+  // The known source symbols older than the history are gone, so they
+  // cannot be removed from the repair symbol anymore
+  MarkSent (repair.firstEsi + repair.nbSourceSymbols);
+  if (repair.firstEsi < m_historyStart)
+    {
+      NS_LOG_LOGIC ("Repair symbol too old");
+      return recovered;
+    }
+
+  Equation eq;
+  eq.data.resize (m_symbolSize);
+  repair.data.CopyData (eq.data.data (), m_symbolSize);
+  for (uint16_t i = 0; i < repair.nbSourceSymbols; i++)
+    {
+      uint8_t c = GetCoefficient (repair.repairKey, i, repair.nbSourceSymbols);
+      if (!c)
+        {
+          continue;
+        }
+      uint32_t esi = repair.firstEsi + i;
+      auto known = m_known.find (esi);
+      if (known != m_known.end ())
+        {
+          AlFecGf256::MulAddRegion (eq.data.data (), known->second.data (), c, m_symbolSize);
+        }
+      else
+        {
+          eq.coefs[esi] = c;
+        }
+    }
+  if (eq.coefs.empty ())
+    {
+      return recovered;
+    }
+
+  InsertEquation (std::move (eq));
+  SolveEquations (recovered);
+  return recovered;
+}
+
+size_t
+AlFecCodecSlidingWindowRlc::GetNbRecovered () const
+{
+  return m_nbRecovered;
+}
+
+size_t
+AlFecCodecSlidingWindowRlc::GetNbLost () const
+{
+  return m_nbLost;
+}
+
+Time
+AlFecCodecSlidingWindowRlc::GetAverageRecoveryDelay () const
+{
+  if (m_nbRecovered == 0)
+    {
+      return Time ();
+    }
+  return Time (m_totalRecoveryDelay.GetTimeStep () / static_cast<int64_t> (m_nbRecovered));
+}
+
+Time
+AlFecCodecSlidingWindowRlc::GetMaxRecoveryDelay () const
+{
+  return m_maxRecoveryDelay;
+}
+
+size_t
+AlFecCodecSlidingWindowRlc::GetNbPendingEquations () const
+{
+  return m_equations.size ();
+}
+
+uint32_t
+AlFecCodecSlidingWindowRlc::GetSymbolSize () const
+{
+  return m_symbolSize;
+}
+
+uint32_t
+AlFecCodecSlidingWindowRlc::GetWindowSize () const
+{
+  return m_windowSize;
+}
+
+} // namespace ns3
@@ -0,0 +1,225 @@
+#ifndef AL_FEC_CODEC_SLIDING_WINDOW_RLC_H
+#define AL_FEC_CODEC_SLIDING_WINDOW_RLC_H
+
+#include "ns3/buffer.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <deque>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Sliding window Random Linear Code over GF(2^8), after RFC 8681.
+ *
+ * Unlike the block codecs, this codec works on a stream: each source symbol
+ * is sent as soon as it is added, and each repair symbol is a random linear
+ * combination of the last windowSize source symbols. The decoder keeps the
+ * repair equations it cannot solve yet and recovers a lost source symbol as
+ * soon as the equations determine it, instead of waiting for a whole block.
+ *
+ * A source symbol holds one packet (ADU) of at most symbolSize - 2 bytes. The
+ * repair symbols are computed over the ADU prefixed with its 16-bit length
+ * and zero-padded to symbolSize, so that the recovered ADU keeps its length.
+ * The coefficients are derived from the repair key with a generator of this
+ * module, not with the TinyMT32 of RFC 8681, so the repair symbols are not
+ * interoperable with other RLC implementations.
+ *
+ * The decoder keeps the source symbols of the last 2 * windowSize ESIs. A
+ * symbol still missing when it leaves this history is counted as lost.
+ */
+class AlFecCodecSlidingWindowRlc : public Object
+{
+public:
+  /**
+   * \brief A repair symbol and its FEC payload ID
+   */
+  struct RepairSymbol
+  {
+    uint16_t repairKey; // Seed of the coefficients
+    uint32_t firstEsi; // ESI of the first source symbol of the window
+    uint16_t nbSourceSymbols; // Number of source symbols of the window
+    Buffer data; // symbolSize bytes
+  };
+
+  AlFecCodecSlidingWindowRlc ();
+  ~AlFecCodecSlidingWindowRlc ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual void DoDispose ();
+
+  /**
+   * \brief Add a source symbol to the encoding window. The symbol itself is
+   * sent unchanged, along with the returned ESI.
+   *
+   * \param p The ADU, at most symbolSize - 2 bytes
+   *
+   * \return The ESI of the source symbol
+  */
+  uint32_t AddSourceSymbol (Buffer p);
+
+  /**
+   * \brief Get the repair symbols due after the source symbols added so far.
+   * One repair symbol is due every 1 / (1 / codeRate - 1) source symbols on
+   * average.
+   *
+   * \return The next repair symbol, or std::nullopt if no repair symbol is due
+  */
+  std::optional<RepairSymbol> NextRepairSymbol ();
+
+  /**
+   * \brief Build a repair symbol over the current encoding window, whether
+   * it is due or not, e.g. to protect the tail of the stream
+  */
+  RepairSymbol BuildRepairSymbol ();
+
+  /**
+   * \brief Decode with a received source symbol
+   *
+   * \return The source symbols recovered thanks to it, as {ESI, ADU} pairs
+   * in ESI order. The received symbol itself is not part of them.
+  */
+  std::vector<std::pair<uint32_t, Buffer>> DecodeSourceSymbol (uint32_t esi, Buffer p);
+
+  /**
+   * \brief Decode with a received repair symbol
+   *
+   * \return The source symbols recovered thanks to it, as {ESI, ADU} pairs
+   * in ESI order
+  */
+  std::vector<std::pair<uint32_t, Buffer>> DecodeRepairSymbol (const RepairSymbol &repair);
+
+  /**
+   * \brief Forget the encoding window, the decoding state and the statistics
+  */
+  void Reset ();
+
+  /**
+   * \brief Get the number of source symbols recovered by the decoder
+  */
+  size_t GetNbRecovered () const;
+
+  /**
+   * \brief Get the number of source symbols that left the decoding history
+   * without being received or recovered
+  */
+  size_t GetNbLost () const;
+
+  /**
+   * \brief Get the average delay between the moment the decoder notices a
+   * missing source symbol, i.e. receives a symbol with a higher ESI or a
+   * repair symbol covering it, and the moment it recovers the symbol
+  */
+  Time GetAverageRecoveryDelay () const;
+
+  /**
+   * \brief Get the largest recovery delay, see GetAverageRecoveryDelay
+  */
+  Time GetMaxRecoveryDelay () const;
+
+  /**
+   * \brief Get the number of repair equations waiting for more symbols
+  */
+  size_t GetNbPendingEquations () const;
+
+  uint32_t GetSymbolSize () const;
+  uint32_t GetWindowSize () const;
+
+private:
+  /**
+   * \brief A repair equation over the unknown source symbols
+   */
+  struct Equation
+  {
+    std::map<uint32_t, uint8_t> coefs; // ESI of each unknown to its coefficient
+    std::vector<uint8_t> data; // Combination of the unknowns
+  };
+
+  /**
+   * \brief Get the coefficient of the i-th source symbol of a repair window.
+   * The last symbol of the window always gets a non-zero coefficient.
+   */
+  uint8_t GetCoefficient (uint16_t repairKey, uint16_t i, uint16_t nbSourceSymbols) const;
+
+  /**
+   * \brief Prefix the ADU with its length and pad it to symbolSize
+   */
+  std::vector<uint8_t> MakeSymbol (const Buffer &p) const;
+
+  /**
+   * \brief Get the ADU back from a padded symbol
+   */
+  Buffer GetAdu (const std::vector<uint8_t> &symbol) const;
+
+  /**
+   * \brief Note that every ESI below end was sent, and start the recovery
+   * delay of the missing ones
+   */
+  void MarkSent (uint32_t end);
+
+  /**
+   * \brief Store a received or recovered source symbol and remove it from
+   * the equations
+   */
+  void AddKnownSymbol (uint32_t esi, std::vector<uint8_t> symbol);
+
+  /**
+   * \brief Reduce the equation with the stored ones, and store it if it
+   * brings a new unknown. The stored equations are kept in reduced row
+   * echelon form, so an equation with a single unknown solves it.
+   */
+  void InsertEquation (Equation equation);
+
+  /**
+   * \brief eq -= c * row
+   */
+  void SubtractEquation (Equation &eq, const Equation &row, uint8_t c) const;
+
+  /**
+   * \brief Recover the unknowns that have an equation of their own
+   */
+  void SolveEquations (std::vector<std::pair<uint32_t, Buffer>> &recovered);
+
+  /**
+   * \brief Drop the source symbols and equations that left the decoding history
+   */
+  void Evict ();
+
+  // Common
+  uint32_t m_symbolSize; // Symbol size including the length prefix. For configuration.
+  uint32_t m_windowSize; // Maximum number of source symbols per repair symbol. For configuration.
+  double m_density; // Share of the window in each repair symbol. For configuration.
+  double m_codeRate; // Ratio of source symbols among all the symbols. For configuration.
+
+  // Encode
+  std::deque<std::vector<uint8_t>> m_window; // Last source symbols, padded
+  uint32_t m_nextEsi; // ESI of the next source symbol
+  uint16_t m_nextRepairKey; // Repair key of the next repair symbol
+  double m_repairCredit; // Repair symbols due
+
+  // Decode
+  bool m_started; // Whether a symbol has been received
+  uint32_t m_sentEnd; // One past the highest ESI known to be sent
+  uint32_t m_historyStart; // Lowest ESI the decoder keeps
+  std::map<uint32_t, std::vector<uint8_t>> m_known; // Received and recovered source symbols
+  std::map<uint32_t, Time> m_missingSince; // Missing source symbols, and when they were noticed
+  std::map<uint32_t, Equation> m_equations; // Stored equations, by pivot ESI
+
+  // Statistics
+  size_t m_nbRecovered;
+  size_t m_nbLost;
+  Time m_totalRecoveryDelay;
+  Time m_maxRecoveryDelay;
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_CODEC_SLIDING_WINDOW_RLC_H
@@ -1,6 +1,10 @@
 #include "ns3/al-fec-codec.h"
 #include "ns3/log.h"
 
+#include <cmath>
+#include <limits>
+#include <string.h>
+
 namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("AlFecCodec");
 void
@@ -25,6 +29,127 @@ AlFecCodec::SetSymbolSize (size_t symbolSize)
   m_symbolSize = symbolSize;
 }
 
+void
+AlFecCodec::Reset ()
+{
+  NextBlock ();
+  m_n = 0;
+  m_k = 0;
+}
+
+std::pair<size_t, size_t>
+AlFecCodec::SetSourceBlock (const uint8_t *block, size_t size)
+{
+  Buffer p;
+  p.AddAtStart (size);
+  p.Begin ().Write (block, size);
+  return SetSourceBlock (p);
+}
+
+void
+AlFecCodec::StartSourceBlock (size_t k)
+{
+  NextBlock ();
+  SetK (k);
+  m_pendingSource.clear ();
+  m_pendingSource.reserve (k * m_symbolSize);
+}
+
+bool
+AlFecCodec::AddSourceSymbol (const uint8_t *symbol, size_t size)
+{
+  NS_ASSERT_MSG (size <= m_symbolSize, "Symbol is larger than the symbol size");
+  NS_ASSERT_MSG (m_pendingSource.size () < m_k * m_symbolSize,
+                 "Every source symbol was already added");
+  size_t offset = m_pendingSource.size ();
+  m_pendingSource.resize (offset + m_symbolSize, 0);
+  memcpy (&m_pendingSource[offset], symbol, size);
+  if (m_pendingSource.size () < m_k * m_symbolSize)
+    {
+      return false;
+    }
+
+  SetSourceBlock (m_pendingSource.data (), m_pendingSource.size ());
+  m_pendingSource.clear ();
+  return true;
+}
+
+std::optional<std::pair<unsigned int, const uint8_t *>>
+AlFecCodec::NextEncodedSymbol ()
+{
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock = NextEncodedBlock ();
+  if (!encodedBlock)
+    {
+      return std::nullopt;
+    }
+  m_emitBuffer.resize (encodedBlock->second.GetSize ());
+  encodedBlock->second.CopyData (m_emitBuffer.data (), m_emitBuffer.size ());
+  return std::make_pair (encodedBlock->first, m_emitBuffer.data ());
+}
+
+std::optional<unsigned int>
+AlFecCodec::NextEncodedSymbol (uint8_t *buf, size_t size)
+{
+  NS_ASSERT_MSG (size >= m_symbolSize, "Buffer is smaller than a symbol");
+  std::optional<std::pair<unsigned int, const uint8_t *>> symbol = NextEncodedSymbol ();
+  if (!symbol)
+    {
+      return std::nullopt;
+    }
+  memcpy (buf, symbol->second, m_symbolSize);
+  return symbol->first;
+}
+
+uint8_t *
+AlFecCodec::GetSymbolBuffer (unsigned int /* esi */)
+{
+  return nullptr;
+}
+
+const uint8_t *
+AlFecCodec::GetSourceSymbol (unsigned int /* esi */)
+{
+  return nullptr;
+}
+
+std::optional<Buffer>
+AlFecCodec::Decode (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  Buffer p;
+  p.AddAtStart (size);
+  p.Begin ().Write (symbol, size);
+  return Decode (p, esi);
+}
+
+bool
+AlFecCodec::DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi)
+{
+  return Decode (symbol, size, esi).has_value ();
+}
+
+std::optional<size_t>
+AlFecCodec::GetRank ()
+{
+  return std::nullopt;
+}
+
+size_t
+AlFecCodec::GetMaxSourceBlockLength ()
+{
+  return std::numeric_limits<size_t>::max ();
+}
+
+size_t
+AlFecCodec::GetMaxSourceBlockLengthForN (size_t maxN, double codeRate)
+{
+  size_t k = static_cast<size_t> (maxN * codeRate);
+  while (k > 1 && ceil (static_cast<double> (k) / codeRate) > maxN)
+    {
+      k--;
+    }
+  return k;
+}
+
 size_t
 AlFecCodec::GetN ()
 {
@@ -5,12 +5,20 @@
 #include "ns3/ptr.h"
 #include <optional>
 #include <utility>
+#include <vector>
 
 namespace ns3 {
 
 /**
  * \brief The generic encoding and decoding class and interface of AL-FEC.
  * This class does not response to packet encapsulation and interpretation.
+ *
+ * The state the codecs share (field tables, matrix cache, OpenFEC session
+ * pool) is synchronized, so different instances may be used from different
+ * threads at the same time. ns-3 Buffers are not thread-safe, so such
+ * instances must stay on the Buffer-free path: SetSourceBlock from memory or
+ * StartSourceBlock and AddSourceSymbol, NextEncodedSymbol, GetSymbolBuffer,
+ * DecodeSymbol and GetSourceSymbol.
 */
 class AlFecCodec
 {
@@ -23,6 +31,17 @@ public:
   */
   virtual std::pair<size_t, size_t> SetSourceBlock (Buffer p) = 0;
 
+  /**
+   * \brief Specify the source block from memory, without an ns-3 Buffer.
+   * The default implementation wraps the block into a Buffer.
+   *
+   * \param block The content of the source block
+   * \param size The size of the source block
+   *
+   * \return {The number of encoded block (n), the number of source block (k)}
+  */
+  virtual std::pair<size_t, size_t> SetSourceBlock (const uint8_t *block, size_t size);
+
   /**
    * \brief Get the next encoded symbol.
    * The encoder implementation must override this.
@@ -44,6 +63,134 @@ public:
   */
   virtual std::optional<Buffer> Decode (Buffer p, unsigned int esi) = 0;
 
+  /**
+   * \brief Start a source block of k symbols that are given one by one to
+   * AddSourceSymbol, as an alternative to SetSourceBlock.
+   * The default implementation collects the symbols and calls SetSourceBlock
+   * once the last one is added.
+   *
+   * \param k The number of source symbols
+  */
+  virtual void StartSourceBlock (size_t k);
+
+  /**
+   * \brief Add the next source symbol of the block started by StartSourceBlock.
+   * Codecs may fold it into the repair symbols right away, so that the repair
+   * symbols are ready as soon as the last source symbol is added.
+   *
+   * \param symbol The content of the source symbol
+   * \param size The size of the symbol, at most GetSymbolSize. A shorter
+   * symbol is padded with zeros.
+   *
+   * \return true if it was the last source symbol of the block. N and the
+   * encoded symbols are then available.
+  */
+  virtual bool AddSourceSymbol (const uint8_t *symbol, size_t size);
+
+  /**
+   * \brief Get the next encoded symbol without copying it.
+   * The default implementation copies the result of NextEncodedBlock.
+   *
+   * \return The ESI and the symbol content (GetSymbolSize bytes). The content
+   * stays valid until the next call to NextEncodedSymbol, NextEncodedBlock,
+   * SetSourceBlock or NextBlock. If there's no unsent encoded block, return std::nullopt
+  */
+  virtual std::optional<std::pair<unsigned int, const uint8_t *>> NextEncodedSymbol ();
+
+  /**
+   * \brief Copy the next encoded symbol into the caller's buffer.
+   *
+   * \param buf The destination, at least GetSymbolSize bytes
+   * \param size The size of buf
+   *
+   * \return The ESI of the copied symbol.
+   * If there's no unsent encoded block, return std::nullopt
+  */
+  std::optional<unsigned int> NextEncodedSymbol (uint8_t *buf, size_t size);
+
+  /**
+   * \brief Get the memory the decoder stores the symbol with the given ESI in,
+   * so that the caller can receive the symbol there and then call Decode with
+   * this pointer. The symbol is then never copied by the codec.
+   * The default implementation returns nullptr.
+   *
+   * \return The slot of the symbol, or nullptr if the codec has no such slot
+   * or does not need the symbol anymore
+  */
+  virtual uint8_t *GetSymbolBuffer (unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol.
+   * The default implementation wraps the symbol into a Buffer.
+   *
+   * \param symbol The content of received symbol. It may be the pointer
+   * returned by GetSymbolBuffer for the same ESI.
+   * \param size The size of the symbol
+   * \param esi The received Encoded Symbol ID
+   *
+   * \return If the source block successfully decoded, return the decoded block.
+   * Other, return std::nullopt
+  */
+  virtual std::optional<Buffer> Decode (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Decode source block with received symbol, without building the
+   * decoded block into an ns-3 Buffer. The source symbols of the decoded
+   * block are then read with GetSourceSymbol until NextBlock.
+   * The default implementation calls Decode, so it only suits the codecs
+   * whose GetSourceSymbol returns the recovered source symbols.
+   *
+   * \param symbol The content of received symbol. It may be the pointer
+   * returned by GetSymbolBuffer for the same ESI.
+   * \param size The size of the symbol
+   * \param esi The received Encoded Symbol ID
+   *
+   * \return true once the source block is decoded
+  */
+  virtual bool DecodeSymbol (const uint8_t *symbol, size_t size, unsigned int esi);
+
+  /**
+   * \brief Get a source symbol of the current block that the decoder has
+   * received or recovered, so that it can be used before the block decodes.
+   * The default implementation returns nullptr.
+   *
+   * \return The content of the symbol (GetSymbolSize bytes), valid until the
+   * next call to NextBlock, or nullptr if the symbol is not available
+  */
+  virtual const uint8_t *GetSourceSymbol (unsigned int esi);
+
+  /**
+   * \brief Get the rank of the symbols received for the current block, that
+   * is the number of linearly independent ones. The block decodes once it
+   * reaches K. The default implementation does not track it.
+   *
+   * \return The rank, or std::nullopt if the codec does not track it
+  */
+  virtual std::optional<size_t> GetRank ();
+
+  /**
+   * \brief Finish the current block and get ready for the next one.
+   * The implementation must override this.
+   *
+   * The configuration and K are kept, so a decoder of equally sized blocks
+   * does not need another SetK. Resources that are expensive to set up
+   * (sessions, matrices, symbol memory) should be kept for the next block
+   * whenever possible. SetSourceBlock implicitly starts a new block.
+  */
+  virtual void NextBlock () = 0;
+
+  /**
+   * \brief Finish the current block and forget N and K, as if the codec were
+   * freshly constructed.
+  */
+  virtual void Reset ();
+
+  /**
+   * \brief Get the largest K the codec supports with its current configuration.
+   * The default implementation has no limit.
+  */
+  virtual size_t GetMaxSourceBlockLength ();
+
   void SetN (size_t n);
   void SetK (size_t k);
   void SetSymbolSize (size_t symbolSize);
@@ -52,9 +199,19 @@ public:
   size_t GetSymbolSize ();
 
 protected:
+  /**
+   * \brief Get the largest K whose N = ceil (K / codeRate) does not exceed
+   * maxN, for the codecs whose ESIs or field bound N
+  */
+  static size_t GetMaxSourceBlockLengthForN (size_t maxN, double codeRate);
+
   size_t m_n = 0; // Number of encoded blocks
   size_t m_k = 0; // Number of source blocks
   size_t m_symbolSize = 16; // The symbol size. For configuration.
+
+private:
+  std::vector<uint8_t> m_emitBuffer; // Symbol returned by the default NextEncodedSymbol
+  std::vector<uint8_t> m_pendingSource; // Symbols collected by the default AddSourceSymbol
 };
 
 } // namespace ns3
@@ -0,0 +1,343 @@
+#include "ns3/al-fec-decoder-context-table.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecDecoderContextTable");
+
+AlFecDecoderContextTable::AlFecDecoderContextTable ()
+    : m_head (NONE),
+      m_tail (NONE),
+      m_maxContexts (1024),
+      m_maxMemory (64 * 1024 * 1024),
+      m_timeout (Time ()),
+      m_memoryUsage (0),
+      m_nbEvictions (0),
+      m_codec (nullptr),
+      m_hasCodecFactory (false)
+{
+}
+
+AlFecDecoderContextTable::~AlFecDecoderContextTable ()
+{
+}
+
+void
+AlFecDecoderContextTable::SetLimits (size_t maxContexts, size_t maxMemory, Time timeout)
+{
+  NS_ASSERT_MSG (maxContexts > 0, "The table must hold at least one context");
+  m_maxContexts = maxContexts;
+  m_maxMemory = maxMemory;
+  m_timeout = timeout;
+}
+
+void
+AlFecDecoderContextTable::SetCodec (AlFecCodec *codec)
+{
+  Dispose ();
+  m_codec = codec;
+  m_hasCodecFactory = false;
+  if (codec)
+    {
+      m_idleCodecs.push_back (codec);
+    }
+}
+
+void
+AlFecDecoderContextTable::SetCodecFactory (const ObjectFactory &factory)
+{
+  // The decoders of the factory replace the codec
+  Clear ();
+  m_idleCodecs.clear ();
+  m_codecFactory = factory;
+  m_hasCodecFactory = true;
+}
+
+AlFecDecoderContextTable::Context *
+AlFecDecoderContextTable::Lookup (uint32_t flowId, uint16_t sn, Time now)
+{
+  NS_LOG_FUNCTION (this << flowId << sn);
+
+  // Expired contexts are at the end of the LRU list
+  if (m_timeout.IsStrictlyPositive ())
+    {
+      while (m_tail != NONE && m_contexts[m_tail].lastAccess + m_timeout < now)
+        {
+          NS_LOG_LOGIC ("Context of flow " << m_contexts[m_tail].flowId << " SN "
+                                           << m_contexts[m_tail].sn << " timed out");
+          Evict (m_tail);
+        }
+    }
+
+  uint64_t key = MakeKey (flowId, sn);
+  Index::iterator it = m_index.find (key);
+  uint32_t index;
+  if (it != m_index.end ())
+    {
+      index = it->second;
+      Unlink (index);
+    }
+  else
+    {
+      // The limit may have been lowered since the last lookup
+      while (m_index.size () >= m_maxContexts)
+        {
+          Evict (m_tail);
+        }
+      if (m_freeContexts.empty ())
+        {
+          index = m_contexts.size ();
+          m_contexts.emplace_back ();
+        }
+      else
+        {
+          index = m_freeContexts.back ();
+          m_freeContexts.pop_back ();
+        }
+      Context &context = m_contexts[index];
+      context.flowId = flowId;
+      context.sn = sn;
+      context.nbDecodedBlocks = 0;
+      context.complete = false;
+      context.packet = Ptr<Packet> ();
+      context.packetContext = nullptr;
+      context.memoryUsage = 0;
+      context.deliveredBlock = 0;
+      context.deliveredSymbols = 0;
+      context.deliveredBytes = 0;
+      context.paddingSize = 0;
+
+      if (m_freeNodes.empty ())
+        {
+          m_index.emplace (key, index);
+        }
+      else
+        {
+          Index::node_type node = std::move (m_freeNodes.back ());
+          m_freeNodes.pop_back ();
+          node.key () = key;
+          node.mapped () = index;
+          m_index.insert (std::move (node));
+        }
+      NS_LOG_LOGIC ("New context of flow " << flowId << " SN " << sn);
+    }
+
+  PushFront (index);
+  m_contexts[index].lastAccess = now;
+  return &m_contexts[index];
+}
+
+AlFecCodec *
+AlFecDecoderContextTable::GetCodec (Context *context, size_t sbn, size_t k)
+{
+  NS_ASSERT_MSG (sbn < context->codecs.size (), "SBN out of range");
+  if (!context->codecs[sbn])
+    {
+      AlFecCodec *codec = AcquireCodec ();
+      codec->SetK (k);
+      context->codecs[sbn] = codec;
+    }
+  return context->codecs[sbn];
+}
+
+bool
+AlFecDecoderContextTable::FinishBlock (Context *context, size_t sbn, const Buffer &block)
+{
+  NS_ASSERT_MSG (sbn < context->decodedBlocks.size (), "SBN out of range");
+  context->decodedBlocks[sbn] = block;
+  context->nbDecodedBlocks++;
+  if (context->codecs[sbn])
+    {
+      ReleaseCodec (context->codecs[sbn]);
+      context->codecs[sbn] = nullptr;
+    }
+  UpdateMemoryUsage (context);
+  return context->nbDecodedBlocks == context->decodedBlocks.size ();
+}
+
+void
+AlFecDecoderContextTable::Complete (Context *context, Ptr<Packet> packet)
+{
+  for (AlFecCodec *&codec : context->codecs)
+    {
+      if (codec)
+        {
+          ReleaseCodec (codec);
+          codec = nullptr;
+        }
+    }
+  context->decodedBlocks.clear ();
+  context->complete = true;
+  context->packet = packet;
+  context->packetContext = nullptr;
+  UpdateMemoryUsage (context);
+}
+
+void
+AlFecDecoderContextTable::UpdateMemoryUsage (Context *context)
+{
+  size_t memoryUsage = 0;
+  for (AlFecCodec *codec : context->codecs)
+    {
+      if (codec)
+        {
+          memoryUsage += codec->GetN () * codec->GetSymbolSize ();
+        }
+    }
+  for (const std::optional<Buffer> &block : context->decodedBlocks)
+    {
+      if (block)
+        {
+          memoryUsage += block->GetSize ();
+        }
+    }
+  if (context->packet)
+    {
+      memoryUsage += context->packet->GetSize ();
+    }
+  m_memoryUsage = m_memoryUsage - context->memoryUsage + memoryUsage;
+  context->memoryUsage = memoryUsage;
+
+  uint32_t index = context - m_contexts.data ();
+  while (m_memoryUsage > m_maxMemory && m_tail != NONE && m_tail != index)
+    {
+      NS_LOG_LOGIC ("Memory usage " << m_memoryUsage << " over the limit");
+      Evict (m_tail);
+    }
+}
+
+void
+AlFecDecoderContextTable::Evict (uint32_t index)
+{
+  NS_ASSERT (index != NONE);
+  Context &context = m_contexts[index];
+  NS_LOG_FUNCTION (this << context.flowId << context.sn);
+
+  for (AlFecCodec *codec : context.codecs)
+    {
+      if (codec)
+        {
+          ReleaseCodec (codec);
+        }
+    }
+  context.codecs.clear ();
+  context.decodedBlocks.clear ();
+  context.packet = Ptr<Packet> ();
+  context.packetContext = nullptr;
+  m_memoryUsage -= context.memoryUsage;
+  context.memoryUsage = 0;
+
+  Unlink (index);
+  m_freeNodes.push_back (m_index.extract (MakeKey (context.flowId, context.sn)));
+  m_freeContexts.push_back (index);
+  m_nbEvictions++;
+}
+
+void
+AlFecDecoderContextTable::Clear ()
+{
+  while (m_tail != NONE)
+    {
+      Evict (m_tail);
+    }
+}
+
+void
+AlFecDecoderContextTable::Dispose ()
+{
+  Clear ();
+  for (Ptr<Object> object : m_codecObjects)
+    {
+      object->Dispose ();
+    }
+  m_codecObjects.clear ();
+  m_idleCodecs.clear ();
+  m_codec = nullptr;
+  m_hasCodecFactory = false;
+}
+
+AlFecCodec *
+AlFecDecoderContextTable::AcquireCodec ()
+{
+  if (m_idleCodecs.empty ())
+    {
+      NS_ASSERT_MSG (m_hasCodecFactory,
+                     "The codec cannot be duplicated, so only one block can be decoded at once");
+      Ptr<Object> object = m_codecFactory.Create ();
+      AlFecCodec *codec = dynamic_cast<AlFecCodec *> (PeekPointer (object));
+      NS_ASSERT (codec != nullptr);
+      m_codecObjects.push_back (object);
+      return codec;
+    }
+  AlFecCodec *codec = m_idleCodecs.back ();
+  m_idleCodecs.pop_back ();
+  return codec;
+}
+
+void
+AlFecDecoderContextTable::ReleaseCodec (AlFecCodec *codec)
+{
+  // The decoder keeps its symbol memory for the next block
+  codec->Reset ();
+  m_idleCodecs.push_back (codec);
+}
+
+void
+AlFecDecoderContextTable::Unlink (uint32_t index)
+{
+  Context &context = m_contexts[index];
+  if (context.prev != NONE)
+    {
+      m_contexts[context.prev].next = context.next;
+    }
+  else
+    {
+      m_head = context.next;
+    }
+  if (context.next != NONE)
+    {
+      m_contexts[context.next].prev = context.prev;
+    }
+  else
+    {
+      m_tail = context.prev;
+    }
+  context.prev = NONE;
+  context.next = NONE;
+}
+
+void
+AlFecDecoderContextTable::PushFront (uint32_t index)
+{
+  Context &context = m_contexts[index];
+  context.prev = NONE;
+  context.next = m_head;
+  if (m_head != NONE)
+    {
+      m_contexts[m_head].prev = index;
+    }
+  m_head = index;
+  if (m_tail == NONE)
+    {
+      m_tail = index;
+    }
+}
+
+size_t
+AlFecDecoderContextTable::GetSize () const
+{
+  return m_index.size ();
+}
+
+size_t
+AlFecDecoderContextTable::GetMemoryUsage () const
+{
+  return m_memoryUsage;
+}
+
+size_t
+AlFecDecoderContextTable::GetNbEvictions () const
+{
+  return m_nbEvictions;
+}
+
+} // namespace ns3
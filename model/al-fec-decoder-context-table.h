@@ -0,0 +1,173 @@
+#ifndef AL_FEC_DECODER_CONTEXT_TABLE_H
+#define AL_FEC_DECODER_CONTEXT_TABLE_H
+
+#include "ns3/al-fec-codec.h"
+#include "ns3/al-fec-packet-context-store.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/packet.h"
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief Receive-side state of the source blocks being decoded, keyed by
+ * (flow id, sequence number).
+ *
+ * A context holds the decoders of the sub-blocks (SBN) of one source block.
+ * Contexts are created on the first symbol of a block and evicted in LRU
+ * order when the number of contexts or the memory of their decoders exceeds
+ * the limits, or when they have not been used for the timeout. A decoded
+ * block keeps a small context until it is evicted, so that its late symbols
+ * are recognized instead of starting the block over.
+ *
+ * Contexts, hash table nodes and decoders are recycled, so a block in steady
+ * state does not allocate anything but its symbol memory.
+ */
+class AlFecDecoderContextTable
+{
+public:
+  static const uint32_t NONE = UINT32_MAX;
+
+  /**
+   * \brief Decoding state of one source block
+   */
+  struct Context
+  {
+    uint32_t flowId = 0;
+    uint16_t sn = 0;
+    std::vector<AlFecCodec *> codecs; // Decoder of each sub-block, nullptr if idle
+    std::vector<std::optional<Buffer>> decodedBlocks; // Decoded sub-blocks
+    size_t nbDecodedBlocks = 0;
+    bool complete = false; // Every sub-block has been decoded
+    Ptr<Packet> packet; // Decoded packet, returned again for the late symbols
+    AlFecPacketContextStore::Context packetContext; // Fetched on the first symbol
+    size_t memoryUsage = 0; // Bytes held by the decoders, the decoded sub-blocks and the packet
+    size_t deliveredBlock = 0; // Early delivery: sub-block of the next source symbol to deliver
+    size_t deliveredSymbols = 0; // Early delivery: source symbols of it already delivered
+    uint32_t deliveredBytes = 0; // Early delivery: bytes of the packet already delivered
+    uint16_t paddingSize = 0; // Early delivery: padding of the packet, from its first symbol
+    Time lastAccess;
+    uint32_t prev = NONE; // LRU list, towards the most recently used
+    uint32_t next = NONE; // LRU list, towards the least recently used
+  };
+
+  AlFecDecoderContextTable ();
+  ~AlFecDecoderContextTable ();
+  AlFecDecoderContextTable (const AlFecDecoderContextTable &) = delete;
+  AlFecDecoderContextTable &operator= (const AlFecDecoderContextTable &) = delete;
+
+  /**
+   * \brief Set the limits of the table
+   *
+   * \param maxContexts The maximum number of contexts
+   * \param maxMemory The maximum number of bytes held by the contexts
+   * \param timeout Contexts unused for this long are evicted. 0 disables the timeout.
+   */
+  void SetLimits (size_t maxContexts, size_t maxMemory, Time timeout);
+
+  /**
+   * \brief Set the codec used to decode. If a factory is also given, the
+   * decoders are created by the factory and the codec itself is not used.
+   */
+  void SetCodec (AlFecCodec *codec);
+  void SetCodecFactory (const ObjectFactory &factory);
+
+  /**
+   * \brief Find the context of a source block, creating it if needed.
+   * The context becomes the most recently used one.
+   *
+   * \param now The current time, for the timeout
+   */
+  Context *Lookup (uint32_t flowId, uint16_t sn, Time now);
+
+  /**
+   * \brief Get the decoder of a sub-block, acquiring an idle one if needed
+   *
+   * \param k The number of source symbols of the sub-block
+   */
+  AlFecCodec *GetCodec (Context *context, size_t sbn, size_t k);
+
+  /**
+   * \brief Store a decoded sub-block and recycle its decoder
+   *
+   * \return Whether every sub-block of the context has been decoded
+   */
+  bool FinishBlock (Context *context, size_t sbn, const Buffer &block);
+
+  /**
+   * \brief Mark the context decoded and free its decoders and sub-blocks
+   *
+   * \param packet Returned again for the late symbols, may be null
+   */
+  void Complete (Context *context, Ptr<Packet> packet);
+
+  /**
+   * \brief Account the memory of the context, and evict the least recently
+   * used other contexts while over the limit
+   */
+  void UpdateMemoryUsage (Context *context);
+
+  /**
+   * \brief Evict every context
+   */
+  void Clear ();
+
+  /**
+   * \brief Dispose the decoders created by the factory
+   */
+  void Dispose ();
+
+  size_t GetSize () const;
+  size_t GetMemoryUsage () const;
+  size_t GetNbEvictions () const;
+
+private:
+  /**
+   * \brief Evict a context, recycling its decoders and its slot
+   */
+  void Evict (uint32_t index);
+
+  AlFecCodec *AcquireCodec ();
+  void ReleaseCodec (AlFecCodec *codec);
+
+  void Unlink (uint32_t index);
+  void PushFront (uint32_t index);
+
+  static uint64_t
+  MakeKey (uint32_t flowId, uint16_t sn)
+  {
+    return (static_cast<uint64_t> (flowId) << 16) | sn;
+  }
+
+  typedef std::unordered_map<uint64_t, uint32_t> Index;
+
+  std::vector<Context> m_contexts; // Slots, used or free
+  std::vector<uint32_t> m_freeContexts; // Free slots
+  Index m_index; // Key to slot
+  std::vector<Index::node_type> m_freeNodes; // Recycled nodes of m_index
+  uint32_t m_head; // Most recently used
+  uint32_t m_tail; // Least recently used
+
+  size_t m_maxContexts;
+  size_t m_maxMemory;
+  Time m_timeout;
+  size_t m_memoryUsage;
+  size_t m_nbEvictions;
+
+  // Decoders
+  AlFecCodec *m_codec; // Used when there is no factory
+  bool m_hasCodecFactory;
+  ObjectFactory m_codecFactory;
+  std::vector<Ptr<Object>> m_codecObjects; // Decoders created by the factory
+  std::vector<AlFecCodec *> m_idleCodecs;
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_DECODER_CONTEXT_TABLE_H
@@ -0,0 +1,511 @@
+#include "ns3/al-fec-gf256.h"
+#include "ns3/log.h"
+
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AL_FEC_GF256_X86
+#endif
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecGf256");
+
+namespace {
+
+const unsigned int kPrimitivePolynomial = 0x11d; // x^8 + x^4 + x^3 + x^2 + 1
+
+struct Gf256Tables
+{
+  uint8_t exp[512]; // alpha^i, doubled so that exp[log a + log b] needs no modulo
+  uint8_t log[256]; // log[0] is unused
+  uint8_t mul[256][256]; // Full product table for the scalar kernel
+  alignas (16) uint8_t mulLo[256][16]; // c * i for i in [0, 16)
+  alignas (16) uint8_t mulHi[256][16]; // c * (i << 4) for i in [0, 16)
+
+  Gf256Tables ()
+  {
+    unsigned int x = 1;
+    for (unsigned int i = 0; i < 255; i++)
+      {
+        exp[i] = x;
+        exp[i + 255] = x;
+        log[x] = i;
+        x <<= 1;
+        if (x & 0x100)
+          {
+            x ^= kPrimitivePolynomial;
+          }
+      }
+    exp[510] = exp[0];
+    exp[511] = exp[1];
+    log[0] = 0;
+
+    for (unsigned int a = 0; a < 256; a++)
+      {
+        for (unsigned int b = 0; b < 256; b++)
+          {
+            mul[a][b] = (a && b) ? exp[log[a] + log[b]] : 0;
+          }
+        for (unsigned int i = 0; i < 16; i++)
+          {
+            mulLo[a][i] = mul[a][i];
+            mulHi[a][i] = mul[a][i << 4];
+          }
+      }
+  }
+};
+
+const Gf256Tables &
+GetTables ()
+{
+  static const Gf256Tables tables;
+  return tables;
+}
+
+template <bool Accumulate>
+void
+MulRegionScalar (uint8_t *dst, const uint8_t *src, uint8_t c, size_t len)
+{
+  const uint8_t *row = GetTables ().mul[c];
+  for (size_t i = 0; i < len; i++)
+    {
+      if (Accumulate)
+        {
+          dst[i] ^= row[src[i]];
+        }
+      else
+        {
+          dst[i] = row[src[i]];
+        }
+    }
+}
+
+void
+XorRegionScalar (uint8_t *dst, const uint8_t *src, size_t len)
+{
+  size_t i = 0;
+  for (; i + sizeof (uint64_t) <= len; i += sizeof (uint64_t))
+    {
+      uint64_t a, b;
+      memcpy (&a, dst + i, sizeof (a));
+      memcpy (&b, src + i, sizeof (b));
+      a ^= b;
+      memcpy (dst + i, &a, sizeof (a));
+    }
+  for (; i < len; i++)
+    {
+      dst[i] ^= src[i];
+    }
+}
+
+/**
+ * dst[i] = sum of c[j] * src[j][i] for i in [begin, end). The sum of each
+ * 64-byte slice is accumulated on the stack, where it stays in the cache.
+ */
+void
+DotProductScalar (uint8_t *dst, const uint8_t *const *src, const uint8_t *c, size_t n,
+                  size_t begin, size_t end)
+{
+  const Gf256Tables &t = GetTables ();
+  uint8_t acc[64];
+  for (size_t i = begin; i < end; i += sizeof (acc))
+    {
+      size_t len = std::min (sizeof (acc), end - i);
+      memset (acc, 0, len);
+      for (size_t j = 0; j < n; j++)
+        {
+          if (c[j] == 0)
+            {
+              continue;
+            }
+          const uint8_t *row = t.mul[c[j]];
+          const uint8_t *x = src[j] + i;
+          for (size_t b = 0; b < len; b++)
+            {
+              acc[b] ^= row[x[b]];
+            }
+        }
+      memcpy (dst + i, acc, len);
+    }
+}
+
+#ifdef AL_FEC_GF256_X86
+
+template <bool Accumulate>
+__attribute__ ((target ("ssse3"))) void
+MulRegionSsse3 (uint8_t *dst, const uint8_t *src, uint8_t c, size_t len)
+{
+  const Gf256Tables &t = GetTables ();
+  const __m128i lo = _mm_load_si128 (reinterpret_cast<const __m128i *> (t.mulLo[c]));
+  const __m128i hi = _mm_load_si128 (reinterpret_cast<const __m128i *> (t.mulHi[c]));
+  const __m128i mask = _mm_set1_epi8 (0x0f);
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16)
+    {
+      __m128i x = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (src + i));
+      __m128i l = _mm_shuffle_epi8 (lo, _mm_and_si128 (x, mask));
+      __m128i h = _mm_shuffle_epi8 (hi, _mm_and_si128 (_mm_srli_epi64 (x, 4), mask));
+      __m128i y = _mm_xor_si128 (l, h);
+      if (Accumulate)
+        {
+          y = _mm_xor_si128 (y, _mm_loadu_si128 (reinterpret_cast<const __m128i *> (dst + i)));
+        }
+      _mm_storeu_si128 (reinterpret_cast<__m128i *> (dst + i), y);
+    }
+  MulRegionScalar<Accumulate> (dst + i, src + i, c, len - i);
+}
+
+__attribute__ ((target ("ssse3"))) void
+XorRegionSsse3 (uint8_t *dst, const uint8_t *src, size_t len)
+{
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16)
+    {
+      __m128i a = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (dst + i));
+      __m128i b = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (src + i));
+      _mm_storeu_si128 (reinterpret_cast<__m128i *> (dst + i), _mm_xor_si128 (a, b));
+    }
+  XorRegionScalar (dst + i, src + i, len - i);
+}
+
+__attribute__ ((target ("ssse3"))) void
+DotProductSsse3 (uint8_t *dst, const uint8_t *const *src, const uint8_t *c, size_t n,
+                 size_t begin, size_t end)
+{
+  const Gf256Tables &t = GetTables ();
+  const __m128i mask = _mm_set1_epi8 (0x0f);
+  size_t i = begin;
+  for (; i + 16 <= end; i += 16)
+    {
+      __m128i acc = _mm_setzero_si128 ();
+      for (size_t j = 0; j < n; j++)
+        {
+          __m128i lo = _mm_load_si128 (reinterpret_cast<const __m128i *> (t.mulLo[c[j]]));
+          __m128i hi = _mm_load_si128 (reinterpret_cast<const __m128i *> (t.mulHi[c[j]]));
+          __m128i x = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (src[j] + i));
+          acc = _mm_xor_si128 (acc, _mm_shuffle_epi8 (lo, _mm_and_si128 (x, mask)));
+          acc = _mm_xor_si128 (
+              acc, _mm_shuffle_epi8 (hi, _mm_and_si128 (_mm_srli_epi64 (x, 4), mask)));
+        }
+      _mm_storeu_si128 (reinterpret_cast<__m128i *> (dst + i), acc);
+    }
+  DotProductScalar (dst, src, c, n, i, end);
+}
+
+template <bool Accumulate>
+__attribute__ ((target ("avx2"))) void
+MulRegionAvx2 (uint8_t *dst, const uint8_t *src, uint8_t c, size_t len)
+{
+  const Gf256Tables &t = GetTables ();
+  const __m256i lo = _mm256_broadcastsi128_si256 (
+      _mm_load_si128 (reinterpret_cast<const __m128i *> (t.mulLo[c])));
+  const __m256i hi = _mm256_broadcastsi128_si256 (
+      _mm_load_si128 (reinterpret_cast<const __m128i *> (t.mulHi[c])));
+  const __m256i mask = _mm256_set1_epi8 (0x0f);
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32)
+    {
+      __m256i x = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (src + i));
+      __m256i l = _mm256_shuffle_epi8 (lo, _mm256_and_si256 (x, mask));
+      __m256i h = _mm256_shuffle_epi8 (hi, _mm256_and_si256 (_mm256_srli_epi64 (x, 4), mask));
+      __m256i y = _mm256_xor_si256 (l, h);
+      if (Accumulate)
+        {
+          y = _mm256_xor_si256 (y,
+                                _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (dst + i)));
+        }
+      _mm256_storeu_si256 (reinterpret_cast<__m256i *> (dst + i), y);
+    }
+  MulRegionSsse3<Accumulate> (dst + i, src + i, c, len - i);
+}
+
+__attribute__ ((target ("avx2"))) void
+XorRegionAvx2 (uint8_t *dst, const uint8_t *src, size_t len)
+{
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32)
+    {
+      __m256i a = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (dst + i));
+      __m256i b = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (src + i));
+      _mm256_storeu_si256 (reinterpret_cast<__m256i *> (dst + i), _mm256_xor_si256 (a, b));
+    }
+  XorRegionSsse3 (dst + i, src + i, len - i);
+}
+
+__attribute__ ((target ("avx2"))) void
+DotProductAvx2 (uint8_t *dst, const uint8_t *const *src, const uint8_t *c, size_t n,
+                size_t begin, size_t end)
+{
+  const Gf256Tables &t = GetTables ();
+  const __m256i mask = _mm256_set1_epi8 (0x0f);
+  size_t i = begin;
+  // Two accumulators, so that the tables of a coefficient serve a whole cache line
+  for (; i + 64 <= end; i += 64)
+    {
+      __m256i acc0 = _mm256_setzero_si256 ();
+      __m256i acc1 = _mm256_setzero_si256 ();
+      for (size_t j = 0; j < n; j++)
+        {
+          const __m256i lo = _mm256_broadcastsi128_si256 (
+              _mm_load_si128 (reinterpret_cast<const __m128i *> (t.mulLo[c[j]])));
+          const __m256i hi = _mm256_broadcastsi128_si256 (
+              _mm_load_si128 (reinterpret_cast<const __m128i *> (t.mulHi[c[j]])));
+          __m256i x0 = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (src[j] + i));
+          __m256i x1 = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (src[j] + i + 32));
+          acc0 = _mm256_xor_si256 (acc0, _mm256_shuffle_epi8 (lo, _mm256_and_si256 (x0, mask)));
+          acc0 = _mm256_xor_si256 (
+              acc0, _mm256_shuffle_epi8 (hi, _mm256_and_si256 (_mm256_srli_epi64 (x0, 4), mask)));
+          acc1 = _mm256_xor_si256 (acc1, _mm256_shuffle_epi8 (lo, _mm256_and_si256 (x1, mask)));
+          acc1 = _mm256_xor_si256 (
+              acc1, _mm256_shuffle_epi8 (hi, _mm256_and_si256 (_mm256_srli_epi64 (x1, 4), mask)));
+        }
+      _mm256_storeu_si256 (reinterpret_cast<__m256i *> (dst + i), acc0);
+      _mm256_storeu_si256 (reinterpret_cast<__m256i *> (dst + i + 32), acc1);
+    }
+  DotProductSsse3 (dst, src, c, n, i, end);
+}
+
+template <bool Accumulate>
+__attribute__ ((target ("avx512f,avx512bw"))) void
+MulRegionAvx512 (uint8_t *dst, const uint8_t *src, uint8_t c, size_t len)
+{
+  const Gf256Tables &t = GetTables ();
+  const __m512i lo =
+      _mm512_broadcast_i32x4 (_mm_load_si128 (reinterpret_cast<const __m128i *> (t.mulLo[c])));
+  const __m512i hi =
+      _mm512_broadcast_i32x4 (_mm_load_si128 (reinterpret_cast<const __m128i *> (t.mulHi[c])));
+  const __m512i mask = _mm512_set1_epi8 (0x0f);
+  size_t i = 0;
+  for (; i + 64 <= len; i += 64)
+    {
+      __m512i x = _mm512_loadu_si512 (src + i);
+      __m512i l = _mm512_shuffle_epi8 (lo, _mm512_and_si512 (x, mask));
+      __m512i h = _mm512_shuffle_epi8 (hi, _mm512_and_si512 (_mm512_srli_epi64 (x, 4), mask));
+      __m512i y = _mm512_xor_si512 (l, h);
+      if (Accumulate)
+        {
+          y = _mm512_xor_si512 (y, _mm512_loadu_si512 (dst + i));
+        }
+      _mm512_storeu_si512 (dst + i, y);
+    }
+  MulRegionAvx2<Accumulate> (dst + i, src + i, c, len - i);
+}
+
+__attribute__ ((target ("avx512f"))) void
+XorRegionAvx512 (uint8_t *dst, const uint8_t *src, size_t len)
+{
+  size_t i = 0;
+  for (; i + 64 <= len; i += 64)
+    {
+      __m512i a = _mm512_loadu_si512 (dst + i);
+      __m512i b = _mm512_loadu_si512 (src + i);
+      _mm512_storeu_si512 (dst + i, _mm512_xor_si512 (a, b));
+    }
+  XorRegionAvx2 (dst + i, src + i, len - i);
+}
+
+__attribute__ ((target ("avx512f,avx512bw"))) void
+DotProductAvx512 (uint8_t *dst, const uint8_t *const *src, const uint8_t *c, size_t n,
+                  size_t begin, size_t end)
+{
+  const Gf256Tables &t = GetTables ();
+  const __m512i mask = _mm512_set1_epi8 (0x0f);
+  size_t i = begin;
+  for (; i + 64 <= end; i += 64)
+    {
+      __m512i acc = _mm512_setzero_si512 ();
+      for (size_t j = 0; j < n; j++)
+        {
+          const __m512i lo = _mm512_broadcast_i32x4 (
+              _mm_load_si128 (reinterpret_cast<const __m128i *> (t.mulLo[c[j]])));
+          const __m512i hi = _mm512_broadcast_i32x4 (
+              _mm_load_si128 (reinterpret_cast<const __m128i *> (t.mulHi[c[j]])));
+          __m512i x = _mm512_loadu_si512 (src[j] + i);
+          acc = _mm512_xor_si512 (acc, _mm512_shuffle_epi8 (lo, _mm512_and_si512 (x, mask)));
+          acc = _mm512_xor_si512 (
+              acc, _mm512_shuffle_epi8 (hi, _mm512_and_si512 (_mm512_srli_epi64 (x, 4), mask)));
+        }
+      _mm512_storeu_si512 (dst + i, acc);
+    }
+  DotProductAvx2 (dst, src, c, n, i, end);
+}
+
+#endif // AL_FEC_GF256_X86
+
+struct Gf256Kernel
+{
+  const char *name;
+  void (*mulAdd) (uint8_t *, const uint8_t *, uint8_t, size_t);
+  void (*mul) (uint8_t *, const uint8_t *, uint8_t, size_t);
+  void (*xorRegion) (uint8_t *, const uint8_t *, size_t);
+  void (*dotProduct) (uint8_t *, const uint8_t *const *, const uint8_t *, size_t, size_t, size_t);
+};
+
+Gf256Kernel
+SelectKernel ()
+{
+#ifdef AL_FEC_GF256_X86
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx512bw"))
+    {
+      return {"avx512bw", MulRegionAvx512<true>, MulRegionAvx512<false>, XorRegionAvx512,
+              DotProductAvx512};
+    }
+  if (__builtin_cpu_supports ("avx2"))
+    {
+      return {"avx2", MulRegionAvx2<true>, MulRegionAvx2<false>, XorRegionAvx2,
+              DotProductAvx2};
+    }
+  if (__builtin_cpu_supports ("ssse3"))
+    {
+      return {"ssse3", MulRegionSsse3<true>, MulRegionSsse3<false>, XorRegionSsse3,
+              DotProductSsse3};
+    }
+#endif
+  return {"scalar", MulRegionScalar<true>, MulRegionScalar<false>, XorRegionScalar,
+          DotProductScalar};
+}
+
+const Gf256Kernel &
+GetKernel ()
+{
+  static const Gf256Kernel kernel = SelectKernel ();
+  return kernel;
+}
+
+} // namespace
+
+uint8_t
+AlFecGf256::Mul (uint8_t a, uint8_t b)
+{
+  return GetTables ().mul[a][b];
+}
+
+uint8_t
+AlFecGf256::Div (uint8_t a, uint8_t b)
+{
+  NS_ASSERT_MSG (b != 0, "Division by zero in GF(2^8)");
+  const Gf256Tables &t = GetTables ();
+  if (a == 0)
+    {
+      return 0;
+    }
+  return t.exp[t.log[a] + 255 - t.log[b]];
+}
+
+uint8_t
+AlFecGf256::Inv (uint8_t a)
+{
+  return Div (1, a);
+}
+
+uint8_t
+AlFecGf256::Exp (unsigned int e)
+{
+  return GetTables ().exp[e % 255];
+}
+
+void
+AlFecGf256::MulAddRegion (uint8_t *dst, const uint8_t *src, uint8_t c, size_t len)
+{
+  if (c == 0)
+    {
+      return;
+    }
+  if (c == 1)
+    {
+      GetKernel ().xorRegion (dst, src, len);
+      return;
+    }
+  GetKernel ().mulAdd (dst, src, c, len);
+}
+
+void
+AlFecGf256::MulRegion (uint8_t *dst, const uint8_t *src, uint8_t c, size_t len)
+{
+  if (c == 0)
+    {
+      memset (dst, 0, len);
+      return;
+    }
+  if (c == 1)
+    {
+      memmove (dst, src, len);
+      return;
+    }
+  GetKernel ().mul (dst, src, c, len);
+}
+
+void
+AlFecGf256::XorRegion (uint8_t *dst, const uint8_t *src, size_t len)
+{
+  GetKernel ().xorRegion (dst, src, len);
+}
+
+void
+AlFecGf256::DotProductRegion (uint8_t *dst, const uint8_t *const *src, const uint8_t *c, size_t n,
+                              size_t len)
+{
+  GetKernel ().dotProduct (dst, src, c, n, 0, len);
+}
+
+bool
+AlFecGf256::InvertMatrix (uint8_t *matrix, size_t k)
+{
+  std::vector<uint8_t> inverse (k * k, 0);
+  for (size_t i = 0; i < k; i++)
+    {
+      inverse[i * k + i] = 1;
+    }
+
+  for (size_t col = 0; col < k; col++)
+    {
+      // Find the pivot
+      size_t pivot = col;
+      while (pivot < k && matrix[pivot * k + col] == 0)
+        {
+          pivot++;
+        }
+      if (pivot == k)
+        {
+          return false;
+        }
+      if (pivot != col)
+        {
+          std::swap_ranges (matrix + pivot * k, matrix + (pivot + 1) * k, matrix + col * k);
+          std::swap_ranges (inverse.begin () + pivot * k, inverse.begin () + (pivot + 1) * k,
+                            inverse.begin () + col * k);
+        }
+
+      // Normalize the pivot row
+      uint8_t scale = Inv (matrix[col * k + col]);
+      MulRegion (matrix + col * k, matrix + col * k, scale, k);
+      MulRegion (&inverse[col * k], &inverse[col * k], scale, k);
+
+      // Eliminate the column from every other row
+      for (size_t row = 0; row < k; row++)
+        {
+          uint8_t factor = matrix[row * k + col];
+          if (row == col || factor == 0)
+            {
+              continue;
+            }
+          MulAddRegion (matrix + row * k, matrix + col * k, factor, k);
+          MulAddRegion (&inverse[row * k], &inverse[col * k], factor, k);
+        }
+    }
+
+  memcpy (matrix, inverse.data (), k * k);
+  return true;
+}
+
+const char *
+AlFecGf256::GetKernelName ()
+{
+  return GetKernel ().name;
+}
+
+} // namespace ns3
@@ -0,0 +1,85 @@
+#ifndef AL_FEC_GF256_H
+#define AL_FEC_GF256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief Arithmetic over GF(2^8) shared by the native codecs.
+ *
+ * The field is generated by x^8 + x^4 + x^3 + x^2 + 1 (0x11d) with alpha = 2,
+ * which is the field OpenFEC uses for Reed-Solomon over GF(2^8). Codecs built
+ * on these routines are therefore interoperable with the OpenFEC codecs.
+ *
+ * The region kernels use the split-nibble technique: c * x is looked up as
+ * lo[x & 0xf] ^ hi[x >> 4] with two 16-entry tables, which maps onto a byte
+ * shuffle instruction. The widest kernel supported by the running CPU
+ * (AVX-512BW, AVX2, SSSE3 or the scalar fallback) is selected on first use.
+ */
+class AlFecGf256
+{
+public:
+  /**
+   * \brief Multiply two field elements
+   */
+  static uint8_t Mul (uint8_t a, uint8_t b);
+
+  /**
+   * \brief Divide a by b. b must not be zero.
+   */
+  static uint8_t Div (uint8_t a, uint8_t b);
+
+  /**
+   * \brief Get the multiplicative inverse of a. a must not be zero.
+   */
+  static uint8_t Inv (uint8_t a);
+
+  /**
+   * \brief Get alpha^e
+   */
+  static uint8_t Exp (unsigned int e);
+
+  /**
+   * \brief dst[i] ^= c * src[i] for i in [0, len)
+   */
+  static void MulAddRegion (uint8_t *dst, const uint8_t *src, uint8_t c, size_t len);
+
+  /**
+   * \brief dst[i] = c * src[i] for i in [0, len). dst may alias src.
+   */
+  static void MulRegion (uint8_t *dst, const uint8_t *src, uint8_t c, size_t len);
+
+  /**
+   * \brief dst[i] ^= src[i] for i in [0, len)
+   */
+  static void XorRegion (uint8_t *dst, const uint8_t *src, size_t len);
+
+  /**
+   * \brief dst[i] = sum of c[j] * src[j][i] for j in [0, n) and i in [0, len)
+   *
+   * The sum of each slice of dst is accumulated in registers over the n
+   * sources, so dst is written once instead of being read and written once
+   * per source as with MulAddRegion. dst must not alias a source.
+   */
+  static void DotProductRegion (uint8_t *dst, const uint8_t *const *src, const uint8_t *c,
+                                size_t n, size_t len);
+
+  /**
+   * \brief Invert a row-major k*k matrix in place with Gauss-Jordan elimination.
+   *
+   * \return false if the matrix is singular. The content of the matrix is
+   * unspecified in that case.
+   */
+  static bool InvertMatrix (uint8_t *matrix, size_t k);
+
+  /**
+   * \brief Get the name of the region kernel selected for this CPU
+   */
+  static const char *GetKernelName ();
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_GF256_H
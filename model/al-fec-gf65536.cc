@@ -0,0 +1,319 @@
+#include "ns3/al-fec-gf65536.h"
+#include "ns3/al-fec-gf256.h"
+#include "ns3/log.h"
+
+#include <string.h>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AL_FEC_GF65536_X86
+#endif
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecGf65536");
+
+namespace {
+
+const unsigned int kPrimitivePolynomial = 0x1002d; // x^16 + x^5 + x^3 + x^2 + 1
+const unsigned int kModulus = 65535; // Order of the multiplicative group
+
+struct Gf65536Tables
+{
+  std::vector<uint16_t> exp; // alpha^i, doubled so that exp[log a + log b] needs no modulo
+  std::vector<uint16_t> log; // log[0] is unused
+
+  Gf65536Tables () : exp (2 * kModulus + 1), log (kModulus + 1, 0)
+  {
+    unsigned int x = 1;
+    for (unsigned int i = 0; i < kModulus; i++)
+      {
+        exp[i] = x;
+        exp[i + kModulus] = x;
+        log[x] = i;
+        x <<= 1;
+        if (x & 0x10000)
+          {
+            x ^= kPrimitivePolynomial;
+          }
+      }
+    exp[2 * kModulus] = exp[0];
+  }
+};
+
+const Gf65536Tables &
+GetTables ()
+{
+  static const Gf65536Tables tables;
+  return tables;
+}
+
+/**
+ * Products of c with each value of each nibble of an element, split into
+ * their low and high bytes
+ */
+struct NibbleTables
+{
+  alignas (16) uint8_t lo[4][16];
+  alignas (16) uint8_t hi[4][16];
+
+  explicit NibbleTables (uint16_t c)
+  {
+    // c * x^j for each bit j of an element, then every sum of 4 of them
+    uint16_t bit[16];
+    uint32_t x = c;
+    for (int j = 0; j < 16; j++)
+      {
+        bit[j] = x;
+        x <<= 1;
+        if (x & 0x10000)
+          {
+            x ^= kPrimitivePolynomial;
+          }
+      }
+    for (int n = 0; n < 4; n++)
+      {
+        uint16_t product[16] = {0};
+        for (int v = 1; v < 16; v++)
+          {
+            int low = __builtin_ctz (v);
+            product[v] = product[v & (v - 1)] ^ bit[4 * n + low];
+          }
+        for (int v = 0; v < 16; v++)
+          {
+            lo[n][v] = product[v] & 0xff;
+            hi[n][v] = product[v] >> 8;
+          }
+      }
+  }
+};
+
+template <bool Accumulate>
+void
+MulRegionScalar (uint8_t *dst, const uint8_t *src, uint16_t c, size_t len)
+{
+  const Gf65536Tables &t = GetTables ();
+  unsigned int logC = t.log[c];
+  for (size_t block = 0; block < len; block += 64)
+    {
+      for (size_t i = block; i < block + 32; i++)
+        {
+          uint16_t x = src[i] | (src[i + 32] << 8);
+          uint16_t y = x ? t.exp[t.log[x] + logC] : 0;
+          if (Accumulate)
+            {
+              dst[i] ^= y & 0xff;
+              dst[i + 32] ^= y >> 8;
+            }
+          else
+            {
+              dst[i] = y & 0xff;
+              dst[i + 32] = y >> 8;
+            }
+        }
+    }
+}
+
+#ifdef AL_FEC_GF65536_X86
+
+template <bool Accumulate>
+__attribute__ ((target ("ssse3"))) void
+MulRegionSsse3 (uint8_t *dst, const uint8_t *src, uint16_t c, size_t len)
+{
+  NibbleTables t (c);
+  __m128i lo[4];
+  __m128i hi[4];
+  for (int n = 0; n < 4; n++)
+    {
+      lo[n] = _mm_load_si128 (reinterpret_cast<const __m128i *> (t.lo[n]));
+      hi[n] = _mm_load_si128 (reinterpret_cast<const __m128i *> (t.hi[n]));
+    }
+  const __m128i mask = _mm_set1_epi8 (0x0f);
+  for (size_t block = 0; block < len; block += 64)
+    {
+      // Two halves of 16 elements
+      for (size_t i = block; i < block + 32; i += 16)
+        {
+          __m128i xl = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (src + i));
+          __m128i xh = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (src + i + 32));
+          __m128i n0 = _mm_and_si128 (xl, mask);
+          __m128i n1 = _mm_and_si128 (_mm_srli_epi64 (xl, 4), mask);
+          __m128i n2 = _mm_and_si128 (xh, mask);
+          __m128i n3 = _mm_and_si128 (_mm_srli_epi64 (xh, 4), mask);
+          __m128i yl = _mm_xor_si128 (
+              _mm_xor_si128 (_mm_shuffle_epi8 (lo[0], n0), _mm_shuffle_epi8 (lo[1], n1)),
+              _mm_xor_si128 (_mm_shuffle_epi8 (lo[2], n2), _mm_shuffle_epi8 (lo[3], n3)));
+          __m128i yh = _mm_xor_si128 (
+              _mm_xor_si128 (_mm_shuffle_epi8 (hi[0], n0), _mm_shuffle_epi8 (hi[1], n1)),
+              _mm_xor_si128 (_mm_shuffle_epi8 (hi[2], n2), _mm_shuffle_epi8 (hi[3], n3)));
+          if (Accumulate)
+            {
+              yl = _mm_xor_si128 (
+                  yl, _mm_loadu_si128 (reinterpret_cast<const __m128i *> (dst + i)));
+              yh = _mm_xor_si128 (
+                  yh, _mm_loadu_si128 (reinterpret_cast<const __m128i *> (dst + i + 32)));
+            }
+          _mm_storeu_si128 (reinterpret_cast<__m128i *> (dst + i), yl);
+          _mm_storeu_si128 (reinterpret_cast<__m128i *> (dst + i + 32), yh);
+        }
+    }
+}
+
+template <bool Accumulate>
+__attribute__ ((target ("avx2"))) void
+MulRegionAvx2 (uint8_t *dst, const uint8_t *src, uint16_t c, size_t len)
+{
+  NibbleTables t (c);
+  __m256i lo[4];
+  __m256i hi[4];
+  for (int n = 0; n < 4; n++)
+    {
+      lo[n] = _mm256_broadcastsi128_si256 (
+          _mm_load_si128 (reinterpret_cast<const __m128i *> (t.lo[n])));
+      hi[n] = _mm256_broadcastsi128_si256 (
+          _mm_load_si128 (reinterpret_cast<const __m128i *> (t.hi[n])));
+    }
+  const __m256i mask = _mm256_set1_epi8 (0x0f);
+  for (size_t i = 0; i < len; i += 64)
+    {
+      __m256i xl = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (src + i));
+      __m256i xh = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (src + i + 32));
+      __m256i n0 = _mm256_and_si256 (xl, mask);
+      __m256i n1 = _mm256_and_si256 (_mm256_srli_epi64 (xl, 4), mask);
+      __m256i n2 = _mm256_and_si256 (xh, mask);
+      __m256i n3 = _mm256_and_si256 (_mm256_srli_epi64 (xh, 4), mask);
+      __m256i yl = _mm256_xor_si256 (
+          _mm256_xor_si256 (_mm256_shuffle_epi8 (lo[0], n0), _mm256_shuffle_epi8 (lo[1], n1)),
+          _mm256_xor_si256 (_mm256_shuffle_epi8 (lo[2], n2), _mm256_shuffle_epi8 (lo[3], n3)));
+      __m256i yh = _mm256_xor_si256 (
+          _mm256_xor_si256 (_mm256_shuffle_epi8 (hi[0], n0), _mm256_shuffle_epi8 (hi[1], n1)),
+          _mm256_xor_si256 (_mm256_shuffle_epi8 (hi[2], n2), _mm256_shuffle_epi8 (hi[3], n3)));
+      if (Accumulate)
+        {
+          yl = _mm256_xor_si256 (yl,
+                                 _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (dst + i)));
+          yh = _mm256_xor_si256 (
+              yh, _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (dst + i + 32)));
+        }
+      _mm256_storeu_si256 (reinterpret_cast<__m256i *> (dst + i), yl);
+      _mm256_storeu_si256 (reinterpret_cast<__m256i *> (dst + i + 32), yh);
+    }
+}
+
+#endif // AL_FEC_GF65536_X86
+
+struct Gf65536Kernel
+{
+  const char *name;
+  void (*mulAdd) (uint8_t *, const uint8_t *, uint16_t, size_t);
+  void (*mul) (uint8_t *, const uint8_t *, uint16_t, size_t);
+};
+
+Gf65536Kernel
+SelectKernel ()
+{
+#ifdef AL_FEC_GF65536_X86
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+    {
+      return {"avx2", MulRegionAvx2<true>, MulRegionAvx2<false>};
+    }
+  if (__builtin_cpu_supports ("ssse3"))
+    {
+      return {"ssse3", MulRegionSsse3<true>, MulRegionSsse3<false>};
+    }
+#endif
+  return {"scalar", MulRegionScalar<true>, MulRegionScalar<false>};
+}
+
+const Gf65536Kernel &
+GetKernel ()
+{
+  static const Gf65536Kernel kernel = SelectKernel ();
+  return kernel;
+}
+
+} // namespace
+
+uint16_t
+AlFecGf65536::Mul (uint16_t a, uint16_t b)
+{
+  if (a == 0 || b == 0)
+    {
+      return 0;
+    }
+  const Gf65536Tables &t = GetTables ();
+  return t.exp[t.log[a] + t.log[b]];
+}
+
+uint16_t
+AlFecGf65536::Div (uint16_t a, uint16_t b)
+{
+  NS_ASSERT_MSG (b != 0, "Division by zero in GF(2^16)");
+  if (a == 0)
+    {
+      return 0;
+    }
+  const Gf65536Tables &t = GetTables ();
+  return t.exp[t.log[a] + kModulus - t.log[b]];
+}
+
+uint16_t
+AlFecGf65536::Inv (uint16_t a)
+{
+  return Div (1, a);
+}
+
+uint16_t
+AlFecGf65536::Exp (unsigned int e)
+{
+  return GetTables ().exp[e % kModulus];
+}
+
+uint16_t
+AlFecGf65536::Log (uint16_t a)
+{
+  NS_ASSERT_MSG (a != 0, "Logarithm of zero in GF(2^16)");
+  return GetTables ().log[a];
+}
+
+void
+AlFecGf65536::MulAddRegion (uint8_t *dst, const uint8_t *src, uint16_t c, size_t len)
+{
+  NS_ASSERT_MSG (len % REGION_ALIGNMENT == 0, "Region length must be a multiple of 64");
+  if (c == 0)
+    {
+      return;
+    }
+  if (c == 1)
+    {
+      AlFecGf256::XorRegion (dst, src, len);
+      return;
+    }
+  GetKernel ().mulAdd (dst, src, c, len);
+}
+
+void
+AlFecGf65536::MulRegion (uint8_t *dst, const uint8_t *src, uint16_t c, size_t len)
+{
+  NS_ASSERT_MSG (len % REGION_ALIGNMENT == 0, "Region length must be a multiple of 64");
+  if (c == 0)
+    {
+      memset (dst, 0, len);
+      return;
+    }
+  if (c == 1)
+    {
+      memmove (dst, src, len);
+      return;
+    }
+  GetKernel ().mul (dst, src, c, len);
+}
+
+const char *
+AlFecGf65536::GetKernelName ()
+{
+  return GetKernel ().name;
+}
+
+} // namespace ns3
@@ -0,0 +1,71 @@
+#ifndef AL_FEC_GF65536_H
+#define AL_FEC_GF65536_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief Arithmetic over GF(2^16) for the FFT Reed-Solomon codec.
+ *
+ * The field is generated by x^16 + x^5 + x^3 + x^2 + 1 (0x1002d) with
+ * alpha = 2. The elements of a region are laid out in blocks of 64 bytes:
+ * the first 32 bytes hold the low bytes of 32 elements and the next 32
+ * bytes their high bytes, so the region lengths must be multiples of 64.
+ *
+ * The region kernels extend the split-nibble technique of AlFecGf256 to the
+ * four nibbles of an element, with a 16-entry table per nibble and per
+ * output byte. The widest kernel supported by the running CPU (AVX2, SSSE3
+ * or the scalar fallback) is selected on first use. All the kernels give the
+ * same bytes.
+ */
+class AlFecGf65536
+{
+public:
+  static const size_t REGION_ALIGNMENT = 64; // Region lengths are multiples of it
+
+  /**
+   * \brief Multiply two field elements
+   */
+  static uint16_t Mul (uint16_t a, uint16_t b);
+
+  /**
+   * \brief Divide a by b. b must not be zero.
+   */
+  static uint16_t Div (uint16_t a, uint16_t b);
+
+  /**
+   * \brief Get the multiplicative inverse of a. a must not be zero.
+   */
+  static uint16_t Inv (uint16_t a);
+
+  /**
+   * \brief Get alpha^e
+   */
+  static uint16_t Exp (unsigned int e);
+
+  /**
+   * \brief Get the discrete logarithm of a. a must not be zero.
+   */
+  static uint16_t Log (uint16_t a);
+
+  /**
+   * \brief dst[i] ^= c * src[i] for the len / 2 elements of the regions
+   */
+  static void MulAddRegion (uint8_t *dst, const uint8_t *src, uint16_t c, size_t len);
+
+  /**
+   * \brief dst[i] = c * src[i] for the len / 2 elements of the regions. dst may alias src.
+   */
+  static void MulRegion (uint8_t *dst, const uint8_t *src, uint16_t c, size_t len);
+
+  /**
+   * \brief Get the name of the region kernel selected for this CPU
+   */
+  static const char *GetKernelName ();
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_GF65536_H
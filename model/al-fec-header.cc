@@ -10,39 +10,52 @@ NS_LOG_COMPONENT_DEFINE ("AlFecHeader");
 
 NS_OBJECT_ENSURE_REGISTERED (EncodeHeader);
 
-EncodeHeader::EncodeHeader () : m_esi (0) //, m_sn (0)
+EncodeHeader::EncodeHeader () : m_sn (0), m_sbn (0), m_esi (0)
 {
 }
 
 EncodeHeader::~EncodeHeader ()
 {
+  m_sbn = 0;
   m_esi = 0;
-  // m_sn = 0;
+  m_sn = 0;
 }
 
 void
-EncodeHeader::SetEncodedSymbolId (uint8_t esi)
+EncodeHeader::SetSourceBlockNumber (uint16_t sbn)
+{
+  m_sbn = sbn;
+}
+
+uint16_t
+EncodeHeader::GetSourceBlockNumber () const
+{
+  return m_sbn;
+}
+
+void
+EncodeHeader::SetEncodedSymbolId (uint16_t esi)
 {
   m_esi = esi;
 }
 
-uint8_t
+uint16_t
 EncodeHeader::GetEncodedSymbolId () const
 {
   return m_esi;
 }
 
-// void
-// PayloadHeader::SetSequenceNumber (uint16_t sn)
-// {
-//   m_sn = sn;
-// }
+void
+EncodeHeader::SetSequenceNumber (uint16_t sn)
+{
+  m_sn = sn;
+}
 
-// uint16_t
-// PayloadHeader::GetSequenceNumber () const
-// {
-//   return m_sn;
-// }
+uint16_t
+EncodeHeader::GetSequenceNumber () const
+{
+  return m_sn;
+}
 
 TypeId
 EncodeHeader::GetTypeId (void)
@@ -62,15 +75,13 @@ EncodeHeader::GetInstanceTypeId (void) const
 void
 EncodeHeader::Print (std::ostream &os) const
 {
-  // os << "SN=" << (int) m_sn;
-
-  os << "ESI=" << (int) m_esi;
+  os << "SN=" << (int) m_sn << " SBN=" << (int) m_sbn << " ESI=" << (int) m_esi;
 }
 
 uint32_t
 EncodeHeader::GetSerializedSize (void) const
 {
-  return sizeof(m_esi); //+ sizeof(m_sn)
+  return sizeof(m_sn) + sizeof(m_sbn) + sizeof(m_esi);
 }
 
 void
@@ -78,7 +89,8 @@ EncodeHeader::Serialize (Buffer::Iterator start) const
 {
   Buffer::Iterator i = start;
 
-  // i.WriteHtonU16 (m_sn);
+  i.WriteHtonU16 (m_sn);
+  i.WriteHtonU16 (m_sbn);
   i.WriteHtonU16 (m_esi);
 }
 
@@ -87,7 +99,8 @@ EncodeHeader::Deserialize (Buffer::Iterator start)
 {
   Buffer::Iterator i = start;
 
-  // m_sn = i.ReadNtohU16 ();
+  m_sn = i.ReadNtohU16 ();
+  m_sbn = i.ReadNtohU16 ();
   m_esi = i.ReadNtohU16 ();
 
   return GetSerializedSize ();
@@ -109,12 +122,12 @@ PayloadHeader::~PayloadHeader ()
 }
 
 void
-PayloadHeader::SetPaddingSize (uint8_t size)
+PayloadHeader::SetPaddingSize (uint16_t size)
 {
   m_paddingSize = size;
 }
 
-uint8_t
+uint16_t
 PayloadHeader::GetPaddingSize () const
 {
   return m_paddingSize;
@@ -138,7 +151,7 @@ PayloadHeader::GetInstanceTypeId (void) const
 void
 PayloadHeader::Print (std::ostream &os) const
 {
-  os << "PaddingSize=" << (int) m_paddingSize;
+  os << "PaddingSize=" << m_paddingSize;
 }
 
 uint32_t
@@ -152,7 +165,7 @@ PayloadHeader::Serialize (Buffer::Iterator start) const
 {
   Buffer::Iterator i = start;
 
-  i.WriteU8 (m_paddingSize);
+  i.WriteHtonU16 (m_paddingSize);
 }
 
 uint32_t
@@ -160,7 +173,116 @@ PayloadHeader::Deserialize (Buffer::Iterator start)
 {
   Buffer::Iterator i = start;
 
-  m_paddingSize = i.ReadU8 ();
+  m_paddingSize = i.ReadNtohU16 ();
+
+  return GetSerializedSize ();
+}
+
+/*=======================*
+ *  SlidingWindowHeader  *
+ *=======================*/
+
+NS_OBJECT_ENSURE_REGISTERED (SlidingWindowHeader);
+
+SlidingWindowHeader::SlidingWindowHeader () : m_esi (0), m_repairKey (0), m_nbSourceSymbols (0)
+{
+}
+
+SlidingWindowHeader::~SlidingWindowHeader ()
+{
+}
+
+void
+SlidingWindowHeader::SetEncodedSymbolId (uint32_t esi)
+{
+  m_esi = esi;
+}
+
+uint32_t
+SlidingWindowHeader::GetEncodedSymbolId () const
+{
+  return m_esi;
+}
+
+void
+SlidingWindowHeader::SetRepairKey (uint16_t repairKey)
+{
+  m_repairKey = repairKey;
+}
+
+uint16_t
+SlidingWindowHeader::GetRepairKey () const
+{
+  return m_repairKey;
+}
+
+void
+SlidingWindowHeader::SetNbSourceSymbols (uint16_t nbSourceSymbols)
+{
+  m_nbSourceSymbols = nbSourceSymbols;
+}
+
+uint16_t
+SlidingWindowHeader::GetNbSourceSymbols () const
+{
+  return m_nbSourceSymbols;
+}
+
+bool
+SlidingWindowHeader::IsRepair () const
+{
+  return m_nbSourceSymbols > 0;
+}
+
+TypeId
+SlidingWindowHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AlFecHeader::SlidingWindowHeader")
+                          .SetParent<Header> ()
+                          .AddConstructor<SlidingWindowHeader> ();
+  return tid;
+}
+
+TypeId
+SlidingWindowHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+SlidingWindowHeader::Print (std::ostream &os) const
+{
+  os << "ESI=" << m_esi;
+  if (IsRepair ())
+    {
+      os << " RepairKey=" << m_repairKey << " NSS=" << m_nbSourceSymbols;
+    }
+}
+
+uint32_t
+SlidingWindowHeader::GetSerializedSize (void) const
+{
+  return sizeof(m_esi) + sizeof(m_repairKey) + sizeof(m_nbSourceSymbols);
+}
+
+void
+SlidingWindowHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+
+  i.WriteHtonU32 (m_esi);
+  i.WriteHtonU16 (m_repairKey);
+  i.WriteHtonU16 (m_nbSourceSymbols);
+}
+
+uint32_t
+SlidingWindowHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+
+  m_esi = i.ReadNtohU32 ();
+  m_repairKey = i.ReadNtohU16 ();
+  m_nbSourceSymbols = i.ReadNtohU16 ();
 
   return GetSerializedSize ();
 }
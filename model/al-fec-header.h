@@ -23,28 +23,42 @@ public:
    *
    * \param esi ESI to set
    */
-  void SetEncodedSymbolId (uint8_t esi);
+  void SetEncodedSymbolId (uint16_t esi);
 
   /**
-   * \brief Set Sequence Number
+   * \brief Set Source Block Number (SBN)
+   *
+   * \param sbn SBN to set
+   */
+  void SetSourceBlockNumber (uint16_t sbn);
+
+  /**
+   * \brief Set Sequence Number of source block
    *
    * \param sn Sequence Number to set
    */
-  // void SetSequenceNumber (uint16_t sn);
+  void SetSequenceNumber (uint16_t sn);
 
   /**
    * \brief Get Encoded Symbol ID (ESI)
    *
    * \returns ESI
    */
-  uint8_t GetEncodedSymbolId () const;
+  uint16_t GetEncodedSymbolId () const;
+
+  /**
+   * \brief Get Source Block Number (SBN)
+   *
+   * \returns SBN
+   */
+  uint16_t GetSourceBlockNumber () const;
 
   /**
    * \brief Get the Sequence Number of source block
    *
    * \returns The Sequence Number of source block
    */
-  // uint16_t GetSequenceNumber () const;
+  uint16_t GetSequenceNumber () const;
 
   /**
    * \brief Get the type ID.
@@ -58,9 +72,10 @@ public:
   virtual uint32_t Deserialize (Buffer::Iterator start);
 
 private:
+  uint16_t m_sn; // Sequence number of the source block
+  uint16_t m_sbn; // Source block number within the packet
   uint16_t m_esi; // Encoded symbol id
   // uint16_t m_k; // Number of the source symbol
-  // uint16_t m_sn; // Sequence number of source packet
 };
 
 class PayloadHeader : public Header
@@ -79,14 +94,72 @@ public:
    *
    * \param size the size of source packet padding to set
    */
-  void SetPaddingSize (uint8_t paddingSize);
+  void SetPaddingSize (uint16_t paddingSize);
 
   /**
    * \brief Get the size of source packet padding
    *
    * \returns The the size of source packet padding
    */
-  uint8_t GetPaddingSize () const;
+  uint16_t GetPaddingSize () const;
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  uint16_t m_paddingSize; // The size of source packet padding, less than the symbol size
+};
+
+/**
+ * \brief FEC payload ID of the sliding window codec, after RFC 8681.
+ *
+ * A source symbol only carries its ESI. A repair symbol carries the ESI of
+ * the first source symbol of its window, the number of source symbols of
+ * the window, and the repair key of its coefficients. A window of zero
+ * source symbols marks a source symbol.
+ */
+class SlidingWindowHeader : public Header
+{
+public:
+  /**
+   * \brief Constructor
+   *
+   * Creates the header of the source symbol with ESI 0
+   */
+  SlidingWindowHeader ();
+  ~SlidingWindowHeader ();
+
+  /**
+   * \brief Set the ESI of a source symbol, or of the first source symbol of
+   * the window of a repair symbol
+   */
+  void SetEncodedSymbolId (uint32_t esi);
+  uint32_t GetEncodedSymbolId () const;
+
+  /**
+   * \brief Set the repair key of a repair symbol
+   */
+  void SetRepairKey (uint16_t repairKey);
+  uint16_t GetRepairKey () const;
+
+  /**
+   * \brief Set the number of source symbols of the window. 0 for a source symbol.
+   */
+  void SetNbSourceSymbols (uint16_t nbSourceSymbols);
+  uint16_t GetNbSourceSymbols () const;
+
+  /**
+   * \brief Whether the header is the one of a repair symbol
+   */
+  bool IsRepair () const;
 
   /**
    * \brief Get the type ID.
@@ -100,7 +173,9 @@ public:
   virtual uint32_t Deserialize (Buffer::Iterator start);
 
 private:
-  uint8_t m_paddingSize; // The size of source packet padding
+  uint32_t m_esi; // ESI of the source symbol, or of the first source symbol of the window
+  uint16_t m_repairKey; // Seed of the coefficients of a repair symbol
+  uint16_t m_nbSourceSymbols; // Number of source symbols of the window, 0 for a source symbol
 };
 
 } // namespace ns3::AlFecHeader
@@ -8,22 +8,28 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("AlFecInfoTag");
 
-AlFecInfoTag::AlFecInfoTag () : m_k (0), m_packetContext (Buffer ())
+AlFecInfoTag::AlFecInfoTag ()
+    : m_k (0),
+      m_nbBlocks (1),
+      m_symbolSize (0),
+      m_aggregated (0),
+      m_directPacket (0),
+      m_contextHandle (0)
 {
   NS_LOG_FUNCTION (this);
 }
 
 void
-AlFecInfoTag::SetPacketContext (Buffer context)
+AlFecInfoTag::SetContextHandle (uint32_t handle)
 {
-
-  m_packetContext = context;
+  NS_LOG_FUNCTION (this << handle);
+  m_contextHandle = handle;
 }
 
-Buffer
-AlFecInfoTag::GetPacketContext ()
+uint32_t
+AlFecInfoTag::GetContextHandle () const
 {
-  return m_packetContext;
+  return m_contextHandle;
 }
 
 void
@@ -40,18 +46,57 @@ AlFecInfoTag::GetK () const
 }
 
 void
-AlFecInfoTag::SetSymbolSize (uint8_t symbolSize)
+AlFecInfoTag::SetNbSourceBlocks (uint16_t nbBlocks)
+{
+  NS_LOG_FUNCTION (this << nbBlocks);
+  m_nbBlocks = nbBlocks;
+}
+
+uint16_t
+AlFecInfoTag::GetNbSourceBlocks () const
+{
+  return m_nbBlocks;
+}
+
+void
+AlFecInfoTag::SetSymbolSize (uint16_t symbolSize)
 {
   NS_LOG_FUNCTION (this << symbolSize);
   m_symbolSize = symbolSize;
 }
 
-uint8_t
+uint16_t
 AlFecInfoTag::GetSymbolSize () const
 {
   return m_symbolSize;
 }
 
+void
+AlFecInfoTag::SetAggregated (bool aggregated)
+{
+  NS_LOG_FUNCTION (this << aggregated);
+  m_aggregated = aggregated;
+}
+
+bool
+AlFecInfoTag::IsAggregated () const
+{
+  return m_aggregated;
+}
+
+void
+AlFecInfoTag::SetDirectPacket (bool directPacket)
+{
+  NS_LOG_FUNCTION (this << directPacket);
+  m_directPacket = directPacket;
+}
+
+bool
+AlFecInfoTag::IsDirectPacket () const
+{
+  return m_directPacket;
+}
+
 TypeId
 AlFecInfoTag::GetTypeId (void)
 {
@@ -70,46 +115,43 @@ uint32_t
 AlFecInfoTag::GetSerializedSize (void) const
 {
   NS_LOG_FUNCTION (this);
-  return sizeof (m_k) + sizeof (m_symbolSize) + sizeof (uint32_t) + m_packetContext.GetSize ();
+  return sizeof (m_k) + sizeof (m_nbBlocks) + sizeof (m_symbolSize) + sizeof (m_aggregated) +
+         sizeof (m_directPacket) + sizeof (m_contextHandle);
 }
 void
 AlFecInfoTag::Serialize (TagBuffer i) const
 {
   NS_LOG_FUNCTION (this << &i);
 
-  uint32_t packetContextSize = m_packetContext.GetSize ();
-
   i.WriteU16 (m_k);
-  i.WriteU8 (m_symbolSize);
-  i.WriteU32 (packetContextSize);
-  i.Write (m_packetContext.PeekData (), packetContextSize);
+  i.WriteU16 (m_nbBlocks);
+  i.WriteU16 (m_symbolSize);
+  i.WriteU8 (m_aggregated);
+  i.WriteU8 (m_directPacket);
+  i.WriteU32 (m_contextHandle);
 }
 void
 AlFecInfoTag::Deserialize (TagBuffer i)
 {
   NS_LOG_FUNCTION (this << &i);
 
-  uint32_t packetContextSize;
-  uint8_t *buf;
   m_k = i.ReadU16 ();
-  m_symbolSize = i.ReadU8 ();
-  packetContextSize = i.ReadU32 ();
-  m_packetContext = Buffer ();
-  m_packetContext.AddAtStart (packetContextSize);
-
-  buf = new uint8_t[packetContextSize];
-  i.Read (buf, packetContextSize);
-  m_packetContext.Begin ().Write (buf, packetContextSize);
-
-  delete[] buf;
+  m_nbBlocks = i.ReadU16 ();
+  m_symbolSize = i.ReadU16 ();
+  m_aggregated = i.ReadU8 ();
+  m_directPacket = i.ReadU8 ();
+  m_contextHandle = i.ReadU32 ();
 }
 void
 AlFecInfoTag::Print (std::ostream &os) const
 {
   NS_LOG_FUNCTION (this << &os);
   os << "AlFecInfoTag [K=" << (int) m_k;
+  os << ", Source blocks:" << (int) m_nbBlocks;
   os << ", Symbol size:" << (int) m_symbolSize;
-  os << ", Size of packet context:" << (int) m_packetContext.GetSize ();
+  os << ", Aggregated:" << (int) m_aggregated;
+  os << ", Direct packet:" << (int) m_directPacket;
+  os << ", Context handle:" << m_contextHandle;
   os << "] ";
 }
 } // namespace ns3
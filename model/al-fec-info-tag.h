@@ -7,10 +7,8 @@
 
 namespace ns3 {
 /**
- * \brief Stores all the context of the original packet except the content buffer.
- * 
- * \warning The implementation follows the ns3::Packet.
- * If the serialization order is changed, this module won't work correctly.
+ * \brief Stores the parameters of the source block of an encoded symbol, and
+ * the handle of the context of the original packet in AlFecPacketContextStore.
 */
 class AlFecInfoTag : public Tag
 {
@@ -23,9 +21,19 @@ public:
   virtual void Print (std::ostream &os) const;
   AlFecInfoTag ();
 
-  void SetPacketContext (Buffer context);
+  /**
+   * \brief Set the handle of the context of the original packet
+   *
+   * \param handle The handle returned by AlFecPacketContextStore::Insert
+   */
+  void SetContextHandle (uint32_t handle);
 
-  Buffer GetPacketContext ();
+  /**
+   * \brief Get the handle of the context of the original packet
+   *
+   * \returns The handle to look up in AlFecPacketContextStore
+   */
+  uint32_t GetContextHandle () const;
 
   /**
    * \brief Set the number of source symbol
@@ -41,13 +49,71 @@ public:
    */
   uint16_t GetK () const;
 
-  void SetSymbolSize (uint8_t symbolSize);
-  uint8_t GetSymbolSize () const;
+  /**
+   * \brief Set the number of source blocks the original packet is split into
+   *
+   * \param nbBlocks The number of source blocks
+   */
+  void SetNbSourceBlocks (uint16_t nbBlocks);
+
+  /**
+   * \brief Get the number of source blocks the original packet is split into
+   *
+   * \returns The number of source blocks
+   */
+  uint16_t GetNbSourceBlocks () const;
+
+  /**
+   * \brief Set whether the source block aggregates several packets, each
+   * prefixed by its length and carrying its own context
+   *
+   * \param aggregated Whether the source block aggregates several packets
+   */
+  void SetAggregated (bool aggregated);
+
+  /**
+   * \brief Get whether the source block aggregates several packets
+   *
+   * \returns Whether the source block aggregates several packets
+   */
+  bool IsAggregated () const;
+
+  /**
+   * \brief Set whether the source packet was copied, its context being
+   * captured by AlFecPacketContextStore::Capture, instead of serialized
+   *
+   * \param directPacket Whether the source packet was copied
+   */
+  void SetDirectPacket (bool directPacket);
+
+  /**
+   * \brief Get whether the source packet was copied instead of serialized
+   *
+   * \returns Whether the source packet was copied
+   */
+  bool IsDirectPacket () const;
+
+  /**
+   * \brief Set the symbol size of the source block
+   *
+   * \param symbolSize The symbol size in bytes
+   */
+  void SetSymbolSize (uint16_t symbolSize);
+
+  /**
+   * \brief Get the symbol size of the source block
+   *
+   * \returns The symbol size in bytes
+   */
+  uint16_t GetSymbolSize () const;
 
 private:
   uint16_t m_k; // Number of the source symbol
-  uint8_t m_symbolSize; // Symbol size
-  Buffer m_packetContext;
+  uint16_t m_nbBlocks; // Number of source blocks of the original packet
+  uint16_t m_symbolSize; // Symbol size
+  uint8_t m_aggregated; // Whether the source block aggregates several packets
+  uint8_t m_directPacket; // Whether the source packet was copied instead of serialized
+  uint32_t m_contextHandle; // Handle of the context of the original packet
 };
 
 inline std::ostream &
@@ -0,0 +1,153 @@
+#include "ns3/al-fec-matrix-cache.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecMatrixCache");
+
+AlFecMatrixCache &
+AlFecMatrixCache::Get ()
+{
+  static AlFecMatrixCache cache;
+  return cache;
+}
+
+AlFecMatrixCache::AlFecMatrixCache () : m_memoryLimit (16 * 1024 * 1024)
+{
+}
+
+std::string
+AlFecMatrixCache::MakeKey (char kind, const std::string &family, uint32_t m, uint32_t k,
+                           uint32_t n)
+{
+  std::string key;
+  key.reserve (family.size () + 2 + 3 * sizeof (uint32_t));
+  key.push_back (kind);
+  key.append (family);
+  key.push_back ('\0');
+  key.append (reinterpret_cast<const char *> (&m), sizeof (m));
+  key.append (reinterpret_cast<const char *> (&k), sizeof (k));
+  key.append (reinterpret_cast<const char *> (&n), sizeof (n));
+  return key;
+}
+
+AlFecMatrixCache::Matrix
+AlFecMatrixCache::GetGenerator (const std::string &family, uint32_t m, uint32_t k, uint32_t n,
+                                const Builder &build)
+{
+  auto result = Lookup (MakeKey ('G', family, m, k, n), build);
+  std::lock_guard<std::mutex> lock (m_mutex);
+  result.second ? m_stats.generatorHits++ : m_stats.generatorMisses++;
+  return result.first;
+}
+
+AlFecMatrixCache::Matrix
+AlFecMatrixCache::GetInverse (const std::string &family, uint32_t m, uint32_t k, uint32_t n,
+                              const std::vector<unsigned int> &esis, const Builder &build)
+{
+  // The erasure pattern is stored as a bitmap of the used ESIs
+  std::string key = MakeKey ('I', family, m, k, n);
+  size_t offset = key.size ();
+  key.resize (offset + (n + 7) / 8, '\0');
+  for (size_t i = 0; i < esis.size (); i++)
+    {
+      NS_ASSERT (esis[i] < n && (i == 0 || esis[i - 1] < esis[i]));
+      key[offset + esis[i] / 8] |= 1 << (esis[i] % 8);
+    }
+  auto result = Lookup (key, build);
+  std::lock_guard<std::mutex> lock (m_mutex);
+  result.second ? m_stats.inverseHits++ : m_stats.inverseMisses++;
+  return result.first;
+}
+
+std::pair<AlFecMatrixCache::Matrix, bool>
+AlFecMatrixCache::Lookup (const std::string &key, const Builder &build)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  auto it = m_index.find (key);
+  if (it != m_index.end ())
+    {
+      m_entries.splice (m_entries.begin (), m_entries, it->second);
+      return std::make_pair (it->second->matrix, true);
+    }
+
+  // Other threads may use the cache meanwhile, and build the same matrix
+  lock.unlock ();
+  Matrix matrix = std::make_shared<const std::vector<uint8_t>> (build ());
+  lock.lock ();
+  it = m_index.find (key);
+  if (it != m_index.end ())
+    {
+      m_entries.splice (m_entries.begin (), m_entries, it->second);
+      return std::make_pair (it->second->matrix, false);
+    }
+  size_t size = key.size () + matrix->size ();
+  if (size > m_memoryLimit)
+    {
+      return std::make_pair (matrix, false);
+    }
+  m_entries.push_front ({key, matrix});
+  m_index.emplace (key, m_entries.begin ());
+  m_stats.memoryUsage += size;
+  m_stats.entries++;
+  Trim ();
+  return std::make_pair (matrix, false);
+}
+
+void
+AlFecMatrixCache::Trim ()
+{
+  while (m_stats.memoryUsage > m_memoryLimit && !m_entries.empty ())
+    {
+      const Entry &victim = m_entries.back ();
+      NS_LOG_LOGIC ("Evict matrix of " << victim.matrix->size () << " bytes");
+      m_stats.memoryUsage -= victim.key.size () + victim.matrix->size ();
+      m_stats.entries--;
+      m_stats.evictions++;
+      m_index.erase (victim.key);
+      m_entries.pop_back ();
+    }
+}
+
+void
+AlFecMatrixCache::SetMemoryLimit (size_t bytes)
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_memoryLimit = bytes;
+  Trim ();
+}
+
+size_t
+AlFecMatrixCache::GetMemoryLimit () const
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return m_memoryLimit;
+}
+
+AlFecMatrixCache::Stats
+AlFecMatrixCache::GetStats () const
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return m_stats;
+}
+
+void
+AlFecMatrixCache::ResetStats ()
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  Stats stats;
+  stats.memoryUsage = m_stats.memoryUsage;
+  stats.entries = m_stats.entries;
+  m_stats = stats;
+}
+
+void
+AlFecMatrixCache::Clear ()
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_entries.clear ();
+  m_index.clear ();
+  m_stats.memoryUsage = 0;
+  m_stats.entries = 0;
+}
+
+} // namespace ns3
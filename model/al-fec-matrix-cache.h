@@ -0,0 +1,124 @@
+#ifndef AL_FEC_MATRIX_CACHE_H
+#define AL_FEC_MATRIX_CACHE_H
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief Process-wide LRU cache of the matrices used by the codecs.
+ *
+ * Generator matrices are keyed by the code family and (m, k, n). Decoding
+ * matrices (the inverse of the generator rows of the used symbols) are
+ * additionally keyed by the bitmap of the ESIs they were built from, since
+ * the same erasure patterns repeat constantly in simulations.
+ *
+ * The matrices are shared: an entry evicted while a codec still uses it stays
+ * alive until the codec drops it. The total size of the cached matrices is
+ * kept under GetMemoryLimit () by evicting the least recently used entries.
+ * The cache may be used from several threads; the matrices are built
+ * outside of its lock.
+ */
+class AlFecMatrixCache
+{
+public:
+  typedef std::shared_ptr<const std::vector<uint8_t>> Matrix;
+  typedef std::function<std::vector<uint8_t> ()> Builder;
+
+  /**
+   * \brief Hit and miss counters
+   */
+  struct Stats
+  {
+    size_t generatorHits = 0;
+    size_t generatorMisses = 0;
+    size_t inverseHits = 0;
+    size_t inverseMisses = 0;
+    size_t evictions = 0;
+    size_t memoryUsage = 0; // Bytes held by the cache
+    size_t entries = 0;
+  };
+
+  /**
+   * \brief Get the cache shared by all the codecs of the process
+   */
+  static AlFecMatrixCache &Get ();
+
+  /**
+   * \brief Get a generator matrix, building it on a miss
+   *
+   * \param family Identifies the code, e.g. the TypeId name of the codec
+   * \param m The field is GF(2^m)
+   * \param k Number of source symbols
+   * \param n Number of encoded symbols
+   * \param build Called to build the matrix on a miss
+   */
+  Matrix GetGenerator (const std::string &family, uint32_t m, uint32_t k, uint32_t n,
+                       const Builder &build);
+
+  /**
+   * \brief Get a decoding matrix, building it on a miss
+   *
+   * \param esis The ESIs of the symbols the matrix is built from, in
+   * increasing order
+   */
+  Matrix GetInverse (const std::string &family, uint32_t m, uint32_t k, uint32_t n,
+                     const std::vector<unsigned int> &esis, const Builder &build);
+
+  /**
+   * \brief Set the maximum number of bytes held by the cache. 0 disables caching.
+   */
+  void SetMemoryLimit (size_t bytes);
+  size_t GetMemoryLimit () const;
+
+  Stats GetStats () const;
+  void ResetStats ();
+
+  /**
+   * \brief Drop every entry
+   */
+  void Clear ();
+
+private:
+  struct Entry
+  {
+    std::string key;
+    Matrix matrix;
+  };
+
+  AlFecMatrixCache ();
+
+  /**
+   * \brief Look up a key, building and inserting the matrix on a miss
+   *
+   * \return The matrix, and whether it was a hit
+   */
+  std::pair<Matrix, bool> Lookup (const std::string &key, const Builder &build);
+
+  /**
+   * \brief Evict the least recently used entries until the limit is honored.
+   * m_mutex must be held.
+   */
+  void Trim ();
+
+  static std::string MakeKey (char kind, const std::string &family, uint32_t m, uint32_t k,
+                              uint32_t n);
+
+  mutable std::mutex m_mutex; // Protects the members below
+  std::list<Entry> m_entries; // Most recently used first
+  std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+  size_t m_memoryLimit;
+  Stats m_stats;
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_MATRIX_CACHE_H
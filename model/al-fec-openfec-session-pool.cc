@@ -0,0 +1,125 @@
+#include "ns3/al-fec-openfec-session-pool.h"
+#include "ns3/log.h"
+
+#define VERBOSITY 2
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecOpenfecSessionPool");
+
+bool
+AlFecOpenfecSessionPool::Key::operator== (const Key &other) const
+{
+  return codecId == other.codecId && k == other.k && n == other.n &&
+         symbolSize == other.symbolSize && m == other.m && seed == other.seed;
+}
+
+AlFecOpenfecSessionPool &
+AlFecOpenfecSessionPool::Get ()
+{
+  static AlFecOpenfecSessionPool pool;
+  return pool;
+}
+
+AlFecOpenfecSessionPool::AlFecOpenfecSessionPool () : m_capacity (16), m_hits (0), m_misses (0)
+{
+}
+
+AlFecOpenfecSessionPool::~AlFecOpenfecSessionPool ()
+{
+  Clear ();
+}
+
+of_session_t *
+AlFecOpenfecSessionPool::CreateSession (of_codec_id_t codecId, of_codec_type_t type,
+                                        of_parameters_t *params)
+{
+  static std::mutex libraryMutex;
+  std::lock_guard<std::mutex> lock (libraryMutex);
+
+  of_session_t *session;
+  int ret = of_create_codec_instance (&session, codecId, type, VERBOSITY);
+  NS_ASSERT_MSG (ret == OF_STATUS_OK, "Create codec instance failed");
+  ret = of_set_fec_parameters (session, params);
+  NS_ASSERT_MSG (ret == OF_STATUS_OK, "Set FEC parameter failed");
+  return session;
+}
+
+of_session_t *
+AlFecOpenfecSessionPool::Acquire (const Key &key)
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  for (auto it = m_sessions.begin (); it != m_sessions.end (); it++)
+    {
+      if (it->first == key)
+        {
+          of_session_t *session = it->second;
+          m_sessions.erase (it);
+          m_hits++;
+          NS_LOG_LOGIC ("Reuse session " << session << " k=" << key.k << " n=" << key.n);
+          return session;
+        }
+    }
+  m_misses++;
+  return nullptr;
+}
+
+void
+AlFecOpenfecSessionPool::Release (const Key &key, of_session_t *session)
+{
+  NS_ASSERT (session);
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_sessions.emplace_front (key, session);
+  Trim ();
+}
+
+void
+AlFecOpenfecSessionPool::SetCapacity (size_t capacity)
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_capacity = capacity;
+  Trim ();
+}
+
+void
+AlFecOpenfecSessionPool::Trim ()
+{
+  while (m_sessions.size () > m_capacity)
+    {
+      of_release_codec_instance (m_sessions.back ().second);
+      m_sessions.pop_back ();
+    }
+}
+
+size_t
+AlFecOpenfecSessionPool::GetCapacity () const
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return m_capacity;
+}
+
+void
+AlFecOpenfecSessionPool::Clear ()
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  for (auto &entry : m_sessions)
+    {
+      of_release_codec_instance (entry.second);
+    }
+  m_sessions.clear ();
+}
+
+size_t
+AlFecOpenfecSessionPool::GetHits () const
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return m_hits;
+}
+
+size_t
+AlFecOpenfecSessionPool::GetMisses () const
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return m_misses;
+}
+
+} // namespace ns3
@@ -0,0 +1,108 @@
+#ifndef AL_FEC_OPENFEC_SESSION_POOL_H
+#define AL_FEC_OPENFEC_SESSION_POOL_H
+
+#include <list>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+
+extern "C" {
+#include "openfec/lib_common/of_openfec_api.h"
+}
+
+namespace ns3 {
+
+/**
+ * \brief A small process-wide pool of idle OpenFEC encoder sessions.
+ *
+ * Creating an OpenFEC session builds the generator matrix of the code, which
+ * is the dominant cost when every block uses a fresh session. Encoder
+ * sessions are stateless between blocks, so a session released by one block
+ * can be handed to the next block with the same parameters. Decoder sessions
+ * keep the received symbols and OpenFEC offers no way to rewind them, so they
+ * are never pooled.
+ *
+ * The pool keeps at most GetCapacity () sessions and drops the least recently
+ * released one when it is full. It may be used from several threads.
+ */
+class AlFecOpenfecSessionPool
+{
+public:
+  /**
+   * \brief The parameters that identify interchangeable sessions
+   */
+  struct Key
+  {
+    of_codec_id_t codecId;
+    uint32_t k; // Number of source symbols
+    uint32_t n; // Number of encoded symbols
+    uint32_t symbolSize; // Encoding symbol length
+    uint32_t m; // Codec specific parameter, e.g. the field size of RS over GF(2^m)
+    uint32_t seed; // Seed of codecs with a pseudo-random matrix, 0 otherwise
+
+    bool operator== (const Key &other) const;
+  };
+
+  /**
+   * \brief Get the pool shared by all the codecs of the process
+   */
+  static AlFecOpenfecSessionPool &Get ();
+
+  ~AlFecOpenfecSessionPool ();
+
+  /**
+   * \brief Create and configure a new session
+   *
+   * OpenFEC writes its verbosity, and the pseudo-random generator of the LDPC
+   * matrices, in global variables while a session is created and configured,
+   * so the sessions of all the threads are created one at a time.
+   */
+  static of_session_t *CreateSession (of_codec_id_t codecId, of_codec_type_t type,
+                                      of_parameters_t *params);
+
+  /**
+   * \brief Take an idle encoder session with the given parameters out of the pool
+   *
+   * \return The session, or nullptr if there is none. The caller has to
+   * create and configure a new session in that case.
+   */
+  of_session_t *Acquire (const Key &key);
+
+  /**
+   * \brief Give an encoder session back to the pool
+   */
+  void Release (const Key &key, of_session_t *session);
+
+  /**
+   * \brief Set the maximum number of idle sessions. Extra sessions are released immediately.
+   */
+  void SetCapacity (size_t capacity);
+  size_t GetCapacity () const;
+
+  /**
+   * \brief Release all the idle sessions
+   */
+  void Clear ();
+
+  size_t GetHits () const;
+  size_t GetMisses () const;
+
+private:
+  AlFecOpenfecSessionPool ();
+
+  /**
+   * \brief Release the least recently used sessions beyond the capacity.
+   * m_mutex must be held.
+   */
+  void Trim ();
+
+  mutable std::mutex m_mutex; // Protects the members below
+  std::list<std::pair<Key, of_session_t *>> m_sessions; // Most recently released first
+  size_t m_capacity;
+  size_t m_hits;
+  size_t m_misses;
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_OPENFEC_SESSION_POOL_H
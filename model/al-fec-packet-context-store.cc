@@ -0,0 +1,361 @@
+#include "ns3/al-fec-packet-context-store.h"
+#include "ns3/log.h"
+#include "ns3/nix-vector.h"
+#include "ns3/tag-buffer.h"
+
+#include <functional>
+#include <string.h>
+#include <string_view>
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecPacketContextStore");
+
+const uint32_t AlFecPacketContextStore::EMPTY;
+
+namespace {
+
+void
+AppendU32 (std::vector<uint8_t> &data, uint32_t value)
+{
+  size_t offset = data.size ();
+  data.resize (offset + sizeof (value));
+  memcpy (&data[offset], &value, sizeof (value));
+}
+
+uint32_t
+ReadU32 (const uint8_t *&p)
+{
+  uint32_t value;
+  memcpy (&value, p, sizeof (value));
+  p += sizeof (value);
+  return value;
+}
+
+/**
+ * Create an empty tag of the given type, nullptr if it has no constructor
+ */
+Tag *
+CreateTag (TypeId tid)
+{
+  if (!tid.HasConstructor ())
+    {
+      NS_LOG_WARN ("Tag " << tid.GetName () << " has no constructor and is dropped");
+      return nullptr;
+    }
+  ObjectBase *object = tid.GetConstructor () ();
+  Tag *tag = dynamic_cast<Tag *> (object);
+  if (!tag)
+    {
+      delete object;
+    }
+  return tag;
+}
+
+/**
+ * Append the TypeId name and the serialized content of a tag
+ */
+void
+AppendTag (std::vector<uint8_t> &data, const Tag &tag)
+{
+  const std::string &name = tag.GetInstanceTypeId ().GetName ();
+  AppendU32 (data, name.size ());
+  data.insert (data.end (), name.begin (), name.end ());
+  uint32_t size = tag.GetSerializedSize ();
+  AppendU32 (data, size);
+  size_t offset = data.size ();
+  data.resize (offset + size);
+  tag.Serialize (TagBuffer (&data[offset], &data[offset] + size));
+}
+
+/**
+ * Read a tag appended by AppendTag. The returned tag is owned by the caller,
+ * nullptr if its type has no constructor.
+ */
+Tag *
+ReadTag (const uint8_t *&p)
+{
+  uint32_t nameSize = ReadU32 (p);
+  std::string name (reinterpret_cast<const char *> (p), nameSize);
+  p += nameSize;
+  uint32_t size = ReadU32 (p);
+  uint8_t *start = const_cast<uint8_t *> (p);
+  p += size;
+  Tag *tag = CreateTag (TypeId::LookupByName (name));
+  if (tag)
+    {
+      tag->Deserialize (TagBuffer (start, start + size));
+    }
+  return tag;
+}
+
+} // namespace
+
+AlFecPacketContextStore &
+AlFecPacketContextStore::Get ()
+{
+  static AlFecPacketContextStore store;
+  return store;
+}
+
+AlFecPacketContextStore::AlFecPacketContextStore ()
+    : m_nextHandle (EMPTY + 1),
+      m_memoryLimit (4 * 1024 * 1024),
+      m_empty (std::make_shared<const Buffer> ())
+{
+}
+
+size_t
+AlFecPacketContextStore::Hash (const Buffer &context)
+{
+  return std::hash<std::string_view> () (std::string_view (
+      reinterpret_cast<const char *> (context.PeekData ()), context.GetSize ()));
+}
+
+size_t
+AlFecPacketContextStore::GetEntrySize (const Entry &entry)
+{
+  return sizeof (Entry) + entry.context->GetSize ();
+}
+
+std::pair<uint32_t, AlFecPacketContextStore::Context>
+AlFecPacketContextStore::Insert (const Buffer &context)
+{
+  if (context.GetSize () == 0)
+    {
+      return std::make_pair (EMPTY, m_empty);
+    }
+
+  // Identical contexts share their entry
+  size_t hash = Hash (context);
+  std::lock_guard<std::mutex> lock (m_mutex);
+  auto range = m_contents.equal_range (hash);
+  for (auto it = range.first; it != range.second; it++)
+    {
+      const Buffer &stored = *it->second->context;
+      if (stored.GetSize () == context.GetSize () &&
+          memcmp (stored.PeekData (), context.PeekData (), context.GetSize ()) == 0)
+        {
+          m_entries.splice (m_entries.begin (), m_entries, it->second);
+          m_stats.insertHits++;
+          return std::make_pair (it->second->handle, it->second->context);
+        }
+    }
+
+  uint32_t handle = m_nextHandle++;
+  NS_ASSERT_MSG (handle != EMPTY, "Packet context handles wrapped around");
+  m_entries.push_front ({handle, hash, std::make_shared<const Buffer> (context)});
+  m_index.emplace (handle, m_entries.begin ());
+  m_contents.emplace (hash, m_entries.begin ());
+  m_stats.insertMisses++;
+  m_stats.memoryUsage += GetEntrySize (m_entries.front ());
+  m_stats.entries++;
+  NS_LOG_LOGIC ("New packet context " << handle << " of " << context.GetSize () << " bytes");
+  Context stored = m_entries.front ().context;
+  Trim ();
+  return std::make_pair (handle, stored);
+}
+
+AlFecPacketContextStore::Context
+AlFecPacketContextStore::Lookup (uint32_t handle)
+{
+  if (handle == EMPTY)
+    {
+      return m_empty;
+    }
+  std::lock_guard<std::mutex> lock (m_mutex);
+  auto it = m_index.find (handle);
+  if (it == m_index.end ())
+    {
+      NS_LOG_LOGIC ("Packet context " << handle << " not found");
+      m_stats.lookupMisses++;
+      return nullptr;
+    }
+  m_entries.splice (m_entries.begin (), m_entries, it->second);
+  m_stats.lookupHits++;
+  return it->second->context;
+}
+
+void
+AlFecPacketContextStore::Trim ()
+{
+  // The entries still referenced are skipped
+  auto it = m_entries.end ();
+  while (m_stats.memoryUsage > m_memoryLimit && it != m_entries.begin ())
+    {
+      --it;
+      if (it->context.use_count () > 1)
+        {
+          continue;
+        }
+      NS_LOG_LOGIC ("Evict packet context " << it->handle);
+      m_stats.memoryUsage -= GetEntrySize (*it);
+      m_stats.entries--;
+      m_stats.evictions++;
+      m_index.erase (it->handle);
+      auto range = m_contents.equal_range (it->hash);
+      for (auto content = range.first; content != range.second; content++)
+        {
+          if (content->second == it)
+            {
+              m_contents.erase (content);
+              break;
+            }
+        }
+      it = m_entries.erase (it);
+    }
+}
+
+Buffer
+AlFecPacketContextStore::Capture (Ptr<const Packet> packet)
+{
+  std::vector<uint8_t> data;
+
+  // Byte tags, with their range
+  std::vector<std::pair<Tag *, std::pair<uint32_t, uint32_t>>> byteTags;
+  ByteTagIterator byteTagIterator = packet->GetByteTagIterator ();
+  while (byteTagIterator.HasNext ())
+    {
+      ByteTagIterator::Item item = byteTagIterator.Next ();
+      Tag *tag = CreateTag (item.GetTypeId ());
+      if (tag)
+        {
+          item.GetTag (*tag);
+          byteTags.push_back ({tag, {item.GetStart (), item.GetEnd ()}});
+        }
+    }
+  AppendU32 (data, byteTags.size ());
+  for (auto &byteTag : byteTags)
+    {
+      AppendU32 (data, byteTag.second.first);
+      AppendU32 (data, byteTag.second.second);
+      AppendTag (data, *byteTag.first);
+      delete byteTag.first;
+    }
+
+  // Packet tags
+  std::vector<Tag *> packetTags;
+  PacketTagIterator packetTagIterator = packet->GetPacketTagIterator ();
+  while (packetTagIterator.HasNext ())
+    {
+      PacketTagIterator::Item item = packetTagIterator.Next ();
+      Tag *tag = CreateTag (item.GetTypeId ());
+      if (tag)
+        {
+          item.GetTag (*tag);
+          packetTags.push_back (tag);
+        }
+    }
+  AppendU32 (data, packetTags.size ());
+  for (Tag *tag : packetTags)
+    {
+      AppendTag (data, *tag);
+      delete tag;
+    }
+
+  // Nix vector, serialized in 32-bit words
+  Ptr<NixVector> nixVector = packet->GetNixVector ();
+  uint32_t nixSize = nixVector ? nixVector->GetSerializedSize () : 0;
+  AppendU32 (data, nixSize);
+  if (nixSize > 0)
+    {
+      std::vector<uint32_t> words ((nixSize + sizeof (uint32_t) - 1) / sizeof (uint32_t));
+      nixVector->Serialize (words.data (), nixSize);
+      size_t offset = data.size ();
+      data.resize (offset + nixSize);
+      memcpy (&data[offset], words.data (), nixSize);
+    }
+
+  Buffer context;
+  context.AddAtStart (data.size ());
+  context.Begin ().Write (data.data (), data.size ());
+  return context;
+}
+
+void
+AlFecPacketContextStore::Restore (const Buffer &context, Ptr<Packet> packet)
+{
+  if (context.GetSize () == 0)
+    {
+      return;
+    }
+  const uint8_t *p = context.PeekData ();
+
+  uint32_t nbByteTags = ReadU32 (p);
+  for (uint32_t i = 0; i < nbByteTags; i++)
+    {
+      uint32_t start = ReadU32 (p);
+      uint32_t end = ReadU32 (p);
+      Tag *tag = ReadTag (p);
+      if (tag)
+        {
+          packet->AddByteTag (*tag, start, end);
+          delete tag;
+        }
+    }
+
+  uint32_t nbPacketTags = ReadU32 (p);
+  for (uint32_t i = 0; i < nbPacketTags; i++)
+    {
+      Tag *tag = ReadTag (p);
+      if (tag)
+        {
+          packet->AddPacketTag (*tag);
+          delete tag;
+        }
+    }
+
+  uint32_t nixSize = ReadU32 (p);
+  if (nixSize > 0)
+    {
+      std::vector<uint32_t> words ((nixSize + sizeof (uint32_t) - 1) / sizeof (uint32_t));
+      memcpy (words.data (), p, nixSize);
+      Ptr<NixVector> nixVector = Create<NixVector> ();
+      nixVector->Deserialize (words.data (), nixSize);
+      packet->SetNixVector (nixVector);
+    }
+}
+
+void
+AlFecPacketContextStore::SetMemoryLimit (size_t bytes)
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_memoryLimit = bytes;
+  Trim ();
+}
+
+size_t
+AlFecPacketContextStore::GetMemoryLimit () const
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return m_memoryLimit;
+}
+
+AlFecPacketContextStore::Stats
+AlFecPacketContextStore::GetStats () const
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return m_stats;
+}
+
+void
+AlFecPacketContextStore::ResetStats ()
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  Stats stats;
+  stats.memoryUsage = m_stats.memoryUsage;
+  stats.entries = m_stats.entries;
+  m_stats = stats;
+}
+
+void
+AlFecPacketContextStore::Clear ()
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_entries.clear ();
+  m_index.clear ();
+  m_contents.clear ();
+  m_stats.memoryUsage = 0;
+  m_stats.entries = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,136 @@
+#ifndef AL_FEC_PACKET_CONTEXT_STORE_H
+#define AL_FEC_PACKET_CONTEXT_STORE_H
+
+#include "ns3/buffer.h"
+#include "ns3/packet.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief Process-wide store of the contexts of the encoded packets.
+ *
+ * The context of a packet (its byte tags, packet tags, metadata and nix
+ * vector) is stored once per source block instead of in the tag of every
+ * encoded symbol, which only carries the handle of the context. Identical
+ * contexts are stored once, and the decoder fetches the context once per
+ * source block. The metadata of a packet carries its UID, so only contexts
+ * without a UID, or the ones of the copies of a packet, share their entry.
+ *
+ * The contexts are shared: an entry referenced by an encoder or a decoder is
+ * never evicted. The other entries stay available to the symbols still in
+ * flight until the total size of the contexts exceeds GetMemoryLimit (),
+ * where the least recently used ones are evicted and their handles stop
+ * resolving. Handles are never reused. The store may be used from several
+ * threads.
+ */
+class AlFecPacketContextStore
+{
+public:
+  typedef std::shared_ptr<const Buffer> Context;
+
+  static const uint32_t EMPTY = 0; // Handle of the empty context, which is not stored
+
+  /**
+   * \brief Hit and miss counters
+   */
+  struct Stats
+  {
+    size_t insertHits = 0; // Insertions of an already stored context
+    size_t insertMisses = 0;
+    size_t lookupHits = 0;
+    size_t lookupMisses = 0; // Lookups of an evicted or unknown handle
+    size_t evictions = 0;
+    size_t memoryUsage = 0; // Bytes held by the store
+    size_t entries = 0;
+  };
+
+  /**
+   * \brief Get the store shared by all the AlFec instances of the process
+   */
+  static AlFecPacketContextStore &Get ();
+
+  /**
+   * \brief Store a context, or find the identical stored one
+   *
+   * \param context The serialized context of a packet
+   * \return The handle of the context, and the context itself. Holding the
+   * context keeps the entry from being evicted.
+   */
+  std::pair<uint32_t, Context> Insert (const Buffer &context);
+
+  /**
+   * \brief Get the context of a handle
+   *
+   * \return The context, or nullptr if it has been evicted. The empty
+   * context for EMPTY.
+   */
+  Context Lookup (uint32_t handle);
+
+  /**
+   * \brief Capture the byte tags, the packet tags and the nix vector of a
+   * packet through the public API of Packet, without serializing its content
+   *
+   * The tags are serialized with their TypeId name and need a constructor.
+   * The header metadata and the UID are not captured.
+   */
+  static Buffer Capture (Ptr<const Packet> packet);
+
+  /**
+   * \brief Add the tags and the nix vector of a captured context to a packet
+   * holding the same bytes
+   */
+  static void Restore (const Buffer &context, Ptr<Packet> packet);
+
+  /**
+   * \brief Set the maximum number of bytes held by the unreferenced contexts
+   */
+  void SetMemoryLimit (size_t bytes);
+  size_t GetMemoryLimit () const;
+
+  Stats GetStats () const;
+  void ResetStats ();
+
+  /**
+   * \brief Drop every entry. The handles of the dropped entries stop resolving.
+   */
+  void Clear ();
+
+private:
+  struct Entry
+  {
+    uint32_t handle;
+    size_t hash;
+    Context context;
+  };
+
+  AlFecPacketContextStore ();
+
+  /**
+   * \brief Evict the least recently used unreferenced entries until the
+   * limit is honored. m_mutex must be held.
+   */
+  void Trim ();
+
+  static size_t Hash (const Buffer &context);
+  static size_t GetEntrySize (const Entry &entry);
+
+  mutable std::mutex m_mutex; // Protects the members below
+  std::list<Entry> m_entries; // Most recently used first
+  std::unordered_map<uint32_t, std::list<Entry>::iterator> m_index; // Handle to entry
+  std::unordered_multimap<size_t, std::list<Entry>::iterator> m_contents; // Hash to entry
+  uint32_t m_nextHandle;
+  size_t m_memoryLimit;
+  Stats m_stats;
+  Context m_empty; // Returned for EMPTY
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_PACKET_CONTEXT_STORE_H
@@ -0,0 +1,627 @@
+#include "ns3/al-fec-raptorq.h"
+#include "ns3/al-fec-gf256.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecRaptorq");
+
+namespace {
+
+const uint8_t ACTIVE = 0;
+const uint8_t PIVOT = 1;
+const uint8_t INACTIVE = 2;
+
+// Degree distribution of RFC 6330 5.3.5.2
+const uint32_t DEGREE_TABLE[] = {0,       5243,    529531,  704294,  791675,  844104,  879057,
+                                 904023,  922747,  937311,  948962,  958494,  966438,  973160,
+                                 978921,  983914,  988283,  992138,  995565,  998631,  1001391,
+                                 1003887, 1006157, 1008229, 1010129, 1011876, 1013490, 1014983,
+                                 1016370, 1017662, 1048576};
+
+// The K' for which J = 0 does not give full rank with this generator, and
+// the smallest J that does
+const uint32_t SYSTEMATIC_INDEX_EXCEPTIONS[][2] = {{351, 1}, {11089, 1}};
+
+bool
+IsPrime (uint32_t n)
+{
+  if (n < 2)
+    {
+      return false;
+    }
+  for (uint32_t d = 2; d * d <= n; d++)
+    {
+      if (n % d == 0)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+} // namespace
+
+const uint32_t AlFecRaptorq::MAX_K;
+
+AlFecRaptorq::AlFecRaptorq () : m_params ()
+{
+}
+
+uint32_t
+AlFecRaptorq::Rand (uint32_t y, uint32_t i, uint32_t m)
+{
+  uint64_t z = ((static_cast<uint64_t> (y) << 8) | i) + 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z ^= z >> 31;
+  return static_cast<uint32_t> (z >> 32) % m;
+}
+
+uint32_t
+AlFecRaptorq::Deg (uint32_t v) const
+{
+  uint32_t d = 1;
+  while (v >= DEGREE_TABLE[d])
+    {
+      d++;
+    }
+  return std::min (d, m_params.w - 2);
+}
+
+AlFecRaptorq::Parameters
+AlFecRaptorq::ComputeParameters (uint32_t kPrime, uint32_t j)
+{
+  Parameters params;
+  params.kPrime = kPrime;
+  params.j = j;
+
+  // S and H are sized like in RFC 6330: about 1% of LDPC symbols plus
+  // sqrt(2K'), and a dozen HDPC symbols
+  uint32_t x = 1;
+  while (x * (x - 1) < 2 * kPrime)
+    {
+      x++;
+    }
+  params.s = (kPrime + 99) / 100 + x;
+  while (!IsPrime (params.s))
+    {
+      params.s++;
+    }
+  params.h = std::max<uint32_t> (10, ceil (log2 (kPrime + params.s)));
+  params.l = kPrime + params.s + params.h;
+
+  // About 0.6% of the symbols are permanently inactivated on top of the HDPC ones
+  params.w = params.l - params.h - kPrime / 156;
+  while (!IsPrime (params.w))
+    {
+      params.w--;
+    }
+  params.p = params.l - params.w;
+  params.p1 = params.p;
+  while (!IsPrime (params.p1))
+    {
+      params.p1++;
+    }
+  params.b = params.w - params.s;
+  return params;
+}
+
+AlFecRaptorq::Parameters
+AlFecRaptorq::GetParameters (uint32_t k)
+{
+  NS_ASSERT_MSG (k > 0 && k <= MAX_K, "RaptorQ supports 1 to " << MAX_K << " source symbols");
+  // K' takes every value from 10 to 51, then grows by 2%, so a source block
+  // is extended by at most 2% of padding
+  uint32_t kPrime = 10;
+  while (kPrime < k)
+    {
+      kPrime = kPrime < 51 ? kPrime + 1 : std::min (MAX_K, (kPrime * 102 + 99) / 100);
+    }
+
+  uint32_t j = 0;
+  for (const uint32_t *exception : SYSTEMATIC_INDEX_EXCEPTIONS)
+    {
+      if (exception[0] == kPrime)
+        {
+          j = exception[1];
+        }
+    }
+  return ComputeParameters (kPrime, j);
+}
+
+void
+AlFecRaptorq::SetParameters (const Parameters &params)
+{
+  NS_LOG_FUNCTION (this << params.kPrime << params.j);
+  if (params.kPrime == m_params.kPrime && params.j == m_params.j && !m_hdpcRows.empty ())
+    {
+      return;
+    }
+  m_params = params;
+
+  // G_HDPC = MT * GAMMA (RFC 6330 5.3.3.3). All the columns of MT but the
+  // last one hold two ones, only their rows are kept.
+  uint32_t cols = params.kPrime + params.s;
+  m_hdpcRows.resize (2 * (cols - 1));
+  for (uint32_t j = 0; j + 1 < cols; j++)
+    {
+      uint32_t i1 = Rand (j + 1, 6, params.h);
+      m_hdpcRows[2 * j] = i1;
+      m_hdpcRows[2 * j + 1] = (i1 + Rand (j + 1, 7, params.h - 1) + 1) % params.h;
+    }
+}
+
+void
+AlFecRaptorq::GetLtColumns (uint32_t isi, std::vector<uint32_t> &columns) const
+{
+  // Tuple[K', X] of RFC 6330 5.3.5.4
+  const Parameters &params = m_params;
+  uint32_t a = 53591 + params.j * 997;
+  if (a % 2 == 0)
+    {
+      a++;
+    }
+  uint32_t b = 10267 * (params.j + 1);
+  uint32_t y = b + isi * a;
+  uint32_t d = Deg (Rand (y, 0, 1u << 20));
+  a = 1 + Rand (y, 1, params.w - 1);
+  b = Rand (y, 2, params.w);
+  uint32_t d1 = d < 4 ? 2 + Rand (isi, 3, 2) : 2;
+  uint32_t a1 = 1 + Rand (isi, 4, params.p1 - 1);
+  uint32_t b1 = Rand (isi, 5, params.p1);
+
+  // Enc[K', C, Tuple] of RFC 6330 5.3.5.3, as a list of intermediate symbols
+  columns.clear ();
+  columns.push_back (b);
+  for (uint32_t i = 1; i < d; i++)
+    {
+      b = (b + a) % params.w;
+      columns.push_back (b);
+    }
+  while (b1 >= params.p)
+    {
+      b1 = (b1 + a1) % params.p1;
+    }
+  columns.push_back (params.w + b1);
+  for (uint32_t i = 1; i < d1; i++)
+    {
+      b1 = (b1 + a1) % params.p1;
+      while (b1 >= params.p)
+        {
+          b1 = (b1 + a1) % params.p1;
+        }
+      columns.push_back (params.w + b1);
+    }
+}
+
+void
+AlFecRaptorq::EncodeSymbol (const uint8_t *intermediate, size_t symbolSize, uint32_t isi,
+                            uint8_t *symbol) const
+{
+  std::vector<uint32_t> columns;
+  GetLtColumns (isi, columns);
+  memcpy (symbol, intermediate + columns[0] * symbolSize, symbolSize);
+  for (size_t i = 1; i < columns.size (); i++)
+    {
+      AlFecGf256::XorRegion (symbol, intermediate + columns[i] * symbolSize, symbolSize);
+    }
+}
+
+void
+AlFecRaptorq::BuildSparseRows (const std::vector<uint32_t> &isis)
+{
+  const Parameters &params = m_params;
+  m_rowStart.clear ();
+  m_rowColumns.clear ();
+
+  // LDPC rows (RFC 6330 5.3.3.3), built column by column
+  std::vector<std::vector<uint32_t>> ldpc (params.s);
+  for (uint32_t i = 0; i < params.b; i++)
+    {
+      uint32_t a = 1 + (i / params.s) % (params.s - 1);
+      uint32_t b = i % params.s;
+      ldpc[b].push_back (i);
+      b = (b + a) % params.s;
+      ldpc[b].push_back (i);
+      b = (b + a) % params.s;
+      ldpc[b].push_back (i);
+    }
+  for (uint32_t i = 0; i < params.s; i++)
+    {
+      ldpc[i].push_back (params.b + i);
+      ldpc[i].push_back (params.w + i % params.p);
+      ldpc[i].push_back (params.w + (i + 1) % params.p);
+    }
+  for (uint32_t i = 0; i < params.s; i++)
+    {
+      m_rowStart.push_back (m_rowColumns.size ());
+      m_rowColumns.insert (m_rowColumns.end (), ldpc[i].begin (), ldpc[i].end ());
+    }
+
+  // LT rows
+  std::vector<uint32_t> columns;
+  for (uint32_t isi : isis)
+    {
+      m_rowStart.push_back (m_rowColumns.size ());
+      GetLtColumns (isi, columns);
+      m_rowColumns.insert (m_rowColumns.end (), columns.begin (), columns.end ());
+    }
+  m_rowStart.push_back (m_rowColumns.size ());
+}
+
+void
+AlFecRaptorq::Inactivate ()
+{
+  const Parameters &params = m_params;
+  uint32_t nbRows = m_rowStart.size () - 1;
+
+  // Rows of each LT column
+  m_columnStart.assign (params.w + 1, 0);
+  m_degree.assign (nbRows, 0);
+  for (uint32_t r = 0; r < nbRows; r++)
+    {
+      for (uint32_t i = m_rowStart[r]; i < m_rowStart[r + 1]; i++)
+        {
+          if (m_rowColumns[i] < params.w)
+            {
+              m_columnStart[m_rowColumns[i] + 1]++;
+              m_degree[r]++;
+            }
+        }
+    }
+  for (uint32_t c = 0; c < params.w; c++)
+    {
+      m_columnStart[c + 1] += m_columnStart[c];
+    }
+  m_columnRows.resize (m_columnStart[params.w]);
+  std::vector<uint32_t> fill (m_columnStart.begin (), m_columnStart.end () - 1);
+  for (uint32_t r = 0; r < nbRows; r++)
+    {
+      for (uint32_t i = m_rowStart[r]; i < m_rowStart[r + 1]; i++)
+        {
+          if (m_rowColumns[i] < params.w)
+            {
+              m_columnRows[fill[m_rowColumns[i]]++] = r;
+            }
+        }
+    }
+
+  // The PI symbols are inactivated from the start
+  m_columnState.assign (params.l, ACTIVE);
+  m_inactive.clear ();
+  for (uint32_t c = params.w; c < params.l; c++)
+    {
+      m_columnState[c] = INACTIVE;
+      m_inactive.push_back (c);
+    }
+  m_rowUsed.assign (nbRows, 0);
+  m_pivots.clear ();
+
+  // Rows are taken by increasing degree. Degrees only decrease, so a row is
+  // pushed again when its degree changes and stale entries are skipped.
+  uint32_t maxDegree = 0;
+  for (uint32_t r = 0; r < nbRows; r++)
+    {
+      maxDegree = std::max (maxDegree, m_degree[r]);
+    }
+  std::vector<std::vector<uint32_t>> buckets (maxDegree + 1);
+  for (uint32_t r = nbRows; r > 0; r--)
+    {
+      // Pushed backwards so that rows of the same degree are taken in order
+      buckets[m_degree[r - 1]].push_back (r - 1);
+    }
+
+  uint32_t minDegree = 1;
+  auto removeColumn = [this, &buckets, &minDegree] (uint32_t c, uint8_t state) {
+    m_columnState[c] = state;
+    for (uint32_t i = m_columnStart[c]; i < m_columnStart[c + 1]; i++)
+      {
+        uint32_t r = m_columnRows[i];
+        if (!m_rowUsed[r])
+          {
+            m_degree[r]--;
+            buckets[m_degree[r]].push_back (r);
+            minDegree = std::min (minDegree, m_degree[r]);
+          }
+      }
+  };
+
+  while (minDegree <= maxDegree)
+    {
+      if (minDegree == 0 || buckets[minDegree].empty ())
+        {
+          // Rows without active column are left to the dense part
+          minDegree++;
+          continue;
+        }
+      uint32_t r = buckets[minDegree].back ();
+      buckets[minDegree].pop_back ();
+      if (m_rowUsed[r] || m_degree[r] != minDegree)
+        {
+          continue;
+        }
+
+      // Inactivate all the active columns of the row but one, which becomes its pivot
+      uint32_t pivot = params.l;
+      for (uint32_t i = m_rowStart[r]; i < m_rowStart[r + 1]; i++)
+        {
+          uint32_t c = m_rowColumns[i];
+          if (m_columnState[c] != ACTIVE)
+            {
+              continue;
+            }
+          if (pivot == params.l)
+            {
+              pivot = c;
+            }
+          else
+            {
+              m_inactive.push_back (c);
+              removeColumn (c, INACTIVE);
+            }
+        }
+      NS_ASSERT (pivot < params.l);
+      m_rowUsed[r] = 1;
+      m_pivots.push_back (std::make_pair (r, pivot));
+      removeColumn (pivot, PIVOT);
+    }
+
+  // The columns that no row can solve are left to the dense part, which fails
+  for (uint32_t c = 0; c < params.w; c++)
+    {
+      if (m_columnState[c] == ACTIVE)
+        {
+          m_columnState[c] = INACTIVE;
+          m_inactive.push_back (c);
+        }
+    }
+}
+
+bool
+AlFecRaptorq::Solve (const std::vector<uint32_t> &isis,
+                     const std::vector<const uint8_t *> &symbols, size_t symbolSize,
+                     uint8_t *intermediate)
+{
+  NS_LOG_FUNCTION (this << isis.size () << symbolSize);
+  const Parameters &params = m_params;
+  NS_ASSERT_MSG (params.kPrime > 0, "Parameters are not set");
+  NS_ASSERT (isis.size () == symbols.size ());
+  if (isis.size () < params.kPrime)
+    {
+      return false;
+    }
+
+  // Triangulate the sparse rows
+  BuildSparseRows (isis);
+  Inactivate ();
+  uint32_t nbRows = m_rowStart.size () - 1;
+  size_t nbInactive = m_inactive.size ();
+  size_t words = (nbInactive + 63) / 64;
+  m_inactiveIndex.assign (params.l, 0);
+  for (size_t i = 0; i < nbInactive; i++)
+    {
+      m_inactiveIndex[m_inactive[i]] = i;
+    }
+  m_pivotOf.assign (params.l, 0);
+  for (size_t i = 0; i < m_pivots.size (); i++)
+    {
+      m_pivotOf[m_pivots[i].second] = i;
+    }
+  auto rowSymbol = [&symbols, &params] (uint32_t r) -> const uint8_t * {
+    return r < params.s ? nullptr : symbols[r - params.s];
+  };
+  auto copyRowSymbol = [symbolSize] (uint8_t *dst, const uint8_t *src) {
+    if (symbolSize == 0)
+      {
+        return;
+      }
+    if (src)
+      {
+        memcpy (dst, src, symbolSize);
+      }
+    else
+      {
+        memset (dst, 0, symbolSize);
+      }
+  };
+
+  // Forward substitution: the symbol of each pivot column only depends on the
+  // inactivated columns. The constant part is kept in its own slot for now.
+  m_pivotInactive.assign (m_pivots.size () * words, 0);
+  for (size_t k = 0; k < m_pivots.size (); k++)
+    {
+      uint32_t r = m_pivots[k].first;
+      uint32_t c = m_pivots[k].second;
+      uint8_t *symbol = intermediate + c * symbolSize;
+      uint64_t *bits = &m_pivotInactive[k * words];
+      copyRowSymbol (symbol, rowSymbol (r));
+      for (uint32_t i = m_rowStart[r]; i < m_rowStart[r + 1]; i++)
+        {
+          uint32_t x = m_rowColumns[i];
+          if (x == c)
+            {
+              continue;
+            }
+          if (m_columnState[x] == PIVOT)
+            {
+              AlFecGf256::XorRegion (symbol, intermediate + x * symbolSize, symbolSize);
+              const uint64_t *other = &m_pivotInactive[m_pivotOf[x] * words];
+              for (size_t w = 0; w < words; w++)
+                {
+                  bits[w] ^= other[w];
+                }
+            }
+          else
+            {
+              uint32_t index = m_inactiveIndex[x];
+              bits[index / 64] ^= 1ULL << (index % 64);
+            }
+        }
+    }
+
+  // The rows left over and the HDPC rows, reduced to the inactivated columns
+  size_t nbDense = nbRows - m_pivots.size () + params.h;
+  if (nbDense < nbInactive)
+    {
+      return false;
+    }
+  m_dense.assign (nbDense * nbInactive, 0);
+  m_denseSymbols.resize (nbDense * symbolSize);
+  auto addPivot = [this, words, symbolSize, intermediate] (uint8_t *row, uint8_t *symbol,
+                                                         uint32_t c, uint8_t coef) {
+    AlFecGf256::MulAddRegion (symbol, intermediate + c * symbolSize, coef, symbolSize);
+    const uint64_t *bits = &m_pivotInactive[m_pivotOf[c] * words];
+    for (size_t w = 0; w < words; w++)
+      {
+        for (uint64_t word = bits[w]; word; word &= word - 1)
+          {
+            row[w * 64 + __builtin_ctzll (word)] ^= coef;
+          }
+      }
+  };
+  size_t d = 0;
+  for (uint32_t r = 0; r < nbRows; r++)
+    {
+      if (m_rowUsed[r])
+        {
+          continue;
+        }
+      uint8_t *row = &m_dense[d * nbInactive];
+      uint8_t *symbol = m_denseSymbols.data () + d * symbolSize;
+      copyRowSymbol (symbol, rowSymbol (r));
+      for (uint32_t i = m_rowStart[r]; i < m_rowStart[r + 1]; i++)
+        {
+          uint32_t x = m_rowColumns[i];
+          if (m_columnState[x] == PIVOT)
+            {
+              addPivot (row, symbol, x, 1);
+            }
+          else
+            {
+              row[m_inactiveIndex[x]] ^= 1;
+            }
+        }
+      d++;
+    }
+
+  // The HDPC rows are G_HDPC = MT * GAMMA applied to the reduced columns.
+  // GAMMA is lower triangular with GAMMA[k][j] = alpha^(k-j), so
+  // Z_k = alpha * Z_(k-1) + column k, and each Z_k is added to the two rows of
+  // MT column k, or to every row for the last column.
+  uint32_t hdpcCols = params.kPrime + params.s;
+  uint8_t *hdpcRows = &m_dense[d * nbInactive];
+  uint8_t *hdpcSymbols = m_denseSymbols.data () + d * symbolSize;
+  m_gammaRow.assign (nbInactive, 0);
+  m_gammaSymbol.assign (symbolSize, 0);
+  uint8_t *gammaRow = m_gammaRow.data ();
+  uint8_t *gammaSymbol = m_gammaSymbol.data ();
+  for (uint32_t i = 0; i < params.h; i++)
+    {
+      copyRowSymbol (hdpcSymbols + i * symbolSize, nullptr);
+    }
+  for (uint32_t c = 0; c < hdpcCols; c++)
+    {
+      AlFecGf256::MulRegion (gammaRow, gammaRow, 2, nbInactive);
+      AlFecGf256::MulRegion (gammaSymbol, gammaSymbol, 2, symbolSize);
+      if (m_columnState[c] == PIVOT)
+        {
+          addPivot (gammaRow, gammaSymbol, c, 1);
+        }
+      else
+        {
+          gammaRow[m_inactiveIndex[c]] ^= 1;
+        }
+      if (c + 1 < hdpcCols)
+        {
+          for (uint32_t i = 2 * c; i < 2 * c + 2; i++)
+            {
+              uint32_t row = m_hdpcRows[i];
+              AlFecGf256::XorRegion (hdpcRows + row * nbInactive, gammaRow, nbInactive);
+              AlFecGf256::XorRegion (hdpcSymbols + row * symbolSize, gammaSymbol, symbolSize);
+            }
+        }
+      else
+        {
+          for (uint32_t row = 0; row < params.h; row++)
+            {
+              uint8_t coef = AlFecGf256::Exp (row);
+              AlFecGf256::MulAddRegion (hdpcRows + row * nbInactive, gammaRow, coef, nbInactive);
+              AlFecGf256::MulAddRegion (hdpcSymbols + row * symbolSize, gammaSymbol, coef,
+                                        symbolSize);
+            }
+        }
+    }
+  for (uint32_t i = 0; i < params.h; i++)
+    {
+      hdpcRows[i * nbInactive + m_inactiveIndex[hdpcCols + i]] ^= 1;
+    }
+
+  // Gauss-Jordan elimination of the dense part
+  std::vector<size_t> order (nbDense);
+  for (size_t i = 0; i < nbDense; i++)
+    {
+      order[i] = i;
+    }
+  for (size_t col = 0; col < nbInactive; col++)
+    {
+      size_t p = col;
+      while (p < nbDense && m_dense[order[p] * nbInactive + col] == 0)
+        {
+          p++;
+        }
+      if (p == nbDense)
+        {
+          NS_LOG_LOGIC ("Rank deficient at inactivated column " << col << "/" << nbInactive);
+          return false;
+        }
+      std::swap (order[col], order[p]);
+      uint8_t *pivotRow = &m_dense[order[col] * nbInactive];
+      uint8_t *pivotSymbol = m_denseSymbols.data () + order[col] * symbolSize;
+      uint8_t inv = AlFecGf256::Inv (pivotRow[col]);
+      AlFecGf256::MulRegion (pivotRow + col, pivotRow + col, inv, nbInactive - col);
+      AlFecGf256::MulRegion (pivotSymbol, pivotSymbol, inv, symbolSize);
+      for (size_t i = 0; i < nbDense; i++)
+        {
+          uint8_t *row = &m_dense[order[i] * nbInactive];
+          uint8_t coef = row[col];
+          if (i == col || coef == 0)
+            {
+              continue;
+            }
+          AlFecGf256::MulAddRegion (row + col, pivotRow + col, coef, nbInactive - col);
+          AlFecGf256::MulAddRegion (m_denseSymbols.data () + order[i] * symbolSize, pivotSymbol, coef,
+                                    symbolSize);
+        }
+    }
+  for (size_t i = 0; i < nbInactive && symbolSize > 0; i++)
+    {
+      memcpy (intermediate + m_inactive[i] * symbolSize, m_denseSymbols.data () + order[i] * symbolSize,
+              symbolSize);
+    }
+
+  // Back substitution, in triangular order, from the original rows
+  for (const std::pair<uint32_t, uint32_t> &pivot : m_pivots)
+    {
+      uint32_t r = pivot.first;
+      uint8_t *symbol = intermediate + pivot.second * symbolSize;
+      copyRowSymbol (symbol, rowSymbol (r));
+      for (uint32_t i = m_rowStart[r]; i < m_rowStart[r + 1]; i++)
+        {
+          if (m_rowColumns[i] != pivot.second)
+            {
+              AlFecGf256::XorRegion (symbol, intermediate + m_rowColumns[i] * symbolSize,
+                                     symbolSize);
+            }
+        }
+    }
+  NS_LOG_LOGIC ("Solved " << params.l << " intermediate symbols with " << nbInactive
+                          << " inactivated");
+  return true;
+}
+
+} // namespace ns3
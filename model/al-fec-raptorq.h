@@ -0,0 +1,153 @@
+#ifndef AL_FEC_RAPTORQ_H
+#define AL_FEC_RAPTORQ_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief A RaptorQ-like code: a precode of LDPC and HDPC constraints, LT
+ * symbols, and an inactivation decoder that solves the intermediate symbols.
+ *
+ * It is modeled on RFC 6330 but does not interoperate with it: the
+ * pseudo-random generator is a 64-bit mixer instead of the V0..V3 tables, S,
+ * H and W are derived by ComputeParameters instead of read from the RFC
+ * table, and K' grows by 2% steps. The systematic index J(K') is 0 except
+ * for the few K' where the source symbols and the precode of this generator
+ * do not have full rank.
+ *
+ * The intermediate symbols C[0..L-1] are laid out like in RFC 6330: the B
+ * regular LT symbols, the S LDPC symbols, then the P permanently inactivated
+ * symbols, the last H of which are the HDPC symbols.
+ */
+class AlFecRaptorq
+{
+public:
+  /**
+   * \brief The parameters of a source block of K' symbols, named like in RFC 6330 5.3.3.3
+   */
+  struct Parameters
+  {
+    uint32_t kPrime; // Number of symbols of the extended source block
+    uint32_t j; // Systematic index
+    uint32_t s; // Number of LDPC symbols
+    uint32_t h; // Number of HDPC symbols
+    uint32_t w; // Number of LT symbols
+    uint32_t l; // Number of intermediate symbols, K' + S + H
+    uint32_t p; // Number of permanently inactivated symbols, L - W
+    uint32_t p1; // Smallest prime not lower than P
+    uint32_t b; // Number of regular LT symbols, W - S
+  };
+
+  /**
+   * \brief The largest supported source block, in symbols
+   */
+  static const uint32_t MAX_K = 56403;
+
+  AlFecRaptorq ();
+
+  /**
+   * \brief Get the parameters of the smallest supported K' not lower than k
+   */
+  static Parameters GetParameters (uint32_t k);
+
+  /**
+   * \brief Derive the parameters of K' and J
+   */
+  static Parameters ComputeParameters (uint32_t kPrime, uint32_t j);
+
+  /**
+   * \brief Prepare the code for the given parameters. The HDPC matrix is kept
+   * as long as the parameters do not change.
+   */
+  void SetParameters (const Parameters &params);
+
+  const Parameters &
+  GetCurrentParameters () const
+  {
+    return m_params;
+  }
+
+  /**
+   * \brief Get the intermediate symbols covered by the LT symbol of the given ISI
+   */
+  void GetLtColumns (uint32_t isi, std::vector<uint32_t> &columns) const;
+
+  /**
+   * \brief Compute the LT symbol of the given ISI from the intermediate symbols
+   */
+  void EncodeSymbol (const uint8_t *intermediate, size_t symbolSize, uint32_t isi,
+                     uint8_t *symbol) const;
+
+  /**
+   * \brief Solve the intermediate symbols from known LT symbols.
+   *
+   * \param isis The ISI of each known symbol. There must be at least K' of them.
+   * \param symbols The content of each known symbol, nullptr for a padding symbol
+   * \param symbolSize The symbol size. 0 only checks that the system has full rank.
+   * \param intermediate Receives the L intermediate symbols
+   *
+   * \return Whether the system has full rank
+   */
+  bool Solve (const std::vector<uint32_t> &isis, const std::vector<const uint8_t *> &symbols,
+              size_t symbolSize, uint8_t *intermediate);
+
+  /**
+   * \brief Get the number of inactivated columns of the last Solve, including
+   * the permanently inactivated ones
+   */
+  size_t
+  GetNbInactivated () const
+  {
+    return m_inactive.size ();
+  }
+
+private:
+  /**
+   * \brief The pseudo-random generator, in place of Rand[y, i, m] of RFC 6330 5.3.5.1
+   */
+  static uint32_t Rand (uint32_t y, uint32_t i, uint32_t m);
+
+  /**
+   * \brief The degree generator Deg[v] of RFC 6330 5.3.5.2
+   */
+  uint32_t Deg (uint32_t v) const;
+
+  /**
+   * \brief Build the sparse rows: the S LDPC rows, then one LT row per known symbol
+   */
+  void BuildSparseRows (const std::vector<uint32_t> &isis);
+
+  /**
+   * \brief Order the sparse rows into a triangular part and inactivate the
+   * columns that prevent it
+   */
+  void Inactivate ();
+
+  Parameters m_params;
+  std::vector<uint8_t> m_hdpcRows; // The two HDPC rows of each column of MT but the last
+
+  // Workspace of Solve, kept between the calls
+  std::vector<uint32_t> m_rowStart; // Sparse rows in CSR form
+  std::vector<uint32_t> m_rowColumns;
+  std::vector<uint32_t> m_columnStart; // Rows of each column below W, in CSR form
+  std::vector<uint32_t> m_columnRows;
+  std::vector<uint32_t> m_degree; // Active columns of each row
+  std::vector<uint8_t> m_columnState; // ACTIVE, PIVOT or INACTIVE
+  std::vector<uint8_t> m_rowUsed; // Whether the row is a pivot
+  std::vector<std::pair<uint32_t, uint32_t>> m_pivots; // (row, column), in triangular order
+  std::vector<uint32_t> m_pivotOf; // Pivot index of each pivot column
+  std::vector<uint32_t> m_inactive; // Inactivated columns
+  std::vector<uint32_t> m_inactiveIndex; // Index of each inactivated column in m_inactive
+  std::vector<uint64_t> m_pivotInactive; // Inactive part of each pivot row once reduced, as bits
+  std::vector<uint8_t> m_dense; // Remaining rows over the inactivated columns
+  std::vector<uint8_t> m_denseSymbols; // Right-hand side of the remaining rows
+  std::vector<uint8_t> m_gammaRow; // Running GAMMA product of the HDPC rows
+  std::vector<uint8_t> m_gammaSymbol;
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_RAPTORQ_H
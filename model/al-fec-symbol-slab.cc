@@ -0,0 +1,62 @@
+#include "ns3/al-fec-symbol-slab.h"
+#include "ns3/log.h"
+
+#include <stdlib.h>
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecSymbolSlab");
+
+AlFecSymbolSlab::AlFecSymbolSlab ()
+    : m_data (nullptr), m_table (nullptr), m_capacity (0), m_tableCapacity (0), m_n (0),
+      m_symbolSize (0)
+{
+}
+
+AlFecSymbolSlab::~AlFecSymbolSlab ()
+{
+  Release ();
+}
+
+void
+AlFecSymbolSlab::Reset (size_t n, size_t symbolSize)
+{
+  NS_LOG_FUNCTION (this << n << symbolSize);
+
+  size_t size = n * symbolSize;
+  if (size > m_capacity)
+    {
+      free (m_data);
+      // aligned_alloc requires the size to be a multiple of the alignment
+      m_capacity = (size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+      m_data = reinterpret_cast<uint8_t *> (aligned_alloc (CACHE_LINE_SIZE, m_capacity));
+      NS_ASSERT_MSG (m_data, "Allocate symbol slab failed");
+    }
+  if (n > m_tableCapacity)
+    {
+      free (m_table);
+      m_tableCapacity = n;
+      m_table = reinterpret_cast<uint8_t **> (malloc (n * sizeof (uint8_t *)));
+      NS_ASSERT_MSG (m_table, "Allocate symbol table failed");
+    }
+
+  m_n = n;
+  m_symbolSize = symbolSize;
+  for (size_t i = 0; i < n; i++)
+    {
+      m_table[i] = GetSymbol (i);
+    }
+}
+
+void
+AlFecSymbolSlab::Release ()
+{
+  free (m_data);
+  free (m_table);
+  m_data = nullptr;
+  m_table = nullptr;
+  m_capacity = 0;
+  m_tableCapacity = 0;
+  m_n = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,87 @@
+#ifndef AL_FEC_SYMBOL_SLAB_H
+#define AL_FEC_SYMBOL_SLAB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief One contiguous, cache-line-aligned allocation holding the n symbols of a block.
+ *
+ * Symbol i lives at offset i * symbolSize, so the source symbols of a
+ * systematic code form the source block itself. The memory is kept when the
+ * slab is reset for the next block, and only grows when a larger block arrives.
+ */
+class AlFecSymbolSlab
+{
+public:
+  static const size_t CACHE_LINE_SIZE = 64;
+
+  AlFecSymbolSlab ();
+  ~AlFecSymbolSlab ();
+  AlFecSymbolSlab (const AlFecSymbolSlab &) = delete;
+  AlFecSymbolSlab &operator= (const AlFecSymbolSlab &) = delete;
+
+  /**
+   * \brief Prepare the slab for a block of n symbols.
+   * The content of the symbols is unspecified afterwards.
+   */
+  void Reset (size_t n, size_t symbolSize);
+
+  /**
+   * \brief Free the memory
+   */
+  void Release ();
+
+  /**
+   * \brief Get the symbol with the given ESI
+   */
+  uint8_t *
+  GetSymbol (size_t esi) const
+  {
+    return m_data + esi * m_symbolSize;
+  }
+
+  /**
+   * \brief Get the symbol table (n pointers into the slab), as expected by OpenFEC
+   */
+  uint8_t **
+  GetTable () const
+  {
+    return m_table;
+  }
+
+  /**
+   * \brief Get the start of the slab
+   */
+  uint8_t *
+  GetData () const
+  {
+    return m_data;
+  }
+
+  size_t
+  GetN () const
+  {
+    return m_n;
+  }
+
+  size_t
+  GetSymbolSize () const
+  {
+    return m_symbolSize;
+  }
+
+private:
+  uint8_t *m_data; // The symbols
+  uint8_t **m_table; // Pointer to each symbol
+  size_t m_capacity; // Allocated bytes of m_data
+  size_t m_tableCapacity; // Allocated entries of m_table
+  size_t m_n; // Number of symbols
+  size_t m_symbolSize; // Size of each symbol
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_SYMBOL_SLAB_H
@@ -0,0 +1,116 @@
+#include "ns3/al-fec-worker-pool.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3 {
+NS_LOG_COMPONENT_DEFINE ("AlFecWorkerPool");
+
+AlFecWorkerPool &
+AlFecWorkerPool::Get ()
+{
+  static AlFecWorkerPool pool;
+  return pool;
+}
+
+AlFecWorkerPool::AlFecWorkerPool () : m_stopping (false)
+{
+}
+
+AlFecWorkerPool::~AlFecWorkerPool ()
+{
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stopping = true;
+  }
+  m_taskReady.notify_all ();
+  for (std::thread &worker : m_workers)
+    {
+      worker.join ();
+    }
+}
+
+void
+AlFecWorkerPool::Grow (size_t nbWorkers)
+{
+  while (m_workers.size () < nbWorkers)
+    {
+      NS_LOG_INFO ("Start worker thread " << m_workers.size ());
+      m_workers.emplace_back (&AlFecWorkerPool::Run, this);
+    }
+}
+
+void
+AlFecWorkerPool::Run ()
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      m_taskReady.wait (lock, [this] () { return m_stopping || !m_tasks.empty (); });
+      if (m_tasks.empty ())
+        {
+          return;
+        }
+      std::function<void ()> task = std::move (m_tasks.front ());
+      m_tasks.pop_front ();
+      lock.unlock ();
+      task ();
+      lock.lock ();
+    }
+}
+
+void
+AlFecWorkerPool::ParallelFor (size_t begin, size_t end, size_t nbThreads, const Body &body)
+{
+  size_t count = end > begin ? end - begin : 0;
+  nbThreads = std::min (nbThreads, count);
+  if (nbThreads <= 1)
+    {
+      body (begin, end);
+      return;
+    }
+
+  // Range i starts after i * chunk items and the first i remainders
+  size_t chunk = count / nbThreads;
+  size_t remainder = count % nbThreads;
+  auto rangeBegin = [begin, chunk, remainder] (size_t i) {
+    return begin + i * chunk + std::min (i, remainder);
+  };
+
+  // Completion of this call, which may run concurrently with others
+  std::mutex doneMutex;
+  std::condition_variable done;
+  size_t pending = nbThreads - 1;
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    Grow (nbThreads - 1);
+    for (size_t i = 1; i < nbThreads; i++)
+      {
+        size_t first = rangeBegin (i);
+        size_t last = rangeBegin (i + 1);
+        m_tasks.push_back ([&body, &doneMutex, &done, &pending, first, last] () {
+          body (first, last);
+          std::lock_guard<std::mutex> doneLock (doneMutex);
+          if (--pending == 0)
+            {
+              done.notify_one ();
+            }
+        });
+      }
+  }
+  m_taskReady.notify_all ();
+
+  body (begin, rangeBegin (1));
+
+  std::unique_lock<std::mutex> doneLock (doneMutex);
+  done.wait (doneLock, [&pending] () { return pending == 0; });
+}
+
+size_t
+AlFecWorkerPool::GetNbWorkers ()
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return m_workers.size ();
+}
+
+} // namespace ns3
@@ -0,0 +1,72 @@
+#ifndef AL_FEC_WORKER_POOL_H
+#define AL_FEC_WORKER_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stddef.h>
+
+namespace ns3 {
+
+/**
+ * \brief Process-wide pool of threads that split a loop between cores.
+ *
+ * ns-3 runs its events on one thread, so the pool is only used inside a
+ * call: ParallelFor returns once every part of the loop is done, and the
+ * simulation never observes the worker threads. The threads are started on
+ * first use and only grow when a larger split is asked for.
+ *
+ * The loop body must not touch the simulator, which includes NS_LOG.
+ */
+class AlFecWorkerPool
+{
+public:
+  typedef std::function<void (size_t begin, size_t end)> Body;
+
+  /**
+   * \brief Get the pool shared by all the codecs of the process
+   */
+  static AlFecWorkerPool &Get ();
+
+  /**
+   * \brief Run body over [begin, end), split into nbThreads contiguous ranges
+   *
+   * The calling thread runs the first range and the workers of the pool run
+   * the other ones. With nbThreads <= 1, body runs on the calling thread only.
+   */
+  void ParallelFor (size_t begin, size_t end, size_t nbThreads, const Body &body);
+
+  /**
+   * \brief Get the number of threads started by the pool
+   */
+  size_t GetNbWorkers ();
+
+private:
+  AlFecWorkerPool ();
+  ~AlFecWorkerPool ();
+  AlFecWorkerPool (const AlFecWorkerPool &) = delete;
+  AlFecWorkerPool &operator= (const AlFecWorkerPool &) = delete;
+
+  /**
+   * \brief Start threads until the pool has nbWorkers of them. m_mutex must be held.
+   */
+  void Grow (size_t nbWorkers);
+
+  /**
+   * \brief Loop of the worker threads
+   */
+  void Run ();
+
+  std::mutex m_mutex; // Protects the members below
+  std::condition_variable m_taskReady; // Notified when a task is queued or the pool stops
+  std::deque<std::function<void ()>> m_tasks; // Ranges waiting for a worker
+  std::vector<std::thread> m_workers;
+  bool m_stopping;
+};
+
+} // namespace ns3
+
+#endif // AL_FEC_WORKER_POOL_H
@@ -1,14 +1,18 @@
 #include "ns3/al-fec.h"
 #include "ns3/al-fec-header.h"
 #include "ns3/core-module.h"
+#include "ns3/simulator.h"
 #include "ns3/type-id.h"
 
 #include "al-fec-info-tag.h"
 #include "util.h"
 
 #include <optional>
+#include <tuple>
 #include <cmath>
 #include <algorithm>
+#include <limits>
+#include <string.h>
 #include <arpa/inet.h>
 
 #include <iomanip>
@@ -19,14 +23,31 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("AlFec");
 NS_OBJECT_ENSURE_REGISTERED (AlFec);
 
-AlFec::AlFec () : m_originalPacket (Ptr<Packet> ()), m_codec (nullptr)
+AlFec::AlFec ()
+    : m_originalPacket (Ptr<Packet> ()),
+      m_directPacketPath (false),
+      m_sourceContextHandle (AlFecPacketContextStore::EMPTY),
+      m_codec (nullptr),
+      m_maxBlockLength (0),
+      m_hasCodecFactory (false),
+      m_sbn (0),
+      m_sn (0),
+      m_nextSn (0),
+      m_aggregated (false),
+      m_directPacket (false),
+      m_contextPinWindow (256),
+      m_maxDecoderContexts (1024),
+      m_maxDecoderMemory (64 * 1024 * 1024),
+      m_decoderContextTimeout (Seconds (10)),
+      m_nbLostContexts (0)
 {
   NS_LOG_FUNCTION (this);
 }
 
-AlFec::AlFec (AlFecCodec *codec) : m_originalPacket (Ptr<Packet> ()), m_codec (codec)
+AlFec::AlFec (AlFecCodec *codec) : AlFec ()
 {
   NS_LOG_FUNCTION (this);
+  SetCodec (codec);
 }
 
 AlFec::~AlFec ()
@@ -37,7 +58,52 @@ AlFec::~AlFec ()
 TypeId
 AlFec::GetTypeId (void)
 {
-  static TypeId tid = TypeId ("ns3::AlFec").AddConstructor<AlFec> ().SetParent<Object> ();
+  static TypeId tid =
+      TypeId ("ns3::AlFec")
+          .AddConstructor<AlFec> ()
+          .SetParent<Object> ()
+          .AddAttribute ("maxSourceBlockLength",
+                         "The maximum number of source symbols per source block. "
+                         "0 means the largest source block of the codec",
+                         UintegerValue (0), MakeUintegerAccessor (&AlFec::m_maxBlockLength),
+                         MakeUintegerChecker<uint32_t> ())
+          .AddAttribute ("flushSize",
+                         "Aggregated packets are encoded once their source block reaches "
+                         "this size in bytes",
+                         UintegerValue (1400), MakeUintegerAccessor (&AlFec::m_flushSize),
+                         MakeUintegerChecker<uint32_t> (1))
+          .AddAttribute ("flushTimeout",
+                         "Aggregated packets are encoded at the latest this long after the "
+                         "first packet of their source block. 0 disables the timeout",
+                         TimeValue (MilliSeconds (20)), MakeTimeAccessor (&AlFec::m_flushTimeout),
+                         MakeTimeChecker ())
+          .AddAttribute ("directPacketPath",
+                         "Copy the bytes of the packets and capture their tags instead of "
+                         "serializing them. The decoded packets get a new UID and lose their "
+                         "header metadata",
+                         BooleanValue (false), MakeBooleanAccessor (&AlFec::m_directPacketPath),
+                         MakeBooleanChecker ())
+          .AddAttribute ("contextPinWindow",
+                         "The packet contexts of the source blocks sent within this many "
+                         "sequence numbers stay in the context store, so that their symbols "
+                         "in flight can be decoded. Older ones may be evicted once the store "
+                         "is full",
+                         UintegerValue (256), MakeUintegerAccessor (&AlFec::m_contextPinWindow),
+                         MakeUintegerChecker<uint16_t> ())
+          .AddAttribute ("maxDecoderContexts",
+                         "The maximum number of source blocks decoded at once",
+                         UintegerValue (1024), MakeUintegerAccessor (&AlFec::m_maxDecoderContexts),
+                         MakeUintegerChecker<uint32_t> (1))
+          .AddAttribute ("maxDecoderMemory",
+                         "The maximum number of bytes held by the source blocks being decoded",
+                         UintegerValue (64 * 1024 * 1024),
+                         MakeUintegerAccessor (&AlFec::m_maxDecoderMemory),
+                         MakeUintegerChecker<uint64_t> ())
+          .AddAttribute ("decoderContextTimeout",
+                         "Source blocks that received nothing for this long are dropped. "
+                         "0 disables the timeout",
+                         TimeValue (Seconds (10)),
+                         MakeTimeAccessor (&AlFec::m_decoderContextTimeout), MakeTimeChecker ());
   // .AddAttribute ("codec", "Pointer to the codec implementation", PointerValue (),
   //                MakePointerAccessor (&AlFec::m_codec), MakePointerChecker<AlFecCodec> ());
   return tid;
@@ -47,12 +113,101 @@ void
 AlFec::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_flushEvent.Cancel ();
+  m_flushCallback = MakeNullCallback<void, size_t> ();
+  m_earlyDeliveryCallback = MakeNullCallback<void, uint32_t, uint16_t, uint32_t, Ptr<Packet>> ();
+  m_decodedPackets.clear ();
+  m_sourceContext = nullptr;
+  m_pinnedContexts.clear ();
+  m_decoderContexts.Dispose ();
+  ReleaseBlockCodecs ();
 }
 
 void
 AlFec::SetCodec (AlFecCodec *codec)
 {
+  NS_LOG_FUNCTION (this);
+  ReleaseBlockCodecs ();
   m_codec = codec;
+  m_decoderContexts.SetCodec (codec);
+
+  // Remember the type and the attributes of the codec, so that the other
+  // source blocks get an identical codec
+  m_hasCodecFactory = false;
+  Object *object = dynamic_cast<Object *> (codec);
+  if (!object)
+    {
+      return;
+    }
+  TypeId tid = object->GetInstanceTypeId ();
+  if (!tid.HasConstructor ())
+    {
+      return;
+    }
+  m_codecFactory = ObjectFactory ();
+  m_codecFactory.SetTypeId (tid);
+  for (size_t i = 0; i < tid.GetAttributeN (); i++)
+    {
+      TypeId::AttributeInformation info = tid.GetAttribute (i);
+      if (!(info.flags & TypeId::ATTR_GET) || !(info.flags & TypeId::ATTR_CONSTRUCT))
+        {
+          continue;
+        }
+      Ptr<AttributeValue> value = info.checker->Create ();
+      object->GetAttribute (info.name, *value);
+      m_codecFactory.Set (info.name, *value);
+    }
+  m_hasCodecFactory = true;
+  m_decoderContexts.SetCodecFactory (m_codecFactory);
+}
+
+AlFecCodec *
+AlFec::GetBlockCodec (size_t sbn)
+{
+  if (sbn == 0)
+    {
+      return m_codec;
+    }
+  while (m_blockCodecs.size () < sbn)
+    {
+      NS_ASSERT_MSG (m_hasCodecFactory,
+                     "The codec cannot be duplicated, so packets must fit in one source block");
+      Ptr<Object> object = m_codecFactory.Create ();
+      AlFecCodec *codec = dynamic_cast<AlFecCodec *> (PeekPointer (object));
+      NS_ASSERT (codec != nullptr);
+      m_blockCodecObjects.push_back (object);
+      m_blockCodecs.push_back (codec);
+    }
+  return m_blockCodecs[sbn - 1];
+}
+
+void
+AlFec::ReleaseBlockCodecs ()
+{
+  for (Ptr<Object> object : m_blockCodecObjects)
+    {
+      object->Dispose ();
+    }
+  m_blockCodecObjects.clear ();
+  m_blockCodecs.clear ();
+  m_partition = AlFecBlockPartition ();
+  m_sbn = 0;
+}
+
+void
+AlFec::Reset ()
+{
+  NS_LOG_FUNCTION (this);
+  m_originalPacket = Ptr<Packet> ();
+  m_decoderContexts.Clear ();
+  if (m_codec)
+    {
+      m_codec->Reset ();
+    }
+  for (AlFecCodec *codec : m_blockCodecs)
+    {
+      codec->Reset ();
+    }
 }
 
 size_t
@@ -64,16 +219,38 @@ AlFec::EncodePacket (Ptr<Packet> originalPacket)
   NS_LOG_INFO ("Got new packet with size=" << payloadSize);
   NS_ASSERT_MSG (m_codec != nullptr, "The codec hasn't been initialized");
 
-  // Serialize packet
+  // Padding
   AlFecHeader::PayloadHeader payloadHeader;
-  Ptr<Packet> encodingPacket;
   m_originalPacket = originalPacket;
-  encodingPacket = m_originalPacket->Copy ();
-
-  // Padding
   size_t symbolSize = m_codec->GetSymbolSize ();
+  NS_ASSERT_MSG (symbolSize >= payloadHeader.GetSerializedSize (),
+                 "The symbol size must hold the payload header");
   size_t packetSize = m_originalPacket->GetSize () + payloadHeader.GetSerializedSize ();
   size_t paddingSize = (symbolSize - (packetSize % symbolSize)) % symbolSize;
+
+  if (m_directPacketPath)
+    {
+      CopyPacket (originalPacket, paddingSize);
+    }
+  else
+    {
+      SerializePacket (originalPacket, paddingSize);
+    }
+  NS_LOG_INFO ("Buffer size=" << m_sourceBlock.GetSize ());
+
+  m_aggregated = false;
+  m_directPacket = m_directPacketPath;
+  return EncodeSourceBlock ();
+}
+
+void
+AlFec::SerializePacket (Ptr<Packet> originalPacket, size_t paddingSize)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Serialize packet
+  AlFecHeader::PayloadHeader payloadHeader;
+  Ptr<Packet> encodingPacket = originalPacket->Copy ();
   encodingPacket->AddPaddingAtEnd (paddingSize);
 
   // Payload header should be append to the encoding content
@@ -105,17 +282,169 @@ AlFec::EncodePacket (Ptr<Packet> originalPacket)
 
   NS_LOG_INFO ("Serialized size: Context=" << contextSize << ", Buffer=" << bufSize);
 
-  m_sourceContext.AddAtStart (contextSize);
-  m_sourceContext.Begin ().Write (serializeBuf, contextSize);
+  // The context is stored once for all the encoded symbols
+  Buffer context;
+  context.AddAtStart (contextSize);
+  context.Begin ().Write (serializeBuf, contextSize);
+  std::tie (m_sourceContextHandle, m_sourceContext) =
+      AlFecPacketContextStore::Get ().Insert (context);
+  m_sourceBlock = Buffer ();
   m_sourceBlock.Deserialize (p, bufSize);
 
   delete[] serializeBuf;
+}
 
-  NS_LOG_INFO ("Buffer size=" << m_sourceBlock.GetSize ());
+void
+AlFec::CopyPacket (Ptr<Packet> originalPacket, size_t paddingSize)
+{
+  NS_LOG_FUNCTION (this);
 
-  m_codec->SetSourceBlock (m_sourceBlock);
+  // The payload header, the bytes of the packet and the padding
+  AlFecHeader::PayloadHeader payloadHeader;
+  payloadHeader.SetPaddingSize (paddingSize);
+  size_t headerSize = payloadHeader.GetSerializedSize ();
+  size_t payloadSize = originalPacket->GetSize ();
+  m_packetBuffer.resize (payloadSize);
+  originalPacket->CopyData (m_packetBuffer.data (), payloadSize);
+  m_sourceBlock = Buffer ();
+  m_sourceBlock.AddAtStart (headerSize + payloadSize + paddingSize);
+  Buffer::Iterator i = m_sourceBlock.Begin ();
+  payloadHeader.Serialize (i);
+  i.Next (headerSize);
+  i.Write (m_packetBuffer.data (), payloadSize);
+  i.WriteU8 (0, paddingSize);
+
+  std::tie (m_sourceContextHandle, m_sourceContext) =
+      AlFecPacketContextStore::Get ().Insert (AlFecPacketContextStore::Capture (originalPacket));
+}
+
+size_t
+AlFec::AggregatePacket (Ptr<Packet> packet)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_codec != nullptr, "The codec hasn't been initialized");
 
-  return m_codec->GetN ();
+  // The whole packet is serialized, so that it keeps its own context
+  const size_t serializedSize = packet->GetSerializedSize ();
+  NS_ASSERT_MSG (serializedSize > 0 && serializedSize <= std::numeric_limits<uint16_t>::max (),
+                 "Packet is too large to be aggregated");
+  // Packet::Serialize writes 32-bit words, so the length prefix and each
+  // packet take a multiple of 4 bytes and every packet starts aligned
+  bool isFirst = m_aggregationBuffer.empty ();
+  size_t offset = m_aggregationBuffer.size ();
+  size_t entrySize = sizeof (uint32_t) + ALIGN (serializedSize, sizeof (uint32_t));
+  m_aggregationBuffer.resize (offset + entrySize, 0);
+  uint16_t length = htons (serializedSize);
+  memcpy (&m_aggregationBuffer[offset], &length, sizeof (uint16_t));
+  packet->Serialize (&m_aggregationBuffer[offset + sizeof (uint32_t)], serializedSize);
+  NS_LOG_INFO ("Aggregated packet with serialized size=" << serializedSize
+                                                         << ", block size="
+                                                         << m_aggregationBuffer.size ());
+
+  if (m_aggregationBuffer.size () >= m_flushSize)
+    {
+      return Flush ();
+    }
+  if (isFirst && m_flushTimeout.IsStrictlyPositive ())
+    {
+      m_flushEvent = Simulator::Schedule (m_flushTimeout, &AlFec::FlushOnTimeout, this);
+    }
+  return 0;
+}
+
+size_t
+AlFec::Flush ()
+{
+  NS_LOG_FUNCTION (this);
+  m_flushEvent.Cancel ();
+  if (m_aggregationBuffer.empty ())
+    {
+      return 0;
+    }
+
+  // A zero length prefix in the padding ends the block
+  size_t symbolSize = m_codec->GetSymbolSize ();
+  size_t size = m_aggregationBuffer.size ();
+  size_t paddingSize = (symbolSize - (size % symbolSize)) % symbolSize;
+  m_aggregationBuffer.resize (size + paddingSize, 0);
+
+  m_originalPacket = Ptr<Packet> ();
+  m_sourceContext = nullptr;
+  m_sourceContextHandle = AlFecPacketContextStore::EMPTY;
+  m_sourceBlock = Buffer ();
+  m_sourceBlock.AddAtStart (m_aggregationBuffer.size ());
+  m_sourceBlock.Begin ().Write (m_aggregationBuffer.data (), m_aggregationBuffer.size ());
+  m_aggregationBuffer.clear ();
+
+  m_aggregated = true;
+  m_directPacket = false;
+  return EncodeSourceBlock ();
+}
+
+void
+AlFec::FlushOnTimeout ()
+{
+  NS_LOG_FUNCTION (this);
+  size_t n = Flush ();
+  if (!m_flushCallback.IsNull ())
+    {
+      m_flushCallback (n);
+    }
+}
+
+void
+AlFec::SetFlushCallback (Callback<void, size_t> cb)
+{
+  m_flushCallback = cb;
+}
+
+size_t
+AlFec::EncodeSourceBlock ()
+{
+  NS_LOG_FUNCTION (this);
+
+  // Split the block into source blocks. The buffer is a whole number of
+  // symbols thanks to the padding.
+  size_t symbolSize = m_codec->GetSymbolSize ();
+  NS_ASSERT_MSG (symbolSize > 0 && symbolSize <= std::numeric_limits<uint16_t>::max (),
+                 "The symbol size does not fit in the tag");
+  size_t maxBlockLength = m_codec->GetMaxSourceBlockLength ();
+  if (m_maxBlockLength > 0)
+    {
+      maxBlockLength = std::min<size_t> (maxBlockLength, m_maxBlockLength);
+    }
+  // K is carried in 16 bits
+  maxBlockLength = std::min<size_t> (maxBlockLength, std::numeric_limits<uint16_t>::max ());
+  m_partition.Compute (m_sourceBlock.GetSize () / symbolSize, maxBlockLength);
+  NS_ASSERT_MSG (m_partition.GetNbBlocks () <= std::numeric_limits<uint16_t>::max (),
+                 "Too many source blocks");
+
+  // Each source block is encoded independently by its own codec, which
+  // copies its part of the buffer without another Buffer
+  const uint8_t *sourceData = m_sourceBlock.PeekData ();
+  size_t n = 0;
+  for (size_t sbn = 0; sbn < m_partition.GetNbBlocks (); sbn++)
+    {
+      AlFecCodec *codec = GetBlockCodec (sbn);
+      codec->SetSourceBlock (sourceData + m_partition.GetBlockOffset (sbn) * symbolSize,
+                             m_partition.GetBlockLength (sbn) * symbolSize);
+      n += codec->GetN ();
+    }
+  m_sbn = 0;
+  m_sn = m_nextSn++;
+
+  // The context stays pinned while the symbols of the block may be in flight
+  if (m_sourceContextHandle != AlFecPacketContextStore::EMPTY)
+    {
+      m_pinnedContexts.emplace_back (m_sn, m_sourceContext);
+    }
+  while (!m_pinnedContexts.empty () &&
+         static_cast<uint16_t> (m_sn - m_pinnedContexts.front ().first) >= m_contextPinWindow)
+    {
+      m_pinnedContexts.pop_front ();
+    }
+
+  return n;
 }
 
 std::optional<Ptr<Packet>>
@@ -123,34 +452,81 @@ AlFec::NextEncodedPacket ()
 {
   NS_LOG_FUNCTION (this);
 
-  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
-  unsigned int esi;
-  Buffer content;
-  Ptr<Packet> p;
-  AlFecHeader::EncodeHeader encodeHeader;
-  uint8_t *buf;
+  std::optional<std::pair<unsigned int, const uint8_t *>> encodedSymbol;
 
-  encodedBlock = m_codec->NextEncodedBlock ();
-  if (!encodedBlock)
+  // The source blocks are sent one after another
+  AlFecCodec *codec = nullptr;
+  for (; m_sbn < m_partition.GetNbBlocks (); m_sbn++)
+    {
+      codec = GetBlockCodec (m_sbn);
+      // The symbol is copied once, from the codec memory into the packet
+      encodedSymbol = codec->NextEncodedSymbol ();
+      if (encodedSymbol)
+        {
+          break;
+        }
+    }
+  if (!encodedSymbol)
     {
       return std::nullopt;
     }
-  esi = encodedBlock->first;
-  content = encodedBlock->second;
+  return CreateEncodedPacket (codec, encodedSymbol->first, encodedSymbol->second,
+                              CreateEncodeTag (codec));
+}
 
-  buf = new uint8_t[content.GetSize ()];
-  content.CopyData (buf, content.GetSize ());
-  p = Create<Packet> (buf, content.GetSize ());
-  delete[] buf;
+std::vector<Ptr<Packet>>
+AlFec::EncodeBatch (const std::vector<Ptr<Packet>> &packets)
+{
+  NS_LOG_FUNCTION (this << packets.size ());
 
-  encodeHeader.SetEncodedSymbolId (esi);
-  p->AddHeader (encodeHeader);
+  std::vector<Ptr<Packet>> encodedPackets;
+  for (Ptr<Packet> packet : packets)
+    {
+      EncodePacket (packet);
+
+      // The tag is the same for every symbol of a source block
+      for (; m_sbn < m_partition.GetNbBlocks (); m_sbn++)
+        {
+          AlFecCodec *codec = GetBlockCodec (m_sbn);
+          AlFecInfoTag encodeTag = CreateEncodeTag (codec);
+          std::optional<std::pair<unsigned int, const uint8_t *>> encodedSymbol;
+          while ((encodedSymbol = codec->NextEncodedSymbol ()))
+            {
+              encodedPackets.push_back (CreateEncodedPacket (codec, encodedSymbol->first,
+                                                             encodedSymbol->second, encodeTag));
+            }
+        }
+    }
+  return encodedPackets;
+}
 
+AlFecInfoTag
+AlFec::CreateEncodeTag (AlFecCodec *codec) const
+{
   // Append K and the context of original packet
   AlFecInfoTag encodeTag;
-  encodeTag.SetPacketContext (m_sourceContext);
-  encodeTag.SetK (m_codec->GetK ());
-  encodeTag.SetSymbolSize (m_codec->GetSymbolSize ());
+  encodeTag.SetContextHandle (m_sourceContextHandle);
+  encodeTag.SetK (codec->GetK ());
+  encodeTag.SetNbSourceBlocks (m_partition.GetNbBlocks ());
+  encodeTag.SetAggregated (m_aggregated);
+  encodeTag.SetDirectPacket (m_directPacket);
+  encodeTag.SetSymbolSize (codec->GetSymbolSize ());
+  return encodeTag;
+}
+
+Ptr<Packet>
+AlFec::CreateEncodedPacket (AlFecCodec *codec, unsigned int esi, const uint8_t *symbol,
+                            const AlFecInfoTag &encodeTag) const
+{
+  NS_ASSERT_MSG (esi <= std::numeric_limits<uint16_t>::max (),
+                 "ESI does not fit in the header, lower maxSourceBlockLength");
+  Ptr<Packet> p = Create<Packet> (symbol, codec->GetSymbolSize ());
+
+  AlFecHeader::EncodeHeader encodeHeader;
+  encodeHeader.SetSequenceNumber (m_sn);
+  encodeHeader.SetSourceBlockNumber (m_sbn);
+  encodeHeader.SetEncodedSymbolId (esi);
+  p->AddHeader (encodeHeader);
   p->AddByteTag (encodeTag);
 
   NS_LOG_LOGIC ("New encoded block " << encodeHeader << "; " << encodeTag);
@@ -159,10 +535,47 @@ AlFec::NextEncodedPacket ()
 }
 
 std::optional<Ptr<Packet>>
-AlFec::DecodePacket (Ptr<Packet> p)
+AlFec::DecodePacket (Ptr<Packet> p, uint32_t flowId)
 {
   NS_LOG_FUNCTION (this);
 
+  bool isLate;
+  m_decoderContexts.SetLimits (m_maxDecoderContexts, m_maxDecoderMemory, m_decoderContextTimeout);
+  return DecodeSymbol (p, flowId, Simulator::Now (), &isLate);
+}
+
+std::vector<Ptr<Packet>>
+AlFec::DecodeBatch (const std::vector<Ptr<Packet>> &packets, uint32_t flowId)
+{
+  NS_LOG_FUNCTION (this << packets.size () << flowId);
+
+  // The limits and the time are the same for the whole burst
+  std::vector<Ptr<Packet>> decodedPackets;
+  m_decoderContexts.SetLimits (m_maxDecoderContexts, m_maxDecoderMemory, m_decoderContextTimeout);
+  Time now = Simulator::Now ();
+  for (Ptr<Packet> p : packets)
+    {
+      bool isLate;
+      std::optional<Ptr<Packet>> decodedPacket = DecodeSymbol (p, flowId, now, &isLate);
+      if (!decodedPacket || isLate)
+        {
+          continue;
+        }
+      decodedPackets.push_back (*decodedPacket);
+      // The following packets of an aggregated block
+      while ((decodedPacket = NextDecodedPacket ()))
+        {
+          decodedPackets.push_back (*decodedPacket);
+        }
+    }
+  return decodedPackets;
+}
+
+std::optional<Ptr<Packet>>
+AlFec::DecodeSymbol (Ptr<Packet> p, uint32_t flowId, Time now, bool *isLate)
+{
+  NS_LOG_FUNCTION (this << flowId);
+
   // int ret;
   // uint8_t *buf;
   AlFecHeader::EncodeHeader encodeHeader;
@@ -172,39 +585,97 @@ AlFec::DecodePacket (Ptr<Packet> p)
 
   NS_LOG_LOGIC ("Decode with block " << encodeHeader << "; " << encodeTag);
 
+  NS_ASSERT_MSG (m_codec != nullptr, "The codec hasn't been initialized");
+
+  // Find the decoding state of the source block
+  AlFecDecoderContextTable::Context *context =
+      m_decoderContexts.Lookup (flowId, encodeHeader.GetSequenceNumber (), now);
+
   // The source packet has already decoded, there's no need to decode again.
-  if (m_originalPacket)
+  // The packets of an aggregated block are only delivered once.
+  *isLate = context->complete;
+  if (context->complete)
     {
-      return m_originalPacket;
+      if (!context->packet)
+        {
+          return std::nullopt;
+        }
+      return context->packet;
     }
 
-  NS_ASSERT_MSG (m_codec != nullptr, "The codec hasn't been initialized");
-
-  // Initialize the decoder
-  if (m_codec->GetK () == 0)
+  // Initialize the decoder of the source block
+  uint16_t sbn = encodeHeader.GetSourceBlockNumber ();
+  if (context->decodedBlocks.empty ())
     {
-      uint16_t k = encodeTag.GetK ();
-      m_codec->SetK (k);
+      context->decodedBlocks.resize (encodeTag.GetNbSourceBlocks ());
+      context->codecs.assign (encodeTag.GetNbSourceBlocks (), nullptr);
+      if (!encodeTag.IsAggregated ())
+        {
+          context->packetContext =
+              AlFecPacketContextStore::Get ().Lookup (encodeTag.GetContextHandle ());
+        }
     }
+  NS_ASSERT_MSG (sbn < context->decodedBlocks.size (), "SBN out of range");
+  if (context->decodedBlocks[sbn])
+    {
+      return std::nullopt;
+    }
+  bool isNewCodec = context->codecs[sbn] == nullptr;
+  AlFecCodec *codec = m_decoderContexts.GetCodec (context, sbn, encodeTag.GetK ());
 
-  // Decode with new symbol
+  // Decode with new symbol. If the codec exposes the slot of the symbol, the
+  // packet content is copied there directly.
+  unsigned int esi = encodeHeader.GetEncodedSymbolId ();
   uint16_t symbolSize = encodeTag.GetSymbolSize ();
-  uint8_t *buf = new uint8_t[symbolSize];
-  Buffer newBlock;
   std::optional<Buffer> decodedBlock;
-  p->CopyData (buf, symbolSize);
-  newBlock.AddAtStart (symbolSize);
-  newBlock.Begin ().Write (buf, symbolSize);
-  decodedBlock = m_codec->Decode (newBlock, encodeHeader.GetEncodedSymbolId ());
-  delete[] buf;
+  uint8_t *slot = codec->GetSymbolBuffer (esi);
+  if (!slot)
+    {
+      m_symbolBuffer.resize (symbolSize);
+      slot = m_symbolBuffer.data ();
+    }
+  p->CopyData (slot, symbolSize);
+  decodedBlock = codec->Decode (slot, symbolSize, esi);
 
+  bool earlyDelivery = !m_earlyDeliveryCallback.IsNull () && !encodeTag.IsAggregated ();
   if (!decodedBlock)
+    {
+      if (isNewCodec)
+        {
+          m_decoderContexts.UpdateMemoryUsage (context);
+        }
+      if (earlyDelivery && esi < codec->GetK ())
+        {
+          DeliverInOrder (context, symbolSize);
+        }
+      return std::nullopt;
+    }
+
+  // Wait for the other source blocks, then put them back together
+  NS_LOG_INFO ("Decoded source block " << sbn);
+  bool isComplete = m_decoderContexts.FinishBlock (context, sbn, *decodedBlock);
+  if (earlyDelivery)
+    {
+      DeliverInOrder (context, symbolSize);
+    }
+  if (!isComplete)
     {
       return std::nullopt;
     }
+  decodedBlock = *context->decodedBlocks[0];
+  for (size_t i = 1; i < context->decodedBlocks.size (); i++)
+    {
+      decodedBlock->AddAtEnd (*context->decodedBlocks[i]);
+    }
 
   NS_LOG_INFO ("Length of decoded block=" << decodedBlock->GetSize ());
 
+  if (encodeTag.IsAggregated ())
+    {
+      m_decoderContexts.Complete (context, Ptr<Packet> ());
+      return DeaggregatePackets (*decodedBlock);
+    }
+
   // Remove the padding of decoded packet at the buffer level
   Buffer header = *decodedBlock;
   AlFecHeader::PayloadHeader payloadHeader;
@@ -214,30 +685,189 @@ AlFec::DecodePacket (Ptr<Packet> p)
   decodedBlock->RemoveAtEnd (paddingSize);
   NS_LOG_INFO ("Buffer size=" << decodedBlock->GetSize ());
 
-  // Restore the context of original packet
-  uint8_t *cur;
-  Buffer packetContext = encodeTag.GetPacketContext ();
+  // Restore the context of original packet. The decoder context pins it from
+  // the first symbol on, but it may have been evicted before that symbol came.
+  if (!context->packetContext)
+    {
+      context->packetContext =
+          AlFecPacketContextStore::Get ().Lookup (encodeTag.GetContextHandle ());
+    }
+  if (!context->packetContext)
+    {
+      NS_LOG_WARN ("Context of source block " << encodeHeader.GetSequenceNumber ()
+                                               << " evicted, the packet is dropped");
+      m_nbLostContexts++;
+      m_decoderContexts.Complete (context, Ptr<Packet> ());
+      return std::nullopt;
+    }
+  Ptr<Packet> decodedPacket;
+  if (encodeTag.IsDirectPacket ())
+    {
+      // The bytes after the payload header are the packet
+      size_t headerSize = payloadHeader.GetSerializedSize ();
+      decodedPacket = Create<Packet> (decodedBlock->PeekData () + headerSize,
+                                      decodedBlock->GetSize () - headerSize);
+      AlFecPacketContextStore::Restore (*context->packetContext, decodedPacket);
+    }
+  else
+    {
+      decodedPacket = DeserializePacket (*decodedBlock, *context->packetContext);
+    }
+
+  m_decoderContexts.Complete (context, decodedPacket);
+
+  return decodedPacket;
+}
+
+Ptr<Packet>
+AlFec::DeserializePacket (const Buffer &block, const Buffer &packetContext)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint8_t *buf, *cur;
   size_t serializedSize =
-      packetContext.GetSize () + (sizeof (uint32_t) + decodedBlock->GetSerializedSize ());
+      packetContext.GetSize () + (sizeof (uint32_t) + block.GetSerializedSize ());
   serializedSize = ALIGN (serializedSize, sizeof (uint32_t));
   buf = new uint8_t[serializedSize];
   cur = buf;
   packetContext.CopyData (cur, packetContext.GetSize ());
   cur += ALIGN (packetContext.GetSize (), sizeof (uint32_t));
-  *reinterpret_cast<uint32_t *> (cur) = decodedBlock->GetSerializedSize () + sizeof (uint32_t);
+  *reinterpret_cast<uint32_t *> (cur) = block.GetSerializedSize () + sizeof (uint32_t);
   cur += sizeof (uint32_t);
-  decodedBlock->Serialize (cur, decodedBlock->GetSerializedSize ());
+  block.Serialize (cur, block.GetSerializedSize ());
 
   // Deserialized the decoded packet with original context
   Ptr<Packet> decodedPacket = Create<Packet> (buf, serializedSize, true);
+  delete[] buf;
 
   // Process the deserialized packet
-
+  AlFecHeader::PayloadHeader payloadHeader;
   decodedPacket->RemoveHeader (payloadHeader);
+  return decodedPacket;
+}
 
-  m_originalPacket = decodedPacket;
+void
+AlFec::SetEarlyDeliveryCallback (Callback<void, uint32_t, uint16_t, uint32_t, Ptr<Packet>> cb)
+{
+  m_earlyDeliveryCallback = cb;
+}
 
-  return m_originalPacket;
+void
+AlFec::DeliverInOrder (AlFecDecoderContextTable::Context *context, size_t symbolSize)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Gather the available symbols that follow the delivered ones, in the
+  // order of the sub-blocks
+  m_deliveryBuffer.clear ();
+  size_t nbBlocks = context->decodedBlocks.size ();
+  while (context->deliveredBlock < nbBlocks)
+    {
+      size_t sbn = context->deliveredBlock;
+      const std::optional<Buffer> &decodedBlock = context->decodedBlocks[sbn];
+      AlFecCodec *codec = context->codecs[sbn];
+      if (!decodedBlock && !codec)
+        {
+          break;
+        }
+      size_t k = decodedBlock ? decodedBlock->GetSize () / symbolSize : codec->GetK ();
+      if (context->deliveredSymbols == k)
+        {
+          context->deliveredBlock++;
+          context->deliveredSymbols = 0;
+          continue;
+        }
+      size_t esi = context->deliveredSymbols;
+      const uint8_t *symbol = decodedBlock ? decodedBlock->PeekData () + esi * symbolSize
+                                           : codec->GetSourceSymbol (esi);
+      if (!symbol)
+        {
+          break;
+        }
+
+      // The payload header starts the packet and the padding ends it
+      size_t begin = 0;
+      size_t end = symbolSize;
+      if (sbn == 0 && esi == 0)
+        {
+          Buffer header;
+          header.AddAtStart (symbolSize);
+          header.Begin ().Write (symbol, symbolSize);
+          AlFecHeader::PayloadHeader payloadHeader;
+          payloadHeader.Deserialize (header.Begin ());
+          context->paddingSize = payloadHeader.GetPaddingSize ();
+          begin = payloadHeader.GetSerializedSize ();
+        }
+      if (sbn + 1 == nbBlocks && esi + 1 == k)
+        {
+          end -= context->paddingSize;
+        }
+      m_deliveryBuffer.insert (m_deliveryBuffer.end (), symbol + begin, symbol + end);
+      context->deliveredSymbols++;
+    }
+
+  if (m_deliveryBuffer.empty ())
+    {
+      return;
+    }
+  uint32_t offset = context->deliveredBytes;
+  context->deliveredBytes += m_deliveryBuffer.size ();
+  NS_LOG_INFO ("Early delivery of " << m_deliveryBuffer.size () << " bytes at offset " << offset);
+  m_earlyDeliveryCallback (context->flowId, context->sn, offset,
+                           Create<Packet> (m_deliveryBuffer.data (), m_deliveryBuffer.size ()));
+}
+
+std::optional<Ptr<Packet>>
+AlFec::DeaggregatePackets (const Buffer &block)
+{
+  NS_LOG_FUNCTION (this);
+
+  std::vector<uint8_t> content (block.GetSize ());
+  block.CopyData (content.data (), content.size ());
+
+  // The packets start on 32-bit boundaries of the block, see AggregatePacket
+  size_t offset = 0;
+  size_t nbPackets = 0;
+  while (offset + sizeof (uint32_t) <= content.size ())
+    {
+      uint16_t length;
+      memcpy (&length, &content[offset], sizeof (uint16_t));
+      length = ntohs (length);
+      offset += sizeof (uint32_t);
+      if (length == 0)
+        {
+          break;
+        }
+      NS_ASSERT_MSG (offset + length <= content.size (), "Corrupted aggregated block");
+      m_decodedPackets.push_back (Create<Packet> (&content[offset], length, true));
+      offset += ALIGN (length, sizeof (uint32_t));
+      nbPackets++;
+    }
+  NS_LOG_INFO ("Restored " << nbPackets << " aggregated packets");
+
+  if (nbPackets == 0)
+    {
+      return std::nullopt;
+    }
+  return NextDecodedPacket ();
+}
+
+std::optional<Ptr<Packet>>
+AlFec::NextDecodedPacket ()
+{
+  if (m_decodedPackets.empty ())
+    {
+      return std::nullopt;
+    }
+  Ptr<Packet> p = m_decodedPackets.front ();
+  m_decodedPackets.pop_front ();
+  return p;
+}
+
+size_t
+AlFec::GetNbLostContexts () const
+{
+  return m_nbLostContexts;
 }
 
 } // namespace ns3
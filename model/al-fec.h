@@ -3,15 +3,32 @@
 
 #include "ns3/packet.h"
 #include "ns3/object.h"
+#include "ns3/object-factory.h"
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
 #include "ns3/al-fec-codec.h"
+#include "ns3/al-fec-block-partition.h"
+#include "ns3/al-fec-decoder-context-table.h"
+#include "ns3/al-fec-packet-context-store.h"
+#include <deque>
 #include <optional>
+#include <vector>
 
 namespace ns3 {
 
+class AlFecInfoTag;
+
 /**
  * \brief The main API of AL-FEC.
  * Internally, it deal with packet encapsulation and interpretation.
  * It does not response to encode and decode.
+ *
+ * The state different instances share (the packet context store, and the
+ * tables, caches and pools of their codecs) is synchronized, and the codecs
+ * encode on their Buffer-free path, so different instances may be used from
+ * different threads at the same time. Each instance still handles ns-3
+ * packets and reads the clock of its simulator, which the threads must allow.
 */
 class AlFec : public Object
 {
@@ -29,16 +46,60 @@ public:
 
   /**
    * \brief Assign a new codec
+   *
+   * Packets larger than the largest source block of the codec are split into
+   * several source blocks, each handled by its own codec. The codec of the
+   * first block is the given one, the others are created with the same type
+   * and attributes, which requires the codec to be an Object with a constructor.
   */
   void SetCodec(AlFecCodec* codec);
 
+  /**
+   * \brief Forget the current packet and the source blocks being decoded,
+   * and reset the codec.
+   * The encoder does not need this: every EncodePacket starts a new block.
+  */
+  void Reset ();
+
   /**
    * \brief Specify the original packet to be encoded
-   * 
+   *
+   * The packet is serialized, so that the decoded packet is identical. With
+   * the directPacketPath attribute, its bytes are copied and its tags and nix
+   * vector captured instead, which skips the serialization but gives the
+   * decoded packet a new UID and no header metadata.
+   *
    * \return The number of resulting packet
   */
   size_t EncodePacket (Ptr<Packet> p);
 
+  /**
+   * \brief Add a packet to the source block being aggregated.
+   *
+   * Several packets are put in one source block, each prefixed by its length.
+   * The prefix and the packets are padded to 4 bytes, so that the packets
+   * are serialized and deserialized at aligned addresses.
+   * The block is encoded once it reaches flushSize bytes, or flushTimeout
+   * after its first packet, whichever comes first. Encoding the block starts
+   * a new one, like EncodePacket does.
+   *
+   * \return The number of resulting packet if the block got encoded, 0 otherwise
+  */
+  size_t AggregatePacket (Ptr<Packet> p);
+
+  /**
+   * \brief Encode the source block being aggregated, if any
+   *
+   * \return The number of resulting packet
+  */
+  size_t Flush ();
+
+  /**
+   * \brief Set the callback invoked with the number of resulting packet when
+   * flushTimeout encodes the aggregated source block
+  */
+  void SetFlushCallback (Callback<void, size_t> cb);
+
   /**
    * \brief Get the next packet of encoded block
    * 
@@ -47,21 +108,199 @@ public:
   */
   std::optional<Ptr<Packet>> NextEncodedPacket ();
 
+  /**
+   * \brief Encode several packets in one call
+   *
+   * Same as EncodePacket followed by NextEncodedPacket until std::nullopt for
+   * each packet, but the tag of the encoded packets is built once per source
+   * block instead of once per symbol.
+   *
+   * \return The encoded packets of every packet, in order
+  */
+  std::vector<Ptr<Packet>> EncodeBatch (const std::vector<Ptr<Packet>> &packets);
+
   /**
    * \brief Try to decode original packet with received packet
-   * 
-   * \return If the source packet successfully decoded, return the decoded packet.
-   * Other, return std::nullopt
+   *
+   * Source blocks are told apart by the flow id and their sequence number,
+   * so the symbols of many blocks may be interleaved. Late symbols of a
+   * decoded packet return the packet again, as long as its context is not
+   * evicted. The packet context is held from the first symbol of a block
+   * on, and the encoder pins the contexts of its last contextPinWindow
+   * source blocks. A block whose context left the store before its first
+   * symbol came is decoded but dropped, and counted by GetNbLostContexts.
+   *
+   * \param p The received packet
+   * \param flowId Identifies the sender, e.g. a hash of its address and port
+   *
+   * \return If every source block of the source packet successfully decoded,
+   * return the decoded packet. Other, return std::nullopt
+  */
+  std::optional<Ptr<Packet>> DecodePacket (Ptr<Packet> p, uint32_t flowId = 0);
+
+  /**
+   * \brief Decode a burst of received packets in one call
+   *
+   * Same as DecodePacket for each packet, with the limits of the decoder
+   * contexts and the current time read once per burst. The packets of the
+   * aggregated source blocks are returned as well, so NextDecodedPacket is
+   * not needed.
+   *
+   * \param packets The received packets
+   * \param flowId Identifies the sender, as in DecodePacket
+   *
+   * \return The packets decoded by this burst, in the order they completed.
+   * Late symbols of the packets already decoded do not return them again.
+  */
+  std::vector<Ptr<Packet>> DecodeBatch (const std::vector<Ptr<Packet>> &packets,
+                                        uint32_t flowId = 0);
+
+  /**
+   * \brief Set the callback receiving the bytes of the packets being decoded
+   * as soon as they are contiguous, i.e. early delivery. A null callback,
+   * the default, disables it.
+   *
+   * The source symbols are the original content, so every source symbol
+   * that follows the bytes already delivered is delivered on arrival. The
+   * gaps, and the bytes after them, are delivered once their source blocks
+   * decode. The callback gets the flow id, the sequence number of the
+   * packet, the offset of the bytes in the packet and the bytes, and it gets
+   * every byte of the packet once and in order. DecodePacket still returns
+   * the whole packet. The packets of aggregated source blocks are not
+   * delivered early.
+  */
+  void SetEarlyDeliveryCallback (Callback<void, uint32_t, uint16_t, uint32_t, Ptr<Packet>> cb);
+
+  /**
+   * \brief Get the next packet of a decoded aggregated source block.
+   * DecodePacket returns the first packet of the block, the following ones
+   * are returned by this method in their original order.
+   *
+   * \return If there's an undelivered packet, return it. Other, return std::nullopt
+  */
+  std::optional<Ptr<Packet>> NextDecodedPacket ();
+
+  /**
+   * \brief Get the number of decoded packets dropped because their packet
+   * context had been evicted from the store
   */
-  std::optional<Ptr<Packet>> DecodePacket (Ptr<Packet> p);
+  size_t GetNbLostContexts () const;
 
 private:
+  /**
+   * \brief Split m_sourceBlock into source blocks and encode them
+   *
+   * \return The number of resulting packet
+  */
+  size_t EncodeSourceBlock ();
+
+  /**
+   * \brief Build the tag of the encoded packets of a source block
+  */
+  AlFecInfoTag CreateEncodeTag (AlFecCodec *codec) const;
+
+  /**
+   * \brief Build the encoded packet of a symbol of source block m_sbn
+  */
+  Ptr<Packet> CreateEncodedPacket (AlFecCodec *codec, unsigned int esi, const uint8_t *symbol,
+                                   const AlFecInfoTag &encodeTag) const;
+
+  /**
+   * \brief Decode a received packet, once the limits of the decoder contexts are set
+   *
+   * \param isLate Set to whether the packet belongs to an already decoded source block
+  */
+  std::optional<Ptr<Packet>> DecodeSymbol (Ptr<Packet> p, uint32_t flowId, Time now,
+                                           bool *isLate);
+
+  /**
+   * \brief Encode the aggregated source block when flushTimeout expires
+  */
+  void FlushOnTimeout ();
+
+  /**
+   * \brief Restore the packets of a decoded aggregated source block
+   *
+   * \return The first packet
+  */
+  std::optional<Ptr<Packet>> DeaggregatePackets (const Buffer &block);
+
+  /**
+   * \brief Deliver the bytes that follow the ones already delivered, from
+   * the received source symbols and the decoded source blocks
+  */
+  void DeliverInOrder (AlFecDecoderContextTable::Context *context, size_t symbolSize);
+
+  /**
+   * \brief Get the codec of the given source block, creating it if needed
+  */
+  AlFecCodec *GetBlockCodec (size_t sbn);
+
+  /**
+   * \brief Dispose the codecs created for the source blocks other than the first one
+  */
+  void ReleaseBlockCodecs ();
+
+  /**
+   * \brief Build m_sourceBlock and the context of a packet by serializing it
+   */
+  void SerializePacket (Ptr<Packet> originalPacket, size_t paddingSize);
+
+  /**
+   * \brief Build m_sourceBlock from the bytes of a packet and capture its
+   * tags with AlFecPacketContextStore::Capture
+   */
+  void CopyPacket (Ptr<Packet> originalPacket, size_t paddingSize);
+
+  /**
+   * \brief Rebuild a decoded packet from its serialized context and its
+   * decoded block, padding removed
+   */
+  Ptr<Packet> DeserializePacket (const Buffer &block, const Buffer &packetContext);
+
   Ptr<Packet> m_originalPacket;
-  Buffer m_sourceContext;
+  bool m_directPacketPath; // Whether packets are copied instead of serialized. For configuration.
+  AlFecPacketContextStore::Context m_sourceContext; // Context of the packet being encoded
+  uint32_t m_sourceContextHandle; // Handle of m_sourceContext in the store
   Buffer m_sourceBlock;
-  AlFecCodec* m_codec;
+  AlFecCodec* m_codec; // Codec of the first source block
+  uint32_t m_maxBlockLength; // Maximum number of source symbols per block. For configuration.
+
+  // Source blocks
+  bool m_hasCodecFactory; // Whether m_codecFactory can duplicate m_codec
+  ObjectFactory m_codecFactory; // Type and attributes of m_codec
+  std::vector<Ptr<Object>> m_blockCodecObjects; // Codecs of the blocks after the first one
+  std::vector<AlFecCodec *> m_blockCodecs; // Same as m_blockCodecObjects
+  AlFecBlockPartition m_partition; // Partition of the packet being encoded
+  size_t m_sbn; // Source block being sent
+
+  // Encode
+  uint16_t m_sn; // Sequence number of the source block being sent
+  uint16_t m_nextSn; // Sequence number of the next source block
+  bool m_aggregated; // Whether the source block being sent aggregates several packets
+  bool m_directPacket; // Whether the packet being sent was copied instead of serialized
+  std::vector<uint8_t> m_aggregationBuffer; // Length-prefixed packets waiting to be encoded
+  std::vector<uint8_t> m_packetBuffer; // Content of the packet being copied
+  uint32_t m_flushSize; // Size that triggers the encoding of the aggregated block. For configuration.
+  Time m_flushTimeout; // Delay that triggers the encoding of the aggregated block. For configuration.
+  EventId m_flushEvent; // Pending flushTimeout
+  uint16_t m_contextPinWindow; // Source blocks whose context stays pinned. For configuration.
+  // Packet contexts of the last source blocks sent, with their sequence number
+  std::deque<std::pair<uint16_t, AlFecPacketContextStore::Context>> m_pinnedContexts;
+  Callback<void, size_t> m_flushCallback; // Notified of the flushTimeout encodings
+
+  // Decode
+  AlFecDecoderContextTable m_decoderContexts; // Source blocks being decoded
+  uint32_t m_maxDecoderContexts; // For configuration.
+  uint64_t m_maxDecoderMemory; // For configuration.
+  Time m_decoderContextTimeout; // For configuration.
+  std::deque<Ptr<Packet>> m_decodedPackets; // Undelivered packets of aggregated blocks
+  size_t m_nbLostContexts; // Decoded packets dropped for lack of their context
+  std::vector<uint8_t> m_symbolBuffer; // Received symbol, for codecs without GetSymbolBuffer
+  Callback<void, uint32_t, uint16_t, uint32_t, Ptr<Packet>> m_earlyDeliveryCallback;
+  std::vector<uint8_t> m_deliveryBuffer; // Bytes of the next early delivery
 };
 
 } // namespace ns3
 
-#endif // AL_FEC_CODEC_H
\ No newline at end of file
+#endif // AL_FEC_H
\ No newline at end of file
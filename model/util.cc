@@ -7,8 +7,9 @@
 void
 fillRandomBytes (uint8_t *buf, unsigned int size)
 {
-  int fd = open ("/dev/random", O_RDONLY);
+  int fd = open ("/dev/urandom", O_RDONLY);
   read (fd, buf, size);
+  close (fd);
 }
 
 std::string
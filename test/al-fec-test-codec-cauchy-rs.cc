@@ -0,0 +1,275 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/object.h"
+#include "ns3/core-module.h"
+
+#include "al-fec-test-codec-cauchy-rs.h"
+#include "ns3/al-fec-codec-cauchy-rs.h"
+#include "ns3/al-fec-matrix-cache.h"
+#include "../model/util.h"
+
+#include <optional>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecCauchyRsTest");
+
+/**
+ * TestSuite
+ */
+
+AlFecCodecCauchyRsTestSuite::AlFecCodecCauchyRsTestSuite ()
+    : TestSuite ("al-fec-codec-cauchy-rs", SYSTEM)
+{
+  LogLevel logLevel = (LogLevel) (LOG_PREFIX_FUNC | LOG_PREFIX_TIME | LOG_LEVEL_ALL);
+
+  LogComponentEnable ("AlFecCodecCauchyRsTest", logLevel);
+  AddTestCase (new CauchyRsDecodeTestCase (), TestCase::QUICK);
+  AddTestCase (new CauchyRsErasureTestCase (), TestCase::QUICK);
+  AddTestCase (new CauchyRsScheduleCacheTestCase (), TestCase::QUICK);
+}
+
+static AlFecCodecCauchyRsTestSuite cauchyRsTestSuite;
+
+/**
+ * TestCase 1
+ */
+
+CauchyRsDecodeTestCase::CauchyRsDecodeTestCase () : TestCase ("Check decoding")
+{
+  NS_LOG_INFO ("Creating CauchyRsDecodeTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecCauchyRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+CauchyRsDecodeTestCase::~CauchyRsDecodeTestCase ()
+{
+}
+
+void
+CauchyRsDecodeTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecCauchyRs> encoderObj = m_codecFactory.Create<AlFecCodecCauchyRs> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecCauchyRs> decoderObj = m_codecFactory.Create<AlFecCodecCauchyRs> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  std::vector<std::pair<unsigned int, Buffer>> blockList;
+  std::random_device rd;
+  std::mt19937 gen (rd ());
+
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  encoder->SetSourceBlock (p);
+  NS_LOG_INFO ("Schedule of " << encoderObj->GetScheduleLength () << " packet operations");
+  while ((encodedBlock = encoder->NextEncodedBlock ()))
+    {
+      NS_TEST_ASSERT_MSG_EQ (encodedBlock->second.GetSize (), symbolSize, "Symbol size mismatch");
+      blockList.push_back (*encodedBlock);
+    }
+  NS_TEST_ASSERT_MSG_EQ (blockList.size (), encoder->GetN (), "Total symbols mismatch");
+
+  shuffle (blockList.begin (), blockList.end (), gen);
+
+  int i;
+  int k = encoder->GetK ();
+  decoder->SetK (k);
+  for (i = 0; i < (int) blockList.size (); i++)
+    {
+      decodedBlock = decoder->Decode (blockList[i].second, blockList[i].first);
+      if (decodedBlock)
+        {
+          break;
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (i + 1, k, "Should decode with k symbols");
+
+  size_t rcvdSize = decodedBlock->GetSize ();
+  uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (rcvdSize));
+  decodedBlock->CopyData (rx_buf, rcvdSize);
+
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch");
+    }
+
+  free (rx_buf);
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 2
+ */
+
+CauchyRsErasureTestCase::CauchyRsErasureTestCase () : TestCase ("Check every erasure pattern")
+{
+  NS_LOG_INFO ("Creating CauchyRsErasureTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecCauchyRs");
+  m_codecFactory.Set ("w", UintegerValue (w));
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+CauchyRsErasureTestCase::~CauchyRsErasureTestCase ()
+{
+}
+
+void
+CauchyRsErasureTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecCauchyRs> encoderObj = m_codecFactory.Create<AlFecCodecCauchyRs> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecCauchyRs> decoderObj = m_codecFactory.Create<AlFecCodecCauchyRs> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::vector<std::pair<unsigned int, Buffer>> blockList;
+
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  encoder->SetSourceBlock (p);
+  while ((encodedBlock = encoder->NextEncodedBlock ()))
+    {
+      blockList.push_back (*encodedBlock);
+    }
+  size_t k = encoder->GetK ();
+  size_t n = encoder->GetN ();
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (n, 1u << w, "N should fit in GF(2^w)");
+
+  // Each subset of k symbols is a bitmap of n bits with k bits set
+  uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (k * symbolSize));
+  int nbPatterns = 0;
+  for (uint32_t subset = 0; subset < (1u << n); subset++)
+    {
+      if (static_cast<size_t> (__builtin_popcount (subset)) != k)
+        {
+          continue;
+        }
+      nbPatterns++;
+      decoder->NextBlock ();
+      decoder->SetK (k);
+      std::optional<Buffer> decodedBlock;
+      for (size_t esi = 0; esi < n; esi++)
+        {
+          if ((subset >> esi) & 1)
+            {
+              decodedBlock = decoder->Decode (blockList[esi].second, blockList[esi].first);
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Pattern " << subset << " failed");
+      decodedBlock->CopyData (rx_buf, k * symbolSize);
+      for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i],
+                                 "Decode content mismatch in pattern " << subset);
+        }
+    }
+  NS_LOG_INFO ("Decoded " << nbPatterns << " erasure patterns of k=" << k << " n=" << n);
+
+  free (rx_buf);
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 3
+ */
+
+CauchyRsScheduleCacheTestCase::CauchyRsScheduleCacheTestCase ()
+    : TestCase ("Check schedule cache")
+{
+  NS_LOG_INFO ("Creating CauchyRsScheduleCacheTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecCauchyRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+CauchyRsScheduleCacheTestCase::~CauchyRsScheduleCacheTestCase ()
+{
+}
+
+void
+CauchyRsScheduleCacheTestCase::DoRun (void)
+{
+  AlFecMatrixCache &cache = AlFecMatrixCache::Get ();
+  cache.Clear ();
+  cache.ResetStats ();
+
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  size_t scheduleLength = 0;
+
+  // A new pair of codecs per block, as the cache is shared by all the instances
+  for (int block = 0; block < nbBlocks; block++)
+    {
+      Ptr<AlFecCodecCauchyRs> encoderObj = m_codecFactory.Create<AlFecCodecCauchyRs> ();
+      AlFecCodec *encoder = GetPointer (encoderObj);
+      Ptr<AlFecCodecCauchyRs> decoderObj = m_codecFactory.Create<AlFecCodecCauchyRs> ();
+      AlFecCodec *decoder = GetPointer (decoderObj);
+      Buffer p;
+      fillRandomBytes (buf, payloadSize);
+      p.AddAtStart (payloadSize);
+      p.Begin ().Write (buf, payloadSize);
+
+      encoder->SetSourceBlock (p);
+      if (block == 0)
+        {
+          scheduleLength = encoderObj->GetScheduleLength ();
+        }
+      NS_TEST_ASSERT_MSG_EQ (encoderObj->GetScheduleLength (), scheduleLength,
+                             "Schedule mismatch in block " << block);
+
+      // Always lose the same source symbols
+      decoder->SetK (encoder->GetK ());
+      decodedBlock = std::nullopt;
+      while ((encodedBlock = encoder->NextEncodedBlock ()) && !decodedBlock)
+        {
+          if (encodedBlock->first % 2 == 1 && encodedBlock->first < encoder->GetK ())
+            {
+              continue;
+            }
+          decodedBlock = decoder->Decode (encodedBlock->second, encodedBlock->first);
+        }
+      NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Block " << block << " not decoded");
+
+      uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (decodedBlock->GetSize ()));
+      decodedBlock->CopyData (rx_buf, decodedBlock->GetSize ());
+      for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch in block " << block);
+        }
+      free (rx_buf);
+      encoderObj->Dispose ();
+      decoderObj->Dispose ();
+    }
+
+  // The bit matrix and the schedule are built once, by the first encoder
+  AlFecMatrixCache::Stats stats = cache.GetStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.generatorMisses, 2, "Schedule should be built once");
+  NS_TEST_ASSERT_MSG_GT (stats.generatorHits, 0, "Schedule should be reused");
+  NS_TEST_ASSERT_MSG_EQ (stats.inverseMisses, 1, "Inverse should be built once");
+  NS_TEST_ASSERT_MSG_EQ (stats.inverseHits, static_cast<size_t> (nbBlocks - 1),
+                         "Inverse should be reused");
+
+  free (buf);
+}
@@ -0,0 +1,70 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef TEST_AL_FEC_CODEC_CAUCHY_RS_H
+#define TEST_AL_FEC_CODEC_CAUCHY_RS_H
+
+#include "ns3/test.h"
+
+using namespace ns3;
+
+class AlFecCodecCauchyRsTestSuite : public TestSuite
+{
+public:
+  AlFecCodecCauchyRsTestSuite ();
+};
+
+/**
+ * Test 1. Successfully decode
+ */
+class CauchyRsDecodeTestCase : public TestCase
+{
+public:
+  CauchyRsDecodeTestCase ();
+  virtual ~CauchyRsDecodeTestCase ();
+  const unsigned int symbolSize = 800;
+  const double codeRate = 0.5;
+  const int payloadSize = 30000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 2. Every K of the N symbols decode the block, with a small w
+ */
+class CauchyRsErasureTestCase : public TestCase
+{
+public:
+  CauchyRsErasureTestCase ();
+  virtual ~CauchyRsErasureTestCase ();
+  const unsigned int w = 4;
+  const unsigned int symbolSize = 8;
+  const double codeRate = 0.5;
+  const int payloadSize = 30;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 3. Repeated parameters and erasure patterns reuse the cached
+ * schedule and decoding matrix
+ */
+class CauchyRsScheduleCacheTestCase : public TestCase
+{
+public:
+  CauchyRsScheduleCacheTestCase ();
+  virtual ~CauchyRsScheduleCacheTestCase ();
+  const unsigned int symbolSize = 64;
+  const double codeRate = 0.5;
+  const int payloadSize = 2000;
+  const int nbBlocks = 3;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+#endif /* TEST_AL_FEC_CODEC_CAUCHY_RS_H */
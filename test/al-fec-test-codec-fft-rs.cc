@@ -0,0 +1,245 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/object.h"
+#include "ns3/core-module.h"
+
+#include "al-fec-test-codec-fft-rs.h"
+#include "ns3/al-fec-codec-fft-rs.h"
+#include "ns3/al-fec-gf65536.h"
+#include "../model/util.h"
+
+#include <optional>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecFftRsTest");
+
+/**
+ * TestSuite
+ */
+
+AlFecCodecFftRsTestSuite::AlFecCodecFftRsTestSuite () : TestSuite ("al-fec-codec-fft-rs", SYSTEM)
+{
+  LogLevel logLevel = (LogLevel) (LOG_PREFIX_FUNC | LOG_PREFIX_TIME | LOG_LEVEL_ALL);
+
+  LogComponentEnable ("AlFecCodecFftRsTest", logLevel);
+  AddTestCase (new FftRsDecodeTestCase (), TestCase::QUICK);
+  AddTestCase (new FftRsLargeBlockTestCase (), TestCase::QUICK);
+  AddTestCase (new FftRsDeterministicTestCase (), TestCase::QUICK);
+}
+
+static AlFecCodecFftRsTestSuite fftRsTestSuite;
+
+/**
+ * TestCase 1
+ */
+
+FftRsDecodeTestCase::FftRsDecodeTestCase () : TestCase ("Check decoding")
+{
+  NS_LOG_INFO ("Creating FftRsDecodeTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecFftRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+FftRsDecodeTestCase::~FftRsDecodeTestCase ()
+{
+}
+
+void
+FftRsDecodeTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecFftRs> encoderObj = m_codecFactory.Create<AlFecCodecFftRs> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecFftRs> decoderObj = m_codecFactory.Create<AlFecCodecFftRs> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  std::vector<std::pair<unsigned int, Buffer>> blockList;
+  std::random_device rd;
+  std::mt19937 gen (rd ());
+
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  NS_LOG_INFO ("GF(2^16) kernel " << AlFecGf65536::GetKernelName ());
+  encoder->SetSourceBlock (p);
+  while ((encodedBlock = encoder->NextEncodedBlock ()))
+    {
+      NS_TEST_ASSERT_MSG_EQ (encodedBlock->second.GetSize (), symbolSize, "Symbol size mismatch");
+      blockList.push_back (*encodedBlock);
+    }
+  NS_TEST_ASSERT_MSG_EQ (blockList.size (), encoder->GetN (), "Total symbols mismatch");
+
+  shuffle (blockList.begin (), blockList.end (), gen);
+
+  int i;
+  int k = encoder->GetK ();
+  decoder->SetK (k);
+  for (i = 0; i < (int) blockList.size (); i++)
+    {
+      decodedBlock = decoder->Decode (blockList[i].second, blockList[i].first);
+      if (decodedBlock)
+        {
+          break;
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (i + 1, k, "Should decode with k symbols");
+
+  size_t rcvdSize = decodedBlock->GetSize ();
+  uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (rcvdSize));
+  decodedBlock->CopyData (rx_buf, rcvdSize);
+
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch");
+    }
+
+  free (rx_buf);
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 2
+ */
+
+FftRsLargeBlockTestCase::FftRsLargeBlockTestCase () : TestCase ("Check a large block")
+{
+  NS_LOG_INFO ("Creating FftRsLargeBlockTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecFftRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+FftRsLargeBlockTestCase::~FftRsLargeBlockTestCase ()
+{
+}
+
+void
+FftRsLargeBlockTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecFftRs> encoderObj = m_codecFactory.Create<AlFecCodecFftRs> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecFftRs> decoderObj = m_codecFactory.Create<AlFecCodecFftRs> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  std::vector<std::pair<unsigned int, Buffer>> repairList;
+
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  encoder->SetSourceBlock (p);
+  size_t k = encoder->GetK ();
+  size_t n = encoder->GetN ();
+  NS_TEST_ASSERT_MSG_GT (k, 256u, "K should not fit in GF(2^8)");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (k, encoderObj->GetMaxSourceBlockLength (), "K too large");
+  while ((encodedBlock = encoder->NextEncodedBlock ()))
+    {
+      if (encodedBlock->first >= k)
+        {
+          repairList.push_back (*encodedBlock);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (repairList.size (), n - k, "Total repair symbols mismatch");
+
+  // Every source symbol is lost, the block decodes from the first k repair symbols
+  decoder->SetK (k);
+  size_t i;
+  for (i = 0; i < repairList.size (); i++)
+    {
+      decodedBlock = decoder->Decode (repairList[i].second, repairList[i].first);
+      if (decodedBlock)
+        {
+          break;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Block not decoded");
+  NS_TEST_ASSERT_MSG_EQ (i + 1, k, "Should decode with k symbols");
+
+  uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (decodedBlock->GetSize ()));
+  decodedBlock->CopyData (rx_buf, decodedBlock->GetSize ());
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch");
+    }
+
+  free (rx_buf);
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 3
+ */
+
+FftRsDeterministicTestCase::FftRsDeterministicTestCase () : TestCase ("Check deterministic output")
+{
+  NS_LOG_INFO ("Creating FftRsDeterministicTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecFftRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+FftRsDeterministicTestCase::~FftRsDeterministicTestCase ()
+{
+}
+
+void
+FftRsDeterministicTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecFftRs> firstObj = m_codecFactory.Create<AlFecCodecFftRs> ();
+  AlFecCodec *first = GetPointer (firstObj);
+  Ptr<AlFecCodecFftRs> secondObj = m_codecFactory.Create<AlFecCodecFftRs> ();
+  AlFecCodec *second = GetPointer (secondObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, const uint8_t *>> firstSymbol;
+  std::optional<std::pair<unsigned int, const uint8_t *>> secondSymbol;
+
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  // The second encoder encodes another block first, leaving its slabs dirty
+  Buffer other;
+  other.AddAtStart (payloadSize / 2);
+  second->SetSourceBlock (other);
+  second->NextBlock ();
+
+  first->SetSourceBlock (p);
+  second->SetSourceBlock (p);
+  NS_TEST_ASSERT_MSG_EQ (first->GetN (), second->GetN (), "N mismatch");
+  size_t nbSymbols = 0;
+  while ((firstSymbol = first->NextEncodedSymbol ()))
+    {
+      secondSymbol = second->NextEncodedSymbol ();
+      NS_TEST_ASSERT_MSG_EQ (secondSymbol.has_value (), true, "Missing symbol");
+      NS_TEST_ASSERT_MSG_EQ (firstSymbol->first, secondSymbol->first, "ESI mismatch");
+      NS_TEST_ASSERT_MSG_EQ (memcmp (firstSymbol->second, secondSymbol->second, symbolSize), 0,
+                             "Symbol " << firstSymbol->first << " differs");
+      nbSymbols++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (nbSymbols, first->GetN (), "Total symbols mismatch");
+
+  free (buf);
+  firstObj->Dispose ();
+  secondObj->Dispose ();
+}
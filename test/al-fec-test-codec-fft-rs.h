@@ -0,0 +1,68 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef TEST_AL_FEC_CODEC_FFT_RS_H
+#define TEST_AL_FEC_CODEC_FFT_RS_H
+
+#include "ns3/test.h"
+
+using namespace ns3;
+
+class AlFecCodecFftRsTestSuite : public TestSuite
+{
+public:
+  AlFecCodecFftRsTestSuite ();
+};
+
+/**
+ * Test 1. Successfully decode
+ */
+class FftRsDecodeTestCase : public TestCase
+{
+public:
+  FftRsDecodeTestCase ();
+  virtual ~FftRsDecodeTestCase ();
+  const unsigned int symbolSize = 128;
+  const double codeRate = 0.5;
+  const int payloadSize = 30000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 2. A block of far more than 256 symbols decodes from repair symbols
+ * only, which GF(2^8) codes cannot build
+ */
+class FftRsLargeBlockTestCase : public TestCase
+{
+public:
+  FftRsLargeBlockTestCase ();
+  virtual ~FftRsLargeBlockTestCase ();
+  const unsigned int symbolSize = 64;
+  const double codeRate = 0.5;
+  const int payloadSize = 4000 * 64;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 3. Two encoders give the same repair symbols for the same block
+ */
+class FftRsDeterministicTestCase : public TestCase
+{
+public:
+  FftRsDeterministicTestCase ();
+  virtual ~FftRsDeterministicTestCase ();
+  const unsigned int symbolSize = 64;
+  const double codeRate = 0.4;
+  const int payloadSize = 20000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+#endif /* TEST_AL_FEC_CODEC_FFT_RS_H */
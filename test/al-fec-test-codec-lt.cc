@@ -0,0 +1,254 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/object.h"
+#include "ns3/core-module.h"
+
+#include "al-fec-test-codec-lt.h"
+#include "ns3/al-fec-codec-lt.h"
+#include "../model/util.h"
+
+#include <optional>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecLtTest");
+
+/**
+ * TestSuite
+ */
+
+AlFecCodecLtTestSuite::AlFecCodecLtTestSuite () : TestSuite ("al-fec-codec-lt", SYSTEM)
+{
+  LogLevel logLevel = (LogLevel) (LOG_PREFIX_FUNC | LOG_PREFIX_TIME | LOG_LEVEL_ALL);
+
+  LogComponentEnable ("AlFecCodecLtTest", logLevel);
+  AddTestCase (new LtDecodeTestCase (), TestCase::QUICK);
+  AddTestCase (new LtOverheadTestCase (), TestCase::QUICK);
+  AddTestCase (new LtNeighborsTestCase (), TestCase::QUICK);
+}
+
+static AlFecCodecLtTestSuite ltTestSuite;
+
+/**
+ * TestCase 1
+ */
+
+LtDecodeTestCase::LtDecodeTestCase () : TestCase ("Check decoding")
+{
+  NS_LOG_INFO ("Creating LtDecodeTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecLt");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+LtDecodeTestCase::~LtDecodeTestCase ()
+{
+}
+
+void
+LtDecodeTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecLt> encoderObj = m_codecFactory.Create<AlFecCodecLt> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecLt> decoderObj = m_codecFactory.Create<AlFecCodecLt> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  std::vector<std::pair<unsigned int, Buffer>> blockList;
+  // A fixed seed keeps the number of symbols needed, and the test, reproducible
+  std::mt19937 gen (5053);
+
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  encoder->SetSourceBlock (p);
+  while ((encodedBlock = encoder->NextEncodedBlock ()))
+    {
+      NS_TEST_ASSERT_MSG_EQ (encodedBlock->second.GetSize (), symbolSize, "Symbol size mismatch");
+      blockList.push_back (*encodedBlock);
+    }
+  NS_TEST_ASSERT_MSG_EQ (blockList.size (), encoder->GetN (), "Total symbols mismatch");
+
+  shuffle (blockList.begin (), blockList.end (), gen);
+
+  int i;
+  int k = encoder->GetK ();
+  decoder->SetK (k);
+  for (i = 0; i < (int) blockList.size (); i++)
+    {
+      decodedBlock = decoder->Decode (blockList[i].second, blockList[i].first);
+      if (decodedBlock)
+        {
+          break;
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Decoder failed");
+  NS_LOG_INFO ("Decoded K=" << k << " with " << i + 1 << " symbols");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (i + 1, maxOverhead * k, "Too many symbols needed");
+
+  size_t rcvdSize = decodedBlock->GetSize ();
+  uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (rcvdSize));
+  decodedBlock->CopyData (rx_buf, rcvdSize);
+
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch");
+    }
+
+  free (rx_buf);
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 2
+ */
+
+LtOverheadTestCase::LtOverheadTestCase () : TestCase ("Check decoding overhead")
+{
+  NS_LOG_INFO ("Creating LtOverheadTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecLt");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+}
+
+LtOverheadTestCase::~LtOverheadTestCase ()
+{
+}
+
+void
+LtOverheadTestCase::DoRun (void)
+{
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  uint8_t *symbol = new uint8_t[symbolSize];
+  // A fixed seed keeps the overhead, and the test, reproducible
+  std::mt19937 gen (5053);
+  std::bernoulli_distribution loss (lossRate);
+  double totalOverhead = 0;
+
+  for (int trial = 0; trial < nbTrials; trial++)
+    {
+      // Each trial draws other neighbors
+      m_codecFactory.Set ("seed", UintegerValue (trial));
+      Ptr<AlFecCodecLt> encoderObj = m_codecFactory.Create<AlFecCodecLt> ();
+      Ptr<AlFecCodecLt> decoderObj = m_codecFactory.Create<AlFecCodecLt> ();
+      AlFecCodec *decoder = GetPointer (decoderObj);
+
+      Buffer p;
+      for (int i = 0; i < payloadSize; i++)
+        {
+          buf[i] = gen ();
+        }
+      p.AddAtStart (payloadSize);
+      p.Begin ().Write (buf, payloadSize);
+      encoderObj->SetSourceBlock (p);
+      size_t k = encoderObj->GetK ();
+      decoder->SetK (k);
+
+      // The symbols go on beyond N until the block is decoded
+      std::optional<Buffer> decodedBlock;
+      size_t nbReceived = 0;
+      for (unsigned int esi = 0; !decodedBlock && esi < 10 * k; esi++)
+        {
+          if (loss (gen))
+            {
+              continue;
+            }
+          encoderObj->GetEncodedSymbol (esi, symbol);
+          decodedBlock = decoder->Decode (symbol, symbolSize, esi);
+          nbReceived++;
+        }
+      NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Decoder failed in trial " << trial);
+      totalOverhead += static_cast<double> (nbReceived) / k;
+
+      uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (decodedBlock->GetSize ()));
+      decodedBlock->CopyData (rx_buf, decodedBlock->GetSize ());
+      for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch in trial " << trial);
+        }
+      free (rx_buf);
+      encoderObj->Dispose ();
+      decoderObj->Dispose ();
+    }
+
+  double averageOverhead = totalOverhead / nbTrials;
+  NS_LOG_INFO ("Average overhead " << averageOverhead << " over " << nbTrials << " blocks");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (averageOverhead, maxAverageOverhead, "Average overhead too high");
+
+  delete[] symbol;
+  free (buf);
+}
+
+/**
+ * TestCase 3
+ */
+
+LtNeighborsTestCase::LtNeighborsTestCase () : TestCase ("Check neighbors")
+{
+  NS_LOG_INFO ("Creating LtNeighborsTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecLt");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+}
+
+LtNeighborsTestCase::~LtNeighborsTestCase ()
+{
+}
+
+void
+LtNeighborsTestCase::DoRun (void)
+{
+  m_codecFactory.Set ("seed", UintegerValue (1));
+  Ptr<AlFecCodecLt> encoder = m_codecFactory.Create<AlFecCodecLt> ();
+  Ptr<AlFecCodecLt> decoder = m_codecFactory.Create<AlFecCodecLt> ();
+  m_codecFactory.Set ("seed", UintegerValue (2));
+  Ptr<AlFecCodecLt> other = m_codecFactory.Create<AlFecCodecLt> ();
+
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  fillRandomBytes (buf, payloadSize);
+  Buffer p;
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+  encoder->SetSourceBlock (p);
+  size_t k = encoder->GetK ();
+
+  // The decoder only knows K, and gets the ESIs out of order
+  decoder->SetK (k);
+  other->SetK (k);
+  std::vector<uint32_t> encoderNeighbors;
+  std::vector<uint32_t> decoderNeighbors;
+  std::vector<uint32_t> otherNeighbors;
+  size_t nbDifferent = 0;
+  for (unsigned int i = 0; i < nbSymbols; i++)
+    {
+      unsigned int esi = (i * 7919) % nbSymbols;
+      encoder->GetNeighbors (esi, encoderNeighbors);
+      decoder->GetNeighbors (esi, decoderNeighbors);
+      other->GetNeighbors (esi, otherNeighbors);
+      NS_TEST_ASSERT_MSG_EQ ((encoderNeighbors == decoderNeighbors), true,
+                             "Neighbors mismatch for ESI " << esi);
+      NS_TEST_ASSERT_MSG_GT (encoderNeighbors.size (), 0, "No neighbor for ESI " << esi);
+
+      std::set<uint32_t> distinct (encoderNeighbors.begin (), encoderNeighbors.end ());
+      NS_TEST_ASSERT_MSG_EQ (distinct.size (), encoderNeighbors.size (),
+                             "Duplicate neighbor for ESI " << esi);
+      NS_TEST_ASSERT_MSG_LT (*distinct.rbegin (), k, "Neighbor out of the block");
+      nbDifferent += encoderNeighbors != otherNeighbors;
+    }
+  NS_TEST_ASSERT_MSG_GT (nbDifferent, nbSymbols / 2, "The seed does not change the neighbors");
+
+  free (buf);
+  encoder->Dispose ();
+  decoder->Dispose ();
+  other->Dispose ();
+}
@@ -0,0 +1,70 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef TEST_AL_FEC_CODEC_LT_H
+#define TEST_AL_FEC_CODEC_LT_H
+
+#include "ns3/test.h"
+
+using namespace ns3;
+
+class AlFecCodecLtTestSuite : public TestSuite
+{
+public:
+  AlFecCodecLtTestSuite ();
+};
+
+/**
+ * Test 1. Successfully decode from shuffled symbols
+ */
+class LtDecodeTestCase : public TestCase
+{
+public:
+  LtDecodeTestCase ();
+  virtual ~LtDecodeTestCase ();
+  const unsigned int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 8000;
+  const double maxOverhead = 1.5; // Symbols needed, relative to K
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 2. The average reception overhead stays low under loss
+ */
+class LtOverheadTestCase : public TestCase
+{
+public:
+  LtOverheadTestCase ();
+  virtual ~LtOverheadTestCase ();
+  const unsigned int symbolSize = 8;
+  const int payloadSize = 8000;
+  const int nbTrials = 20;
+  const double lossRate = 0.3;
+  const double maxAverageOverhead = 1.3; // Average symbols needed, relative to K
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 3. The neighbors of a symbol only depend on the seed, K and the ESI
+ */
+class LtNeighborsTestCase : public TestCase
+{
+public:
+  LtNeighborsTestCase ();
+  virtual ~LtNeighborsTestCase ();
+  const unsigned int symbolSize = 8;
+  const int payloadSize = 800;
+  const unsigned int nbSymbols = 1000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+#endif /* TEST_AL_FEC_CODEC_LT_H */
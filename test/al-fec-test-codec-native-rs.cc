@@ -0,0 +1,507 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/object.h"
+#include "ns3/core-module.h"
+
+#include "al-fec-test-codec-native-rs.h"
+#include "ns3/al-fec-codec-native-rs.h"
+#include "ns3/al-fec-codec-openfec-rs.h"
+#include "ns3/al-fec-gf256.h"
+#include "ns3/al-fec-matrix-cache.h"
+#include "../model/util.h"
+
+#include <algorithm>
+#include <optional>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecNativeRsTest");
+
+/**
+ * TestSuite
+ */
+
+AlFecCodecNativeRsTestSuite::AlFecCodecNativeRsTestSuite ()
+    : TestSuite ("al-fec-codec-native-rs", SYSTEM)
+{
+  LogLevel logLevel = (LogLevel) (LOG_PREFIX_FUNC | LOG_PREFIX_TIME | LOG_LEVEL_ALL);
+
+  LogComponentEnable ("AlFecCodecNativeRsTest", logLevel);
+  AddTestCase (new NativeRsDecodeTestCase (), TestCase::QUICK);
+  AddTestCase (new NativeRsInteropTestCase (), TestCase::QUICK);
+  AddTestCase (new NativeRsMatrixCacheTestCase (), TestCase::QUICK);
+  AddTestCase (new NativeRsIncrementalTestCase (), TestCase::QUICK);
+  AddTestCase (new NativeRsIncrementalDecodeTestCase (), TestCase::QUICK);
+  AddTestCase (new NativeRsParallelRepairTestCase (), TestCase::QUICK);
+}
+
+static AlFecCodecNativeRsTestSuite nativeRsTestSuite;
+
+/**
+ * TestCase 1
+ */
+
+NativeRsDecodeTestCase::NativeRsDecodeTestCase () : TestCase ("Check decoding")
+{
+  NS_LOG_INFO ("Creating NativeRsDecodeTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecNativeRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+NativeRsDecodeTestCase::~NativeRsDecodeTestCase ()
+{
+}
+
+void
+NativeRsDecodeTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecNativeRs> encoderObj = m_codecFactory.Create<AlFecCodecNativeRs> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecNativeRs> decoderObj = m_codecFactory.Create<AlFecCodecNativeRs> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  std::vector<std::pair<unsigned int, Buffer>> blockList;
+  std::random_device rd;
+  std::mt19937 gen (rd ());
+
+  NS_LOG_INFO ("GF(2^8) kernel: " << AlFecGf256::GetKernelName ());
+
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  encoder->SetSourceBlock (p);
+  while ((encodedBlock = encoder->NextEncodedBlock ()))
+    {
+      NS_TEST_ASSERT_MSG_EQ (encodedBlock->second.GetSize (), symbolSize, "Symbol size mismatch");
+      blockList.push_back (*encodedBlock);
+    }
+  NS_TEST_ASSERT_MSG_EQ (blockList.size (), encoder->GetN (), "Total symbols mismatch");
+
+  shuffle (blockList.begin (), blockList.end (), gen);
+
+  int i;
+  int k = encoder->GetK ();
+  decoder->SetK (k);
+  for (i = 0; i < (int) blockList.size (); i++)
+    {
+      decodedBlock = decoder->Decode (blockList[i].second, blockList[i].first);
+      if (decodedBlock)
+        {
+          break;
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (i + 1, k, "Should decode with k symbols");
+
+  size_t rcvdSize = decodedBlock->GetSize ();
+  uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (rcvdSize));
+  decodedBlock->CopyData (rx_buf, rcvdSize);
+
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch");
+    }
+
+  free (rx_buf);
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 2
+ */
+
+NativeRsInteropTestCase::NativeRsInteropTestCase ()
+    : TestCase ("Check interoperability with OpenFEC")
+{
+  NS_LOG_INFO ("Creating NativeRsInteropTestCase");
+  m_nativeFactory.SetTypeId ("ns3::AlFecCodecNativeRs");
+  m_nativeFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_nativeFactory.Set ("codeRate", DoubleValue (codeRate));
+  m_openfecFactory.SetTypeId ("ns3::AlFecCodecOpenfecRs");
+  m_openfecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_openfecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+NativeRsInteropTestCase::~NativeRsInteropTestCase ()
+{
+}
+
+void
+NativeRsInteropTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecNativeRs> nativeEncoderObj = m_nativeFactory.Create<AlFecCodecNativeRs> ();
+  Ptr<AlFecCodecOpenfecRs> openfecEncoderObj = m_openfecFactory.Create<AlFecCodecOpenfecRs> ();
+  Ptr<AlFecCodecNativeRs> nativeDecoderObj = m_nativeFactory.Create<AlFecCodecNativeRs> ();
+  Ptr<AlFecCodecOpenfecRs> openfecDecoderObj = m_openfecFactory.Create<AlFecCodecOpenfecRs> ();
+  AlFecCodec *nativeEncoder = GetPointer (nativeEncoderObj);
+  AlFecCodec *openfecEncoder = GetPointer (openfecEncoderObj);
+  AlFecCodec *nativeDecoder = GetPointer (nativeDecoderObj);
+  AlFecCodec *openfecDecoder = GetPointer (openfecDecoderObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> nativeBlock, openfecBlock;
+  std::optional<Buffer> nativeDecoded, openfecDecoded;
+  uint8_t *nativeSymbol = new uint8_t[symbolSize];
+  uint8_t *openfecSymbol = new uint8_t[symbolSize];
+
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  nativeEncoder->SetSourceBlock (p);
+  openfecEncoder->SetSourceBlock (p);
+  NS_TEST_ASSERT_MSG_EQ (nativeEncoder->GetN (), openfecEncoder->GetN (), "N mismatch");
+  NS_TEST_ASSERT_MSG_EQ (nativeEncoder->GetK (), openfecEncoder->GetK (), "K mismatch");
+
+  size_t k = nativeEncoder->GetK ();
+  nativeDecoder->SetK (k);
+  openfecDecoder->SetK (k);
+  while ((nativeBlock = nativeEncoder->NextEncodedBlock ()) &&
+         (openfecBlock = openfecEncoder->NextEncodedBlock ()))
+    {
+      NS_TEST_ASSERT_MSG_EQ (nativeBlock->first, openfecBlock->first, "ESI mismatch");
+      nativeBlock->second.CopyData (nativeSymbol, symbolSize);
+      openfecBlock->second.CopyData (openfecSymbol, symbolSize);
+      for (int i = 0; i < symbolSize; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (nativeSymbol[i], openfecSymbol[i], "Encoded symbol mismatch");
+        }
+
+      // Drop the first half of the source symbols to force the decoders to use repair symbols
+      if (nativeBlock->first < k / 2)
+        {
+          continue;
+        }
+      if (!openfecDecoded)
+        {
+          openfecDecoded = openfecDecoder->Decode (nativeBlock->second, nativeBlock->first);
+        }
+      if (!nativeDecoded)
+        {
+          nativeDecoded = nativeDecoder->Decode (openfecBlock->second, openfecBlock->first);
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (nativeDecoded.has_value (), true, "Native decoder failed");
+  NS_TEST_ASSERT_MSG_EQ (openfecDecoded.has_value (), true, "OpenFEC decoder failed");
+
+  uint8_t *nativeBuf = new uint8_t[nativeDecoded->GetSize ()];
+  uint8_t *openfecBuf = new uint8_t[openfecDecoded->GetSize ()];
+  nativeDecoded->CopyData (nativeBuf, nativeDecoded->GetSize ());
+  openfecDecoded->CopyData (openfecBuf, openfecDecoded->GetSize ());
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], nativeBuf[i], "Native decode content mismatch");
+      NS_TEST_ASSERT_MSG_EQ (buf[i], openfecBuf[i], "OpenFEC decode content mismatch");
+    }
+
+  delete[] openfecBuf;
+  delete[] nativeBuf;
+  delete[] openfecSymbol;
+  delete[] nativeSymbol;
+  free (buf);
+  nativeEncoderObj->Dispose ();
+  openfecEncoderObj->Dispose ();
+  nativeDecoderObj->Dispose ();
+  openfecDecoderObj->Dispose ();
+}
+
+/**
+ * TestCase 3
+ */
+
+NativeRsMatrixCacheTestCase::NativeRsMatrixCacheTestCase () : TestCase ("Check matrix cache")
+{
+  NS_LOG_INFO ("Creating NativeRsMatrixCacheTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecNativeRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+NativeRsMatrixCacheTestCase::~NativeRsMatrixCacheTestCase ()
+{
+}
+
+void
+NativeRsMatrixCacheTestCase::DoRun (void)
+{
+  AlFecMatrixCache &cache = AlFecMatrixCache::Get ();
+  cache.Clear ();
+  cache.ResetStats ();
+
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+
+  // A new pair of codecs per block, as the cache is shared by all the instances
+  for (int block = 0; block < nbBlocks; block++)
+    {
+      Ptr<AlFecCodecNativeRs> encoderObj = m_codecFactory.Create<AlFecCodecNativeRs> ();
+      AlFecCodec *encoder = GetPointer (encoderObj);
+      Ptr<AlFecCodecNativeRs> decoderObj = m_codecFactory.Create<AlFecCodecNativeRs> ();
+      AlFecCodec *decoder = GetPointer (decoderObj);
+      Buffer p;
+      fillRandomBytes (buf, payloadSize);
+      p.AddAtStart (payloadSize);
+      p.Begin ().Write (buf, payloadSize);
+
+      // Always lose the same source symbols
+      encoder->SetSourceBlock (p);
+      decoder->SetK (encoder->GetK ());
+      decodedBlock = std::nullopt;
+      while ((encodedBlock = encoder->NextEncodedBlock ()) && !decodedBlock)
+        {
+          if (encodedBlock->first % 2 == 1 && encodedBlock->first < encoder->GetK ())
+            {
+              continue;
+            }
+          decodedBlock = decoder->Decode (encodedBlock->second, encodedBlock->first);
+        }
+      NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Block " << block << " not decoded");
+
+      uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (decodedBlock->GetSize ()));
+      decodedBlock->CopyData (rx_buf, decodedBlock->GetSize ());
+      for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch in block " << block);
+        }
+      free (rx_buf);
+      encoderObj->Dispose ();
+      decoderObj->Dispose ();
+    }
+
+  AlFecMatrixCache::Stats stats = cache.GetStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.generatorMisses, 1, "Generator should be built once");
+  NS_TEST_ASSERT_MSG_EQ (stats.inverseMisses, 1, "Inverse should be built once");
+  NS_TEST_ASSERT_MSG_EQ (stats.inverseHits, static_cast<size_t> (nbBlocks - 1),
+                         "Inverse should be reused");
+  NS_TEST_ASSERT_MSG_GT (stats.memoryUsage, 0, "Cache should hold the matrices");
+
+  free (buf);
+}
+
+/**
+ * TestCase 4
+ */
+
+NativeRsIncrementalTestCase::NativeRsIncrementalTestCase ()
+    : TestCase ("Check incremental encoding")
+{
+  NS_LOG_INFO ("Creating NativeRsIncrementalTestCase");
+  m_nativeFactory.SetTypeId ("ns3::AlFecCodecNativeRs");
+  m_nativeFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_nativeFactory.Set ("codeRate", DoubleValue (codeRate));
+  m_openfecFactory.SetTypeId ("ns3::AlFecCodecOpenfecRs");
+  m_openfecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_openfecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+NativeRsIncrementalTestCase::~NativeRsIncrementalTestCase ()
+{
+}
+
+void
+NativeRsIncrementalTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecNativeRs> blockObj = m_nativeFactory.Create<AlFecCodecNativeRs> ();
+  AlFecCodec *block = GetPointer (blockObj);
+  Ptr<AlFecCodecNativeRs> nativeObj = m_nativeFactory.Create<AlFecCodecNativeRs> ();
+  AlFecCodec *native = GetPointer (nativeObj);
+  Ptr<AlFecCodecOpenfecRs> openfecObj = m_openfecFactory.Create<AlFecCodecOpenfecRs> ();
+  AlFecCodec *openfec = GetPointer (openfecObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+  block->SetSourceBlock (p);
+  size_t k = block->GetK ();
+
+  // The last source symbol is shorter than the symbol size
+  native->StartSourceBlock (k);
+  openfec->StartSourceBlock (k);
+  for (size_t i = 0; i < k; i++)
+    {
+      size_t offset = i * symbolSize;
+      size_t size = std::min<size_t> (symbolSize, payloadSize - offset);
+      bool last = i + 1 == k;
+      NS_TEST_ASSERT_MSG_EQ (native->AddSourceSymbol (buf + offset, size), last,
+                             "Native block completion mismatch at " << i);
+      NS_TEST_ASSERT_MSG_EQ (openfec->AddSourceSymbol (buf + offset, size), last,
+                             "OpenFEC block completion mismatch at " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (native->GetN (), block->GetN (), "Native N mismatch");
+  NS_TEST_ASSERT_MSG_EQ (openfec->GetN (), block->GetN (), "OpenFEC N mismatch");
+
+  std::optional<std::pair<unsigned int, Buffer>> expected;
+  std::vector<uint8_t> expectedBuf (symbolSize);
+  std::vector<uint8_t> actualBuf (symbolSize);
+  while ((expected = block->NextEncodedBlock ()))
+    {
+      expected->second.CopyData (expectedBuf.data (), symbolSize);
+      for (AlFecCodec *codec : {native, openfec})
+        {
+          std::optional<unsigned int> esi =
+              codec->NextEncodedSymbol (actualBuf.data (), symbolSize);
+          NS_TEST_ASSERT_MSG_EQ (esi.has_value (), true, "Missing symbol " << expected->first);
+          NS_TEST_ASSERT_MSG_EQ (*esi, expected->first, "ESI mismatch");
+          NS_TEST_ASSERT_MSG_EQ (expectedBuf == actualBuf, true,
+                                 "Symbol " << expected->first << " differs");
+        }
+    }
+
+  free (buf);
+  blockObj->Dispose ();
+  nativeObj->Dispose ();
+  openfecObj->Dispose ();
+}
+
+/**
+ * TestCase 5
+ */
+
+NativeRsIncrementalDecodeTestCase::NativeRsIncrementalDecodeTestCase ()
+    : TestCase ("Check incremental decoding")
+{
+  NS_LOG_INFO ("Creating NativeRsIncrementalDecodeTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecNativeRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+  m_codecFactory.Set ("incrementalDecoding", BooleanValue (true));
+}
+
+NativeRsIncrementalDecodeTestCase::~NativeRsIncrementalDecodeTestCase ()
+{
+}
+
+void
+NativeRsIncrementalDecodeTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecNativeRs> encoderObj = m_codecFactory.Create<AlFecCodecNativeRs> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecNativeRs> decoderObj = m_codecFactory.Create<AlFecCodecNativeRs> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  std::vector<std::pair<unsigned int, Buffer>> blockList;
+  std::random_device rd;
+  std::mt19937 gen (rd ());
+
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  encoder->SetSourceBlock (p);
+  while ((encodedBlock = encoder->NextEncodedBlock ()))
+    {
+      blockList.push_back (*encodedBlock);
+    }
+
+  // The odd source symbols arrive last, so that they take over the pivots of
+  // the repair symbols
+  size_t k = encoder->GetK ();
+  shuffle (blockList.begin (), blockList.end (), gen);
+  std::stable_partition (blockList.begin (), blockList.end (),
+                         [k] (const std::pair<unsigned int, Buffer> &block) {
+                           return block.first >= k || block.first % 2 == 0;
+                         });
+
+  decoder->SetK (k);
+  NS_TEST_ASSERT_MSG_EQ (decoder->GetRank ().has_value (), true, "Rank should be tracked");
+  size_t i;
+  for (i = 0; i < blockList.size (); i++)
+    {
+      decodedBlock = decoder->Decode (blockList[i].second, blockList[i].first);
+      NS_TEST_ASSERT_MSG_EQ (*decoder->GetRank (), std::min (i + 1, k),
+                             "Rank mismatch after " << i + 1 << " symbols");
+      if (decodedBlock)
+        {
+          break;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (i + 1, k, "Should decode with k symbols");
+
+  uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (decodedBlock->GetSize ()));
+  decodedBlock->CopyData (rx_buf, decodedBlock->GetSize ());
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch");
+    }
+
+  free (rx_buf);
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 6
+ */
+
+NativeRsParallelRepairTestCase::NativeRsParallelRepairTestCase ()
+    : TestCase ("Check repair symbols built by several threads")
+{
+  NS_LOG_INFO ("Creating NativeRsParallelRepairTestCase");
+  m_serialFactory.SetTypeId ("ns3::AlFecCodecNativeRs");
+  m_serialFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_serialFactory.Set ("codeRate", DoubleValue (codeRate));
+  m_parallelFactory = m_serialFactory;
+  m_parallelFactory.Set ("nbWorkerThreads", UintegerValue (3));
+}
+
+NativeRsParallelRepairTestCase::~NativeRsParallelRepairTestCase ()
+{
+}
+
+void
+NativeRsParallelRepairTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecNativeRs> serialObj = m_serialFactory.Create<AlFecCodecNativeRs> ();
+  AlFecCodec *serial = GetPointer (serialObj);
+  Ptr<AlFecCodecNativeRs> parallelObj = m_parallelFactory.Create<AlFecCodecNativeRs> ();
+  AlFecCodec *parallel = GetPointer (parallelObj);
+
+  std::vector<uint8_t> buf (payloadSize);
+  std::optional<std::pair<unsigned int, const uint8_t *>> serialSymbol, parallelSymbol;
+  for (int block = 0; block < nbBlocks; block++)
+    {
+      Buffer p;
+      fillRandomBytes (buf.data (), payloadSize);
+      p.AddAtStart (payloadSize);
+      p.Begin ().Write (buf.data (), payloadSize);
+
+      serial->SetSourceBlock (p);
+      parallel->SetSourceBlock (p);
+      NS_TEST_ASSERT_MSG_EQ (parallel->GetN (), serial->GetN (), "N mismatch");
+      while ((serialSymbol = serial->NextEncodedSymbol ()))
+        {
+          parallelSymbol = parallel->NextEncodedSymbol ();
+          NS_TEST_ASSERT_MSG_EQ (parallelSymbol.has_value (), true, "Missing symbol");
+          NS_TEST_ASSERT_MSG_EQ (parallelSymbol->first, serialSymbol->first, "ESI mismatch");
+          NS_TEST_ASSERT_MSG_EQ (memcmp (parallelSymbol->second, serialSymbol->second, symbolSize),
+                                 0, "Encoded symbol mismatch");
+        }
+      NS_TEST_ASSERT_MSG_EQ (parallel->NextEncodedSymbol ().has_value (), false,
+                             "Too many symbols");
+    }
+
+  serialObj->Dispose ();
+  parallelObj->Dispose ();
+}
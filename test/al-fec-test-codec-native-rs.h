@@ -0,0 +1,128 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef TEST_AL_FEC_CODEC_NATIVE_RS_H
+#define TEST_AL_FEC_CODEC_NATIVE_RS_H
+
+#include "ns3/test.h"
+
+using namespace ns3;
+
+class AlFecCodecNativeRsTestSuite : public TestSuite
+{
+public:
+  AlFecCodecNativeRsTestSuite ();
+};
+
+/**
+ * Test 1. Successfully decode
+ */
+class NativeRsDecodeTestCase : public TestCase
+{
+public:
+  NativeRsDecodeTestCase ();
+  virtual ~NativeRsDecodeTestCase ();
+  const unsigned int symbolSize = 100;
+  const double codeRate = 0.5;
+  const int payloadSize = 3000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 2. Encoded symbols are identical to the OpenFEC RS codec, and
+ * the two codecs can decode each other's symbols
+ */
+class NativeRsInteropTestCase : public TestCase
+{
+public:
+  NativeRsInteropTestCase ();
+  virtual ~NativeRsInteropTestCase ();
+  const int symbolSize = 100;
+  const double codeRate = 0.4;
+  const int payloadSize = 3000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_nativeFactory;
+  ObjectFactory m_openfecFactory;
+};
+
+/**
+ * Test 3. Repeated parameters and erasure patterns hit the matrix cache
+ */
+class NativeRsMatrixCacheTestCase : public TestCase
+{
+public:
+  NativeRsMatrixCacheTestCase ();
+  virtual ~NativeRsMatrixCacheTestCase ();
+  const unsigned int symbolSize = 64;
+  const double codeRate = 0.5;
+  const int payloadSize = 2000;
+  const int nbBlocks = 3;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 4. Source symbols added one by one give the same encoded symbols as
+ * the whole source block, with the native fold and with the default
+ * implementation of the OpenFEC RS codec
+ */
+class NativeRsIncrementalTestCase : public TestCase
+{
+public:
+  NativeRsIncrementalTestCase ();
+  virtual ~NativeRsIncrementalTestCase ();
+  const unsigned int symbolSize = 100;
+  const double codeRate = 0.5;
+  const int payloadSize = 2950;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_nativeFactory;
+  ObjectFactory m_openfecFactory;
+};
+
+/**
+ * Test 5. The incremental decoder reports the rank of the received symbols
+ * and decodes with k of them, source symbols arriving after repair ones
+ */
+class NativeRsIncrementalDecodeTestCase : public TestCase
+{
+public:
+  NativeRsIncrementalDecodeTestCase ();
+  virtual ~NativeRsIncrementalDecodeTestCase ();
+  const unsigned int symbolSize = 100;
+  const double codeRate = 0.5;
+  const int payloadSize = 5000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 6. Repair symbols built by several threads are identical to the ones
+ * built by the calling thread only
+ */
+class NativeRsParallelRepairTestCase : public TestCase
+{
+public:
+  NativeRsParallelRepairTestCase ();
+  virtual ~NativeRsParallelRepairTestCase ();
+  const unsigned int symbolSize = 1024;
+  const double codeRate = 0.5;
+  const int payloadSize = 100000;
+  const int nbBlocks = 3;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_serialFactory;
+  ObjectFactory m_parallelFactory;
+};
+
+#endif /* TEST_AL_FEC_CODEC_NATIVE_RS_H */
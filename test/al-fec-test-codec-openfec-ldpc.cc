@@ -0,0 +1,529 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/object.h"
+#include "ns3/core-module.h"
+#include "ns3/packet.h"
+
+#include "al-fec-test-codec-openfec-ldpc.h"
+#include "ns3/al-fec-codec-openfec-ldpc.h"
+#include "ns3/al-fec-openfec-session-pool.h"
+#include "ns3/al-fec-header.h"
+#include "../model/util.h"
+
+#include <optional>
+#include <cmath>
+#include <random>
+#include <limits>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecOpenfecLdpcTest");
+
+/**
+ * TestSuite
+ */
+
+AlFecCodecOpenfecLdpcTestSuite::AlFecCodecOpenfecLdpcTestSuite ()
+    : TestSuite ("al-fec-codec-openfec-ldpc", SYSTEM)
+{
+  LogLevel logLevel = (LogLevel) (LOG_PREFIX_FUNC | LOG_PREFIX_TIME | LOG_LEVEL_ALL);
+
+  LogComponentEnable ("AlFecCodecOpenfecLdpcTest", logLevel);
+  AddTestCase (new OpenfecLdpcEncodeTestCase (), TestCase::QUICK);
+  AddTestCase (new OpenfecLdpcDecodeTestCase (), TestCase::QUICK);
+  AddTestCase (new OpenfecLdpcLazyRepairTestCase (), TestCase::QUICK);
+  AddTestCase (new OpenfecLdpcBlockStreamTestCase (), TestCase::QUICK);
+  AddTestCase (new OpenfecLdpcSystematicDecodeTestCase (), TestCase::QUICK);
+  AddTestCase (new OpenfecLdpcMlDecodeTestCase (), TestCase::QUICK);
+  AddTestCase (new OpenfecLdpcMlBackoffTestCase (), TestCase::QUICK);
+}
+
+static AlFecCodecOpenfecLdpcTestSuite openfecLdpcTestSuite;
+
+/**
+ * TestCase 1
+ */
+
+OpenfecLdpcEncodeTestCase::OpenfecLdpcEncodeTestCase () : TestCase ("Check encoding")
+{
+  NS_LOG_INFO ("Creating OpenfecLdpcEncodeTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecOpenfecLdpc");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+OpenfecLdpcEncodeTestCase::~OpenfecLdpcEncodeTestCase ()
+{
+}
+
+void
+OpenfecLdpcEncodeTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecOpenfecLdpc> encoderObj = m_codecFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  Buffer p;
+  AlFecHeader::EncodeHeader header;
+  size_t k;
+  int cntSymbol = 0;
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+  k = ceil ((double) payloadSize / symbolSize);
+
+  NS_LOG_INFO ("Source block:\n" << printBuffer (buf, payloadSize));
+
+  encoder->SetSourceBlock (p);
+  NS_TEST_ASSERT_MSG_EQ (encoder->GetK (), k, "Calculated source blocks mismatch");
+  while ((encodedBlock = encoder->NextEncodedBlock ()))
+    {
+      cntSymbol++;
+      NS_TEST_ASSERT_MSG_EQ (encodedBlock->second.GetSize (), symbolSize, "Symbol size mismatch");
+    }
+  NS_TEST_ASSERT_MSG_EQ (cntSymbol, ceil (k / codeRate), "Total symbols mismatch");
+  free (buf);
+  encoderObj->Dispose ();
+}
+
+/**
+ * TestCase 2
+ */
+
+OpenfecLdpcDecodeTestCase::OpenfecLdpcDecodeTestCase () : TestCase ("Check decoding")
+{
+  NS_LOG_INFO ("Creating OpenfecLdpcDecodeTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecOpenfecLdpc");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+OpenfecLdpcDecodeTestCase::~OpenfecLdpcDecodeTestCase ()
+{
+}
+
+void
+OpenfecLdpcDecodeTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecOpenfecLdpc> encoderObj = m_codecFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecOpenfecLdpc> decoderObj = m_codecFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  std::vector<std::pair<unsigned int, Buffer>> blockList;
+  std::random_device rd;
+  std::mt19937 gen (rd ());
+
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  encoder->SetSourceBlock (p);
+  while ((encodedBlock = encoder->NextEncodedBlock ()))
+    {
+      blockList.push_back (*encodedBlock);
+    }
+
+  shuffle (blockList.begin (), blockList.end (), gen);
+
+  int i;
+  int k = encoder->GetK ();
+  decoder->SetK (k);
+  for (i = 0; i < (int) blockList.size (); i++)
+    {
+      decodedBlock = decoder->Decode (blockList[i].second, blockList[i].first);
+      if (decodedBlock)
+        {
+          break;
+        }
+    }
+
+  // Unlike RS, LDPC-Staircase is not MDS and may need a few more than k symbols
+  NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Decoder failed");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (i + 1, k * (1 + maxOverhead), "Decoding overhead too large");
+
+  // Check if we can decode with more symbol
+  for (i++; i < (int) blockList.size (); i++)
+    {
+      decodedBlock = decoder->Decode (blockList[i].second, blockList[i].first);
+    }
+
+  size_t rcvdSize = decodedBlock->GetSize ();
+  uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (rcvdSize));
+  decodedBlock->CopyData (rx_buf, rcvdSize);
+  NS_LOG_INFO ("Original source block\n" << printBuffer (buf, payloadSize));
+  NS_LOG_INFO ("Decoded source block\n" << printBuffer (rx_buf, rcvdSize));
+
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch");
+    }
+
+  free (rx_buf);
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 3
+ */
+
+OpenfecLdpcLazyRepairTestCase::OpenfecLdpcLazyRepairTestCase () : TestCase ("Check lazy repair")
+{
+  NS_LOG_INFO ("Creating OpenfecLdpcLazyRepairTestCase");
+  m_eagerFactory.SetTypeId ("ns3::AlFecCodecOpenfecLdpc");
+  m_eagerFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_eagerFactory.Set ("codeRate", DoubleValue (codeRate));
+  m_lazyFactory = m_eagerFactory;
+  m_lazyFactory.Set ("lazyRepair", BooleanValue (true));
+}
+
+OpenfecLdpcLazyRepairTestCase::~OpenfecLdpcLazyRepairTestCase ()
+{
+}
+
+void
+OpenfecLdpcLazyRepairTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecOpenfecLdpc> eagerObj = m_eagerFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *eager = GetPointer (eagerObj);
+  Ptr<AlFecCodecOpenfecLdpc> lazyObj = m_lazyFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *lazy = GetPointer (lazyObj);
+
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  uint8_t *eagerSymbol = reinterpret_cast<uint8_t *> (malloc (symbolSize));
+  uint8_t *lazySymbol = reinterpret_cast<uint8_t *> (malloc (symbolSize));
+  std::optional<std::pair<unsigned int, Buffer>> eagerBlock, lazyBlock;
+  Buffer p;
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  eager->SetSourceBlock (p);
+  lazy->SetSourceBlock (p);
+  NS_TEST_ASSERT_MSG_EQ (lazy->GetN (), eager->GetN (), "N mismatch");
+  while ((eagerBlock = eager->NextEncodedBlock ()))
+    {
+      lazyBlock = lazy->NextEncodedBlock ();
+      NS_TEST_ASSERT_MSG_EQ (lazyBlock.has_value (), true, "Missing lazy symbol");
+      NS_TEST_ASSERT_MSG_EQ (lazyBlock->first, eagerBlock->first, "ESI mismatch");
+      eagerBlock->second.CopyData (eagerSymbol, symbolSize);
+      lazyBlock->second.CopyData (lazySymbol, symbolSize);
+      for (unsigned int i = 0; i < symbolSize; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (lazySymbol[i], eagerSymbol[i], "Encoded symbol mismatch");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (lazy->NextEncodedBlock ().has_value (), false, "Too many lazy symbols");
+
+  free (lazySymbol);
+  free (eagerSymbol);
+  free (buf);
+  eagerObj->Dispose ();
+  lazyObj->Dispose ();
+}
+
+/**
+ * TestCase 4
+ */
+
+OpenfecLdpcBlockStreamTestCase::OpenfecLdpcBlockStreamTestCase () : TestCase ("Check block stream")
+{
+  NS_LOG_INFO ("Creating OpenfecLdpcBlockStreamTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecOpenfecLdpc");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+OpenfecLdpcBlockStreamTestCase::~OpenfecLdpcBlockStreamTestCase ()
+{
+}
+
+void
+OpenfecLdpcBlockStreamTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecOpenfecLdpc> encoderObj = m_codecFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecOpenfecLdpc> decoderObj = m_codecFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  size_t hits = AlFecOpenfecSessionPool::Get ().GetHits ();
+
+  for (int block = 0; block < nbBlocks; block++)
+    {
+      Buffer p;
+      fillRandomBytes (buf, payloadSize);
+      p.AddAtStart (payloadSize);
+      p.Begin ().Write (buf, payloadSize);
+
+      // Lose the first half of the source symbols, so that every block needs
+      // real decoding. Repair symbols alone may not determine an LDPC block.
+      encoder->SetSourceBlock (p);
+      decoder->SetK (encoder->GetK ());
+      decodedBlock = std::nullopt;
+      while ((encodedBlock = encoder->NextEncodedBlock ()) && !decodedBlock)
+        {
+          if (encodedBlock->first >= encoder->GetK () / 2)
+            {
+              decodedBlock = decoder->Decode (encodedBlock->second, encodedBlock->first);
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Block " << block << " not decoded");
+
+      uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (decodedBlock->GetSize ()));
+      decodedBlock->CopyData (rx_buf, decodedBlock->GetSize ());
+      for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch in block " << block);
+        }
+      free (rx_buf);
+      decoder->NextBlock ();
+    }
+
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (AlFecOpenfecSessionPool::Get ().GetHits () - hits,
+                               static_cast<size_t> (nbBlocks - 1),
+                               "Encoder session should be reused");
+
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 5
+ */
+
+OpenfecLdpcSystematicDecodeTestCase::OpenfecLdpcSystematicDecodeTestCase ()
+    : TestCase ("Check systematic decoding")
+{
+  NS_LOG_INFO ("Creating OpenfecLdpcSystematicDecodeTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecOpenfecLdpc");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+OpenfecLdpcSystematicDecodeTestCase::~OpenfecLdpcSystematicDecodeTestCase ()
+{
+}
+
+void
+OpenfecLdpcSystematicDecodeTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecOpenfecLdpc> encoderObj = m_codecFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecOpenfecLdpc> decoderObj = m_codecFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  std::vector<std::pair<unsigned int, Buffer>> sourceList;
+  Buffer p;
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  encoder->SetSourceBlock (p);
+  size_t k = encoder->GetK ();
+  while ((encodedBlock = encoder->NextEncodedBlock ()) && encodedBlock->first < k)
+    {
+      sourceList.push_back (*encodedBlock);
+    }
+
+  // Out of order, but only source symbols
+  decoder->SetK (k);
+  for (auto it = sourceList.rbegin (); it != sourceList.rend (); it++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), false, "Decoded too early");
+      decodedBlock = decoder->Decode (it->second, it->first);
+    }
+  NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Should decode with k source symbols");
+
+  uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (decodedBlock->GetSize ()));
+  decodedBlock->CopyData (rx_buf, decodedBlock->GetSize ());
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch");
+    }
+
+  free (rx_buf);
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 6
+ */
+
+OpenfecLdpcMlDecodeTestCase::OpenfecLdpcMlDecodeTestCase () : TestCase ("Check ML decoding")
+{
+  NS_LOG_INFO ("Creating OpenfecLdpcMlDecodeTestCase");
+  m_mlFactory.SetTypeId ("ns3::AlFecCodecOpenfecLdpc");
+  m_mlFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_mlFactory.Set ("codeRate", DoubleValue (codeRate));
+  m_iterativeFactory = m_mlFactory;
+  m_iterativeFactory.Set ("mlDecoding", BooleanValue (false));
+}
+
+OpenfecLdpcMlDecodeTestCase::~OpenfecLdpcMlDecodeTestCase ()
+{
+}
+
+void
+OpenfecLdpcMlDecodeTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecOpenfecLdpc> encoderObj = m_mlFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecOpenfecLdpc> mlObj = m_mlFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *mlDecoder = GetPointer (mlObj);
+  Ptr<AlFecCodecOpenfecLdpc> iterativeObj = m_iterativeFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *iterativeDecoder = GetPointer (iterativeObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> mlBlock, iterativeBlock;
+  std::vector<std::pair<unsigned int, Buffer>> blockList;
+  std::random_device rd;
+  std::mt19937 gen (rd ());
+
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  encoder->SetSourceBlock (p);
+  while ((encodedBlock = encoder->NextEncodedBlock ()))
+    {
+      blockList.push_back (*encodedBlock);
+    }
+  shuffle (blockList.begin (), blockList.end (), gen);
+
+  // Both decoders get the symbols in the same order
+  int k = encoder->GetK ();
+  int nbMl = 0, nbIterative = 0;
+  mlDecoder->SetK (k);
+  iterativeDecoder->SetK (k);
+  for (int i = 0; i < (int) blockList.size () && !(mlBlock && iterativeBlock); i++)
+    {
+      if (!mlBlock)
+        {
+          mlBlock = mlDecoder->Decode (blockList[i].second, blockList[i].first);
+          nbMl = i + 1;
+        }
+      if (!iterativeBlock)
+        {
+          iterativeBlock = iterativeDecoder->Decode (blockList[i].second, blockList[i].first);
+          nbIterative = i + 1;
+        }
+    }
+
+  NS_LOG_INFO ("k=" << k << ", ML decoding with " << nbMl << " symbols, iterative decoding with "
+                    << nbIterative << " symbols");
+  NS_TEST_ASSERT_MSG_EQ (mlBlock.has_value (), true, "ML decoder failed");
+  NS_TEST_ASSERT_MSG_EQ (iterativeBlock.has_value (), true, "Iterative decoder failed");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (nbMl, nbIterative, "ML decoding needs more symbols");
+
+  uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (mlBlock->GetSize ()));
+  mlBlock->CopyData (rx_buf, mlBlock->GetSize ());
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch");
+    }
+
+  free (rx_buf);
+  free (buf);
+  encoderObj->Dispose ();
+  mlObj->Dispose ();
+  iterativeObj->Dispose ();
+}
+
+/**
+ * TestCase 7
+ */
+
+OpenfecLdpcMlBackoffTestCase::OpenfecLdpcMlBackoffTestCase ()
+    : TestCase ("Check the back-off of ML decoding attempts")
+{
+  NS_LOG_INFO ("Creating OpenfecLdpcMlBackoffTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecOpenfecLdpc");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+OpenfecLdpcMlBackoffTestCase::~OpenfecLdpcMlBackoffTestCase ()
+{
+}
+
+void
+OpenfecLdpcMlBackoffTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecOpenfecLdpc> encoderObj = m_codecFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecOpenfecLdpc> decoderObj = m_codecFactory.Create<AlFecCodecOpenfecLdpc> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  std::vector<std::pair<unsigned int, Buffer>> sourceList, repairList;
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  encoder->SetSourceBlock (p);
+  size_t k = encoder->GetK ();
+  while ((encodedBlock = encoder->NextEncodedBlock ()))
+    {
+      (encodedBlock->first < k ? sourceList : repairList).push_back (*encodedBlock);
+    }
+
+  // The repair symbols come first. Alone, they hardly solve the sparse
+  // parity check matrix, so the ML decoding fails for a while past k.
+  decoder->SetK (k);
+  size_t nbReceived = 0;
+  repairList.insert (repairList.end (), sourceList.begin (), sourceList.end ());
+  for (size_t i = 0; i < repairList.size () && !decodedBlock; i++)
+    {
+      decodedBlock = decoder->Decode (repairList[i].second, repairList[i].first);
+      nbReceived++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Decoder failed");
+
+  // Attempts at k, k + 1, k + 2, k + 4... and one session per failed attempt
+  size_t nbAttempts = decoderObj->GetNbMlAttempts ();
+  size_t nbSessions = decoderObj->GetNbDecoderSessions ();
+  size_t extra = nbReceived - std::min (nbReceived, k);
+  size_t maxAttempts = 1;
+  for (size_t step = 1; step <= extra; step *= 2)
+    {
+      maxAttempts++;
+    }
+  NS_LOG_INFO ("k=" << k << ", decoded with " << nbReceived << " symbols, " << nbAttempts
+                    << " ML attempts, " << nbSessions << " sessions");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (nbAttempts, maxAttempts, "ML decoding retried too often");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (nbSessions, nbAttempts + 1, "Session rebuilt without ML attempt");
+
+  uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (decodedBlock->GetSize ()));
+  decodedBlock->CopyData (rx_buf, decodedBlock->GetSize ());
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch");
+    }
+
+  free (rx_buf);
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
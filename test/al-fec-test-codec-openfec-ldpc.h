@@ -0,0 +1,140 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef TEST_AL_FEC_CODEC_OPENFEC_LDPC_H
+#define TEST_AL_FEC_CODEC_OPENFEC_LDPC_H
+
+#include "ns3/test.h"
+
+using namespace ns3;
+
+class AlFecCodecOpenfecLdpcTestSuite : public TestSuite
+{
+public:
+  AlFecCodecOpenfecLdpcTestSuite ();
+};
+
+/**
+ * Test 1. Successfully encode
+ */
+class OpenfecLdpcEncodeTestCase : public TestCase
+{
+public:
+  OpenfecLdpcEncodeTestCase ();
+  virtual ~OpenfecLdpcEncodeTestCase ();
+  const unsigned int symbolSize = 16;
+  const double codeRate = 0.25;
+  const int payloadSize = 1000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 2. Successfully decode with a small overhead
+ */
+class OpenfecLdpcDecodeTestCase : public TestCase
+{
+public:
+  OpenfecLdpcDecodeTestCase ();
+  virtual ~OpenfecLdpcDecodeTestCase ();
+  const int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 16000;
+  const double maxOverhead = 0.1; // Extra symbols, relative to k
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 3. Lazy repair symbols are identical to the eagerly built ones
+ */
+class OpenfecLdpcLazyRepairTestCase : public TestCase
+{
+public:
+  OpenfecLdpcLazyRepairTestCase ();
+  virtual ~OpenfecLdpcLazyRepairTestCase ();
+  const unsigned int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 1000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_eagerFactory;
+  ObjectFactory m_lazyFactory;
+};
+
+/**
+ * Test 4. One encoder and one decoder instance process a stream of blocks
+ */
+class OpenfecLdpcBlockStreamTestCase : public TestCase
+{
+public:
+  OpenfecLdpcBlockStreamTestCase ();
+  virtual ~OpenfecLdpcBlockStreamTestCase ();
+  const unsigned int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 1000;
+  const int nbBlocks = 5;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 5. Decode with the source symbols only
+ */
+class OpenfecLdpcSystematicDecodeTestCase : public TestCase
+{
+public:
+  OpenfecLdpcSystematicDecodeTestCase ();
+  virtual ~OpenfecLdpcSystematicDecodeTestCase ();
+  const unsigned int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 1000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 6. ML decoding never needs more symbols than the iterative decoding
+ */
+class OpenfecLdpcMlDecodeTestCase : public TestCase
+{
+public:
+  OpenfecLdpcMlDecodeTestCase ();
+  virtual ~OpenfecLdpcMlDecodeTestCase ();
+  const unsigned int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 16000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_mlFactory;
+  ObjectFactory m_iterativeFactory;
+};
+
+/**
+ * Test 7. A decoder that keeps failing ML decoding only retries it, and
+ * rebuilds its session, after twice as many symbols beyond k each time
+ */
+class OpenfecLdpcMlBackoffTestCase : public TestCase
+{
+public:
+  OpenfecLdpcMlBackoffTestCase ();
+  virtual ~OpenfecLdpcMlBackoffTestCase ();
+  const unsigned int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 16000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+#endif /* TEST_AL_FEC_CODEC_OPENFEC_LDPC_H */
@@ -7,6 +7,7 @@
 
 #include "al-fec-test-codec-openfec-rs.h"
 #include "ns3/al-fec-codec-openfec-rs.h"
+#include "ns3/al-fec-openfec-session-pool.h"
 #include "ns3/al-fec-header.h"
 #include "../model/util.h"
 
@@ -16,6 +17,7 @@
 #include <cmath>
 #include <random>
 #include <limits>
+#include <vector>
 
 using namespace ns3;
 
@@ -33,6 +35,10 @@ AlFecCodecOpenfecRsTestSuite::AlFecCodecOpenfecRsTestSuite ()
   LogComponentEnable ("AlFecCodecOpenfecRsTest", logLevel);
   AddTestCase (new OpenfecRsEncodeTestCase (), TestCase::QUICK);
   AddTestCase (new OpenfecRsDecodeTestCase (), TestCase::QUICK);
+  AddTestCase (new OpenfecRsLazyRepairTestCase (), TestCase::QUICK);
+  AddTestCase (new OpenfecRsBlockStreamTestCase (), TestCase::QUICK);
+  AddTestCase (new OpenfecRsSystematicDecodeTestCase (), TestCase::QUICK);
+  AddTestCase (new OpenfecRsParallelRepairTestCase (), TestCase::QUICK);
 }
 
 static AlFecCodecOpenfecRsTestSuite openfecRsTestSuite;
@@ -164,3 +170,248 @@ OpenfecRsDecodeTestCase::DoRun (void)
   encoderObj->Dispose ();
   decoderObj->Dispose ();
 }
+
+/**
+ * TestCase 3
+ */
+
+OpenfecRsLazyRepairTestCase::OpenfecRsLazyRepairTestCase () : TestCase ("Check lazy repair")
+{
+  NS_LOG_INFO ("Creating OpenfecRsLazyRepairTestCase");
+  m_eagerFactory.SetTypeId ("ns3::AlFecCodecOpenfecRs");
+  m_eagerFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_eagerFactory.Set ("codeRate", DoubleValue (codeRate));
+  m_lazyFactory = m_eagerFactory;
+  m_lazyFactory.Set ("lazyRepair", BooleanValue (true));
+}
+
+OpenfecRsLazyRepairTestCase::~OpenfecRsLazyRepairTestCase ()
+{
+}
+
+void
+OpenfecRsLazyRepairTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecOpenfecRs> eagerObj = m_eagerFactory.Create<AlFecCodecOpenfecRs> ();
+  AlFecCodec *eager = GetPointer (eagerObj);
+  Ptr<AlFecCodecOpenfecRs> lazyObj = m_lazyFactory.Create<AlFecCodecOpenfecRs> ();
+  AlFecCodec *lazy = GetPointer (lazyObj);
+
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  uint8_t *eagerSymbol = reinterpret_cast<uint8_t *> (malloc (symbolSize));
+  uint8_t *lazySymbol = reinterpret_cast<uint8_t *> (malloc (symbolSize));
+  std::optional<std::pair<unsigned int, Buffer>> eagerBlock, lazyBlock;
+  Buffer p;
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  eager->SetSourceBlock (p);
+  lazy->SetSourceBlock (p);
+  NS_TEST_ASSERT_MSG_EQ (lazy->GetN (), eager->GetN (), "N mismatch");
+  while ((eagerBlock = eager->NextEncodedBlock ()))
+    {
+      lazyBlock = lazy->NextEncodedBlock ();
+      NS_TEST_ASSERT_MSG_EQ (lazyBlock.has_value (), true, "Missing lazy symbol");
+      NS_TEST_ASSERT_MSG_EQ (lazyBlock->first, eagerBlock->first, "ESI mismatch");
+      eagerBlock->second.CopyData (eagerSymbol, symbolSize);
+      lazyBlock->second.CopyData (lazySymbol, symbolSize);
+      for (unsigned int i = 0; i < symbolSize; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (lazySymbol[i], eagerSymbol[i], "Encoded symbol mismatch");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (lazy->NextEncodedBlock ().has_value (), false, "Too many lazy symbols");
+
+  free (lazySymbol);
+  free (eagerSymbol);
+  free (buf);
+  eagerObj->Dispose ();
+  lazyObj->Dispose ();
+}
+
+/**
+ * TestCase 4
+ */
+
+OpenfecRsBlockStreamTestCase::OpenfecRsBlockStreamTestCase () : TestCase ("Check block stream")
+{
+  NS_LOG_INFO ("Creating OpenfecRsBlockStreamTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecOpenfecRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+OpenfecRsBlockStreamTestCase::~OpenfecRsBlockStreamTestCase ()
+{
+}
+
+void
+OpenfecRsBlockStreamTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecOpenfecRs> encoderObj = m_codecFactory.Create<AlFecCodecOpenfecRs> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecOpenfecRs> decoderObj = m_codecFactory.Create<AlFecCodecOpenfecRs> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  size_t hits = AlFecOpenfecSessionPool::Get ().GetHits ();
+
+  for (int block = 0; block < nbBlocks; block++)
+    {
+      Buffer p;
+      fillRandomBytes (buf, payloadSize);
+      p.AddAtStart (payloadSize);
+      p.Begin ().Write (buf, payloadSize);
+
+      // Feed only the repair symbols, so that every block needs real decoding
+      encoder->SetSourceBlock (p);
+      decoder->SetK (encoder->GetK ());
+      decodedBlock = std::nullopt;
+      while ((encodedBlock = encoder->NextEncodedBlock ()) && !decodedBlock)
+        {
+          if (encodedBlock->first >= encoder->GetK ())
+            {
+              decodedBlock = decoder->Decode (encodedBlock->second, encodedBlock->first);
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Block " << block << " not decoded");
+
+      uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (decodedBlock->GetSize ()));
+      decodedBlock->CopyData (rx_buf, decodedBlock->GetSize ());
+      for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch in block " << block);
+        }
+      free (rx_buf);
+      decoder->NextBlock ();
+    }
+
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (AlFecOpenfecSessionPool::Get ().GetHits () - hits,
+                               static_cast<size_t> (nbBlocks - 1),
+                               "Encoder session should be reused");
+
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 5
+ */
+
+OpenfecRsSystematicDecodeTestCase::OpenfecRsSystematicDecodeTestCase ()
+    : TestCase ("Check systematic decoding")
+{
+  NS_LOG_INFO ("Creating OpenfecRsSystematicDecodeTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecOpenfecRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+OpenfecRsSystematicDecodeTestCase::~OpenfecRsSystematicDecodeTestCase ()
+{
+}
+
+void
+OpenfecRsSystematicDecodeTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecOpenfecRs> encoderObj = m_codecFactory.Create<AlFecCodecOpenfecRs> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecOpenfecRs> decoderObj = m_codecFactory.Create<AlFecCodecOpenfecRs> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  std::vector<std::pair<unsigned int, Buffer>> sourceList;
+  Buffer p;
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  encoder->SetSourceBlock (p);
+  size_t k = encoder->GetK ();
+  while ((encodedBlock = encoder->NextEncodedBlock ()) && encodedBlock->first < k)
+    {
+      sourceList.push_back (*encodedBlock);
+    }
+
+  // Out of order, but only source symbols
+  decoder->SetK (k);
+  for (auto it = sourceList.rbegin (); it != sourceList.rend (); it++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), false, "Decoded too early");
+      decodedBlock = decoder->Decode (it->second, it->first);
+    }
+  NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Should decode with k source symbols");
+
+  uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (decodedBlock->GetSize ()));
+  decodedBlock->CopyData (rx_buf, decodedBlock->GetSize ());
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch");
+    }
+
+  free (rx_buf);
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 6
+ */
+
+OpenfecRsParallelRepairTestCase::OpenfecRsParallelRepairTestCase ()
+    : TestCase ("Check repair symbols built by several threads")
+{
+  NS_LOG_INFO ("Creating OpenfecRsParallelRepairTestCase");
+  m_serialFactory.SetTypeId ("ns3::AlFecCodecOpenfecRs");
+  m_serialFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_serialFactory.Set ("codeRate", DoubleValue (codeRate));
+  m_parallelFactory = m_serialFactory;
+  m_parallelFactory.Set ("nbWorkerThreads", UintegerValue (3));
+}
+
+OpenfecRsParallelRepairTestCase::~OpenfecRsParallelRepairTestCase ()
+{
+}
+
+void
+OpenfecRsParallelRepairTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecOpenfecRs> serialObj = m_serialFactory.Create<AlFecCodecOpenfecRs> ();
+  AlFecCodec *serial = GetPointer (serialObj);
+  Ptr<AlFecCodecOpenfecRs> parallelObj = m_parallelFactory.Create<AlFecCodecOpenfecRs> ();
+  AlFecCodec *parallel = GetPointer (parallelObj);
+
+  std::vector<uint8_t> buf (payloadSize);
+  std::optional<std::pair<unsigned int, const uint8_t *>> serialSymbol, parallelSymbol;
+  for (int block = 0; block < nbBlocks; block++)
+    {
+      Buffer p;
+      fillRandomBytes (buf.data (), payloadSize);
+      p.AddAtStart (payloadSize);
+      p.Begin ().Write (buf.data (), payloadSize);
+
+      serial->SetSourceBlock (p);
+      parallel->SetSourceBlock (p);
+      NS_TEST_ASSERT_MSG_EQ (parallel->GetN (), serial->GetN (), "N mismatch");
+      while ((serialSymbol = serial->NextEncodedSymbol ()))
+        {
+          parallelSymbol = parallel->NextEncodedSymbol ();
+          NS_TEST_ASSERT_MSG_EQ (parallelSymbol.has_value (), true, "Missing symbol");
+          NS_TEST_ASSERT_MSG_EQ (parallelSymbol->first, serialSymbol->first, "ESI mismatch");
+          NS_TEST_ASSERT_MSG_EQ (memcmp (parallelSymbol->second, serialSymbol->second, symbolSize),
+                                 0, "Encoded symbol mismatch");
+        }
+      NS_TEST_ASSERT_MSG_EQ (parallel->NextEncodedSymbol ().has_value (), false,
+                             "Too many symbols");
+    }
+
+  serialObj->Dispose ();
+  parallelObj->Dispose ();
+}
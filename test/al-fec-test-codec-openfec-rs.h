@@ -47,4 +47,77 @@ private:
   ObjectFactory m_codecFactory;
 };
 
+/**
+ * Test 3. Lazy repair symbols are identical to the eagerly built ones
+ */
+class OpenfecRsLazyRepairTestCase : public TestCase
+{
+public:
+  OpenfecRsLazyRepairTestCase ();
+  virtual ~OpenfecRsLazyRepairTestCase ();
+  const unsigned int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 1000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_eagerFactory;
+  ObjectFactory m_lazyFactory;
+};
+
+/**
+ * Test 4. One encoder and one decoder instance process a stream of blocks
+ */
+class OpenfecRsBlockStreamTestCase : public TestCase
+{
+public:
+  OpenfecRsBlockStreamTestCase ();
+  virtual ~OpenfecRsBlockStreamTestCase ();
+  const unsigned int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 1000;
+  const int nbBlocks = 5;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 5. Decode with the source symbols only
+ */
+class OpenfecRsSystematicDecodeTestCase : public TestCase
+{
+public:
+  OpenfecRsSystematicDecodeTestCase ();
+  virtual ~OpenfecRsSystematicDecodeTestCase ();
+  const unsigned int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 1000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 6. Repair symbols built by several threads are identical to the ones
+ * built by the calling thread only
+ */
+class OpenfecRsParallelRepairTestCase : public TestCase
+{
+public:
+  OpenfecRsParallelRepairTestCase ();
+  virtual ~OpenfecRsParallelRepairTestCase ();
+  const unsigned int symbolSize = 1024;
+  const double codeRate = 0.5;
+  const int payloadSize = 100000;
+  const int nbBlocks = 3;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_serialFactory;
+  ObjectFactory m_parallelFactory;
+};
+
 #endif /* TEST_AL_FEC_CODEC_OPENFEC_RS_H */
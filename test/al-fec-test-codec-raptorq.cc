@@ -0,0 +1,296 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/object.h"
+#include "ns3/core-module.h"
+
+#include "al-fec-test-codec-raptorq.h"
+#include "ns3/al-fec-codec-raptorq.h"
+#include "../model/util.h"
+
+#include <optional>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <string.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecRaptorqTest");
+
+/**
+ * TestSuite
+ */
+
+AlFecCodecRaptorqTestSuite::AlFecCodecRaptorqTestSuite ()
+    : TestSuite ("al-fec-codec-raptorq", SYSTEM)
+{
+  LogLevel logLevel = (LogLevel) (LOG_PREFIX_FUNC | LOG_PREFIX_TIME | LOG_LEVEL_ALL);
+
+  LogComponentEnable ("AlFecCodecRaptorqTest", logLevel);
+  AddTestCase (new RaptorqDecodeTestCase (), TestCase::QUICK);
+  AddTestCase (new RaptorqOverheadTestCase (), TestCase::QUICK);
+  AddTestCase (new RaptorqLargeBlockTestCase (), TestCase::QUICK);
+}
+
+static AlFecCodecRaptorqTestSuite raptorqTestSuite;
+
+/**
+ * TestCase 1
+ */
+
+RaptorqDecodeTestCase::RaptorqDecodeTestCase () : TestCase ("Check decoding")
+{
+  NS_LOG_INFO ("Creating RaptorqDecodeTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecRaptorq");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+RaptorqDecodeTestCase::~RaptorqDecodeTestCase ()
+{
+}
+
+void
+RaptorqDecodeTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecRaptorq> encoderObj = m_codecFactory.Create<AlFecCodecRaptorq> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecRaptorq> decoderObj = m_codecFactory.Create<AlFecCodecRaptorq> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+  std::optional<Buffer> decodedBlock;
+  std::vector<std::pair<unsigned int, Buffer>> blockList;
+
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  encoder->SetSourceBlock (p);
+  while ((encodedBlock = encoder->NextEncodedBlock ()))
+    {
+      NS_TEST_ASSERT_MSG_EQ (encodedBlock->second.GetSize (), symbolSize, "Symbol size mismatch");
+      blockList.push_back (*encodedBlock);
+    }
+  NS_TEST_ASSERT_MSG_EQ (blockList.size (), encoder->GetN (), "Total symbols mismatch");
+
+  // The source symbols are sent first and unchanged
+  uint8_t *symbol = new uint8_t[symbolSize];
+  for (unsigned int esi = 0; esi < encoder->GetK (); esi++)
+    {
+      blockList[esi].second.CopyData (symbol, symbolSize);
+      for (size_t i = 0; i < symbolSize && esi * symbolSize + i < (size_t) payloadSize; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (symbol[i], buf[esi * symbolSize + i], "Code is not systematic");
+        }
+    }
+  delete[] symbol;
+
+  // Fixed seeds keep the orders of the symbols, and the test, reproducible
+  int k = encoder->GetK ();
+  decoder->SetK (k);
+  for (uint32_t seed = 1; seed <= nbSeeds; seed++)
+    {
+      std::mt19937 gen (seed);
+      shuffle (blockList.begin (), blockList.end (), gen);
+
+      int i;
+      decodedBlock = std::nullopt;
+      for (i = 0; i < (int) blockList.size (); i++)
+        {
+          decodedBlock = decoder->Decode (blockList[i].second, blockList[i].first);
+          if (decodedBlock)
+            {
+              break;
+            }
+        }
+
+      NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Decoder failed, seed " << seed);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (i + 1, k + 2, "Should decode with k + 2 symbols, seed " << seed);
+
+      size_t rcvdSize = decodedBlock->GetSize ();
+      uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (rcvdSize));
+      decodedBlock->CopyData (rx_buf, rcvdSize);
+
+      for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch");
+        }
+
+      free (rx_buf);
+      decoder->NextBlock ();
+    }
+
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 2
+ */
+
+RaptorqOverheadTestCase::RaptorqOverheadTestCase ()
+    : TestCase ("Check decoding overhead")
+{
+  NS_LOG_INFO ("Creating RaptorqOverheadTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecRaptorq");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+}
+
+RaptorqOverheadTestCase::~RaptorqOverheadTestCase ()
+{
+}
+
+void
+RaptorqOverheadTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecRaptorq> encoderObj = m_codecFactory.Create<AlFecCodecRaptorq> ();
+  Ptr<AlFecCodecRaptorq> decoderObj = m_codecFactory.Create<AlFecCodecRaptorq> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  uint8_t *symbol = new uint8_t[symbolSize];
+  // A fixed seed keeps the success rate, and the test, reproducible
+  std::mt19937 gen (6330);
+  int nbDecodedAtK = 0;
+  int nbDecodedAtK2 = 0;
+
+  for (int trial = 0; trial < nbTrials; trial++)
+    {
+      Buffer p;
+      for (int i = 0; i < payloadSize; i++)
+        {
+          buf[i] = gen ();
+        }
+      p.AddAtStart (payloadSize);
+      p.Begin ().Write (buf, payloadSize);
+      encoderObj->SetSourceBlock (p);
+      size_t k = encoderObj->GetK ();
+
+      // Repair symbols only, from a random ESI on
+      decoderObj->NextBlock ();
+      decoder->SetK (k);
+      unsigned int esi = k + gen () % 10000;
+      std::optional<Buffer> decodedBlock;
+      size_t nbReceived = 0;
+      while (!decodedBlock && nbReceived < k + 2)
+        {
+          encoderObj->GetEncodedSymbol (esi, symbol);
+          decodedBlock = decoder->Decode (symbol, symbolSize, esi++);
+          nbReceived++;
+        }
+      if (!decodedBlock)
+        {
+          continue;
+        }
+      nbDecodedAtK += nbReceived == k;
+      nbDecodedAtK2++;
+
+      uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (decodedBlock->GetSize ()));
+      decodedBlock->CopyData (rx_buf, decodedBlock->GetSize ());
+      for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch in trial " << trial);
+        }
+      free (rx_buf);
+    }
+
+  NS_LOG_INFO ("Decoded " << nbDecodedAtK << "/" << nbTrials << " blocks with K symbols, "
+                          << nbDecodedAtK2 << "/" << nbTrials << " with K + 2");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (nbDecodedAtK2, minSuccessRate * nbTrials,
+                               "Too many failures with K + 2 symbols");
+
+  delete[] symbol;
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 3
+ */
+
+RaptorqLargeBlockTestCase::RaptorqLargeBlockTestCase () : TestCase ("Check large block")
+{
+  NS_LOG_INFO ("Creating RaptorqLargeBlockTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecRaptorq");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+RaptorqLargeBlockTestCase::~RaptorqLargeBlockTestCase ()
+{
+}
+
+void
+RaptorqLargeBlockTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecRaptorq> encoderObj = m_codecFactory.Create<AlFecCodecRaptorq> ();
+  AlFecCodec *encoder = GetPointer (encoderObj);
+  Ptr<AlFecCodecRaptorq> decoderObj = m_codecFactory.Create<AlFecCodecRaptorq> ();
+  AlFecCodec *decoder = GetPointer (decoderObj);
+
+  Buffer p;
+  uint8_t *buf = reinterpret_cast<uint8_t *> (malloc (payloadSize));
+  std::optional<std::pair<unsigned int, const uint8_t *>> encodedSymbol;
+  std::optional<Buffer> decodedBlock;
+  // A fixed seed keeps the lost symbols, and the test, reproducible
+  std::mt19937 gen (3);
+  std::bernoulli_distribution loss (lossRate);
+
+  fillRandomBytes (buf, payloadSize);
+  p.AddAtStart (payloadSize);
+  p.Begin ().Write (buf, payloadSize);
+
+  encoder->SetSourceBlock (p);
+  size_t k = encoder->GetK ();
+  NS_TEST_ASSERT_MSG_GT (k, 255, "The block should be too large for RS over GF(2^8)");
+  decoder->SetK (k);
+
+  // The loss rate exceeds 1 - codeRate, so the symbols up to N are not enough
+  size_t nbReceived = 0;
+  while ((encodedSymbol = encoder->NextEncodedSymbol ()) && !decodedBlock)
+    {
+      if (loss (gen))
+        {
+          continue;
+        }
+      uint8_t *slot = decoder->GetSymbolBuffer (encodedSymbol->first);
+      NS_TEST_ASSERT_MSG_EQ (static_cast<bool> (slot), true, "No slot for a new symbol");
+      memcpy (slot, encodedSymbol->second, symbolSize);
+      decodedBlock = decoder->Decode (slot, symbolSize, encodedSymbol->first);
+      nbReceived++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), false, "Decoded with too few symbols");
+
+  // A fountain code goes on with more repair symbols
+  encoder->SetN (2 * encoder->GetN ());
+  while ((encodedSymbol = encoder->NextEncodedSymbol ()) && !decodedBlock)
+    {
+      if (loss (gen))
+        {
+          continue;
+        }
+      decodedBlock = decoder->Decode (encodedSymbol->second, symbolSize, encodedSymbol->first);
+      nbReceived++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Decoder failed");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (nbReceived, k + 2, "Should decode with k + 2 symbols");
+
+  size_t rcvdSize = decodedBlock->GetSize ();
+  uint8_t *rx_buf = reinterpret_cast<uint8_t *> (malloc (rcvdSize));
+  decodedBlock->CopyData (rx_buf, rcvdSize);
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], rx_buf[i], "Decode content mismatch");
+    }
+
+  free (rx_buf);
+  free (buf);
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
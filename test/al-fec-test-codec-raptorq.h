@@ -0,0 +1,70 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef TEST_AL_FEC_CODEC_RAPTORQ_H
+#define TEST_AL_FEC_CODEC_RAPTORQ_H
+
+#include "ns3/test.h"
+
+using namespace ns3;
+
+class AlFecCodecRaptorqTestSuite : public TestSuite
+{
+public:
+  AlFecCodecRaptorqTestSuite ();
+};
+
+/**
+ * Test 1. Successfully decode, whatever the order of the symbols
+ */
+class RaptorqDecodeTestCase : public TestCase
+{
+public:
+  RaptorqDecodeTestCase ();
+  virtual ~RaptorqDecodeTestCase ();
+  const unsigned int symbolSize = 100;
+  const double codeRate = 0.5;
+  const int payloadSize = 3000;
+  const uint32_t nbSeeds = 10; // Orders the symbols are received in
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 2. Decoding from repair symbols only needs K + 2 symbols nearly always
+ */
+class RaptorqOverheadTestCase : public TestCase
+{
+public:
+  RaptorqOverheadTestCase ();
+  virtual ~RaptorqOverheadTestCase ();
+  const unsigned int symbolSize = 8;
+  const int payloadSize = 800;
+  const int nbTrials = 200;
+  const double minSuccessRate = 0.99; // Decoding success rate with K + 2 symbols
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 3. A block too large for RS is decoded from repair symbols beyond N
+ */
+class RaptorqLargeBlockTestCase : public TestCase
+{
+public:
+  RaptorqLargeBlockTestCase ();
+  virtual ~RaptorqLargeBlockTestCase ();
+  const unsigned int symbolSize = 16;
+  const double codeRate = 0.8;
+  const int payloadSize = 320000;
+  const double lossRate = 0.3;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+#endif /* TEST_AL_FEC_CODEC_RAPTORQ_H */
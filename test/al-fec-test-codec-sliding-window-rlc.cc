@@ -0,0 +1,265 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/object.h"
+#include "ns3/core-module.h"
+#include "ns3/simulator.h"
+
+#include "al-fec-test-codec-sliding-window-rlc.h"
+#include "ns3/al-fec-header.h"
+
+#include <optional>
+#include <algorithm>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("AlFecCodecSlidingWindowRlcTest");
+
+/**
+ * TestSuite
+ */
+
+AlFecCodecSlidingWindowRlcTestSuite::AlFecCodecSlidingWindowRlcTestSuite ()
+    : TestSuite ("al-fec-codec-sliding-window-rlc", SYSTEM)
+{
+  LogLevel logLevel = (LogLevel) (LOG_PREFIX_FUNC | LOG_PREFIX_TIME | LOG_LEVEL_ALL);
+
+  LogComponentEnable ("AlFecCodecSlidingWindowRlcTest", logLevel);
+  AddTestCase (new RlcRecoveryTestCase (), TestCase::QUICK);
+  AddTestCase (new RlcRecoveryDelayTestCase (), TestCase::QUICK);
+}
+
+static AlFecCodecSlidingWindowRlcTestSuite slidingWindowRlcTestSuite;
+
+/**
+ * Copy the content of a packet into a buffer
+ */
+static Buffer
+PacketToBuffer (Ptr<Packet> p)
+{
+  Buffer b;
+  b.AddAtStart (p->GetSize ());
+  std::vector<uint8_t> content (p->GetSize ());
+  p->CopyData (content.data (), content.size ());
+  b.Begin ().Write (content.data (), content.size ());
+  return b;
+}
+
+/**
+ * TestCase 1
+ */
+
+RlcRecoveryTestCase::RlcRecoveryTestCase () : TestCase ("Check recovery")
+{
+  NS_LOG_INFO ("Creating RlcRecoveryTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecSlidingWindowRlc");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("windowSize", UintegerValue (windowSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+RlcRecoveryTestCase::~RlcRecoveryTestCase ()
+{
+}
+
+void
+RlcRecoveryTestCase::DoRun (void)
+{
+  for (double density : {1.0, 0.5})
+    {
+      m_codecFactory.Set ("density", DoubleValue (density));
+      Ptr<AlFecCodecSlidingWindowRlc> encoder =
+          m_codecFactory.Create<AlFecCodecSlidingWindowRlc> ();
+      Ptr<AlFecCodecSlidingWindowRlc> decoder =
+          m_codecFactory.Create<AlFecCodecSlidingWindowRlc> ();
+
+      // A fixed seed keeps the number of lost symbols, and the test, reproducible
+      std::mt19937 gen (8681);
+      std::bernoulli_distribution loss (lossRate);
+      std::map<uint32_t, std::vector<uint8_t>> sent;
+      std::vector<bool> delivered (nbPackets, false);
+      size_t nbRecovered = 0;
+
+      auto deliver = [&] (const std::vector<std::pair<uint32_t, Buffer>> &recovered) {
+        for (const std::pair<uint32_t, Buffer> &symbol : recovered)
+          {
+            std::vector<uint8_t> adu (symbol.second.GetSize ());
+            symbol.second.CopyData (adu.data (), adu.size ());
+            NS_TEST_ASSERT_MSG_EQ ((adu == sent[symbol.first]), true,
+                                   "Recovered content mismatch for ESI " << symbol.first);
+            NS_TEST_ASSERT_MSG_EQ (delivered[symbol.first], false,
+                                   "ESI " << symbol.first << " delivered twice");
+            delivered[symbol.first] = true;
+            nbRecovered++;
+          }
+      };
+
+      for (int i = 0; i < nbPackets; i++)
+        {
+          // ADUs of any size, up to symbolSize - 2
+          std::vector<uint8_t> adu (gen () % (symbolSize - 1));
+          for (uint8_t &byte : adu)
+            {
+              byte = gen ();
+            }
+          Buffer p;
+          p.AddAtStart (adu.size ());
+          p.Begin ().Write (adu.data (), adu.size ());
+          uint32_t esi = encoder->AddSourceSymbol (p);
+          NS_TEST_ASSERT_MSG_EQ (esi, static_cast<uint32_t> (i), "ESI mismatch");
+          sent[esi] = adu;
+
+          if (!loss (gen))
+            {
+              delivered[esi] = true;
+              deliver (decoder->DecodeSourceSymbol (esi, p));
+            }
+          std::optional<AlFecCodecSlidingWindowRlc::RepairSymbol> repair;
+          while ((repair = encoder->NextRepairSymbol ()))
+            {
+              NS_TEST_ASSERT_MSG_LT_OR_EQ (repair->nbSourceSymbols, windowSize,
+                                           "Repair window too large");
+              if (!loss (gen))
+                {
+                  deliver (decoder->DecodeRepairSymbol (*repair));
+                }
+            }
+        }
+
+      size_t nbDelivered = std::count (delivered.begin (), delivered.end (), true);
+      NS_LOG_INFO ("density=" << density << ": " << nbRecovered << " recovered, "
+                              << nbPackets - nbDelivered << " missing");
+      NS_TEST_ASSERT_MSG_EQ (decoder->GetNbRecovered (), nbRecovered, "Recovered count mismatch");
+      NS_TEST_ASSERT_MSG_GT (nbRecovered, 0, "Nothing recovered");
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (nbDelivered, minDeliveryRate * nbPackets,
+                                   "Too many source symbols lost");
+
+      encoder->Dispose ();
+      decoder->Dispose ();
+    }
+}
+
+/**
+ * TestCase 2
+ */
+
+RlcRecoveryDelayTestCase::RlcRecoveryDelayTestCase ()
+    : TestCase ("Check recovery delay"), m_nbDelivered (0), m_nbMismatch (0)
+{
+  NS_LOG_INFO ("Creating RlcRecoveryDelayTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecSlidingWindowRlc");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("windowSize", UintegerValue (windowSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+RlcRecoveryDelayTestCase::~RlcRecoveryDelayTestCase ()
+{
+}
+
+void
+RlcRecoveryDelayTestCase::SendPacket (int i)
+{
+  std::vector<uint8_t> adu (symbolSize - 2);
+  for (uint8_t &byte : adu)
+    {
+      byte = m_gen ();
+    }
+  Ptr<Packet> p = Create<Packet> (adu.data (), adu.size ());
+  uint32_t esi = m_encoder->AddSourceSymbol (PacketToBuffer (p));
+  m_sent[esi] = adu;
+  m_sentTime[esi] = Simulator::Now ();
+
+  AlFecHeader::SlidingWindowHeader header;
+  header.SetEncodedSymbolId (esi);
+  p->AddHeader (header);
+  Simulator::Schedule (propagationDelay, &RlcRecoveryDelayTestCase::ReceivePacket, this, p);
+
+  std::optional<AlFecCodecSlidingWindowRlc::RepairSymbol> repair;
+  while ((repair = m_encoder->NextRepairSymbol ()))
+    {
+      Ptr<Packet> r = Create<Packet> (repair->data.PeekData (), repair->data.GetSize ());
+      header.SetEncodedSymbolId (repair->firstEsi);
+      header.SetRepairKey (repair->repairKey);
+      header.SetNbSourceSymbols (repair->nbSourceSymbols);
+      r->AddHeader (header);
+      Simulator::Schedule (propagationDelay, &RlcRecoveryDelayTestCase::ReceivePacket, this, r);
+    }
+
+  if (i + 1 < nbPackets)
+    {
+      Simulator::Schedule (interval, &RlcRecoveryDelayTestCase::SendPacket, this, i + 1);
+    }
+}
+
+void
+RlcRecoveryDelayTestCase::ReceivePacket (Ptr<Packet> p)
+{
+  std::bernoulli_distribution loss (lossRate);
+  if (loss (m_gen))
+    {
+      return;
+    }
+
+  AlFecHeader::SlidingWindowHeader header;
+  p->RemoveHeader (header);
+  std::vector<std::pair<uint32_t, Buffer>> recovered;
+  if (header.IsRepair ())
+    {
+      AlFecCodecSlidingWindowRlc::RepairSymbol repair;
+      repair.repairKey = header.GetRepairKey ();
+      repair.firstEsi = header.GetEncodedSymbolId ();
+      repair.nbSourceSymbols = header.GetNbSourceSymbols ();
+      repair.data = PacketToBuffer (p);
+      recovered = m_decoder->DecodeRepairSymbol (repair);
+    }
+  else
+    {
+      m_nbDelivered++;
+      recovered =
+          m_decoder->DecodeSourceSymbol (header.GetEncodedSymbolId (), PacketToBuffer (p));
+    }
+
+  for (const std::pair<uint32_t, Buffer> &symbol : recovered)
+    {
+      std::vector<uint8_t> adu (symbol.second.GetSize ());
+      symbol.second.CopyData (adu.data (), adu.size ());
+      m_nbMismatch += adu != m_sent[symbol.first];
+      m_nbDelivered++;
+      m_maxLateness = std::max (m_maxLateness, Simulator::Now () - m_sentTime[symbol.first] -
+                                                   propagationDelay);
+    }
+}
+
+void
+RlcRecoveryDelayTestCase::DoRun (void)
+{
+  m_encoder = m_codecFactory.Create<AlFecCodecSlidingWindowRlc> ();
+  m_decoder = m_codecFactory.Create<AlFecCodecSlidingWindowRlc> ();
+  m_gen.seed (8681);
+
+  Simulator::Schedule (Seconds (0), &RlcRecoveryDelayTestCase::SendPacket, this, 0);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  Time average = m_decoder->GetAverageRecoveryDelay ();
+  Time max = m_decoder->GetMaxRecoveryDelay ();
+  NS_LOG_INFO (m_decoder->GetNbRecovered () << " recovered, " << m_decoder->GetNbLost ()
+                                            << " lost, average recovery delay " << average
+                                            << ", max " << max);
+  NS_TEST_ASSERT_MSG_EQ (m_nbMismatch, 0, "Recovered content mismatch");
+  NS_TEST_ASSERT_MSG_GT (m_decoder->GetNbRecovered (), 0, "Nothing recovered");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_nbDelivered, static_cast<size_t> (0.99 * nbPackets),
+                               "Too many source packets lost");
+
+  // A loss is recovered while it is in the decoding history of 2 windows,
+  // whatever the length of the stream
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (average, max, "Average delay above the max");
+  double history = 2 * windowSize * interval.GetSeconds ();
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (max.GetSeconds (), history, "Recovery slower than the history");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_maxLateness.GetSeconds (), history,
+                               "Delivery later than the history");
+
+  m_encoder->Dispose ();
+  m_decoder->Dispose ();
+}
@@ -0,0 +1,83 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef TEST_AL_FEC_CODEC_SLIDING_WINDOW_RLC_H
+#define TEST_AL_FEC_CODEC_SLIDING_WINDOW_RLC_H
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/al-fec-codec-sliding-window-rlc.h"
+
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+class AlFecCodecSlidingWindowRlcTestSuite : public TestSuite
+{
+public:
+  AlFecCodecSlidingWindowRlcTestSuite ();
+};
+
+/**
+ * Test 1. Recover the lost source symbols of a stream, with a full and a sparse window
+ */
+class RlcRecoveryTestCase : public TestCase
+{
+public:
+  RlcRecoveryTestCase ();
+  virtual ~RlcRecoveryTestCase ();
+  const unsigned int symbolSize = 202;
+  const unsigned int windowSize = 32;
+  const double codeRate = 0.8;
+  const double lossRate = 0.1;
+  const int nbPackets = 2000;
+  const double minDeliveryRate = 0.99; // Source symbols received or recovered
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 2. Packets with the sliding window header over a lossy channel, and
+ * the recovery delay in simulated time
+ */
+class RlcRecoveryDelayTestCase : public TestCase
+{
+public:
+  RlcRecoveryDelayTestCase ();
+  virtual ~RlcRecoveryDelayTestCase ();
+  const unsigned int symbolSize = 102;
+  const unsigned int windowSize = 8;
+  const double codeRate = 0.75;
+  const double lossRate = 0.05;
+  const int nbPackets = 500;
+  const Time interval = MilliSeconds (10); // Between two source packets
+  const Time propagationDelay = MilliSeconds (5);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Send the next source packet and the repair packets due after it
+   */
+  void SendPacket (int i);
+
+  /**
+   * \brief Receive a packet, unless the channel drops it
+   */
+  void ReceivePacket (Ptr<Packet> p);
+
+  ObjectFactory m_codecFactory;
+  Ptr<AlFecCodecSlidingWindowRlc> m_encoder;
+  Ptr<AlFecCodecSlidingWindowRlc> m_decoder;
+  std::mt19937 m_gen;
+  std::map<uint32_t, std::vector<uint8_t>> m_sent; // ADU of each ESI
+  std::map<uint32_t, Time> m_sentTime; // Send time of each ESI
+  size_t m_nbDelivered; // Source packets received or recovered
+  size_t m_nbMismatch; // Recovered source packets with a wrong content
+  Time m_maxLateness; // Largest delay between the expected and the actual delivery of a packet
+};
+
+#endif /* TEST_AL_FEC_CODEC_SLIDING_WINDOW_RLC_H */
@@ -0,0 +1,250 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/object.h"
+#include "ns3/core-module.h"
+#include "ns3/packet.h"
+
+#include "al-fec-test-decoder-context-table.h"
+#include "ns3/al-fec-codec-native-rs.h"
+#include "ns3/al-fec-decoder-context-table.h"
+#include "../model/util.h"
+
+#include <optional>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("AlFecDecoderContextTableTest");
+
+/**
+ * TestSuite
+ */
+
+AlFecDecoderContextTableTestSuite::AlFecDecoderContextTableTestSuite ()
+    : TestSuite ("al-fec-decoder-context-table", SYSTEM)
+{
+  LogLevel logLevel = (LogLevel) (LOG_PREFIX_FUNC | LOG_PREFIX_TIME | LOG_LEVEL_ALL);
+
+  LogComponentEnable ("AlFecDecoderContextTableTest", logLevel);
+  AddTestCase (new ContextLimitTestCase (), TestCase::QUICK);
+  AddTestCase (new ContextMemoryLimitTestCase (), TestCase::QUICK);
+  AddTestCase (new ContextTimeoutTestCase (), TestCase::QUICK);
+  AddTestCase (new ContextCodecRecyclingTestCase (), TestCase::QUICK);
+}
+
+static AlFecDecoderContextTableTestSuite decoderContextTableTestSuite;
+
+/**
+ * TestCase 1
+ */
+
+ContextLimitTestCase::ContextLimitTestCase () : TestCase ("Check the context limit")
+{
+  NS_LOG_INFO ("Creating ContextLimitTestCase");
+}
+
+ContextLimitTestCase::~ContextLimitTestCase ()
+{
+}
+
+void
+ContextLimitTestCase::DoRun (void)
+{
+  AlFecDecoderContextTable table;
+  table.SetLimits (maxContexts, 1024 * 1024, Time ());
+
+  for (uint16_t sn = 0; sn < nbBlocks; sn++)
+    {
+      table.Lookup (0, sn, Time ());
+    }
+  NS_TEST_ASSERT_MSG_EQ (table.GetSize (), maxContexts, "The table is over its limit");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNbEvictions (), nbBlocks - maxContexts, "Evictions mismatch");
+
+  // The most recent blocks are still there
+  AlFecDecoderContextTable::Context *context = table.Lookup (0, nbBlocks - 1, Time ());
+  context->complete = true;
+  NS_TEST_ASSERT_MSG_EQ (table.GetNbEvictions (), nbBlocks - maxContexts,
+                         "A kept block was evicted");
+
+  // A lower limit is enforced by the next new block
+  table.SetLimits (loweredMaxContexts, 1024 * 1024, Time ());
+  table.Lookup (0, nbBlocks, Time ());
+  NS_TEST_ASSERT_MSG_EQ (table.GetSize (), loweredMaxContexts, "The table is over its new limit");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNbEvictions (), nbBlocks + 1 - loweredMaxContexts,
+                         "Evictions mismatch after lowering the limit");
+  context = table.Lookup (0, nbBlocks - 1, Time ());
+  NS_TEST_ASSERT_MSG_EQ (context->complete, true, "The most recently used block was evicted");
+  table.Dispose ();
+}
+
+/**
+ * TestCase 2
+ */
+
+ContextMemoryLimitTestCase::ContextMemoryLimitTestCase ()
+    : TestCase ("Check the memory limit of the contexts")
+{
+  NS_LOG_INFO ("Creating ContextMemoryLimitTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecNativeRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+ContextMemoryLimitTestCase::~ContextMemoryLimitTestCase ()
+{
+}
+
+void
+ContextMemoryLimitTestCase::DoRun (void)
+{
+  AlFecDecoderContextTable table;
+  table.SetLimits (1024, maxMemory, Time ());
+  table.SetCodecFactory (m_codecFactory);
+
+  // Each block receives one symbol, so that its decoder holds N symbols
+  std::vector<uint8_t> symbol (symbolSize);
+  size_t decoderSize = 0;
+  AlFecDecoderContextTable::Context *context = nullptr;
+  for (uint16_t sn = 0; sn < nbBlocks; sn++)
+    {
+      context = table.Lookup (0, sn, Time ());
+      context->decodedBlocks.resize (1);
+      context->codecs.assign (1, nullptr);
+      AlFecCodec *codec = table.GetCodec (context, 0, k);
+      codec->Decode (symbol.data (), symbolSize, 0);
+      decoderSize = codec->GetN () * codec->GetSymbolSize ();
+      table.UpdateMemoryUsage (context);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (table.GetMemoryUsage (), maxMemory,
+                                   "The table is over its memory limit");
+    }
+  size_t nbKept = maxMemory / decoderSize;
+  NS_TEST_ASSERT_MSG_EQ (table.GetSize (), nbKept, "Contexts mismatch");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNbEvictions (), nbBlocks - nbKept, "Evictions mismatch");
+  NS_TEST_ASSERT_MSG_EQ (table.GetMemoryUsage (), nbKept * decoderSize, "Memory usage mismatch");
+
+  // The decoded packet kept for the late symbols is counted in place of the decoder
+  size_t nbEvictions = table.GetNbEvictions ();
+  table.Complete (context, Create<Packet> (packetSize));
+  NS_TEST_ASSERT_MSG_EQ (table.GetMemoryUsage (), static_cast<size_t> (packetSize),
+                         "The decoded packet should be counted");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNbEvictions (), nbEvictions + nbKept - 1,
+                         "The packet should evict the other blocks");
+
+  table.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (table.GetMemoryUsage (), static_cast<size_t> (0),
+                         "Evicted memory should be released");
+  table.Dispose ();
+}
+
+/**
+ * TestCase 3
+ */
+
+ContextTimeoutTestCase::ContextTimeoutTestCase () : TestCase ("Check the timeout of the contexts")
+{
+  NS_LOG_INFO ("Creating ContextTimeoutTestCase");
+}
+
+ContextTimeoutTestCase::~ContextTimeoutTestCase ()
+{
+}
+
+void
+ContextTimeoutTestCase::DoRun (void)
+{
+  AlFecDecoderContextTable table;
+  table.SetLimits (1024, 1024 * 1024, Seconds (1));
+
+  AlFecDecoderContextTable::Context *context = table.Lookup (0, 0, Seconds (0));
+  context->complete = true;
+  context = table.Lookup (0, 1, Seconds (0.5));
+  context->complete = true;
+
+  // Block 0 is unused for more than the timeout, block 1 is not
+  table.Lookup (0, 2, Seconds (1.2));
+  NS_TEST_ASSERT_MSG_EQ (table.GetSize (), static_cast<size_t> (2),
+                         "The timed out block should be dropped");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNbEvictions (), static_cast<size_t> (1), "Evictions mismatch");
+  context = table.Lookup (0, 1, Seconds (1.2));
+  NS_TEST_ASSERT_MSG_EQ (context->complete, true, "A recent block was dropped");
+  context = table.Lookup (0, 0, Seconds (1.2));
+  NS_TEST_ASSERT_MSG_EQ (context->complete, false, "A timed out block should start over");
+  table.Dispose ();
+}
+
+/**
+ * TestCase 4
+ */
+
+ContextCodecRecyclingTestCase::ContextCodecRecyclingTestCase ()
+    : TestCase ("Check the decoders recycled between blocks")
+{
+  NS_LOG_INFO ("Creating ContextCodecRecyclingTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecNativeRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+ContextCodecRecyclingTestCase::~ContextCodecRecyclingTestCase ()
+{
+}
+
+void
+ContextCodecRecyclingTestCase::DoRun (void)
+{
+  AlFecDecoderContextTable table;
+  table.SetCodecFactory (m_codecFactory);
+  Ptr<AlFecCodecNativeRs> encoder = m_codecFactory.Create<AlFecCodecNativeRs> ();
+
+  size_t blockSize = k * symbolSize;
+  uint8_t *buf = new uint8_t[blockSize];
+  AlFecCodec *firstCodec = nullptr;
+  for (uint16_t sn = 0; sn < 2; sn++)
+    {
+      fillRandomBytes (buf, blockSize);
+      Buffer p;
+      p.AddAtStart (blockSize);
+      p.Begin ().Write (buf, blockSize);
+      encoder->NextBlock ();
+      encoder->SetSourceBlock (p);
+
+      AlFecDecoderContextTable::Context *context = table.Lookup (0, sn, Time ());
+      context->decodedBlocks.resize (1);
+      context->codecs.assign (1, nullptr);
+      AlFecCodec *codec = table.GetCodec (context, 0, k);
+      if (sn == 0)
+        {
+          firstCodec = codec;
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (codec, firstCodec, "The decoder should be recycled");
+        }
+
+      // The first source symbols are lost, so that the block needs repair symbols
+      std::optional<std::pair<unsigned int, Buffer>> encodedBlock;
+      std::optional<Buffer> decodedBlock;
+      while (!decodedBlock && (encodedBlock = encoder->NextEncodedBlock ()))
+        {
+          if (encodedBlock->first < nbLost)
+            {
+              continue;
+            }
+          decodedBlock = codec->Decode (encodedBlock->second, encodedBlock->first);
+        }
+      NS_TEST_ASSERT_MSG_EQ (decodedBlock.has_value (), true, "Block " << sn << " not decoded");
+      NS_TEST_ASSERT_MSG_EQ (decodedBlock->GetSize (), blockSize, "Decoded size mismatch");
+      const uint8_t *decoded = decodedBlock->PeekData ();
+      for (size_t i = 0; i < blockSize; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (decoded[i], buf[i], "Block " << sn << " content mismatch");
+        }
+      NS_TEST_ASSERT_MSG_EQ (table.FinishBlock (context, 0, *decodedBlock), true,
+                             "The context should be decoded");
+    }
+
+  delete[] buf;
+  encoder->Dispose ();
+  table.Dispose ();
+}
@@ -0,0 +1,85 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef TEST_AL_FEC_DECODER_CONTEXT_TABLE_H
+#define TEST_AL_FEC_DECODER_CONTEXT_TABLE_H
+
+#include "ns3/test.h"
+
+using namespace ns3;
+
+class AlFecDecoderContextTableTestSuite : public TestSuite
+{
+public:
+  AlFecDecoderContextTableTestSuite ();
+};
+
+/**
+ * Test 1. The least recently used contexts are evicted past the context
+ * limit, also when the limit is lowered
+ */
+class ContextLimitTestCase : public TestCase
+{
+public:
+  ContextLimitTestCase ();
+  virtual ~ContextLimitTestCase ();
+  const size_t maxContexts = 4;
+  const size_t loweredMaxContexts = 2;
+  const uint16_t nbBlocks = 10;
+
+private:
+  virtual void DoRun (void);
+};
+
+/**
+ * Test 2. Contexts are evicted past the memory limit, which counts the
+ * decoders and the retained decoded packets
+ */
+class ContextMemoryLimitTestCase : public TestCase
+{
+public:
+  ContextMemoryLimitTestCase ();
+  virtual ~ContextMemoryLimitTestCase ();
+  const unsigned int symbolSize = 100;
+  const double codeRate = 0.5;
+  const size_t k = 10;
+  const size_t maxMemory = 5000; // Room for the decoders of two blocks
+  const uint16_t nbBlocks = 4;
+  const uint32_t packetSize = 4000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 3. Contexts unused for the timeout are dropped and start over
+ */
+class ContextTimeoutTestCase : public TestCase
+{
+public:
+  ContextTimeoutTestCase ();
+  virtual ~ContextTimeoutTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+/**
+ * Test 4. The decoder recycled from a decoded block decodes the next block
+ */
+class ContextCodecRecyclingTestCase : public TestCase
+{
+public:
+  ContextCodecRecyclingTestCase ();
+  virtual ~ContextCodecRecyclingTestCase ();
+  const unsigned int symbolSize = 16;
+  const double codeRate = 0.5;
+  const size_t k = 10;
+  const unsigned int nbLost = 3; // First source symbols of each block
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+#endif /* TEST_AL_FEC_DECODER_CONTEXT_TABLE_H */
@@ -9,6 +9,8 @@
 #include "ns3/al-fec.h"
 #include "ns3/al-fec-codec-openfec-rs.h"
 #include "ns3/al-fec-header.h"
+#include "ns3/al-fec-info-tag.h"
+#include "ns3/al-fec-packet-context-store.h"
 #include "../model/util.h"
 
 #include "ns3/icmpv4.h"
@@ -19,6 +21,8 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <limits>
+#include <map>
+#include <set>
 
 using namespace ns3;
 
@@ -103,6 +107,16 @@ public:
     return std::nullopt;
   }
 
+  /**
+   * \brief Finish the current block
+  */
+  void
+  NextBlock ()
+  {
+    m_sourceBlock = Buffer ();
+    m_esi = 0;
+  }
+
 private:
   Buffer m_sourceBlock;
   unsigned int m_esi = 0;
@@ -119,6 +133,21 @@ AlFecPacketTestSuite::AlFecPacketTestSuite () : TestSuite ("al-fec-packet", SYST
   LogComponentEnable ("AlFecPacketTest", logLevel);
   AddTestCase (new EncapsulateTestCase (), TestCase::QUICK);
   AddTestCase (new InterpretationTestCase (), TestCase::QUICK);
+  AddTestCase (new MultiBlockInterpretationTestCase (), TestCase::QUICK);
+  AddTestCase (new AggregationTestCase (), TestCase::QUICK);
+  AddTestCase (new InterleavedBlocksTestCase (), TestCase::QUICK);
+  AddTestCase (new EarlyDeliveryTestCase ("ns3::AlFecCodecNativeRs"), TestCase::QUICK);
+  AddTestCase (new EarlyDeliveryTestCase ("ns3::AlFecCodecRaptorq"), TestCase::QUICK);
+  AddTestCase (new EarlyDeliveryTestCase ("ns3::AlFecCodecLt"), TestCase::QUICK);
+  AddTestCase (new EarlyDeliveryTestCase ("ns3::AlFecCodecOpenfecLdpc"), TestCase::QUICK);
+  AddTestCase (new WideParametersTestCase (), TestCase::QUICK);
+  AddTestCase (new SharedContextTestCase (), TestCase::QUICK);
+  AddTestCase (new DirectPacketPathTestCase (), TestCase::QUICK);
+  AddTestCase (new BatchTestCase (), TestCase::QUICK);
+  AddTestCase (new LowCodeRateTestCase ("ns3::AlFecCodecRaptorq"), TestCase::QUICK);
+  AddTestCase (new LowCodeRateTestCase ("ns3::AlFecCodecLt"), TestCase::QUICK);
+  AddTestCase (new EvictedContextTestCase (0), TestCase::QUICK);
+  AddTestCase (new EvictedContextTestCase (3), TestCase::QUICK);
 }
 
 static AlFecPacketTestSuite packetTestSuite;
@@ -263,3 +292,992 @@ InterpretationTestCase::DoRun (void)
   encoderObj->Dispose ();
   decoderObj->Dispose ();
 }
+
+/**
+ * TestCase 3
+ */
+
+MultiBlockInterpretationTestCase::MultiBlockInterpretationTestCase ()
+    : TestCase ("Check multi-block interpretation")
+{
+  NS_LOG_INFO ("Creating MultiBlockInterpretationTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecOpenfecRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+MultiBlockInterpretationTestCase::~MultiBlockInterpretationTestCase ()
+{
+}
+
+void
+MultiBlockInterpretationTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecOpenfecRs> encoderObj = m_codecFactory.Create<AlFecCodecOpenfecRs> ();
+  AlFecCodec *encodeCodec = static_cast<AlFecCodec *> (GetPointer (encoderObj));
+  Ptr<AlFec> encoder = CreateObject<AlFec> ();
+  encoder->SetCodec (encodeCodec);
+
+  uint8_t *buf = new uint8_t[payloadSize];
+  std::optional<Ptr<Packet>> encodedPacket;
+  Ptr<Packet> originalPacket;
+  fillRandomBytes (buf, payloadSize);
+  originalPacket = Create<Packet> (buf, payloadSize);
+  delete[] buf;
+
+  // The packet does not fit in one RS(255) block
+  std::vector<Ptr<Packet>> packetList;
+  std::set<uint16_t> sbnList;
+  size_t n = encoder->EncodePacket (originalPacket);
+  while ((encodedPacket = encoder->NextEncodedPacket ()))
+    {
+      AlFecHeader::EncodeHeader encodeHeader;
+      (*encodedPacket)->PeekHeader (encodeHeader);
+      sbnList.insert (encodeHeader.GetSourceBlockNumber ());
+      packetList.push_back (*encodedPacket);
+    }
+  NS_TEST_ASSERT_MSG_EQ (packetList.size (), n, "Total symbols mismatch");
+  NS_TEST_ASSERT_MSG_GT (sbnList.size (), 1, "Packet should be split into several blocks");
+
+  // Lose one packet out of three, which every block can recover at rate 1/2
+  std::random_device rd;
+  std::mt19937 gen (rd ());
+  shuffle (packetList.begin (), packetList.end (), gen);
+  Ptr<AlFecCodecOpenfecRs> decoderObj = m_codecFactory.Create<AlFecCodecOpenfecRs> ();
+  AlFecCodec *decodeCodec = static_cast<AlFecCodec *> (GetPointer (decoderObj));
+  Ptr<AlFec> decoder = CreateObject<AlFec> ();
+  decoder->SetCodec (decodeCodec);
+
+  std::optional<Ptr<Packet>> decodedPacket;
+  for (size_t i = 0; i < packetList.size (); i++)
+    {
+      if (i % 3 == 0)
+        {
+          continue;
+        }
+      decodedPacket = decoder->DecodePacket (packetList[i]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (decodedPacket.has_value (), true, "Packet not decoded");
+
+  // Compare the decoded packet with original packet
+  NS_TEST_ASSERT_MSG_EQ (originalPacket->GetSerializedSize (),
+                         (*decodedPacket)->GetSerializedSize (), "Serialized size mismatch");
+  size_t serializedSize = originalPacket->GetSerializedSize ();
+  uint8_t *txBuf = new uint8_t[serializedSize];
+  originalPacket->Serialize (txBuf, serializedSize);
+  uint8_t *rxBuf = new uint8_t[serializedSize];
+  (*decodedPacket)->Serialize (rxBuf, serializedSize);
+  for (size_t i = 0; i < static_cast<size_t> (serializedSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (txBuf[i], rxBuf[i], "Decode content mismatch");
+    }
+  delete[] rxBuf;
+  delete[] txBuf;
+  encoder->Dispose ();
+  decoder->Dispose ();
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 4
+ */
+
+AggregationTestCase::AggregationTestCase () : TestCase ("Check aggregation")
+{
+  NS_LOG_INFO ("Creating AggregationTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecOpenfecRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+AggregationTestCase::~AggregationTestCase ()
+{
+}
+
+void
+AggregationTestCase::Flushed (size_t n)
+{
+  NS_LOG_INFO ("Flushed " << n << " encoded packets");
+  m_nbFlushed += n;
+}
+
+void
+AggregationTestCase::DoRun (void)
+{
+  Ptr<AlFecCodecOpenfecRs> encoderObj = m_codecFactory.Create<AlFecCodecOpenfecRs> ();
+  Ptr<AlFec> encoder = CreateObject<AlFec> ();
+  encoder->SetCodec (GetPointer (encoderObj));
+  encoder->SetAttribute ("flushSize", UintegerValue (100000));
+  Ptr<AlFecCodecOpenfecRs> decoderObj = m_codecFactory.Create<AlFecCodecOpenfecRs> ();
+  Ptr<AlFec> decoder = CreateObject<AlFec> ();
+  decoder->SetCodec (GetPointer (decoderObj));
+
+  uint8_t *buf = new uint8_t[payloadSize];
+  std::random_device rd;
+  std::mt19937 gen (rd ());
+  std::uniform_int_distribution<uint16_t> uniDist (0, std::numeric_limits<uint16_t>::max ());
+
+  // Consecutive blocks have different sequence numbers, so the receiver
+  // decodes each of them
+  for (int block = 0; block < nbBlocks; block++)
+    {
+      std::vector<Ptr<Packet>> originalPackets;
+      for (int i = 0; i < nbPackets; i++)
+        {
+          fillRandomBytes (buf, payloadSize);
+          Ptr<Packet> p = Create<Packet> (buf, payloadSize);
+          Icmpv4Echo testHeader;
+          testHeader.SetIdentifier (uniDist (gen));
+          testHeader.SetSequenceNumber (i);
+          p->AddHeader (testHeader);
+          originalPackets.push_back (p);
+          NS_TEST_ASSERT_MSG_EQ (encoder->AggregatePacket (p), 0, "Block flushed too early");
+        }
+      size_t n = encoder->Flush ();
+      NS_TEST_ASSERT_MSG_GT (n, 0, "Nothing to send");
+
+      std::vector<Ptr<Packet>> packetList;
+      std::optional<Ptr<Packet>> encodedPacket;
+      while ((encodedPacket = encoder->NextEncodedPacket ()))
+        {
+          packetList.push_back (*encodedPacket);
+        }
+      NS_TEST_ASSERT_MSG_EQ (packetList.size (), n, "Total symbols mismatch");
+
+      // Lose the first source symbols
+      std::vector<Ptr<Packet>> decodedPackets;
+      std::optional<Ptr<Packet>> decodedPacket;
+      for (size_t i = 2; i < packetList.size (); i++)
+        {
+          if ((decodedPacket = decoder->DecodePacket (packetList[i])))
+            {
+              decodedPackets.push_back (*decodedPacket);
+              while ((decodedPacket = decoder->NextDecodedPacket ()))
+                {
+                  decodedPackets.push_back (*decodedPacket);
+                }
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (decodedPackets.size (), originalPackets.size (),
+                             "Packets should be delivered individually");
+
+      for (size_t i = 0; i < originalPackets.size (); i++)
+        {
+          size_t serializedSize = originalPackets[i]->GetSerializedSize ();
+          NS_TEST_ASSERT_MSG_EQ (decodedPackets[i]->GetSerializedSize (), serializedSize,
+                                 "Serialized size mismatch");
+          uint8_t *txBuf = new uint8_t[serializedSize];
+          uint8_t *rxBuf = new uint8_t[serializedSize];
+          originalPackets[i]->Serialize (txBuf, serializedSize);
+          decodedPackets[i]->Serialize (rxBuf, serializedSize);
+          for (size_t j = 0; j < serializedSize; j++)
+            {
+              NS_TEST_ASSERT_MSG_EQ (txBuf[j], rxBuf[j], "Decode content mismatch");
+            }
+          delete[] rxBuf;
+          delete[] txBuf;
+        }
+    }
+
+  // A lone packet is flushed by the timeout
+  encoder->SetAttribute ("flushTimeout", TimeValue (MilliSeconds (5)));
+  encoder->SetFlushCallback (MakeCallback (&AggregationTestCase::Flushed, this));
+  fillRandomBytes (buf, payloadSize);
+  encoder->AggregatePacket (Create<Packet> (buf, payloadSize));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_GT (m_nbFlushed, 0, "Timeout should flush the block");
+
+  delete[] buf;
+  encoder->Dispose ();
+  decoder->Dispose ();
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 5
+ */
+
+InterleavedBlocksTestCase::InterleavedBlocksTestCase ()
+    : TestCase ("Check interleaved source blocks")
+{
+  NS_LOG_INFO ("Creating InterleavedBlocksTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecOpenfecRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+InterleavedBlocksTestCase::~InterleavedBlocksTestCase ()
+{
+}
+
+void
+InterleavedBlocksTestCase::DoRun (void)
+{
+  uint8_t *buf = new uint8_t[payloadSize];
+  std::map<std::pair<uint32_t, uint16_t>, Ptr<Packet>> originalPackets;
+  std::vector<std::pair<uint32_t, Ptr<Packet>>> packetList;
+
+  // Every flow sends several packets, each in its own source block
+  for (uint32_t flowId = 0; flowId < static_cast<uint32_t> (nbFlows); flowId++)
+    {
+      Ptr<AlFecCodecOpenfecRs> encoderObj = m_codecFactory.Create<AlFecCodecOpenfecRs> ();
+      Ptr<AlFec> encoder = CreateObject<AlFec> ();
+      encoder->SetCodec (GetPointer (encoderObj));
+      for (uint16_t sn = 0; sn < nbPacketsPerFlow; sn++)
+        {
+          fillRandomBytes (buf, payloadSize);
+          Ptr<Packet> p = Create<Packet> (buf, payloadSize);
+          originalPackets[std::make_pair (flowId, sn)] = p;
+          std::optional<Ptr<Packet>> encodedPacket;
+          encoder->EncodePacket (p);
+          while ((encodedPacket = encoder->NextEncodedPacket ()))
+            {
+              packetList.push_back (std::make_pair (flowId, *encodedPacket));
+            }
+        }
+      encoder->Dispose ();
+      encoderObj->Dispose ();
+    }
+
+  // All the source blocks are in flight at once
+  std::random_device rd;
+  std::mt19937 gen (rd ());
+  shuffle (packetList.begin (), packetList.end (), gen);
+
+  Ptr<AlFecCodecOpenfecRs> decoderObj = m_codecFactory.Create<AlFecCodecOpenfecRs> ();
+  Ptr<AlFec> decoder = CreateObject<AlFec> ();
+  decoder->SetCodec (GetPointer (decoderObj));
+  std::map<std::pair<uint32_t, uint16_t>, Ptr<Packet>> decodedPackets;
+  for (auto &rcvdPacket : packetList)
+    {
+      AlFecHeader::EncodeHeader encodeHeader;
+      rcvdPacket.second->PeekHeader (encodeHeader);
+      std::optional<Ptr<Packet>> decodedPacket =
+          decoder->DecodePacket (rcvdPacket.second, rcvdPacket.first);
+      if (decodedPacket)
+        {
+          decodedPackets.emplace (
+              std::make_pair (rcvdPacket.first, encodeHeader.GetSequenceNumber ()),
+              *decodedPacket);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (decodedPackets.size (), originalPackets.size (),
+                         "Every source block should be decoded");
+
+  for (auto &originalPacket : originalPackets)
+    {
+      Ptr<Packet> decodedPacket = decodedPackets[originalPacket.first];
+      NS_TEST_ASSERT_MSG_EQ (static_cast<bool> (decodedPacket), true, "Missing packet");
+      size_t serializedSize = originalPacket.second->GetSerializedSize ();
+      NS_TEST_ASSERT_MSG_EQ (decodedPacket->GetSerializedSize (), serializedSize,
+                             "Serialized size mismatch");
+      uint8_t *txBuf = new uint8_t[serializedSize];
+      uint8_t *rxBuf = new uint8_t[serializedSize];
+      originalPacket.second->Serialize (txBuf, serializedSize);
+      decodedPacket->Serialize (rxBuf, serializedSize);
+      for (size_t i = 0; i < serializedSize; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (txBuf[i], rxBuf[i], "Decode content mismatch");
+        }
+      delete[] rxBuf;
+      delete[] txBuf;
+    }
+
+  delete[] buf;
+  decoder->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 6
+ */
+
+EarlyDeliveryTestCase::EarlyDeliveryTestCase (std::string typeId)
+    : TestCase ("Check early delivery with " + typeId)
+{
+  NS_LOG_INFO ("Creating EarlyDeliveryTestCase");
+  m_codecFactory.SetTypeId (typeId);
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+  if (typeId == "ns3::AlFecCodecLt")
+    {
+      // The ESIs below K must be the source symbols
+      m_codecFactory.Set ("systematic", BooleanValue (true));
+    }
+}
+
+EarlyDeliveryTestCase::~EarlyDeliveryTestCase ()
+{
+}
+
+void
+EarlyDeliveryTestCase::Delivered (uint32_t flowId, uint16_t sn, uint32_t offset, Ptr<Packet> p)
+{
+  NS_LOG_INFO ("Delivered " << p->GetSize () << " bytes at offset " << offset);
+  NS_TEST_ASSERT_MSG_EQ (offset, m_delivered.size (), "Bytes should be delivered in order");
+  size_t size = m_delivered.size ();
+  m_delivered.resize (size + p->GetSize ());
+  p->CopyData (&m_delivered[size], p->GetSize ());
+}
+
+void
+EarlyDeliveryTestCase::DoRun (void)
+{
+  Ptr<Object> encoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> encoder = CreateObject<AlFec> ();
+  encoder->SetAttribute ("maxSourceBlockLength", UintegerValue (maxSourceBlockLength));
+  encoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (encoderObj)));
+
+  uint8_t *buf = new uint8_t[payloadSize];
+  fillRandomBytes (buf, payloadSize);
+  Ptr<Packet> originalPacket = Create<Packet> (buf, payloadSize);
+  std::optional<Ptr<Packet>> encodedPacket;
+  std::vector<Ptr<Packet>> packetList;
+  encoder->EncodePacket (originalPacket);
+  while ((encodedPacket = encoder->NextEncodedPacket ()))
+    {
+      packetList.push_back (*encodedPacket);
+    }
+
+  Ptr<Object> decoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> decoder = CreateObject<AlFec> ();
+  decoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (decoderObj)));
+  decoder->SetEarlyDeliveryCallback (MakeCallback (&EarlyDeliveryTestCase::Delivered, this));
+
+  // The symbols arrive in order, except one source symbol of the first source block
+  std::optional<Ptr<Packet>> decodedPacket;
+  size_t nbBlocks = 0;
+  for (Ptr<Packet> packet : packetList)
+    {
+      AlFecHeader::EncodeHeader encodeHeader;
+      AlFecInfoTag encodeTag;
+      packet->PeekHeader (encodeHeader);
+      packet->FindFirstMatchingByteTag (encodeTag);
+      uint16_t sbn = encodeHeader.GetSourceBlockNumber ();
+      unsigned int esi = encodeHeader.GetEncodedSymbolId ();
+      size_t k = encodeTag.GetK ();
+      nbBlocks = encodeTag.GetNbSourceBlocks ();
+      if (sbn == 0 && esi == lostEsi)
+        {
+          continue;
+        }
+      NS_TEST_ASSERT_MSG_EQ (decodedPacket.has_value (), false, "Packet decoded too early");
+      decodedPacket = decoder->DecodePacket (packet);
+
+      // The payload header starts the first symbol
+      size_t headerSize = AlFecHeader::PayloadHeader ().GetSerializedSize ();
+      size_t expected = 0;
+      if (sbn == 0 && esi < lostEsi)
+        {
+          expected = (esi + 1) * symbolSize - headerSize;
+        }
+      else if (sbn == 0 && esi < k)
+        {
+          expected = lostEsi * symbolSize - headerSize;
+        }
+      else if (sbn == 0)
+        {
+          // The rest of the block is delivered at once when it decodes, after
+          // a number of repair symbols that depends on the codec
+          bool gapOrBlock = m_delivered.size () == lostEsi * symbolSize - headerSize ||
+                            m_delivered.size () == k * symbolSize - headerSize;
+          NS_TEST_ASSERT_MSG_EQ (gapOrBlock, true,
+                                 "Delivered bytes mismatch after sbn=" << sbn << " esi=" << esi);
+          continue;
+        }
+      else
+        {
+          continue;
+        }
+      NS_TEST_ASSERT_MSG_EQ (m_delivered.size (), expected,
+                             "Delivered bytes mismatch after sbn=" << sbn << " esi=" << esi);
+    }
+  NS_TEST_ASSERT_MSG_GT (nbBlocks, 1, "Packet should be split into several blocks");
+  NS_TEST_ASSERT_MSG_EQ (decodedPacket.has_value (), true, "Packet not decoded");
+
+  // Every byte of the packet was delivered once
+  NS_TEST_ASSERT_MSG_EQ (m_delivered.size (), static_cast<size_t> (payloadSize),
+                         "Delivered size mismatch");
+  for (size_t i = 0; i < static_cast<size_t> (payloadSize); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buf[i], m_delivered[i], "Delivered content mismatch");
+    }
+
+  delete[] buf;
+  encoder->Dispose ();
+  decoder->Dispose ();
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 7
+ */
+
+WideParametersTestCase::WideParametersTestCase ()
+    : TestCase ("Check interpretation with large symbols and large blocks")
+{
+  NS_LOG_INFO ("Creating WideParametersTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecFftRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+WideParametersTestCase::~WideParametersTestCase ()
+{
+}
+
+void
+WideParametersTestCase::DoRun (void)
+{
+  Ptr<Object> encoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> encoder = CreateObject<AlFec> ();
+  encoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (encoderObj)));
+
+  // The padding does not fit in a byte
+  size_t headerSize = AlFecHeader::PayloadHeader ().GetSerializedSize ();
+  size_t payloadSize = nbSourceSymbols * symbolSize - headerSize - paddingSize;
+  uint8_t *buf = new uint8_t[payloadSize];
+  fillRandomBytes (buf, payloadSize);
+  Ptr<Packet> originalPacket = Create<Packet> (buf, payloadSize);
+  delete[] buf;
+  std::optional<Ptr<Packet>> encodedPacket;
+  std::vector<Ptr<Packet>> packetList;
+  encoder->EncodePacket (originalPacket);
+  while ((encodedPacket = encoder->NextEncodedPacket ()))
+    {
+      packetList.push_back (*encodedPacket);
+    }
+
+  // The ESI, K and the symbol size go through the header and the tag
+  AlFecHeader::EncodeHeader encodeHeader;
+  AlFecInfoTag encodeTag;
+  packetList.back ()->PeekHeader (encodeHeader);
+  packetList.back ()->FindFirstMatchingByteTag (encodeTag);
+  NS_TEST_ASSERT_MSG_EQ (encodeTag.GetNbSourceBlocks (), 1, "Packet should fit in one block");
+  NS_TEST_ASSERT_MSG_EQ (encodeTag.GetK (), nbSourceSymbols, "K mismatch");
+  NS_TEST_ASSERT_MSG_EQ (encodeTag.GetSymbolSize (), symbolSize, "Symbol size mismatch");
+  NS_TEST_ASSERT_MSG_EQ (encodeHeader.GetEncodedSymbolId (), packetList.size () - 1,
+                         "ESI mismatch");
+
+  Ptr<Object> decoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> decoder = CreateObject<AlFec> ();
+  decoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (decoderObj)));
+
+  // Lose the first half of the source symbols
+  std::optional<Ptr<Packet>> decodedPacket;
+  for (size_t i = nbSourceSymbols / 2; i < packetList.size () && !decodedPacket; i++)
+    {
+      decodedPacket = decoder->DecodePacket (packetList[i]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (decodedPacket.has_value (), true, "Packet not decoded");
+
+  NS_TEST_ASSERT_MSG_EQ (originalPacket->GetSerializedSize (),
+                         (*decodedPacket)->GetSerializedSize (), "Serialized size mismatch");
+  size_t serializedSize = originalPacket->GetSerializedSize ();
+  std::vector<uint8_t> originalBuf (serializedSize);
+  std::vector<uint8_t> decodedBuf (serializedSize);
+  originalPacket->Serialize (originalBuf.data (), serializedSize);
+  (*decodedPacket)->Serialize (decodedBuf.data (), serializedSize);
+  NS_TEST_ASSERT_MSG_EQ (originalBuf == decodedBuf, true, "Decoded packet mismatch");
+
+  encoder->Dispose ();
+  decoder->Dispose ();
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 8
+ */
+
+SharedContextTestCase::SharedContextTestCase () : TestCase ("Check the shared packet context")
+{
+  NS_LOG_INFO ("Creating SharedContextTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecOpenfecRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+SharedContextTestCase::~SharedContextTestCase ()
+{
+}
+
+void
+SharedContextTestCase::DoRun (void)
+{
+  AlFecPacketContextStore &store = AlFecPacketContextStore::Get ();
+  store.ResetStats ();
+
+  Ptr<Object> encoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> encoder = CreateObject<AlFec> ();
+  encoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (encoderObj)));
+
+  // Two copies of a packet, which keep its UID and so its context
+  uint8_t *buf = new uint8_t[payloadSize];
+  fillRandomBytes (buf, payloadSize);
+  Ptr<Packet> packet = Create<Packet> (buf, payloadSize);
+  delete[] buf;
+
+  std::vector<Ptr<Packet>> originalPackets;
+  std::vector<std::vector<Ptr<Packet>>> packetLists;
+  std::set<uint32_t> handles;
+  for (int i = 0; i < 2; i++)
+    {
+      originalPackets.push_back (packet->Copy ());
+
+      std::optional<Ptr<Packet>> encodedPacket;
+      packetLists.emplace_back ();
+      encoder->EncodePacket (originalPackets.back ());
+      while ((encodedPacket = encoder->NextEncodedPacket ()))
+        {
+          AlFecInfoTag encodeTag;
+          (*encodedPacket)->FindFirstMatchingByteTag (encodeTag);
+          handles.insert (encodeTag.GetContextHandle ());
+          packetLists.back ().push_back (*encodedPacket);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (handles.size (), 1, "The packets should share their context");
+  NS_TEST_ASSERT_MSG_EQ (store.GetStats ().insertHits, 1, "The second context should be a hit");
+
+  // The context outlives the encoder for the symbols in flight
+  encoder->Dispose ();
+  encoderObj->Dispose ();
+
+  Ptr<Object> decoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> decoder = CreateObject<AlFec> ();
+  decoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (decoderObj)));
+  for (size_t i = 0; i < originalPackets.size (); i++)
+    {
+      std::optional<Ptr<Packet>> decodedPacket;
+      std::vector<Ptr<Packet>> &packetList = packetLists[i];
+      for (size_t j = packetList.size () / 2; j < packetList.size (); j++)
+        {
+          decodedPacket = decoder->DecodePacket (packetList[j]);
+        }
+      NS_TEST_ASSERT_MSG_EQ (decodedPacket.has_value (), true, "Packet not decoded");
+
+      size_t serializedSize = originalPackets[i]->GetSerializedSize ();
+      NS_TEST_ASSERT_MSG_EQ ((*decodedPacket)->GetSerializedSize (), serializedSize,
+                             "Serialized size mismatch");
+      std::vector<uint8_t> originalBuf (serializedSize);
+      std::vector<uint8_t> decodedBuf (serializedSize);
+      originalPackets[i]->Serialize (originalBuf.data (), serializedSize);
+      (*decodedPacket)->Serialize (decodedBuf.data (), serializedSize);
+      NS_TEST_ASSERT_MSG_EQ (originalBuf == decodedBuf, true, "Decoded packet mismatch");
+    }
+  // The context is fetched once per source block
+  NS_TEST_ASSERT_MSG_EQ (store.GetStats ().lookupHits, originalPackets.size (),
+                         "The context should be fetched once per block");
+
+  decoder->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 9
+ */
+
+DirectPacketPathTestCase::DirectPacketPathTestCase ()
+    : TestCase ("Check interpretation of copied packets")
+{
+  NS_LOG_INFO ("Creating DirectPacketPathTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecNativeRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+DirectPacketPathTestCase::~DirectPacketPathTestCase ()
+{
+}
+
+void
+DirectPacketPathTestCase::DoRun (void)
+{
+  Ptr<Object> encoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> encoder = CreateObject<AlFec> ();
+  encoder->SetAttribute ("directPacketPath", BooleanValue (true));
+  encoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (encoderObj)));
+
+  uint8_t *buf = new uint8_t[payloadSize];
+  fillRandomBytes (buf, payloadSize);
+  Ptr<Packet> originalPacket = Create<Packet> (buf, payloadSize);
+  delete[] buf;
+
+  // Any tag with a constructor is carried, AlFecInfoTag is one
+  AlFecInfoTag byteTag;
+  byteTag.SetK (1234);
+  originalPacket->AddByteTag (byteTag, 10, 20);
+  AlFecInfoTag packetTag;
+  packetTag.SetK (4321);
+  originalPacket->AddPacketTag (packetTag);
+
+  std::optional<Ptr<Packet>> encodedPacket;
+  std::vector<Ptr<Packet>> packetList;
+  encoder->EncodePacket (originalPacket);
+  while ((encodedPacket = encoder->NextEncodedPacket ()))
+    {
+      packetList.push_back (*encodedPacket);
+    }
+
+  // Lose every other symbol
+  Ptr<Object> decoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> decoder = CreateObject<AlFec> ();
+  decoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (decoderObj)));
+  std::optional<Ptr<Packet>> decodedPacket;
+  for (size_t i = 0; i < packetList.size () && !decodedPacket; i += 2)
+    {
+      decodedPacket = decoder->DecodePacket (packetList[i]);
+    }
+  for (size_t i = 1; i < packetList.size () && !decodedPacket; i += 2)
+    {
+      decodedPacket = decoder->DecodePacket (packetList[i]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (decodedPacket.has_value (), true, "Packet not decoded");
+
+  // The content
+  NS_TEST_ASSERT_MSG_EQ ((*decodedPacket)->GetSize (), originalPacket->GetSize (),
+                         "Size mismatch");
+  std::vector<uint8_t> originalBuf (payloadSize);
+  std::vector<uint8_t> decodedBuf (payloadSize);
+  originalPacket->CopyData (originalBuf.data (), payloadSize);
+  (*decodedPacket)->CopyData (decodedBuf.data (), payloadSize);
+  NS_TEST_ASSERT_MSG_EQ (originalBuf == decodedBuf, true, "Decoded packet mismatch");
+
+  // The tags
+  size_t nbByteTags = 0;
+  ByteTagIterator it = (*decodedPacket)->GetByteTagIterator ();
+  while (it.HasNext ())
+    {
+      ByteTagIterator::Item item = it.Next ();
+      NS_TEST_ASSERT_MSG_EQ (item.GetTypeId (), AlFecInfoTag::GetTypeId (), "Byte tag mismatch");
+      NS_TEST_ASSERT_MSG_EQ (item.GetStart (), 10, "Byte tag start mismatch");
+      NS_TEST_ASSERT_MSG_EQ (item.GetEnd (), 20, "Byte tag end mismatch");
+      AlFecInfoTag tag;
+      item.GetTag (tag);
+      NS_TEST_ASSERT_MSG_EQ (tag.GetK (), 1234, "Byte tag content mismatch");
+      nbByteTags++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (nbByteTags, 1, "Byte tag not restored");
+  AlFecInfoTag decodedPacketTag;
+  NS_TEST_ASSERT_MSG_EQ ((*decodedPacket)->PeekPacketTag (decodedPacketTag), true,
+                         "Packet tag not restored");
+  NS_TEST_ASSERT_MSG_EQ (decodedPacketTag.GetK (), 4321, "Packet tag content mismatch");
+
+  encoder->Dispose ();
+  decoder->Dispose ();
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 10
+ */
+
+BatchTestCase::BatchTestCase () : TestCase ("Check the batch encode and decode APIs")
+{
+  NS_LOG_INFO ("Creating BatchTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecNativeRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+BatchTestCase::~BatchTestCase ()
+{
+}
+
+void
+BatchTestCase::DoRun (void)
+{
+  Ptr<Object> batchEncoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> batchEncoder = CreateObject<AlFec> ();
+  batchEncoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (batchEncoderObj)));
+  Ptr<Object> encoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> encoder = CreateObject<AlFec> ();
+  encoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (encoderObj)));
+
+  std::vector<Ptr<Packet>> originalPackets;
+  for (int i = 0; i < nbPackets; i++)
+    {
+      uint8_t *buf = new uint8_t[payloadSize];
+      fillRandomBytes (buf, payloadSize);
+      originalPackets.push_back (Create<Packet> (buf, payloadSize));
+      delete[] buf;
+    }
+
+  // The batch gives the packets of the per-packet API
+  std::vector<Ptr<Packet>> packetList = batchEncoder->EncodeBatch (originalPackets);
+  std::vector<Ptr<Packet>> expectedList;
+  std::vector<size_t> nbEncodedPackets;
+  for (Ptr<Packet> originalPacket : originalPackets)
+    {
+      std::optional<Ptr<Packet>> encodedPacket;
+      nbEncodedPackets.push_back (encoder->EncodePacket (originalPacket));
+      while ((encodedPacket = encoder->NextEncodedPacket ()))
+        {
+          expectedList.push_back (*encodedPacket);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (packetList.size (), expectedList.size (), "Number of packets mismatch");
+  for (size_t i = 0; i < packetList.size (); i++)
+    {
+      uint32_t size = expectedList[i]->GetSize ();
+      NS_TEST_ASSERT_MSG_EQ (packetList[i]->GetSize (), size, "Encoded size mismatch");
+      std::vector<uint8_t> expectedBuf (size);
+      std::vector<uint8_t> batchBuf (size);
+      expectedList[i]->CopyData (expectedBuf.data (), size);
+      packetList[i]->CopyData (batchBuf.data (), size);
+      NS_TEST_ASSERT_MSG_EQ (batchBuf == expectedBuf, true, "Encoded packet mismatch");
+    }
+
+  // Decode the second half of the symbols of every packet in one burst
+  std::vector<Ptr<Packet>> burst;
+  std::vector<Ptr<Packet>> lateBurst;
+  size_t first = 0;
+  for (size_t nbEncoded : nbEncodedPackets)
+    {
+      for (size_t j = 0; j < nbEncoded; j++)
+        {
+          (j < nbEncoded / 2 ? lateBurst : burst).push_back (packetList[first + j]);
+        }
+      first += nbEncoded;
+    }
+  Ptr<Object> decoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> decoder = CreateObject<AlFec> ();
+  decoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (decoderObj)));
+  std::vector<Ptr<Packet>> decodedPackets = decoder->DecodeBatch (burst);
+  NS_TEST_ASSERT_MSG_EQ (decodedPackets.size (), originalPackets.size (),
+                         "Every packet should decode");
+  for (size_t i = 0; i < decodedPackets.size (); i++)
+    {
+      size_t serializedSize = originalPackets[i]->GetSerializedSize ();
+      NS_TEST_ASSERT_MSG_EQ (decodedPackets[i]->GetSerializedSize (), serializedSize,
+                             "Serialized size mismatch");
+      std::vector<uint8_t> originalBuf (serializedSize);
+      std::vector<uint8_t> decodedBuf (serializedSize);
+      originalPackets[i]->Serialize (originalBuf.data (), serializedSize);
+      decodedPackets[i]->Serialize (decodedBuf.data (), serializedSize);
+      NS_TEST_ASSERT_MSG_EQ (originalBuf == decodedBuf, true, "Decoded packet mismatch");
+    }
+
+  // The late symbols do not return the packets again
+  NS_TEST_ASSERT_MSG_EQ (decoder->DecodeBatch (lateBurst).size (), 0,
+                         "Late symbols should not decode");
+
+  batchEncoder->Dispose ();
+  encoder->Dispose ();
+  decoder->Dispose ();
+  batchEncoderObj->Dispose ();
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 11
+ */
+
+LowCodeRateTestCase::LowCodeRateTestCase (std::string typeId)
+    : TestCase ("Check the ESI range of " + typeId + " at a low code rate")
+{
+  NS_LOG_INFO ("Creating LowCodeRateTestCase");
+  m_codecFactory.SetTypeId (typeId);
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+LowCodeRateTestCase::~LowCodeRateTestCase ()
+{
+}
+
+void
+LowCodeRateTestCase::DoRun (void)
+{
+  Ptr<Object> encoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> encoder = CreateObject<AlFec> ();
+  encoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (encoderObj)));
+
+  uint8_t *buf = new uint8_t[payloadSize];
+  fillRandomBytes (buf, payloadSize);
+  Ptr<Packet> originalPacket = Create<Packet> (buf, payloadSize);
+  delete[] buf;
+
+  // N = K / codeRate of a single block would not fit in the 16-bit ESI
+  std::optional<Ptr<Packet>> encodedPacket;
+  std::vector<Ptr<Packet>> packetList;
+  std::map<uint16_t, std::set<uint16_t>> esis;
+  size_t n = encoder->EncodePacket (originalPacket);
+  while ((encodedPacket = encoder->NextEncodedPacket ()))
+    {
+      AlFecHeader::EncodeHeader encodeHeader;
+      (*encodedPacket)->PeekHeader (encodeHeader);
+      esis[encodeHeader.GetSourceBlockNumber ()].insert (encodeHeader.GetEncodedSymbolId ());
+      packetList.push_back (*encodedPacket);
+    }
+  NS_TEST_ASSERT_MSG_EQ (packetList.size (), n, "Total symbols mismatch");
+  NS_TEST_ASSERT_MSG_GT (esis.size (), 1, "Packet should be split into several blocks");
+  size_t nbEsis = 0;
+  for (const auto &blockEsis : esis)
+    {
+      nbEsis += blockEsis.second.size ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (nbEsis, n, "The ESIs of a block should be distinct");
+
+  Ptr<Object> decoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> decoder = CreateObject<AlFec> ();
+  decoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (decoderObj)));
+
+  // Lose one packet out of two
+  std::optional<Ptr<Packet>> decodedPacket;
+  for (size_t i = 1; i < packetList.size () && !decodedPacket; i += 2)
+    {
+      decodedPacket = decoder->DecodePacket (packetList[i]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (decodedPacket.has_value (), true, "Packet not decoded");
+
+  size_t serializedSize = originalPacket->GetSerializedSize ();
+  NS_TEST_ASSERT_MSG_EQ ((*decodedPacket)->GetSerializedSize (), serializedSize,
+                         "Serialized size mismatch");
+  std::vector<uint8_t> originalBuf (serializedSize);
+  std::vector<uint8_t> decodedBuf (serializedSize);
+  originalPacket->Serialize (originalBuf.data (), serializedSize);
+  (*decodedPacket)->Serialize (decodedBuf.data (), serializedSize);
+  NS_TEST_ASSERT_MSG_EQ (originalBuf == decodedBuf, true, "Decoded packet mismatch");
+
+  encoder->Dispose ();
+  decoder->Dispose ();
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+}
+
+/**
+ * TestCase 12
+ */
+
+EvictedContextTestCase::EvictedContextTestCase (uint16_t contextPinWindow)
+    : TestCase ("Check the eviction of packet contexts in flight with a pin window of " +
+                std::to_string (contextPinWindow)),
+      m_contextPinWindow (contextPinWindow)
+{
+  NS_LOG_INFO ("Creating EvictedContextTestCase");
+  m_codecFactory.SetTypeId ("ns3::AlFecCodecNativeRs");
+  m_codecFactory.Set ("symbolSize", UintegerValue (symbolSize));
+  m_codecFactory.Set ("codeRate", DoubleValue (codeRate));
+}
+
+EvictedContextTestCase::~EvictedContextTestCase ()
+{
+}
+
+void
+EvictedContextTestCase::DoRun (void)
+{
+  AlFecPacketContextStore &store = AlFecPacketContextStore::Get ();
+  size_t previousLimit = store.GetMemoryLimit ();
+  store.SetMemoryLimit (memoryLimit);
+  store.ResetStats ();
+
+  Ptr<Object> encoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> encoder = CreateObject<AlFec> ();
+  encoder->SetAttribute ("directPacketPath", BooleanValue (true));
+  encoder->SetAttribute ("contextPinWindow", UintegerValue (m_contextPinWindow));
+  encoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (encoderObj)));
+  Ptr<Object> decoderObj = m_codecFactory.Create ();
+  Ptr<AlFec> decoder = CreateObject<AlFec> ();
+  decoder->SetCodec (dynamic_cast<AlFecCodec *> (PeekPointer (decoderObj)));
+
+  // Three packets, whose packet tags give them distinct contexts
+  std::vector<Ptr<Packet>> originalPackets;
+  std::vector<std::vector<Ptr<Packet>>> packetLists;
+  for (int i = 0; i < 3; i++)
+    {
+      uint8_t *buf = new uint8_t[payloadSize];
+      fillRandomBytes (buf, payloadSize);
+      originalPackets.push_back (Create<Packet> (buf, payloadSize));
+      delete[] buf;
+      AlFecInfoTag packetTag;
+      packetTag.SetK (i + 1);
+      originalPackets.back ()->AddPacketTag (packetTag);
+
+      std::optional<Ptr<Packet>> encodedPacket;
+      packetLists.emplace_back ();
+      encoder->EncodePacket (originalPackets.back ());
+      while ((encodedPacket = encoder->NextEncodedPacket ()))
+        {
+          packetLists.back ().push_back (*encodedPacket);
+        }
+
+      // The first symbol of the first packet arrives before the others are sent
+      if (i == 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ (decoder->DecodePacket (packetLists[0][0]).has_value (), false,
+                                 "Decoded with one symbol");
+        }
+    }
+
+  // Fill the store. The context of the first packet is held by its decoder
+  // context and the one of the last packet by the encoder; the one of the
+  // second packet is only pinned by the encoder within the pin window.
+  for (int i = 0; i < nbFillers; i++)
+    {
+      std::vector<uint8_t> filler (fillerSize, i);
+      Buffer context;
+      context.AddAtStart (fillerSize);
+      context.Begin ().Write (filler.data (), fillerSize);
+      store.Insert (context);
+    }
+  NS_TEST_ASSERT_MSG_GT (store.GetStats ().evictions, 0, "The store should have evicted contexts");
+
+  // The first packet decodes with its tag
+  std::optional<Ptr<Packet>> decodedPacket;
+  for (size_t i = packetLists[0].size () / 2; i < packetLists[0].size () && !decodedPacket; i++)
+    {
+      decodedPacket = decoder->DecodePacket (packetLists[0][i]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (decodedPacket.has_value (), true, "Packet in flight not decoded");
+  AlFecInfoTag decodedPacketTag;
+  NS_TEST_ASSERT_MSG_EQ ((*decodedPacket)->PeekPacketTag (decodedPacketTag), true,
+                         "Packet tag not restored");
+  NS_TEST_ASSERT_MSG_EQ (decodedPacketTag.GetK (), 1, "Packet tag content mismatch");
+
+  NS_TEST_ASSERT_MSG_EQ (decoder->GetNbLostContexts (), 0, "Packet in flight counted as lost");
+
+  size_t lookupMisses = store.GetStats ().lookupMisses;
+  if (m_contextPinWindow >= 2)
+    {
+      // The second packet kept its context and decodes with its tag
+      decodedPacket = std::nullopt;
+      for (size_t i = 0; i < packetLists[1].size () && !decodedPacket; i++)
+        {
+          decodedPacket = decoder->DecodePacket (packetLists[1][i]);
+        }
+      NS_TEST_ASSERT_MSG_EQ (decodedPacket.has_value (), true, "Pinned packet not decoded");
+      NS_TEST_ASSERT_MSG_EQ ((*decodedPacket)->PeekPacketTag (decodedPacketTag), true,
+                             "Packet tag not restored");
+      NS_TEST_ASSERT_MSG_EQ (decodedPacketTag.GetK (), 2, "Packet tag content mismatch");
+      NS_TEST_ASSERT_MSG_EQ (store.GetStats ().lookupMisses, lookupMisses,
+                             "The pinned context should not have been evicted");
+      NS_TEST_ASSERT_MSG_EQ (decoder->GetNbLostContexts (), 0, "Pinned packet counted as lost");
+    }
+  else
+    {
+      // The second packet lost its context: it is dropped, late symbols included
+      for (Ptr<Packet> packet : packetLists[1])
+        {
+          decodedPacket = decoder->DecodePacket (packet);
+          NS_TEST_ASSERT_MSG_EQ (decodedPacket.has_value (), false,
+                                 "Packet decoded without its context");
+        }
+      NS_TEST_ASSERT_MSG_GT (store.GetStats ().lookupMisses, lookupMisses,
+                             "The context should have been evicted");
+      NS_TEST_ASSERT_MSG_EQ (decoder->GetNbLostContexts (), 1, "Lost packet not counted");
+    }
+
+  encoder->Dispose ();
+  decoder->Dispose ();
+  encoderObj->Dispose ();
+  decoderObj->Dispose ();
+  store.SetMemoryLimit (previousLimit);
+}
@@ -47,4 +47,197 @@ private:
   ObjectFactory m_codecFactory;
 };
 
+/**
+ * Test 3. Successfully interpretation of a packet split into several source blocks
+ */
+class MultiBlockInterpretationTestCase : public TestCase
+{
+public:
+  MultiBlockInterpretationTestCase ();
+  virtual ~MultiBlockInterpretationTestCase ();
+  const int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 20000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 4. Successfully interpretation of source blocks aggregating several packets
+ */
+class AggregationTestCase : public TestCase
+{
+public:
+  AggregationTestCase ();
+  virtual ~AggregationTestCase ();
+  const int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 60;
+  const int nbPackets = 8;
+  const int nbBlocks = 2;
+
+private:
+  virtual void DoRun (void);
+  void Flushed (size_t n);
+  ObjectFactory m_codecFactory;
+  size_t m_nbFlushed = 0;
+};
+
+/**
+ * Test 5. Successfully interpretation of interleaved source blocks of several flows
+ */
+class InterleavedBlocksTestCase : public TestCase
+{
+public:
+  InterleavedBlocksTestCase ();
+  virtual ~InterleavedBlocksTestCase ();
+  const int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 500;
+  const int nbFlows = 3;
+  const int nbPacketsPerFlow = 4;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 6. The source bytes of a packet are delivered early and in order,
+ * and the gap of a lost source symbol once its source block decodes
+ */
+class EarlyDeliveryTestCase : public TestCase
+{
+public:
+  EarlyDeliveryTestCase (std::string typeId);
+  virtual ~EarlyDeliveryTestCase ();
+  const int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 3000;
+  const uint32_t maxSourceBlockLength = 100; // Less than the symbols of the packet
+  const unsigned int lostEsi = 5;
+
+private:
+  virtual void DoRun (void);
+  void Delivered (uint32_t flowId, uint16_t sn, uint32_t offset, Ptr<Packet> p);
+  ObjectFactory m_codecFactory;
+  std::vector<uint8_t> m_delivered; // Bytes delivered early, in order
+};
+
+/**
+ * Test 7. Successfully interpretation of a block of large symbols, with
+ * ESIs, K and a padding that do not fit in a byte
+ */
+class WideParametersTestCase : public TestCase
+{
+public:
+  WideParametersTestCase ();
+  virtual ~WideParametersTestCase ();
+  const uint16_t symbolSize = 2048;
+  const double codeRate = 0.5;
+  const uint16_t nbSourceSymbols = 600;
+  const size_t paddingSize = 1000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 8. The encoded packets carry the handle of a context stored once, and
+ * the copies of a packet share it
+ */
+class SharedContextTestCase : public TestCase
+{
+public:
+  SharedContextTestCase ();
+  virtual ~SharedContextTestCase ();
+  const int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 1000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 9. Successfully interpretation of packets copied instead of
+ * serialized, with their byte tags and packet tags
+ */
+class DirectPacketPathTestCase : public TestCase
+{
+public:
+  DirectPacketPathTestCase ();
+  virtual ~DirectPacketPathTestCase ();
+  const int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 3000;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 10. The batch APIs produce the same packets as the per-packet ones
+ */
+class BatchTestCase : public TestCase
+{
+public:
+  BatchTestCase ();
+  virtual ~BatchTestCase ();
+  const int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 1000;
+  const int nbPackets = 4;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 11. A fountain codec at a low code rate splits a large packet so that
+ * the ESIs of every block fit in the header
+ */
+class LowCodeRateTestCase : public TestCase
+{
+public:
+  LowCodeRateTestCase (std::string typeId);
+  virtual ~LowCodeRateTestCase ();
+  const int symbolSize = 16;
+  const double codeRate = 0.25;
+  const int payloadSize = 300000; // More than the 16384 symbols of one block at this rate
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+};
+
+/**
+ * Test 12. The packet context of a block in flight survives a full context
+ * store while it is pinned by the encoder, and a block whose context was
+ * evicted is dropped and counted
+ */
+class EvictedContextTestCase : public TestCase
+{
+public:
+  EvictedContextTestCase (uint16_t contextPinWindow);
+  virtual ~EvictedContextTestCase ();
+  const int symbolSize = 16;
+  const double codeRate = 0.5;
+  const int payloadSize = 1000;
+  const size_t memoryLimit = 1024; // Bytes of the context store during the test
+  const int nbFillers = 16; // Unreferenced contexts inserted while the blocks are in flight
+  const int fillerSize = 256;
+
+private:
+  virtual void DoRun (void);
+  ObjectFactory m_codecFactory;
+  uint16_t m_contextPinWindow;
+};
+
 #endif /* TEST_AL_FEC_PACKET_H */
@@ -0,0 +1,315 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/object.h"
+#include "ns3/core-module.h"
+
+#include "al-fec-test-thread-safety.h"
+#include "ns3/al-fec-matrix-cache.h"
+#include "ns3/al-fec-openfec-session-pool.h"
+
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("AlFecThreadSafetyTest");
+
+/**
+ * TestSuite
+ */
+
+AlFecThreadSafetyTestSuite::AlFecThreadSafetyTestSuite ()
+    : TestSuite ("al-fec-thread-safety", SYSTEM)
+{
+  LogLevel logLevel = (LogLevel) (LOG_PREFIX_FUNC | LOG_PREFIX_TIME | LOG_LEVEL_ALL);
+
+  LogComponentEnable ("AlFecThreadSafetyTest", logLevel);
+  AddTestCase (new MatrixCacheThreadsTestCase (), TestCase::QUICK);
+  AddTestCase (new SessionPoolThreadsTestCase (), TestCase::QUICK);
+  AddTestCase (new ParallelCodecPairsTestCase (), TestCase::QUICK);
+}
+
+static AlFecThreadSafetyTestSuite threadSafetyTestSuite;
+
+/**
+ * TestCase 1
+ */
+
+MatrixCacheThreadsTestCase::MatrixCacheThreadsTestCase ()
+    : TestCase ("Check the matrix cache shared by several threads")
+{
+  NS_LOG_INFO ("Creating MatrixCacheThreadsTestCase");
+}
+
+MatrixCacheThreadsTestCase::~MatrixCacheThreadsTestCase ()
+{
+}
+
+void
+MatrixCacheThreadsTestCase::DoRun (void)
+{
+  AlFecMatrixCache &cache = AlFecMatrixCache::Get ();
+  size_t previousLimit = cache.GetMemoryLimit ();
+  cache.SetMemoryLimit (memoryLimit);
+  cache.ResetStats ();
+
+  // The content of a matrix only depends on its key
+  auto build = [] (uint32_t k, uint32_t n) {
+    std::vector<uint8_t> matrix (k * n);
+    for (size_t i = 0; i < matrix.size (); i++)
+      {
+        matrix[i] = k * 31 + i;
+      }
+    return matrix;
+  };
+
+  // The threads do not report failures, which are counted and checked here
+  std::vector<int> nbMismatches (nbThreads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nbThreads; t++)
+    {
+      threads.emplace_back ([this, t, &cache, &build, &nbMismatches] () {
+        for (int i = 0; i < nbLookups; i++)
+          {
+            uint32_t k = 1 + (i * 7 + t) % nbKeys;
+            uint32_t n = 4 * k;
+            AlFecMatrixCache::Matrix matrix = cache.GetGenerator (
+                "ns3::ThreadSafetyTest", 8, k, n, [&build, k, n] () { return build (k, n); });
+            if (*matrix != build (k, n))
+              {
+                nbMismatches[t]++;
+              }
+          }
+      });
+    }
+  for (std::thread &thread : threads)
+    {
+      thread.join ();
+    }
+
+  AlFecMatrixCache::Stats stats = cache.GetStats ();
+  for (int t = 0; t < nbThreads; t++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (nbMismatches[t], 0, "Thread " << t << " got a wrong matrix");
+    }
+  NS_TEST_ASSERT_MSG_EQ (stats.generatorHits + stats.generatorMisses,
+                         static_cast<size_t> (nbThreads * nbLookups), "Lookups were lost");
+  NS_TEST_ASSERT_MSG_GT (stats.evictions, 0, "The cache should have evicted matrices");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (stats.memoryUsage, memoryLimit, "The cache is over its limit");
+
+  cache.SetMemoryLimit (previousLimit);
+}
+
+/**
+ * TestCase 2
+ */
+
+SessionPoolThreadsTestCase::SessionPoolThreadsTestCase ()
+    : TestCase ("Check the OpenFEC session pool shared by several threads")
+{
+  NS_LOG_INFO ("Creating SessionPoolThreadsTestCase");
+}
+
+SessionPoolThreadsTestCase::~SessionPoolThreadsTestCase ()
+{
+}
+
+void
+SessionPoolThreadsTestCase::DoRun (void)
+{
+  AlFecOpenfecSessionPool &pool = AlFecOpenfecSessionPool::Get ();
+  size_t hits = pool.GetHits ();
+  size_t misses = pool.GetMisses ();
+
+  of_rs_2_m_parameters_t params;
+  params.nb_source_symbols = k;
+  params.nb_repair_symbols = n - k;
+  params.encoding_symbol_length = symbolSize;
+  params.m = 8;
+  AlFecOpenfecSessionPool::Key key = {OF_CODEC_REED_SOLOMON_GF_2_M_STABLE, k, n, symbolSize, 8,
+                                      0};
+
+  // Each session is held by one thread at a time
+  std::mutex inUseMutex;
+  std::set<of_session_t *> inUse;
+  std::vector<int> nbShared (nbThreads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nbThreads; t++)
+    {
+      threads.emplace_back ([this, t, &pool, &params, &key, &inUseMutex, &inUse, &nbShared] () {
+        for (int i = 0; i < nbAcquisitions; i++)
+          {
+            of_session_t *session = pool.Acquire (key);
+            if (!session)
+              {
+                of_rs_2_m_parameters_t sessionParams = params;
+                session = AlFecOpenfecSessionPool::CreateSession (
+                    key.codecId, OF_ENCODER, reinterpret_cast<of_parameters_t *> (&sessionParams));
+              }
+            {
+              std::lock_guard<std::mutex> lock (inUseMutex);
+              if (!inUse.insert (session).second)
+                {
+                  nbShared[t]++;
+                }
+            }
+            std::this_thread::yield ();
+            {
+              std::lock_guard<std::mutex> lock (inUseMutex);
+              inUse.erase (session);
+            }
+            pool.Release (key, session);
+          }
+      });
+    }
+  for (std::thread &thread : threads)
+    {
+      thread.join ();
+    }
+
+  for (int t = 0; t < nbThreads; t++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (nbShared[t], 0, "Thread " << t << " got a session in use");
+    }
+  NS_TEST_ASSERT_MSG_EQ (pool.GetHits () - hits + pool.GetMisses () - misses,
+                         static_cast<size_t> (nbThreads * nbAcquisitions),
+                         "Acquisitions were lost");
+}
+
+/**
+ * TestCase 3
+ */
+
+ParallelCodecPairsTestCase::ParallelCodecPairsTestCase ()
+    : TestCase ("Check codec pairs running in parallel threads")
+{
+  NS_LOG_INFO ("Creating ParallelCodecPairsTestCase");
+  // The block codecs that decode every block with a quarter of the symbols lost
+  for (const char *typeId : {"ns3::AlFecCodecNativeRs", "ns3::AlFecCodecCauchyRs",
+                             "ns3::AlFecCodecFftRs", "ns3::AlFecCodecOpenfecRs",
+                             "ns3::AlFecCodecOpenfecLdpc", "ns3::AlFecCodecRaptorq"})
+    {
+      ObjectFactory factory;
+      factory.SetTypeId (typeId);
+      factory.Set ("symbolSize", UintegerValue (symbolSize));
+      factory.Set ("codeRate", DoubleValue (codeRate));
+      m_codecFactories.push_back (factory);
+    }
+}
+
+ParallelCodecPairsTestCase::~ParallelCodecPairsTestCase ()
+{
+}
+
+void
+ParallelCodecPairsTestCase::RunPair (size_t pair, AlFecCodec *encoder, AlFecCodec *decoder,
+                                     PairResult &result) const
+{
+  // The content only depends on the pair, so that runs can be compared. No
+  // ns-3 Buffer is created: the blocks and symbols stay in plain memory.
+  std::mt19937 gen (pair);
+  std::vector<uint8_t> buf (payloadSize);
+  std::optional<std::pair<unsigned int, const uint8_t *>> encodedSymbol;
+
+  for (int block = 0; block < nbBlocks; block++)
+    {
+      for (uint8_t &byte : buf)
+        {
+          byte = gen ();
+        }
+      result.sources.insert (result.sources.end (), buf.begin (), buf.end ());
+
+      // Lose one symbol out of four, from a different first one in each pair
+      encoder->SetSourceBlock (buf.data (), buf.size ());
+      decoder->SetK (encoder->GetK ());
+      bool isDecoded = false;
+      while ((encodedSymbol = encoder->NextEncodedSymbol ()))
+        {
+          result.encoded.insert (result.encoded.end (), encodedSymbol->second,
+                                 encodedSymbol->second + symbolSize);
+          if ((encodedSymbol->first + pair) % 4 != 0 && !isDecoded)
+            {
+              isDecoded = decoder->DecodeSymbol (encodedSymbol->second, symbolSize,
+                                                 encodedSymbol->first);
+            }
+        }
+
+      // The decoded block is read from the source symbols of the decoder
+      for (size_t esi = 0; isDecoded && esi < decoder->GetK (); esi++)
+        {
+          const uint8_t *symbol = decoder->GetSourceSymbol (esi);
+          size_t size = std::min<size_t> (symbolSize, payloadSize - esi * symbolSize);
+          if (!symbol)
+            {
+              break;
+            }
+          result.decoded.insert (result.decoded.end (), symbol, symbol + size);
+        }
+      decoder->NextBlock ();
+    }
+}
+
+void
+ParallelCodecPairsTestCase::DoRun (void)
+{
+  // The objects are created and disposed of by this thread, and each thread
+  // only uses its own pair
+  std::vector<Ptr<Object>> codecObjects;
+  auto createPairs = [this, &codecObjects] () {
+    std::vector<std::pair<AlFecCodec *, AlFecCodec *>> pairs;
+    for (int i = 0; i < nbPairs; i++)
+      {
+        const ObjectFactory &factory = m_codecFactories[i % m_codecFactories.size ()];
+        Ptr<Object> encoderObj = factory.Create ();
+        Ptr<Object> decoderObj = factory.Create ();
+        codecObjects.push_back (encoderObj);
+        codecObjects.push_back (decoderObj);
+        pairs.emplace_back (dynamic_cast<AlFecCodec *> (PeekPointer (encoderObj)),
+                            dynamic_cast<AlFecCodec *> (PeekPointer (decoderObj)));
+      }
+    return pairs;
+  };
+
+  // Serial reference
+  std::vector<PairResult> expected (nbPairs);
+  std::vector<std::pair<AlFecCodec *, AlFecCodec *>> pairs = createPairs ();
+  for (int i = 0; i < nbPairs; i++)
+    {
+      RunPair (i, pairs[i].first, pairs[i].second, expected[i]);
+      NS_TEST_ASSERT_MSG_EQ (expected[i].decoded == expected[i].sources, true,
+                             "Pair " << i << " did not decode every block");
+    }
+
+  // Every pair in its own thread, with fresh codecs
+  std::vector<PairResult> results (nbPairs);
+  pairs = createPairs ();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < nbPairs; i++)
+    {
+      threads.emplace_back (&ParallelCodecPairsTestCase::RunPair, this, i, pairs[i].first,
+                            pairs[i].second, std::ref (results[i]));
+    }
+  for (std::thread &thread : threads)
+    {
+      thread.join ();
+    }
+
+  for (int i = 0; i < nbPairs; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (results[i].encoded == expected[i].encoded, true,
+                             "Encoded symbols of pair " << i << " mismatch");
+      NS_TEST_ASSERT_MSG_EQ (results[i].decoded == expected[i].decoded, true,
+                             "Decoded blocks of pair " << i << " mismatch");
+    }
+
+  for (Ptr<Object> codecObject : codecObjects)
+    {
+      codecObject->Dispose ();
+    }
+}
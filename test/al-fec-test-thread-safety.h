@@ -0,0 +1,93 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef TEST_AL_FEC_THREAD_SAFETY_H
+#define TEST_AL_FEC_THREAD_SAFETY_H
+
+#include "ns3/test.h"
+#include "ns3/al-fec-codec.h"
+
+#include <vector>
+
+using namespace ns3;
+
+class AlFecThreadSafetyTestSuite : public TestSuite
+{
+public:
+  AlFecThreadSafetyTestSuite ();
+};
+
+/**
+ * Test 1. Threads sharing the matrix cache, with evictions, always get the
+ * matrix of their key
+ */
+class MatrixCacheThreadsTestCase : public TestCase
+{
+public:
+  MatrixCacheThreadsTestCase ();
+  virtual ~MatrixCacheThreadsTestCase ();
+  const int nbThreads = 8;
+  const int nbLookups = 2000; // Lookups of each thread
+  const uint32_t nbKeys = 16;
+  const size_t memoryLimit = 4096; // Less than the matrices of all the keys
+
+private:
+  virtual void DoRun (void);
+};
+
+/**
+ * Test 2. Threads sharing the OpenFEC session pool never get the same
+ * session at the same time
+ */
+class SessionPoolThreadsTestCase : public TestCase
+{
+public:
+  SessionPoolThreadsTestCase ();
+  virtual ~SessionPoolThreadsTestCase ();
+  const int nbThreads = 8;
+  const int nbAcquisitions = 200; // Acquisitions of each thread
+  const uint32_t k = 10;
+  const uint32_t n = 20;
+  const uint32_t symbolSize = 16;
+
+private:
+  virtual void DoRun (void);
+};
+
+/**
+ * Test 3. Encoder and decoder pairs of every block codec, running in
+ * parallel threads on the Buffer-free path, give the same symbols and
+ * decoded blocks as a serial run
+ */
+class ParallelCodecPairsTestCase : public TestCase
+{
+public:
+  ParallelCodecPairsTestCase ();
+  virtual ~ParallelCodecPairsTestCase ();
+  const unsigned int symbolSize = 64;
+  const double codeRate = 0.5;
+  const int payloadSize = 5000;
+  const int nbPairs = 16;
+  const int nbBlocks = 8;
+
+private:
+  /**
+   * \brief What a pair produced over its blocks
+   */
+  struct PairResult
+  {
+    std::vector<uint8_t> sources; // Content of the source blocks
+    std::vector<uint8_t> encoded; // Every encoded symbol
+    std::vector<uint8_t> decoded; // Content of the decoded blocks
+  };
+
+  /**
+   * \brief Encode and decode the blocks of a pair. It runs on any thread, so
+   * it does not report failures, which DoRun does from the results.
+   */
+  void RunPair (size_t pair, AlFecCodec *encoder, AlFecCodec *decoder, PairResult &result) const;
+
+  virtual void DoRun (void);
+  std::vector<ObjectFactory> m_codecFactories;
+};
+
+#endif /* TEST_AL_FEC_THREAD_SAFETY_H */